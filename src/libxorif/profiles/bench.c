@@ -0,0 +1,76 @@
+/*
+ * Copyright 2020 - 2023 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file bench.c
+ * @author Steven Dickinson
+ * @brief Simple timing of common API calls (used by "make profile-compare").
+ * @addtogroup libxorif
+ * @{
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include "xorif_api.h"
+
+#define NUM_LOOPS 100000
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main(void)
+{
+    if (xorif_init(NULL) != XORIF_SUCCESS)
+    {
+        printf("xorif_init() failed\n");
+        return 1;
+    }
+
+    struct xorif_fhi_eth_stats stats;
+    double t;
+
+    t = now_ns();
+    for (int i = 0; i < NUM_LOOPS; ++i)
+    {
+        xorif_set_cc_num_rbs(i % 8, 100 + (i % 100));
+    }
+    printf("xorif_set_cc_num_rbs     %8.1f ns/call\n", (now_ns() - t) / NUM_LOOPS);
+
+    t = now_ns();
+    for (int i = 0; i < NUM_LOOPS; ++i)
+    {
+        xorif_get_fhi_eth_stats(0, &stats);
+    }
+    printf("xorif_get_fhi_eth_stats  %8.1f ns/call\n", (now_ns() - t) / NUM_LOOPS);
+
+    xorif_set_cc_num_rbs(0, 100);
+    t = now_ns();
+    for (int i = 0; i < NUM_LOOPS / 100; ++i)
+    {
+        xorif_configure_cc(0);
+    }
+    printf("xorif_configure_cc       %8.1f ns/call\n", (now_ns() - t) / (NUM_LOOPS / 100));
+
+    xorif_finish();
+    return 0;
+}
+
+/** @} */
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2020 - 2023 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file sim.h
+ * @author Steven Dickinson
+ * @brief Hardware profile matching the NO_HW simulated register bank.
+ * @addtogroup libxorif
+ * @{
+ *
+ * Build with "make PROFILE=sim NO_HW=1".
+ *
+ * A hardware profile fixes the capabilities of the target device at build
+ * time. Copy this file and fill in the values reported by
+ * xorif_get_capabilities() (or "get fhi_caps" in xorif-app) on the target.
+ * xorif_init() fails if the device doesn't match the profile.
+ */
+
+#ifndef XORIF_PROFILE_SIM_H
+#define XORIF_PROFILE_SIM_H
+
+// Optional features (0 = compiled out, and their setters return XORIF_NOT_SUPPORTED)
+#define HAS_SSB 1      /**< SSB channel support */
+#define HAS_PRACH 1    /**< PRACH compression support */
+#define HAS_OCP 0      /**< Integrated O-RAN Channel Processor (requires OCP=1) */
+#define HAS_RECORDER 0 /**< Flight recorder (API calls, errors, register writes, alarms, etc.) */
+
+/**
+ * @brief Fixed device capabilities (see struct xorif_caps).
+ */
+static const struct xorif_caps xorif_profile_caps =
+{
+    .max_cc = 8,
+    .num_eth_ports = 4,
+    .numerologies = 0x1F,
+    .extended_cp = 0,
+    .iq_de_comp_methods = IQ_COMP_NONE_SUPPORT | IQ_COMP_BLOCK_FP_SUPPORT | IQ_COMP_MODULATION_SUPPORT,
+    .iq_de_comp_bfp_widths = 0xFFFF,
+    .iq_de_comp_mod_widths = 0x3E,
+    .iq_comp_methods = IQ_COMP_NONE_SUPPORT | IQ_COMP_BLOCK_FP_SUPPORT,
+    .iq_comp_bfp_widths = 0xFFFF,
+    .no_framer_ss = 8,
+    .no_deframer_ss = 20,
+    .max_framer_ethernet_pkt = 9000,
+    .max_deframer_ethernet_pkt = 9000,
+    .max_subcarriers = 6600,
+    .max_data_symbols = 16,
+    .max_ctrl_symbols = 16,
+    .max_ul_ctrl_1kwords = 4,
+    .max_dl_ctrl_1kwords = 4,
+    .max_dl_data_1kwords = 16,
+    .max_ssb_ctrl_512words = 1,
+    .max_ssb_data_512words = 2,
+    .timer_clk_ps = 5000,
+    .num_unsolicited_ports = 1,
+    .num_prach_ports = 1,
+    .du_id_limit = 4,
+    .bs_id_limit = 6,
+    .cc_id_limit = 4,
+    .ru_id_limit = 8,
+    .ss_id_limit = 5,
+    .ru_ports_map_width = 8,
+    .extra_flags = 0,
+};
+
+#endif // XORIF_PROFILE_SIM_H
+
+/** @} */
@@ -193,6 +193,11 @@ class LIBXORIF:
         self.logger.info(f'xorif_configure_cc: {cc}')
         return lib.xorif_configure_cc(cc)
 
+    # int xorif_configure_cc_hot_add(uint16_t cc)
+    def xorif_configure_cc_hot_add(self, cc):
+        self.logger.info(f'xorif_configure_cc_hot_add: {cc}')
+        return lib.xorif_configure_cc_hot_add(cc)
+
     # int xorif_disable_cc(uint16_t cc)
     def xorif_enable_cc(self, cc):
         self.logger.info(f'xorif_enable_cc: {cc}')
@@ -203,7 +208,7 @@ class LIBXORIF:
         self.logger.info(f'xorif_disable_cc: {cc}')
         return lib.xorif_disable_cc(cc)
 
-    # uint8_t xorif_get_enabled_cc_mask(void)
+    # uint16_t xorif_get_enabled_cc_mask(void)
     def xorif_get_enabled_cc_mask(self):
         self.logger.info('xorif_get_enabled_cc_mask:')
         return lib.xorif_get_enabled_cc_mask()
@@ -381,6 +386,61 @@ class LIBXORIF:
         result = lib.xorif_get_fhi_eth_stats(port, stats_ptr)
         return (result, cdata_to_py(stats_ptr[0]))
 
+    # int xorif_get_fhi_eth_stats_all(uint16_t num_ports, struct xorif_fhi_eth_stats *ptr)
+    def xorif_get_fhi_eth_stats_all(self, num_ports):
+        self.logger.info(f'xorif_get_fhi_eth_stats_all: {num_ports}')
+        stats_ptr = ffi.new("struct xorif_fhi_eth_stats[]", max(num_ports, 1))
+        result = lib.xorif_get_fhi_eth_stats_all(num_ports, stats_ptr)
+        return (result, [cdata_to_py(stats_ptr[i]) for i in range(num_ports)])
+
+    # int xorif_start_stats_collector(uint32_t period_ms, uint16_t depth, const char *ptp_device)
+    def xorif_start_stats_collector(self, period_ms, depth, ptp_device=None):
+        self.logger.info(f'xorif_start_stats_collector: {period_ms}, {depth}, {ptp_device}')
+        if not ptp_device:
+            ptp_device = ffi.NULL
+        else:
+            ptp_device = bytes(ptp_device, "ascii")
+        return lib.xorif_start_stats_collector(period_ms, depth, ptp_device)
+
+    # int xorif_stop_stats_collector(void)
+    def xorif_stop_stats_collector(self):
+        self.logger.info('xorif_stop_stats_collector:')
+        return lib.xorif_stop_stats_collector()
+
+    # int xorif_get_stats_sample(int port, uint16_t age, struct xorif_fhi_eth_stats *ptr, uint64_t *timestamp)
+    def xorif_get_stats_sample(self, port, age=0):
+        self.logger.info(f'xorif_get_stats_sample: {port}, {age}')
+        stats_ptr = ffi.new("struct xorif_fhi_eth_stats *")
+        timestamp_ptr = ffi.new("uint64_t *")
+        result = lib.xorif_get_stats_sample(port, age, stats_ptr, timestamp_ptr)
+        return (result, cdata_to_py(stats_ptr[0]), timestamp_ptr[0])
+
+    # int xorif_get_stats_window(int port, uint32_t window_ms, struct xorif_fhi_eth_stats_window *ptr)
+    def xorif_get_stats_window(self, port, window_ms=0):
+        self.logger.info(f'xorif_get_stats_window: {port}, {window_ms}')
+        window_ptr = ffi.new("struct xorif_fhi_eth_stats_window *")
+        result = lib.xorif_get_stats_window(port, window_ms, window_ptr)
+        return (result, cdata_to_py(window_ptr[0]))
+
+    # int xorif_open_stats_consumer(uint16_t *handle)
+    def xorif_open_stats_consumer(self):
+        self.logger.info(f'xorif_open_stats_consumer')
+        handle_ptr = ffi.new("uint16_t *")
+        result = lib.xorif_open_stats_consumer(handle_ptr)
+        return (result, handle_ptr[0])
+
+    # int xorif_close_stats_consumer(uint16_t handle)
+    def xorif_close_stats_consumer(self, handle):
+        self.logger.info(f'xorif_close_stats_consumer: {handle}')
+        return lib.xorif_close_stats_consumer(handle)
+
+    # int xorif_read_stats_consumer(uint16_t handle, int port, struct xorif_fhi_eth_stats_delta *ptr)
+    def xorif_read_stats_consumer(self, handle, port):
+        self.logger.info(f'xorif_read_stats_consumer: {handle}, {port}')
+        delta_ptr = ffi.new("struct xorif_fhi_eth_stats_delta *")
+        result = lib.xorif_read_stats_consumer(handle, port, delta_ptr)
+        return (result, cdata_to_py(delta_ptr[0]))
+
     # int xorif_set_fhi_dest_mac_addr(int port, const uint8_t address[])
     def xorif_set_fhi_dest_mac_addr(self, port, address):
         self.logger.info(f'xorif_set_fhi_dest_mac_addr: {port}, {address}')
@@ -428,6 +488,35 @@ class LIBXORIF:
                 self.logger.error('xorif_set_modu_dest_mac_addr: invalid MAC address format')
                 return lib.XORIF_FAILURE
 
+    # int xorif_set_modu_table(int port, uint16_t du, uint16_t number, const struct xorif_modu_entry *table)
+    def xorif_set_modu_table(self, port, du, table):
+        self.logger.info(f'xorif_set_modu_table: {port}, {du}, {table}')
+        table_ptr = ffi.new("struct xorif_modu_entry[]", max(len(table), 1))
+        for i, entry in enumerate(table):
+            try:
+                array = [int(x, 16) for x in entry['address'].split(':')]
+            except:
+                return lib.XORIF_FAILURE
+            if len(array) != 6:
+                self.logger.error('xorif_set_modu_table: invalid MAC address format')
+                return lib.XORIF_FAILURE
+            table_ptr[i].address = array
+            table_ptr[i].id = entry.get('id', 0)
+            table_ptr[i].dei = entry.get('dei', 0)
+            table_ptr[i].pcp = entry.get('pcp', 0)
+        return lib.xorif_set_modu_table(port, du, len(table), table_ptr)
+
+    # int xorif_get_modu_table(int port, uint16_t du, uint16_t number, struct xorif_modu_entry *table)
+    def xorif_get_modu_table(self, port, du, number):
+        self.logger.info(f'xorif_get_modu_table: {port}, {du}, {number}')
+        table_ptr = ffi.new("struct xorif_modu_entry[]", max(number, 1))
+        result = lib.xorif_get_modu_table(port, du, number, table_ptr)
+        table = []
+        for i in range(number):
+            table.append({'address': ':'.join(f'{x:02x}' for x in table_ptr[i].address),
+                          'id': table_ptr[i].id, 'dei': table_ptr[i].dei, 'pcp': table_ptr[i].pcp})
+        return (result, table)
+
     # int xorif_set_mtu_size(uint16_t size)
     def xorif_set_mtu_size(self, size):
         self.logger.info(f'xorif_set_mtu_size: {size}')
@@ -457,6 +546,41 @@ class LIBXORIF:
             self.logger.error('xorif_set_fhi_packet_filter: invalid filter / mask size')
             return lib.XORIF_FAILURE
 
+    # int xorif_compile_packet_filter(const struct xorif_packet_match *match, uint32_t filter[16], uint16_t mask[4], uint16_t *exact)
+    def xorif_compile_packet_filter(self, match):
+        self.logger.info(f'xorif_compile_packet_filter: {match}')
+        match_ptr = ffi.new("const struct xorif_packet_match *", match)
+        filter_ptr = ffi.new("uint32_t[16]")
+        mask_ptr = ffi.new("uint16_t[4]")
+        exact_ptr = ffi.new("uint16_t *")
+        result = lib.xorif_compile_packet_filter(match_ptr, filter_ptr, mask_ptr, exact_ptr)
+        return (result, list(filter_ptr), list(mask_ptr), exact_ptr[0])
+
+    # int xorif_set_fhi_port_filter(int port, const struct xorif_packet_match *match)
+    def xorif_set_fhi_port_filter(self, port, match):
+        self.logger.info(f'xorif_set_fhi_port_filter: {port}, {match}')
+        match_ptr = ffi.new("const struct xorif_packet_match *", match)
+        return lib.xorif_set_fhi_port_filter(port, match_ptr)
+
+    # int xorif_set_cc_planned_eth_port(uint16_t cc, uint16_t port)
+    def xorif_set_cc_planned_eth_port(self, cc, port):
+        self.logger.info(f'xorif_set_cc_planned_eth_port: {cc}, {port}')
+        return lib.xorif_set_cc_planned_eth_port(cc, port)
+
+    # int xorif_get_cc_planned_eth_port(uint16_t cc, uint16_t *port)
+    def xorif_get_cc_planned_eth_port(self, cc):
+        self.logger.info(f'xorif_get_cc_planned_eth_port: {cc}')
+        port_ptr = ffi.new("uint16_t *")
+        result = lib.xorif_get_cc_planned_eth_port(cc, port_ptr)
+        return (result, port_ptr[0])
+
+    # int xorif_get_fhi_port_config(int port, struct xorif_fhi_port_config *ptr)
+    def xorif_get_fhi_port_config(self, port):
+        self.logger.info(f'xorif_get_fhi_port_config: {port}')
+        config_ptr = ffi.new("struct xorif_fhi_port_config *")
+        result = lib.xorif_get_fhi_port_config(port, config_ptr)
+        return (result, cdata_to_py(config_ptr[0]))
+
     # int xorif_set_fhi_eaxc_id(uint16_t du_bits, uint16_t bs_bits, uint16_t cc_bits, uint16_t ru_bits)
     def xorif_set_fhi_eaxc_id(self, du_bits, bs_bits, cc_bits, ru_bits):
         self.logger.info(f'xorif_set_fhi_eaxc_id: {du_bits}, {bs_bits}, {cc_bits}, {ru_bits}')
@@ -504,6 +628,35 @@ class LIBXORIF:
         self.logger.info(f'xorif_set_ru_ports_table_vcc: {address}, {port}, {type}, {ccid}, {number}')
         return lib.xorif_set_ru_ports_table_vcc(address, port, type, ccid, number)
 
+    # int xorif_set_ru_ports_table_bulk(uint16_t address, uint16_t number, const struct xorif_ru_port_map *map)
+    def xorif_set_ru_ports_table_bulk(self, address, map):
+        self.logger.info(f'xorif_set_ru_ports_table_bulk: {address}, {map}')
+        map_ptr = ffi.new("struct xorif_ru_port_map[]", map)
+        return lib.xorif_set_ru_ports_table_bulk(address, len(map), map_ptr)
+
+    # int xorif_verify_ru_ports_table(uint16_t *num_errors)
+    def xorif_verify_ru_ports_table(self):
+        self.logger.info('xorif_verify_ru_ports_table:')
+        data_ptr = ffi.new("uint16_t *")
+        result = lib.xorif_verify_ru_ports_table(data_ptr)
+        return (result, data_ptr[0])
+
+    # int xorif_compile_eaxc_layout(const struct xorif_eaxc_spec *spec, struct xorif_eaxc_layout *layout, struct xorif_ru_port_map *table, uint16_t table_len)
+    def xorif_compile_eaxc_layout(self, spec):
+        self.logger.info(f'xorif_compile_eaxc_layout: {spec}')
+        spec_ptr = ffi.new("const struct xorif_eaxc_spec *", spec)
+        layout_ptr = ffi.new("struct xorif_eaxc_layout *")
+        table_ptr = ffi.new("struct xorif_ru_port_map[]", 2048)
+        result = lib.xorif_compile_eaxc_layout(spec_ptr, layout_ptr, table_ptr, 2048)
+        table = [cdata_to_py(table_ptr[i]) for i in range(layout_ptr.table_size)]
+        return (result, cdata_to_py(layout_ptr[0]), table)
+
+    # int xorif_apply_eaxc_layout(const struct xorif_eaxc_layout *layout)
+    def xorif_apply_eaxc_layout(self, layout):
+        self.logger.info(f'xorif_apply_eaxc_layout: {layout}')
+        layout_ptr = ffi.new("const struct xorif_eaxc_layout *", layout)
+        return lib.xorif_apply_eaxc_layout(layout_ptr)
+
     # int xorif_enable_fhi_interrupts(uint32_t mask)
     def xorif_enable_fhi_interrupts(self, mask):
         self.logger.info(f'xorif_enable_fhi_interrupts: 0x{mask:08x}')
@@ -525,6 +678,77 @@ class LIBXORIF:
         self.logger.info(f'xorif_register_fhi_isr: {callback}')
         return lib.xorif_register_fhi_isr(callback)
 
+    # int xorif_open_alarm_queue(int *fd)
+    def xorif_open_alarm_queue(self):
+        self.logger.info('xorif_open_alarm_queue:')
+        fd_ptr = ffi.new("int *")
+        result = lib.xorif_open_alarm_queue(fd_ptr)
+        return (result, fd_ptr[0])
+
+    # int xorif_close_alarm_queue(void)
+    def xorif_close_alarm_queue(self):
+        self.logger.info('xorif_close_alarm_queue:')
+        return lib.xorif_close_alarm_queue()
+
+    # int xorif_read_alarm_events(uint16_t max, struct xorif_alarm_event *events, uint16_t *num, uint32_t *dropped)
+    def xorif_read_alarm_events(self, max=256):
+        self.logger.info(f'xorif_read_alarm_events: {max}')
+        events_ptr = ffi.new("struct xorif_alarm_event[]", max)
+        num_ptr = ffi.new("uint16_t *")
+        dropped_ptr = ffi.new("uint32_t *")
+        result = lib.xorif_read_alarm_events(max, events_ptr, num_ptr, dropped_ptr)
+        events = [cdata_to_py(events_ptr[i]) for i in range(num_ptr[0])]
+        return (result, events, dropped_ptr[0])
+
+    # int xorif_get_fhi_alarm_counts(struct xorif_fhi_alarm_counts *ptr)
+    def xorif_get_fhi_alarm_counts(self):
+        self.logger.info('xorif_get_fhi_alarm_counts:')
+        data_ptr = ffi.new("struct xorif_fhi_alarm_counts *")
+        result = lib.xorif_get_fhi_alarm_counts(data_ptr)
+        return (result, cdata_to_py(data_ptr[0]))
+
+    # void xorif_clear_fhi_alarm_counts(void)
+    def xorif_clear_fhi_alarm_counts(self):
+        self.logger.info('xorif_clear_fhi_alarm_counts:')
+        lib.xorif_clear_fhi_alarm_counts()
+
+    # int xorif_set_fhi_alarm_policy(uint32_t alarms, uint16_t action, uint16_t cc_mask)
+    def xorif_set_fhi_alarm_policy(self, alarms, action, cc_mask=0):
+        self.logger.info(f'xorif_set_fhi_alarm_policy: {alarms}, {action}, {cc_mask}')
+        return lib.xorif_set_fhi_alarm_policy(alarms, action, cc_mask)
+
+    # int xorif_get_fhi_alarm_policy(uint32_t alarm, uint16_t *action, uint16_t *cc_mask)
+    def xorif_get_fhi_alarm_policy(self, alarm):
+        self.logger.info(f'xorif_get_fhi_alarm_policy: {alarm}')
+        action_ptr = ffi.new("uint16_t *")
+        cc_mask_ptr = ffi.new("uint16_t *")
+        result = lib.xorif_get_fhi_alarm_policy(alarm, action_ptr, cc_mask_ptr)
+        return (result, action_ptr[0], cc_mask_ptr[0])
+
+    # int xorif_set_fhi_alarm_storm(uint32_t threshold, uint32_t window_ms, uint32_t backoff_ms)
+    def xorif_set_fhi_alarm_storm(self, threshold, window_ms, backoff_ms):
+        self.logger.info(f'xorif_set_fhi_alarm_storm: {threshold}, {window_ms}, {backoff_ms}')
+        return lib.xorif_set_fhi_alarm_storm(threshold, window_ms, backoff_ms)
+
+    # int xorif_get_fhi_alarm_storm_stats(struct xorif_fhi_alarm_storm_stats *ptr)
+    def xorif_get_fhi_alarm_storm_stats(self):
+        self.logger.info('xorif_get_fhi_alarm_storm_stats:')
+        data_ptr = ffi.new("struct xorif_fhi_alarm_storm_stats *")
+        result = lib.xorif_get_fhi_alarm_storm_stats(data_ptr)
+        return (result, cdata_to_py(data_ptr[0]))
+
+    # int xorif_get_irq_stats(struct xorif_irq_stats *ptr)
+    def xorif_get_irq_stats(self):
+        self.logger.info('xorif_get_irq_stats:')
+        data_ptr = ffi.new("struct xorif_irq_stats *")
+        result = lib.xorif_get_irq_stats(data_ptr)
+        return (result, cdata_to_py(data_ptr[0]))
+
+    # void xorif_clear_irq_stats(void)
+    def xorif_clear_irq_stats(self):
+        self.logger.info('xorif_clear_irq_stats:')
+        lib.xorif_clear_irq_stats()
+
     # int xorif_monitor_clear()
     def xorif_monitor_clear(self):
         self.logger.info('xorif_monitor_clear:')
@@ -547,6 +771,37 @@ class LIBXORIF:
         result = lib.xorif_monitor_read(counter, data_ptr)
         return (result, data_ptr[0])
 
+    # int xorif_monitor_read_bulk(uint16_t num, const uint8_t counters[], uint64_t values[], uint64_t *timestamp)
+    def xorif_monitor_read_bulk(self, counters):
+        self.logger.info(f'xorif_monitor_read_bulk: {counters}')
+        values_ptr = ffi.new("uint64_t[]", max(len(counters), 1))
+        timestamp_ptr = ffi.new("uint64_t *")
+        result = lib.xorif_monitor_read_bulk(len(counters), counters, values_ptr, timestamp_ptr)
+        return (result, list(values_ptr[0:len(counters)]), timestamp_ptr[0])
+
+    # int xorif_start_monitor_stream(uint32_t period_us, uint16_t num, const uint8_t counters[], uint16_t depth)
+    def xorif_start_monitor_stream(self, period_us, counters, depth=256):
+        self.logger.info(f'xorif_start_monitor_stream: {period_us}, {counters}, {depth}')
+        return lib.xorif_start_monitor_stream(period_us, len(counters), counters, depth)
+
+    # int xorif_stop_monitor_stream(void)
+    def xorif_stop_monitor_stream(self):
+        self.logger.info('xorif_stop_monitor_stream:')
+        return lib.xorif_stop_monitor_stream()
+
+    # int xorif_read_monitor_stream(uint16_t max, struct xorif_monitor_sample *samples, uint16_t *num, uint32_t *dropped)
+    def xorif_read_monitor_stream(self, max=64):
+        self.logger.info(f'xorif_read_monitor_stream: {max}')
+        samples_ptr = ffi.new("struct xorif_monitor_sample[]", max)
+        num_ptr = ffi.new("uint16_t *")
+        dropped_ptr = ffi.new("uint32_t *")
+        result = lib.xorif_read_monitor_stream(max, samples_ptr, num_ptr, dropped_ptr)
+        samples = []
+        for i in range(num_ptr[0]):
+            sample = samples_ptr[i]
+            samples.append({'timestamp': sample.timestamp, 'values': list(sample.values[0:sample.num_counters])})
+        return (result, samples, dropped_ptr[0])
+
     # int xorif_stall_monitor_snapshot(void)
     def xorif_stall_monitor_snapshot(self):
         self.logger.info('xorif_stall_monitor_snapshot:')
@@ -558,3 +813,191 @@ class LIBXORIF:
         data_ptr = ffi.new("struct xorif_stall_monitor *")
         result = lib.xorif_stall_monitor_read(data_ptr)
         return (result, cdata_to_py(data_ptr[0]))
+
+    # int xorif_start_stall_sampler(uint32_t period_ms, uint32_t window_ms, uint32_t threshold, uint16_t action)
+    def xorif_start_stall_sampler(self, period_ms, window_ms, threshold=0, action=0):
+        self.logger.info(f'xorif_start_stall_sampler: {period_ms}, {window_ms}, {threshold}, {action}')
+        return lib.xorif_start_stall_sampler(period_ms, window_ms, threshold, action)
+
+    # int xorif_stop_stall_sampler(void)
+    def xorif_stop_stall_sampler(self):
+        self.logger.info('xorif_stop_stall_sampler:')
+        return lib.xorif_stop_stall_sampler()
+
+    # int xorif_clear_stall_stats(void)
+    def xorif_clear_stall_stats(self):
+        self.logger.info('xorif_clear_stall_stats:')
+        return lib.xorif_clear_stall_stats()
+
+    # int xorif_get_stall_stats(uint16_t type, uint16_t ss, struct xorif_stall_stats *ptr)
+    def xorif_get_stall_stats(self, type, ss):
+        self.logger.info(f'xorif_get_stall_stats: {type}, {ss}')
+        data_ptr = ffi.new("struct xorif_stall_stats *")
+        result = lib.xorif_get_stall_stats(type, ss, data_ptr)
+        return (result, cdata_to_py(data_ptr[0]))
+
+    # int xorif_get_stall_sampler_status(struct xorif_stall_sampler_status *ptr)
+    def xorif_get_stall_sampler_status(self):
+        self.logger.info('xorif_get_stall_sampler_status:')
+        data_ptr = ffi.new("struct xorif_stall_sampler_status *")
+        result = lib.xorif_get_stall_sampler_status(data_ptr)
+        return (result, cdata_to_py(data_ptr[0]))
+
+    # int xorif_configure_arrival_histogram(uint32_t bin_width_ns, uint16_t num_bins, int32_t origin_ns)
+    def xorif_configure_arrival_histogram(self, bin_width_ns, num_bins, origin_ns=0):
+        self.logger.info(f'xorif_configure_arrival_histogram: {bin_width_ns}, {num_bins}, {origin_ns}')
+        return lib.xorif_configure_arrival_histogram(bin_width_ns, num_bins, origin_ns)
+
+    # int xorif_clear_arrival_histograms(void)
+    def xorif_clear_arrival_histograms(self):
+        self.logger.info('xorif_clear_arrival_histograms:')
+        return lib.xorif_clear_arrival_histograms()
+
+    # int xorif_add_arrival_samples(uint16_t cc, int port, uint16_t num, const int32_t offsets[])
+    def xorif_add_arrival_samples(self, cc, port, offsets):
+        self.logger.info(f'xorif_add_arrival_samples: {cc}, {port}, {len(offsets)}')
+        offsets_ptr = ffi.new("int32_t[]", offsets)
+        return lib.xorif_add_arrival_samples(cc, port, len(offsets), offsets_ptr)
+
+    # int xorif_get_arrival_histogram(uint16_t cc, int port, struct xorif_arrival_histogram *ptr)
+    def xorif_get_arrival_histogram(self, cc, port):
+        self.logger.info(f'xorif_get_arrival_histogram: {cc}, {port}')
+        data_ptr = ffi.new("struct xorif_arrival_histogram *")
+        result = lib.xorif_get_arrival_histogram(cc, port, data_ptr)
+        return (result, cdata_to_py(data_ptr[0]))
+
+    # int xorif_get_arrival_percentile(uint16_t cc, int port, double percentile, int32_t *offset_ns)
+    def xorif_get_arrival_percentile(self, cc, port, percentile):
+        self.logger.info(f'xorif_get_arrival_percentile: {cc}, {port}, {percentile}')
+        offset_ptr = ffi.new("int32_t *")
+        result = lib.xorif_get_arrival_percentile(cc, port, percentile, offset_ptr)
+        return (result, offset_ptr[0])
+
+    # int xorif_set_recorder_trigger(uint32_t triggers, uint32_t alarm_mask, uint16_t post_records, const char *dump_file)
+    def xorif_set_recorder_trigger(self, triggers, alarm_mask=0, post_records=0, dump_file=None):
+        self.logger.info(f'xorif_set_recorder_trigger: {triggers}, {alarm_mask}, {post_records}, {dump_file}')
+        if not dump_file:
+            dump_file = ffi.NULL
+        else:
+            dump_file = bytes(dump_file, "ascii")
+        return lib.xorif_set_recorder_trigger(triggers, alarm_mask, post_records, dump_file)
+
+    # int xorif_set_recorder_sampling(uint32_t period_ms)
+    def xorif_set_recorder_sampling(self, period_ms):
+        self.logger.info(f'xorif_set_recorder_sampling: {period_ms}')
+        return lib.xorif_set_recorder_sampling(period_ms)
+
+    # int xorif_trigger_recorder(void)
+    def xorif_trigger_recorder(self):
+        self.logger.info('xorif_trigger_recorder:')
+        return lib.xorif_trigger_recorder()
+
+    # int xorif_rearm_recorder(void)
+    def xorif_rearm_recorder(self):
+        self.logger.info('xorif_rearm_recorder:')
+        return lib.xorif_rearm_recorder()
+
+    # int xorif_dump_recorder(const char *dump_file)
+    def xorif_dump_recorder(self, dump_file):
+        self.logger.info(f'xorif_dump_recorder: {dump_file}')
+        return lib.xorif_dump_recorder(bytes(dump_file, "ascii"))
+
+    # int xorif_get_recorder_status(struct xorif_recorder_status *ptr)
+    def xorif_get_recorder_status(self):
+        self.logger.info('xorif_get_recorder_status:')
+        data_ptr = ffi.new("struct xorif_recorder_status *")
+        result = lib.xorif_get_recorder_status(data_ptr)
+        return (result, cdata_to_py(data_ptr[0]))
+
+    # int xorif_start_timeline(uint32_t max_events)
+    def xorif_start_timeline(self, max_events=0):
+        self.logger.info(f'xorif_start_timeline: {max_events}')
+        return lib.xorif_start_timeline(max_events)
+
+    # int xorif_stop_timeline(void)
+    def xorif_stop_timeline(self):
+        self.logger.info('xorif_stop_timeline:')
+        return lib.xorif_stop_timeline()
+
+    # int xorif_write_timeline(const char *file)
+    def xorif_write_timeline(self, file):
+        self.logger.info(f'xorif_write_timeline: {file}')
+        return lib.xorif_write_timeline(bytes(file, "ascii"))
+
+    # int xorif_get_timeline_status(struct xorif_timeline_status *ptr)
+    def xorif_get_timeline_status(self):
+        self.logger.info('xorif_get_timeline_status:')
+        data_ptr = ffi.new("struct xorif_timeline_status *")
+        result = lib.xorif_get_timeline_status(data_ptr)
+        return (result, cdata_to_py(data_ptr[0]))
+
+    # int xorif_start_scrubber(uint32_t budget, uint16_t mode)
+    def xorif_start_scrubber(self, budget=0, mode=0):
+        self.logger.info(f'xorif_start_scrubber: {budget}, {mode}')
+        return lib.xorif_start_scrubber(budget, mode)
+
+    # int xorif_stop_scrubber(void)
+    def xorif_stop_scrubber(self):
+        self.logger.info('xorif_stop_scrubber:')
+        return lib.xorif_stop_scrubber()
+
+    # int xorif_scrub_registers(uint16_t mode, uint32_t *mismatches)
+    def xorif_scrub_registers(self, mode=0):
+        self.logger.info(f'xorif_scrub_registers: {mode}')
+        mismatches_ptr = ffi.new("uint32_t *")
+        result = lib.xorif_scrub_registers(mode, mismatches_ptr)
+        return (result, mismatches_ptr[0])
+
+    # int xorif_get_scrubber_status(struct xorif_scrubber_status *ptr)
+    def xorif_get_scrubber_status(self):
+        self.logger.info('xorif_get_scrubber_status:')
+        data_ptr = ffi.new("struct xorif_scrubber_status *")
+        result = lib.xorif_get_scrubber_status(data_ptr)
+        return (result, cdata_to_py(data_ptr[0]))
+
+    # int xorif_get_scrubber_log(uint16_t max, struct xorif_scrub_mismatch *list, uint16_t *num)
+    def xorif_get_scrubber_log(self, max=32):
+        self.logger.info(f'xorif_get_scrubber_log: {max}')
+        list_ptr = ffi.new("struct xorif_scrub_mismatch[]", max)
+        num_ptr = ffi.new("uint16_t *")
+        result = lib.xorif_get_scrubber_log(max, list_ptr, num_ptr)
+        return (result, [cdata_to_py(list_ptr[i]) for i in range(num_ptr[0])])
+
+    # int xorif_clear_scrubber_stats(void)
+    def xorif_clear_scrubber_stats(self):
+        self.logger.info('xorif_clear_scrubber_stats:')
+        return lib.xorif_clear_scrubber_stats()
+
+    # int xorif_get_latency_budget(uint16_t cc, const struct xorif_transport_delay *transport, struct xorif_latency_budget *ptr)
+    def xorif_get_latency_budget(self, cc, transport):
+        self.logger.info(f'xorif_get_latency_budget: {cc}, {transport}')
+        transport_ptr = ffi.new("const struct xorif_transport_delay *", transport)
+        budget_ptr = ffi.new("struct xorif_latency_budget *")
+        result = lib.xorif_get_latency_budget(cc, transport_ptr, budget_ptr)
+        return (result, cdata_to_py(budget_ptr[0]))
+
+    # int xorif_get_cc_bandwidth(uint16_t cc, const struct xorif_bandwidth_params *params, struct xorif_cc_bandwidth *ptr)
+    def xorif_get_cc_bandwidth(self, cc, params):
+        self.logger.info(f'xorif_get_cc_bandwidth: {cc}, {params}')
+        params_ptr = ffi.new("const struct xorif_bandwidth_params *", params)
+        bw_ptr = ffi.new("struct xorif_cc_bandwidth *")
+        result = lib.xorif_get_cc_bandwidth(cc, params_ptr, bw_ptr)
+        return (result, cdata_to_py(bw_ptr[0]))
+
+    # int xorif_get_port_bandwidth(uint16_t port, const struct xorif_bandwidth_params *params, struct xorif_port_bandwidth *ptr)
+    def xorif_get_port_bandwidth(self, port, params):
+        self.logger.info(f'xorif_get_port_bandwidth: {port}, {params}')
+        params_ptr = ffi.new("const struct xorif_bandwidth_params *", params)
+        bw_ptr = ffi.new("struct xorif_port_bandwidth *")
+        result = lib.xorif_get_port_bandwidth(port, params_ptr, bw_ptr)
+        return (result, cdata_to_py(bw_ptr[0]))
+
+    # int xorif_advise_iq_compression(uint16_t cc, enum xorif_chan_type chan, const struct xorif_comp_advice_params *params, struct xorif_comp_advice *ptr)
+    def xorif_advise_iq_compression(self, cc, chan, params):
+        self.logger.info(f'xorif_advise_iq_compression: {cc}, {chan}, {params}')
+        params_ptr = ffi.new("const struct xorif_comp_advice_params *", params)
+        advice_ptr = ffi.new("struct xorif_comp_advice *")
+        result = lib.xorif_advise_iq_compression(cc, chan, params_ptr, advice_ptr)
+        advice = cdata_to_py(advice_ptr[0])
+        advice['candidates'] = advice['candidates'][:advice['num_candidates']]
+        return (result, advice)
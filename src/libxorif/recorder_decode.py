@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+#
+# Copyright 2020 - 2023 Advanced Micro Devices, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Offline decoder for libxorif flight recorder dump files
+# (see xorif_set_recorder_trigger() / xorif_dump_recorder()).
+# It doesn't need the library, so dumps can be decoded on any machine.
+
+__author__ = "Steven Dickinson"
+__copyright__ = "Copyright 2022, Advanced Micro Devices, Inc."
+
+import sys
+import struct
+import argparse
+from datetime import datetime, timezone
+from collections import namedtuple
+
+# Dump file format (struct xorif_recorder_header / struct xorif_recorder_record)
+RECORDER_MAGIC = 0x43455258
+RECORDER_VERSION = 1
+HEADER_FORMAT = "=IHHIIIIQQIII12x"
+RECORD_FORMAT = "=QIHH8I48s"
+
+Header = namedtuple("Header", "magic version record_size num_records trigger trigger_seq lost "
+                              "mono_time real_time sw_version hw_version hw_internal_rev")
+Record = namedtuple("Record", "timestamp seq type arg data name")
+
+RECORD_TYPES = {1: "API", 2: "ERROR", 3: "WRITE", 4: "ALARM", 5: "STATS", 6: "STALL", 7: "TRIGGER"}
+
+TRIGGERS = {0x1: "ALARM", 0x2: "STALL", 0x4: "ERROR", 0x8: "MANUAL"}
+
+ALARMS = {
+    0x1: "FRAMER_RESET_STATUS",
+    0x2: "DEFRAMER_RESET_STATUS",
+    0x100: "DEFRAMER_IN_FIFO_OF",
+    0x200: "DEFRAMER_IN_FIFO_UF",
+    0x400: "DEFRAMER_ETH_CIRC_BUFF_OF",
+    0x800: "DEFRAMER_ETH_CIRC_BUFF_PTR_OF",
+    0x1000: "FRAMER_OUT_FIFO_OF",
+    0x2000: "FRAMER_OUT_FIFO_UF",
+    0x4000: "FRAMER_PRACH_SECTION_OF",
+    0x8000: "FRAMER_PRACH_SECTION_NF",
+    0x10000: "FRAMER_SECTION_OF",
+    0x80000000: "AXI_TIMEOUT",
+}
+
+ACTIONS = ["IGNORE", "COUNT", "LOG", "DISABLE_CC", "RESTART_DEFRAMER", "RESET"]
+
+STATS_FIELDS = ["rx_good", "rx_bad", "rx_bad_fcs", "rx_early", "rx_late", "rx_corrupt", "rx_error_drop", "tx_total"]
+
+
+def decode(file):
+    """Read a dump file, returning the header and the list of records (oldest first)."""
+    with open(file, "rb") as f:
+        data = f.read()
+    header_size = struct.calcsize(HEADER_FORMAT)
+    if len(data) < header_size:
+        raise ValueError(f"'{file}' is too short for a flight recorder dump")
+    header = Header(*struct.unpack_from(HEADER_FORMAT, data))
+    if header.magic != RECORDER_MAGIC:
+        raise ValueError(f"'{file}' is not a flight recorder dump (magic 0x{header.magic:08X})")
+    if header.version != RECORDER_VERSION:
+        raise ValueError(f"'{file}' has an unsupported version ({header.version})")
+    if header.record_size != struct.calcsize(RECORD_FORMAT):
+        raise ValueError(f"'{file}' has an unsupported record size ({header.record_size})")
+
+    records = []
+    for i in range(header.num_records):
+        values = struct.unpack_from(RECORD_FORMAT, data, header_size + i * header.record_size)
+        name = values[12].split(b"\0", 1)[0].decode(errors="replace")
+        records.append(Record(values[0], values[1], values[2], values[3], values[4:12], name))
+    return header, records
+
+
+def alarm_names(status):
+    """Convert alarm status bits to names."""
+    names = [n for m, n in ALARMS.items() if status & m]
+    return "|".join(names) if names else "-"
+
+
+def describe(record):
+    """Describe a record (type-specific details)."""
+    d = record.data
+    if record.type in (1, 2):
+        return record.name
+    elif record.type == 3:
+        width = bin(d[1]).count("1")
+        return f"{record.name} (0x{d[0]:04X})[{d[2] + width - 1}:{d[2]}] <= 0x{d[3]:X} ({d[3]})"
+    elif record.type == 4:
+        action = ACTIONS[d[2]] if d[2] < len(ACTIONS) else str(d[2])
+        return f"status = 0x{d[0]:X} ({alarm_names(d[0])}), handled = 0x{d[1]:X}, action = {action}, cc_mask = 0x{d[3]:X}"
+    elif record.type == 5:
+        return f"port {record.arg}: " + ", ".join(f"{n} = {v}" for n, v in zip(STATS_FIELDS, d))
+    elif record.type == 6:
+        return f"flags = 0x{d[1] << 32 | d[0]:X}, onsets = 0x{d[3] << 32 | d[2]:X}"
+    elif record.type == 7:
+        trigger = TRIGGERS.get(record.arg, str(record.arg))
+        if record.arg == 0x1:
+            return f"{trigger} (0x{d[0]:X} {alarm_names(d[0])})"
+        elif record.arg == 0x2:
+            return f"{trigger} (spatial stream bit {d[0]})"
+        elif record.name:
+            return f"{trigger} ({record.name})"
+        return trigger
+    return ""
+
+
+def print_dump(header, records, out=sys.stdout):
+    """Print the header and records (times relative to the trigger, or to the dump)."""
+    real = datetime.fromtimestamp(header.real_time / 1e9, tz=timezone.utc)
+    trigger = TRIGGERS.get(header.trigger, "none")
+    print(f"Flight recorder dump: {real.isoformat()} UTC", file=out)
+    print(f"SW version = 0x{header.sw_version:08X}, HW version = 0x{header.hw_version:08X}, "
+          f"HW internal revision = {header.hw_internal_rev}", file=out)
+    print(f"Records = {header.num_records}, lost = {header.lost}, trigger = {trigger} (seq {header.trigger_seq})", file=out)
+
+    origin = header.mono_time
+    for r in records:
+        if r.seq == header.trigger_seq:
+            origin = r.timestamp
+            break
+
+    for r in records:
+        marker = "*" if r.seq == header.trigger_seq else " "
+        t = (r.timestamp - origin) / 1e6
+        print(f"{marker}{r.seq:10d} {t:+14.3f} ms {RECORD_TYPES.get(r.type, str(r.type)):7s} {describe(r)}", file=out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode a libxorif flight recorder dump file")
+    parser.add_argument("file", help="dump file")
+    parser.add_argument("-t", "--type", action="append", choices=list(RECORD_TYPES.values()),
+                        help="only show records of this type (can be repeated)")
+    args = parser.parse_args()
+
+    header, records = decode(args.file)
+    if args.type:
+        types = [k for k, v in RECORD_TYPES.items() if v in args.type]
+        records = [r for r in records if r.type in types or r.seq == header.trigger_seq]
+    print_dump(header, records)
+
+
+if __name__ == "__main__":
+    main()
@@ -2,6 +2,7 @@
 
 import sys
 import logging
+import json
 from collections import namedtuple
 from cffi import FFI
 import pytest
@@ -16,6 +17,11 @@ const = namedtuple("xocp_const", lib.constants.keys())(*lib.constants.values())
 # Open C library directly (to access hidden functions)
 ffi = FFI()
 ffi.cdef("int xocp_test_error_injections(uint16_t instance, uint32_t status);")
+ffi.cdef("int xorif_test_error_injections(uint32_t status);")
+ffi.cdef("void xorif_clear_fhi_alarms(void);")
+ffi.cdef("int xorif_start_timeline(uint32_t max_events);")
+ffi.cdef("int xorif_stop_timeline(void);")
+ffi.cdef("int xorif_write_timeline(const char *file);")
 c_lib = ffi.dlopen("libxorif.so.1")
 
 def go_to_operational():
@@ -492,3 +498,60 @@ def test_inject_errors_callback():
     assert result == const.XOCP_SUCCESS
     assert status == bits
     assert test_status == bits
+
+@pytest.mark.skipif("EXTRA_DEBUG" not in lib.constants, reason="No test code to inject errors")
+def test_inject_errors_shared_irq():
+    """The FHI and OCP share the interrupt, check only the pending source is handled."""
+    instance = go_to_operational()
+    global test_status
+
+    assert lib.xocp_register_event_callback(instance, callback) == const.XOCP_SUCCESS
+    assert lib.xocp_clear_event_status(instance) == const.XOCP_SUCCESS
+
+    # FHI alarm only (FRAMER_OUT_FIFO_OF), the OCP handler isn't run
+    test_status = 0
+    assert c_lib.xorif_test_error_injections(0x1000) == METAL_IRQ_HANDLED
+    assert test_status == 0
+    result, status = lib.xocp_get_event_status(instance)
+    assert result == const.XOCP_SUCCESS
+    assert status == 0
+    c_lib.xorif_clear_fhi_alarms()
+
+    # OCP event only
+    bits = const.XOCP_UL_CC_UPDATE_TRIGGERED
+    assert c_lib.xocp_test_error_injections(instance, bits) == METAL_IRQ_HANDLED
+    assert test_status == bits
+
+    # Clear errors
+    lib.xocp_clear_event_status(instance)
+
+def test_xocp_timeline(tmp_path):
+    """The OCP operations are captured by the ORIF timeline."""
+    assert c_lib.xorif_start_timeline(0) == 0
+    try:
+        instance = go_to_operational()
+        result, cc_cfg = lib.xocp_get_cc_cfg(instance, 0)
+        cc_cfg["num_rbs"] = 100
+        assert lib.xocp_set_cc_cfg(instance, 0, cc_cfg) == const.XOCP_SUCCESS
+        sequence = [0, 0]
+        assert lib.xocp_set_schedule(instance, 3, len(sequence), sequence) == const.XOCP_SUCCESS
+    finally:
+        c_lib.xorif_stop_timeline()
+
+    path = str(tmp_path / "timeline.json")
+    assert c_lib.xorif_write_timeline(bytes(path, "ascii")) == 0
+    with open(path) as f:
+        spans = [e for e in json.load(f)["traceEvents"] if e["ph"] == "X"]
+    names = [e["name"] for e in spans]
+    assert "xocp_start" in names
+    assert "xocp_set_cc_cfg" in names
+    schedule = spans[names.index("xocp_set_schedule")]
+    dl = spans[names.index("program_schedule_dl")]
+    ul = spans[names.index("program_schedule_ul")]
+    assert schedule["cat"] == "ocp"
+    assert schedule["args"]["length"] == 2
+
+    # 2 entries per symbol, 3 words per entry
+    assert dl["args"]["reg_writes"] == ul["args"]["reg_writes"] == 12
+    assert schedule["args"]["reg_writes"] == 24
+    assert schedule["ts"] <= dl["ts"] < ul["ts"] <= schedule["ts"] + schedule["dur"]
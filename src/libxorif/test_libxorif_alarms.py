@@ -1,6 +1,9 @@
 #!/usr/bin/env python3
 
 import sys
+import os
+import select
+import time
 import logging
 from collections import namedtuple
 from cffi import FFI
@@ -8,6 +11,7 @@ import pytest
 
 sys.path.append('/usr/share/xorif')
 import pylibxorif
+import recorder_decode
 
 lib = pylibxorif.LIBXORIF()
 lib.set_log_level(logging.DEBUG)
@@ -95,3 +99,320 @@ def test_inject_errors_callback():
     assert c_lib.xorif_test_error_injections(bits) == METAL_IRQ_HANDLED
     assert lib.xorif_get_fhi_alarms() == bits
     assert test_status == bits
+
+@pytest.mark.skipif("EXTRA_DEBUG" not in lib.constants, reason="No test code to inject errors")
+def test_alarm_counts():
+    assert lib.xorif_get_state() == 1
+
+    lib.xorif_clear_fhi_alarm_counts()
+    result, counts = lib.xorif_get_fhi_alarm_counts()
+    assert result == const.XORIF_SUCCESS
+    assert counts['interrupts'] == 0
+    assert counts['count'] == [0] * 32
+
+    # Counted without the queue, and not affected by clearing the alarms
+    for n in range(3):
+        assert c_lib.xorif_test_error_injections(const.FRAMER_OUT_FIFO_OF) == METAL_IRQ_HANDLED
+    assert c_lib.xorif_test_error_injections(const.FRAMER_OUT_FIFO_OF | const.DEFRAMER_IN_FIFO_UF) == METAL_IRQ_HANDLED
+    lib.xorif_clear_fhi_alarms()
+    result, counts = lib.xorif_get_fhi_alarm_counts()
+    assert counts['interrupts'] == 4
+    assert counts['count'][const.FRAMER_OUT_FIFO_OF.bit_length() - 1] == 4
+    assert counts['count'][const.DEFRAMER_IN_FIFO_UF.bit_length() - 1] == 1
+    assert sum(counts['count']) == 5
+    assert counts['last'][const.FRAMER_OUT_FIFO_OF.bit_length() - 1] > 0
+    assert counts['last'][const.DEFRAMER_IN_FIFO_OF.bit_length() - 1] == 0
+
+    lib.xorif_clear_fhi_alarm_counts()
+    assert lib.xorif_get_fhi_alarm_counts()[1]['interrupts'] == 0
+
+@pytest.mark.skipif("EXTRA_DEBUG" not in lib.constants, reason="No test code to inject errors")
+def test_alarm_queue():
+    assert lib.xorif_get_state() == 1
+
+    assert lib.xorif_read_alarm_events()[0] == const.XORIF_NOT_SUPPORTED
+    result, fd = lib.xorif_open_alarm_queue()
+    assert result == const.XORIF_SUCCESS
+    assert fd >= 0
+    assert lib.xorif_open_alarm_queue() == (const.XORIF_SUCCESS, fd)
+    try:
+        # Nothing to read
+        assert select.select([fd], [], [], 0)[0] == []
+        result, events, dropped = lib.xorif_read_alarm_events()
+        assert (result, events, dropped) == (const.XORIF_SUCCESS, [], 0)
+
+        # Events are queued in order, with timestamps, and the descriptor becomes readable
+        for n in interrupts:
+            assert c_lib.xorif_test_error_injections(n) == METAL_IRQ_HANDLED
+        assert select.select([fd], [], [], 0)[0] == [fd]
+        result, events, dropped = lib.xorif_read_alarm_events(4)
+        assert len(events) == 4
+        assert [e['status'] for e in events] == interrupts[0:4]
+        assert all(a['timestamp'] <= b['timestamp'] for a, b in zip(events, events[1:]))
+        assert all(b['seq'] == a['seq'] + 1 for a, b in zip(events, events[1:]))
+
+        # Still readable, since events remain
+        assert select.select([fd], [], [], 0)[0] == [fd]
+        result, events, dropped = lib.xorif_read_alarm_events()
+        assert [e['status'] for e in events] == interrupts[4:]
+        assert dropped == 0
+        assert select.select([fd], [], [], 0)[0] == []
+
+        # Overflow (256 events held)
+        for n in range(300):
+            assert c_lib.xorif_test_error_injections(const.FRAMER_SECTION_OF) == METAL_IRQ_HANDLED
+        result, events, dropped = lib.xorif_read_alarm_events(1000)
+        assert len(events) == 256
+        assert dropped == 44
+        assert events[-1]['seq'] - events[0]['seq'] == 255
+    finally:
+        assert lib.xorif_close_alarm_queue() == const.XORIF_SUCCESS
+
+    # Closed
+    assert lib.xorif_read_alarm_events()[0] == const.XORIF_NOT_SUPPORTED
+    assert c_lib.xorif_test_error_injections(const.FRAMER_SECTION_OF) == METAL_IRQ_HANDLED
+    lib.xorif_clear_fhi_alarms()
+
+def test_alarm_policy_api():
+    assert lib.xorif_get_state() == 1
+
+    # Default policy is a full reset
+    for n in interrupts:
+        assert lib.xorif_get_fhi_alarm_policy(n) == (const.XORIF_SUCCESS, const.ALARM_ACTION_RESET, 0)
+    assert lib.xorif_get_fhi_alarm_policy(0)[0] == const.XORIF_INVALID_CONFIG
+    assert lib.xorif_get_fhi_alarm_policy(const.AXI_TIMEOUT)[0] == const.XORIF_INVALID_CONFIG
+    assert lib.xorif_get_fhi_alarm_policy(interrupts[0] | interrupts[1])[0] == const.XORIF_INVALID_CONFIG
+    assert lib.xorif_set_fhi_alarm_policy(0, const.ALARM_ACTION_LOG) == const.XORIF_INVALID_CONFIG
+    assert lib.xorif_set_fhi_alarm_policy(const.AXI_TIMEOUT, const.ALARM_ACTION_LOG) == const.XORIF_INVALID_CONFIG
+    assert lib.xorif_set_fhi_alarm_policy(interrupts[0], 99) == const.XORIF_INVALID_CONFIG
+
+    bits = const.FRAMER_OUT_FIFO_OF | const.FRAMER_OUT_FIFO_UF
+    assert lib.xorif_set_fhi_alarm_policy(bits, const.ALARM_ACTION_DISABLE_CC, 0x5) == const.XORIF_SUCCESS
+    assert lib.xorif_get_fhi_alarm_policy(const.FRAMER_OUT_FIFO_UF) == (const.XORIF_SUCCESS, const.ALARM_ACTION_DISABLE_CC, 0x5)
+    assert lib.xorif_set_fhi_alarm_policy(bits, const.ALARM_ACTION_RESET) == const.XORIF_SUCCESS
+
+@pytest.mark.skipif("EXTRA_DEBUG" not in lib.constants, reason="No test code to inject errors")
+def test_alarm_policy_actions():
+    """Inject alarms against the fake register bank, for each policy action."""
+    assert lib.xorif_get_state() == 1
+    alarm = const.DEFRAMER_IN_FIFO_OF
+    other = const.FRAMER_PRACH_SECTION_NF
+    mask = lib.xorif_get_enabled_cc_mask()
+    assert mask & 0xC0 == 0
+
+    def inject(status, action, cc_mask=0):
+        lib.xorif_clear_fhi_alarms()
+        lib.xorif_clear_fhi_alarm_counts()
+        assert lib.xorif_set_fhi_alarm_policy(alarm, action, cc_mask) == const.XORIF_SUCCESS
+        assert c_lib.xorif_test_error_injections(status) == METAL_IRQ_HANDLED
+        result, counts = lib.xorif_get_fhi_alarm_counts()
+        return (lib.xorif_get_fhi_alarms(), counts)
+
+    result, fd = lib.xorif_open_alarm_queue()
+    try:
+        # Ignore: cleared, but not recorded
+        alarms, counts = inject(alarm, const.ALARM_ACTION_IGNORE)
+        assert alarms == 0
+        assert counts['interrupts'] == 0
+        assert counts['resets'] == 0
+        assert lib.xorif_read_alarm_events()[1] == []
+
+        # Count only
+        alarms, counts = inject(alarm, const.ALARM_ACTION_COUNT)
+        assert alarms == alarm
+        assert counts['count'][alarm.bit_length() - 1] == 1
+        assert counts['resets'] + counts['deframer_restarts'] + counts['cc_disables'] == 0
+        assert [e['status'] for e in lib.xorif_read_alarm_events()[1]] == [alarm]
+
+        # Rate-limited log
+        alarms, counts = inject(alarm, const.ALARM_ACTION_LOG)
+        for n in range(4):
+            assert c_lib.xorif_test_error_injections(alarm) == METAL_IRQ_HANDLED
+        counts = lib.xorif_get_fhi_alarm_counts()[1]
+        assert counts['count'][alarm.bit_length() - 1] == 5
+        assert counts['suppressed'] >= 4
+        assert counts['resets'] == 0
+
+        # Per-carrier disable (with a carrier that's not in the policy left enabled)
+        assert lib.xorif_enable_cc(6) == const.XORIF_SUCCESS
+        assert lib.xorif_enable_cc(7) == const.XORIF_SUCCESS
+        alarms, counts = inject(alarm, const.ALARM_ACTION_DISABLE_CC, 0x80)
+        assert counts['cc_disables'] == 1
+        assert counts['resets'] == 0
+        assert lib.xorif_get_enabled_cc_mask() == mask | 0x40
+        assert lib.xorif_disable_cc(6) == const.XORIF_SUCCESS
+
+        # De-framer restart (the statistics see the counter restart at the next read)
+        handle = lib.xorif_open_stats_consumer()[1]
+        alarms, counts = inject(alarm, const.ALARM_ACTION_RESTART_DEFRAMER)
+        assert counts['deframer_restarts'] == 1
+        assert counts['resets'] == 0
+        assert lib.xorif_read_stats_consumer(handle, 0)[1]['resets'] == 1
+        assert lib.xorif_close_stats_consumer(handle) == const.XORIF_SUCCESS
+
+        # Most severe action wins (the other alarm has the default policy)
+        alarms, counts = inject(alarm | other, const.ALARM_ACTION_COUNT)
+        assert alarms == alarm | other
+        assert counts['resets'] == 1
+        assert counts['deframer_restarts'] == 0
+
+        # Other alarm ignored, so only the first is recorded
+        assert lib.xorif_set_fhi_alarm_policy(other, const.ALARM_ACTION_IGNORE) == const.XORIF_SUCCESS
+        lib.xorif_read_alarm_events()
+        alarms, counts = inject(alarm | other, const.ALARM_ACTION_RESTART_DEFRAMER)
+        assert alarms == alarm
+        assert counts['deframer_restarts'] == 1
+        assert [e['status'] for e in lib.xorif_read_alarm_events()[1]] == [alarm]
+    finally:
+        lib.xorif_close_alarm_queue()
+        lib.xorif_set_fhi_alarm_policy(alarm | other, const.ALARM_ACTION_RESET)
+        lib.xorif_clear_fhi_alarms()
+        lib.xorif_clear_fhi_alarm_counts()
+
+@pytest.mark.skipif("EXTRA_DEBUG" not in lib.constants, reason="No test code to inject errors")
+def test_alarm_storm():
+    """Inject an alarm storm, and check it's masked, coalesced and re-enabled."""
+    assert lib.xorif_get_state() == 1
+    alarm = const.FRAMER_OUT_FIFO_OF
+    bit = alarm.bit_length() - 1
+    all_alarms = sum(interrupts)
+
+    assert lib.xorif_set_fhi_alarm_storm(5, 0, 100) == const.XORIF_INVALID_CONFIG
+    assert lib.xorif_set_fhi_alarm_storm(5, 1000, 0) == const.XORIF_INVALID_CONFIG
+    assert lib.xorif_set_fhi_alarm_storm(5, 1000, 100) == const.XORIF_SUCCESS
+    assert lib.xorif_set_fhi_alarm_policy(alarm, const.ALARM_ACTION_COUNT) == const.XORIF_SUCCESS
+    assert lib.xorif_enable_fhi_interrupts(all_alarms) == const.XORIF_SUCCESS
+    lib.xorif_clear_fhi_alarm_counts()
+    result, fd = lib.xorif_open_alarm_queue()
+    try:
+        # 5th occurrence starts the storm, the rest are coalesced
+        for n in range(20):
+            assert c_lib.xorif_test_error_injections(alarm) == METAL_IRQ_HANDLED
+        result, stats = lib.xorif_get_fhi_alarm_storm_stats()
+        assert result == const.XORIF_SUCCESS
+        assert stats['masked'] == alarm
+        assert stats['storms'][bit] == 1
+        assert stats['coalesced'][bit] == 15
+        assert stats['backoff_ms'][bit] == 100
+        assert lib.xorif_read_fhi_reg("CFG_FRAM_INT_ENA_OUTFIFO_OF") == (0, 0)
+        assert lib.xorif_read_fhi_reg("CFG_FRAM_INT_ENA_OUTFIFO_UF") == (0, 1)
+        assert lib.xorif_get_fhi_alarm_counts()[1]['count'][bit] == 20
+        result, events, dropped = lib.xorif_read_alarm_events()
+        assert len(events) == 5
+
+        # Re-enabling the interrupts keeps the alarm masked
+        assert lib.xorif_enable_fhi_interrupts(all_alarms) == const.XORIF_SUCCESS
+        assert lib.xorif_read_fhi_reg("CFG_FRAM_INT_ENA_OUTFIFO_OF") == (0, 0)
+
+        # Re-enabled after the back-off, and the next event carries the coalesced count
+        time.sleep(0.2)
+        result, stats = lib.xorif_get_fhi_alarm_storm_stats()
+        assert stats['masked'] == 0
+        assert stats['masked_time'][bit] >= 100000000
+        assert lib.xorif_read_fhi_reg("CFG_FRAM_INT_ENA_OUTFIFO_OF") == (0, 1)
+        assert c_lib.xorif_test_error_injections(alarm) == METAL_IRQ_HANDLED
+        result, events, dropped = lib.xorif_read_alarm_events()
+        assert len(events) == 1
+        assert events[0]['coalesced'] == 15
+
+        # Storms again soon after, so the back-off is doubled
+        for n in range(5):
+            assert c_lib.xorif_test_error_injections(alarm) == METAL_IRQ_HANDLED
+        result, stats = lib.xorif_get_fhi_alarm_storm_stats()
+        assert stats['masked'] == alarm
+        assert stats['storms'][bit] == 2
+        assert stats['backoff_ms'][bit] == 200
+
+        # Disabling storm detection re-enables the alarm
+        assert lib.xorif_set_fhi_alarm_storm(0, 0, 0) == const.XORIF_SUCCESS
+        assert lib.xorif_get_fhi_alarm_storm_stats()[1]['masked'] == 0
+        assert lib.xorif_read_fhi_reg("CFG_FRAM_INT_ENA_OUTFIFO_OF") == (0, 1)
+        for n in range(20):
+            assert c_lib.xorif_test_error_injections(alarm) == METAL_IRQ_HANDLED
+        assert lib.xorif_get_fhi_alarm_storm_stats()[1]['storms'][bit] == 2
+    finally:
+        lib.xorif_close_alarm_queue()
+        lib.xorif_set_fhi_alarm_storm(1000, 1000, 1000)
+        lib.xorif_set_fhi_alarm_policy(alarm, const.ALARM_ACTION_RESET)
+        lib.xorif_enable_fhi_interrupts(0)
+        lib.xorif_clear_fhi_alarms()
+        lib.xorif_clear_fhi_alarm_counts()
+
+@pytest.mark.skipif("EXTRA_DEBUG" not in lib.constants, reason="No test code to inject errors")
+def test_irq_stats():
+    """Benchmark the interrupt handler latency, and check the pending sources are counted."""
+    assert lib.xorif_get_state() == 1
+    alarm = const.FRAMER_OUT_FIFO_UF
+    assert lib.xorif_set_fhi_alarm_policy(alarm, const.ALARM_ACTION_COUNT) == const.XORIF_SUCCESS
+    lib.xorif_clear_irq_stats()
+    result, stats = lib.xorif_get_irq_stats()
+    assert result == const.XORIF_SUCCESS
+    assert stats['interrupts'] == 0
+    assert stats['min_ns'] == 0
+
+    try:
+        for n in range(100):
+            assert c_lib.xorif_test_error_injections(alarm) == METAL_IRQ_HANDLED
+        assert c_lib.xorif_test_error_injections(0) == METAL_IRQ_HANDLED
+
+        result, stats = lib.xorif_get_irq_stats()
+        assert result == const.XORIF_SUCCESS
+        assert stats['interrupts'] == 101
+        assert stats['fhi'] == 100
+        assert stats['ocp'] == 0
+        assert stats['spurious'] == 1
+        assert 0 < stats['min_ns'] <= stats['last_ns'] <= stats['max_ns']
+        assert stats['min_ns'] * 101 <= stats['total_ns'] <= stats['max_ns'] * 101
+        assert sum(stats['histogram']) == 101
+        print(f"IRQ latency: mean = {stats['total_ns'] // 101} ns, min = {stats['min_ns']} ns, max = {stats['max_ns']} ns")
+
+        lib.xorif_clear_irq_stats()
+        result, stats = lib.xorif_get_irq_stats()
+        assert stats['interrupts'] == 0
+        assert sum(stats['histogram']) == 0
+    finally:
+        lib.xorif_set_fhi_alarm_policy(alarm, const.ALARM_ACTION_RESET)
+        lib.xorif_clear_fhi_alarms()
+        lib.xorif_clear_fhi_alarm_counts()
+
+@pytest.mark.skipif("EXTRA_DEBUG" not in lib.constants, reason="No test code to inject errors")
+def test_recorder_alarm_trigger(tmp_path):
+    assert lib.xorif_get_state() == 1
+
+    path = str(tmp_path / "recorder_alarm.bin")
+    try:
+        lib.xorif_clear_fhi_alarms()
+        assert lib.xorif_set_fhi_alarm_policy(const.FRAMER_OUT_FIFO_OF | const.FRAMER_OUT_FIFO_UF, const.ALARM_ACTION_COUNT) == const.XORIF_SUCCESS
+        dumps = lib.xorif_get_recorder_status()[1]['dumps']
+        assert lib.xorif_set_recorder_trigger(const.RECORDER_TRIGGER_ALARM, const.FRAMER_OUT_FIFO_UF, 2, path) == const.XORIF_SUCCESS
+
+        # Alarms not in the mask are recorded, but don't fire the trigger
+        assert c_lib.xorif_test_error_injections(const.FRAMER_OUT_FIFO_OF) == METAL_IRQ_HANDLED
+        assert lib.xorif_get_recorder_status()[1]['trigger'] == 0
+
+        assert c_lib.xorif_test_error_injections(const.FRAMER_OUT_FIFO_UF) == METAL_IRQ_HANDLED
+        end = time.time() + 2.0
+        while (lib.xorif_get_recorder_status()[1]['dumps'] == dumps) and (time.time() < end):
+            time.sleep(0.01)
+        result, status = lib.xorif_get_recorder_status()
+        assert status['frozen'] == 1
+        assert status['trigger'] == const.RECORDER_TRIGGER_ALARM
+
+        header, records = recorder_decode.decode(path)
+        assert header.trigger == const.RECORDER_TRIGGER_ALARM
+        alarms = [r for r in records if r.type == const.RECORD_ALARM]
+        assert [a.data[0] for a in alarms[-2:]] == [const.FRAMER_OUT_FIFO_OF, const.FRAMER_OUT_FIFO_UF]
+        assert alarms[-1].data[2] == const.ALARM_ACTION_COUNT
+        trigger = [r for r in records if r.seq == header.trigger_seq][0]
+        assert trigger.type == const.RECORD_TRIGGER
+        assert trigger.data[0] == const.FRAMER_OUT_FIFO_UF
+        assert records[-1].seq == header.trigger_seq + 2
+
+        # The interrupt handler's register writes (master interrupt) follow the alarm
+        assert records[records.index(alarms[-1]) + 2].name == "CFG_MASTER_INT_ENABLE"
+        assert "FRAMER_OUT_FIFO_UF" in recorder_decode.describe(alarms[-1])
+    finally:
+        lib.xorif_set_recorder_trigger(0)
+        lib.xorif_rearm_recorder()
+        lib.xorif_set_fhi_alarm_policy(const.FRAMER_OUT_FIFO_OF | const.FRAMER_OUT_FIFO_UF, const.ALARM_ACTION_RESET)
+        lib.xorif_clear_fhi_alarms()
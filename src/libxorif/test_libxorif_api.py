@@ -4,9 +4,13 @@ import sys
 import logging
 from collections import namedtuple
 import pytest
+import time
+import math
+import json
 
 sys.path.append('/usr/share/xorif')
 import pylibxorif
+import recorder_decode
 
 lib = pylibxorif.LIBXORIF()
 lib.set_log_level(logging.DEBUG)
@@ -58,6 +62,10 @@ def test_init_api():
     lib.xorif_finish()
     assert lib.xorif_get_state() == 0
 
+    # The component carrier configuration is released, so the per-CC functions fail
+    assert lib.xorif_configure_cc(0) == const.XORIF_INVALID_CC
+    assert lib.xorif_set_cc_num_rbs(0, 100) == const.XORIF_INVALID_CC
+
     # Initialize with name
     assert lib.xorif_init("oran_radio_if") == const.XORIF_SUCCESS
     assert lib.xorif_get_state() == 1
@@ -94,7 +102,7 @@ def test_capabilities_api():
     # General capabilities...
 
     print(caps)
-    assert caps['max_cc'] >= 1 and caps['max_cc'] <= 8
+    assert caps['max_cc'] >= 1 and caps['max_cc'] <= 16
     assert caps['num_eth_ports'] >= 1 and caps['num_eth_ports'] <= 4
     assert caps['numerologies'] != 0
     assert caps['extended_cp'] == 0
@@ -558,6 +566,227 @@ def test_stats_api():
         assert result == const.XORIF_INVALID_ETH_PORT
 
 
+def test_stats_all_api():
+    """Test the API to get the stats/counters for all ports (single snapshot)."""
+    assert lib.xorif_get_state() == 1
+
+    num_ports = caps['num_eth_ports']
+    lib.xorif_clear_fhi_stats()
+    result, stats = lib.xorif_get_fhi_eth_stats_all(num_ports)
+    assert result == const.XORIF_SUCCESS
+    assert len(stats) == num_ports
+    assert lib.xorif_get_fhi_eth_stats_all(num_ports + 1)[0] == const.XORIF_INVALID_ETH_PORT
+
+
+@pytest.mark.skipif("EXTRA_DEBUG" not in lib.constants, reason="Needs the fake register bank")
+def test_stats_all_accumulation():
+    """Check the software accumulation of the counters (fake register bank)."""
+    assert lib.xorif_get_state() == 1
+
+    num_ports = caps['num_eth_ports']
+    lib.xorif_clear_fhi_stats()
+
+    def set_counter(port, value):
+        assert lib.xorif_write_fhi_reg_offset("STATS_ORAN_RX_TOTAL_L", port * 0x100, value & 0xFFFFFFFF) == 0
+        assert lib.xorif_write_fhi_reg_offset("STATS_ORAN_RX_TOTAL_H", port * 0x100, value >> 32) == 0
+
+    # Different counts per port, including a carry into the high word
+    for p in range(num_ports):
+        set_counter(p, 0xFFFFFFF0 + p)
+    result, stats = lib.xorif_get_fhi_eth_stats_all(num_ports)
+    assert [s['oran_rx_total'] for s in stats] == [0xFFFFFFF0 + p for p in range(num_ports)]
+    for p in range(num_ports):
+        set_counter(p, 0x100000010 + p)
+    result, stats = lib.xorif_get_fhi_eth_stats_all(num_ports)
+    assert [s['oran_rx_total'] for s in stats] == [0x100000010 + p for p in range(num_ports)]
+
+    # Hardware counter restarts (e.g. after a reset), the accumulated count keeps increasing
+    set_counter(0, 5)
+    result, stats = lib.xorif_get_fhi_eth_stats_all(num_ports)
+    assert stats[0]['oran_rx_total'] == 0x100000010 + 5
+    assert lib.xorif_get_fhi_eth_stats(0)[1]['oran_rx_total'] == 5
+
+    # Clear resets the accumulators
+    for p in range(num_ports):
+        set_counter(p, 0)
+    lib.xorif_clear_fhi_stats()
+    result, stats = lib.xorif_get_fhi_eth_stats_all(num_ports)
+    assert all(s['oran_rx_total'] == 0 for s in stats)
+
+
+def test_stats_collector_api():
+    """Test the API to start/stop the statistics collector."""
+    assert lib.xorif_get_state() == 1
+
+    assert lib.xorif_get_stats_sample(0)[0] == const.XORIF_NOT_SUPPORTED
+    assert lib.xorif_get_stats_window(0)[0] == const.XORIF_NOT_SUPPORTED
+    assert lib.xorif_start_stats_collector(0, 16) == const.XORIF_INVALID_CONFIG
+    assert lib.xorif_start_stats_collector(10, 1) == const.XORIF_INVALID_CONFIG
+    assert lib.xorif_start_stats_collector(10, 4097) == const.XORIF_INVALID_CONFIG
+    assert lib.xorif_start_stats_collector(10, 16, "/dev/null") == const.XORIF_INVALID_CONFIG
+
+    assert lib.xorif_start_stats_collector(10, 16) == const.XORIF_SUCCESS
+    result, stats, timestamp = lib.xorif_get_stats_sample(0)
+    assert result == const.XORIF_SUCCESS
+    assert timestamp > 0
+    assert lib.xorif_get_stats_sample(caps['num_eth_ports'])[0] == const.XORIF_INVALID_ETH_PORT
+    assert lib.xorif_get_stats_sample(-1)[0] == const.XORIF_INVALID_ETH_PORT
+    assert lib.xorif_get_stats_window(-1)[0] == const.XORIF_INVALID_ETH_PORT
+    assert lib.xorif_get_stats_sample(0, 16)[0] == const.XORIF_INVALID_CONFIG
+    result, window = lib.xorif_get_stats_window(0)
+    assert result == const.XORIF_SUCCESS
+    assert window['num_samples'] >= 1
+    assert lib.xorif_stop_stats_collector() == const.XORIF_SUCCESS
+    assert lib.xorif_stop_stats_collector() == const.XORIF_SUCCESS
+    assert lib.xorif_get_stats_sample(0)[0] == const.XORIF_NOT_SUPPORTED
+
+
+@pytest.mark.skipif("EXTRA_DEBUG" not in lib.constants, reason="Needs the fake register bank")
+def test_stats_collector_series():
+    """Check the collected time series, rates and min/max values (fake register bank)."""
+    assert lib.xorif_get_state() == 1
+
+    num_ports = caps['num_eth_ports']
+    lib.xorif_clear_fhi_stats()
+
+    def set_counter(port, value):
+        assert lib.xorif_write_fhi_reg_offset("STATS_ORAN_RX_TOTAL_L", port * 0x100, value & 0xFFFFFFFF) == 0
+        assert lib.xorif_write_fhi_reg_offset("STATS_ORAN_RX_TOTAL_H", port * 0x100, value >> 32) == 0
+
+    assert lib.xorif_start_stats_collector(5, 256) == const.XORIF_SUCCESS
+    try:
+        # Readers get the collected values (the raw counters are unchanged, so they match)
+        for p in range(num_ports):
+            set_counter(p, 1000 * (p + 1))
+        time.sleep(0.1)
+        for p in range(num_ports):
+            result, stats, timestamp = lib.xorif_get_stats_sample(p)
+            assert stats['oran_rx_total'] == 1000 * (p + 1)
+            assert lib.xorif_get_fhi_eth_stats(p)[1]['oran_rx_total'] == 1000 * (p + 1)
+        result, stats = lib.xorif_get_fhi_eth_stats_all(num_ports)
+        assert [s['oran_rx_total'] for s in stats] == [1000 * (p + 1) for p in range(num_ports)]
+
+        # Rate and min/max (counter changes once in the window)
+        set_counter(0, 3000)
+        time.sleep(0.1)
+        result, window = lib.xorif_get_stats_window(0, 150)
+        assert result == const.XORIF_SUCCESS
+        assert window['num_samples'] >= 2
+        assert window['end_time'] > window['start_time']
+        span = (window['end_time'] - window['start_time']) / 1e9
+        assert abs(window['rate']['oran_rx_total'] - 2000 / span) <= 1
+        assert window['min']['oran_rx_total'] == 0
+        assert window['max']['oran_rx_total'] >= window['rate']['oran_rx_total'] > 0
+        assert window['rate']['total_rx_good_pkt_cnt'] == 0
+
+        # Clear discards the samples
+        for p in range(num_ports):
+            set_counter(p, 0)
+        lib.xorif_clear_fhi_stats()
+        assert lib.xorif_get_stats_sample(0)[1]['oran_rx_total'] == 0
+
+        # Number of samples is bounded
+        assert lib.xorif_start_stats_collector(1, 4) == const.XORIF_SUCCESS
+        time.sleep(0.05)
+        assert lib.xorif_get_stats_window(0)[1]['num_samples'] == 4
+    finally:
+        assert lib.xorif_stop_stats_collector() == const.XORIF_SUCCESS
+
+
+def test_stats_consumer_api():
+    """Test the API to open/close/read statistics consumers."""
+    assert lib.xorif_get_state() == 1
+
+    result, handle = lib.xorif_open_stats_consumer()
+    assert result == const.XORIF_SUCCESS
+    result, delta = lib.xorif_read_stats_consumer(handle, 0)
+    assert result == const.XORIF_SUCCESS
+    assert delta['interval'] > 0
+    assert lib.xorif_read_stats_consumer(handle, caps['num_eth_ports'])[0] == const.XORIF_INVALID_ETH_PORT
+    assert lib.xorif_close_stats_consumer(handle) == const.XORIF_SUCCESS
+    assert lib.xorif_close_stats_consumer(handle) == const.XORIF_INVALID_CONFIG
+    assert lib.xorif_read_stats_consumer(handle, 0)[0] == const.XORIF_INVALID_CONFIG
+
+    # Limited number of handles
+    handles = []
+    while True:
+        result, handle = lib.xorif_open_stats_consumer()
+        if result != const.XORIF_SUCCESS:
+            break
+        handles.append(handle)
+    assert result == const.XORIF_MEMORY_ALLOCATION_FAIL
+    assert len(handles) == 16
+    for handle in handles:
+        assert lib.xorif_close_stats_consumer(handle) == const.XORIF_SUCCESS
+
+
+@pytest.mark.skipif("EXTRA_DEBUG" not in lib.constants, reason="Needs the fake register bank")
+def test_stats_consumer_deltas():
+    """Check consumer deltas, rates and reset epochs (fake register bank)."""
+    assert lib.xorif_get_state() == 1
+
+    def set_counter(port, value):
+        assert lib.xorif_write_fhi_reg_offset("STATS_ORAN_RX_TOTAL_L", port * 0x100, value & 0xFFFFFFFF) == 0
+        assert lib.xorif_write_fhi_reg_offset("STATS_ORAN_RX_TOTAL_H", port * 0x100, value >> 32) == 0
+
+    def read(handle, port=0):
+        result, delta = lib.xorif_read_stats_consumer(handle, port)
+        assert result == const.XORIF_SUCCESS
+        return delta
+
+    lib.xorif_clear_fhi_stats()
+    set_counter(0, 0)
+    a = lib.xorif_open_stats_consumer()[1]
+    b = lib.xorif_open_stats_consumer()[1]
+    try:
+        # Independent baselines
+        set_counter(0, 1000)
+        d = read(a)
+        assert d['delta']['oran_rx_total'] == 1000
+        assert d['resets'] == 0
+        set_counter(0, 1500)
+        assert read(a)['delta']['oran_rx_total'] == 500
+        assert read(b)['delta']['oran_rx_total'] == 1500
+        assert read(b)['delta']['oran_rx_total'] == 0
+
+        # Clear (hardware counters restart from 0)
+        epoch = d['epoch']
+        set_counter(0, 1600)
+        lib.xorif_clear_fhi_stats()
+        set_counter(0, 300)
+        d = read(a)
+        assert d['resets'] == 1
+        assert d['epoch'] == epoch + 1
+        assert d['delta']['oran_rx_total'] == 100 + 300
+        assert read(b)['delta']['oran_rx_total'] == 100 + 300
+
+        # Reset (data-pipe restart and clear), which restarts the (fake) counters
+        set_counter(0, 400)
+        assert lib.xorif_reset_fhi(0) == const.XORIF_SUCCESS
+        set_counter(0, 50)
+        d = read(a)
+        assert d['resets'] == 2
+        assert d['delta']['oran_rx_total'] == 100 + 50
+        assert read(a)['resets'] == 0
+
+        # Rates
+        time.sleep(0.1)
+        set_counter(0, 1050)
+        d = read(a)
+        assert abs(d['rate']['oran_rx_total'] - 1000 / (d['interval'] / 1e9)) <= 1
+
+        # Served from the statistics collector
+        assert lib.xorif_start_stats_collector(5, 8) == const.XORIF_SUCCESS
+        set_counter(0, 1250)
+        time.sleep(0.05)
+        assert read(a)['delta']['oran_rx_total'] == 200
+        assert lib.xorif_stop_stats_collector() == const.XORIF_SUCCESS
+    finally:
+        lib.xorif_close_stats_consumer(a)
+        lib.xorif_close_stats_consumer(b)
+        lib.xorif_stop_stats_collector()
+
+
 def test_set_mac_address_api():
     """Test the API to set MAC address."""
     assert lib.xorif_get_state() == 1
@@ -636,6 +865,57 @@ def test_ethernet_packet_filter_api():
     assert lib.xorif_set_fhi_packet_filter(0, filter, mask) == const.XORIF_SUCCESS
 
 
+def test_port_config_api():
+    """Test the API for independent per-port configuration and CC to port planning."""
+    assert lib.xorif_get_state() == 1
+
+    num_ports = caps['num_eth_ports']
+    assert lib.xorif_set_fhi_protocol(const.PROTOCOL_ECPRI, 1, const.IP_MODE_RAW) == const.XORIF_SUCCESS
+
+    # Each port has its own VLAN tag and filter (matching its VLAN ID)
+    for p in range(num_ports):
+        assert lib.xorif_set_fhi_vlan_tag(p, 100 + p, 0, p) == const.XORIF_SUCCESS
+        match = {'transport': const.PROTOCOL_ECPRI, 'ip_mode': const.IP_MODE_RAW, 'vlan': 1,
+                 'fields': const.PKT_MATCH_VLAN_ID | const.PKT_MATCH_VLAN_PCP, 'vlan_id': 100 + p, 'vlan_pcp': p}
+        assert lib.xorif_set_fhi_port_filter(p, match) == const.XORIF_SUCCESS
+
+    # Plan the CCs round-robin across the ports
+    for cc in range(caps['max_cc']):
+        assert lib.xorif_set_cc_planned_eth_port(cc, cc % num_ports) == const.XORIF_SUCCESS
+        assert lib.xorif_get_cc_planned_eth_port(cc) == (const.XORIF_SUCCESS, cc % num_ports)
+
+    for p in range(num_ports):
+        match = {'transport': const.PROTOCOL_ECPRI, 'ip_mode': const.IP_MODE_RAW, 'vlan': 1,
+                 'fields': const.PKT_MATCH_VLAN_ID | const.PKT_MATCH_VLAN_PCP, 'vlan_id': 100 + p, 'vlan_pcp': p}
+        _, filter, mask, _ = lib.xorif_compile_packet_filter(match)
+        result, config = lib.xorif_get_fhi_port_config(p)
+        assert result == const.XORIF_SUCCESS
+        assert config['transport'] == const.PROTOCOL_ECPRI
+        assert config['vlan'] == 1
+        assert config['ip_mode'] == const.IP_MODE_RAW
+        assert (config['vlan_id'], config['vlan_dei'], config['vlan_pcp']) == (100 + p, 0, p)
+        assert config['planned_cc_mask'] == sum(1 << cc for cc in range(caps['max_cc']) if cc % num_ports == p)
+        assert config['filter'] == filter
+        assert config['mask'] == mask
+
+    # Filter must agree with the common protocol settings
+    match = {'transport': const.PROTOCOL_IEEE_1914_3, 'ip_mode': const.IP_MODE_RAW, 'vlan': 1}
+    assert lib.xorif_set_fhi_port_filter(0, match) == const.XORIF_INVALID_CONFIG
+
+    # Invalid values
+    match = {'transport': const.PROTOCOL_ECPRI, 'ip_mode': const.IP_MODE_RAW, 'vlan': 1}
+    assert lib.xorif_set_fhi_port_filter(num_ports, match) == const.XORIF_INVALID_ETH_PORT
+    assert lib.xorif_set_cc_planned_eth_port(0, num_ports) == const.XORIF_INVALID_ETH_PORT
+    assert lib.xorif_set_cc_planned_eth_port(caps['max_cc'], 0) == const.XORIF_INVALID_CC
+    assert lib.xorif_get_cc_planned_eth_port(caps['max_cc'])[0] == const.XORIF_INVALID_CC
+    assert lib.xorif_get_fhi_port_config(num_ports)[0] == const.XORIF_INVALID_ETH_PORT
+
+    # Restore defaults
+    for cc in range(caps['max_cc']):
+        assert lib.xorif_set_cc_planned_eth_port(cc, 0) == const.XORIF_SUCCESS
+    assert lib.xorif_set_fhi_protocol(const.PROTOCOL_ECPRI, 0, const.IP_MODE_RAW) == const.XORIF_SUCCESS
+
+
 def test_eaxc_id_api():
     """Test the API to set the eaxc id."""
     assert lib.xorif_get_state() == 1
@@ -775,6 +1055,86 @@ def test_set_ru_ports_table_api():
     assert lib.xorif_clear_ru_ports_table() == const.XORIF_SUCCESS
 
 
+def test_set_ru_ports_table_bulk_api():
+    """Test the API to set RU port table mapping from a table, and verify"""
+    assert lib.xorif_get_state() == 1
+
+    width = caps['ru_ports_map_width']
+    size = 1 << width
+    table = [{'port': i % 32, 'type': 1, 'ccid': i % 16} for i in range(16)]
+
+    if width == 0:
+        assert lib.xorif_set_ru_ports_table_bulk(0, table) == const.XORIF_INVALID_RU_PORT_MAPPING
+        assert lib.xorif_verify_ru_ports_table()[0] == const.XORIF_INVALID_RU_PORT_MAPPING
+    else:
+        assert lib.xorif_clear_ru_ports_table() == const.XORIF_SUCCESS
+        assert lib.xorif_set_ru_ports_table_bulk(0, table) == const.XORIF_SUCCESS
+        assert lib.xorif_set_ru_ports_table_bulk(size - 16, table) == const.XORIF_SUCCESS
+        assert lib.xorif_set_ru_ports_table_bulk(size - 15, table) == const.XORIF_INVALID_RU_PORT_MAPPING
+        assert lib.xorif_set_ru_ports_table_bulk(0, []) == const.XORIF_SUCCESS
+        assert lib.xorif_verify_ru_ports_table() == (const.XORIF_SUCCESS, 0)
+        assert lib.xorif_clear_ru_ports_table() == const.XORIF_SUCCESS
+
+
+def test_eaxc_layout_api():
+    """Test the eAxC ID layout compiler"""
+    assert lib.xorif_get_state() == 1
+
+    # 1 DU, 1 BS, 4 CCs, 8 antennas, 4 PRACH, 2 SSB
+    spec = {'num_du': 1, 'num_bs': 1, 'num_cc': 4, 'num_user': 8, 'num_prach': 4, 'num_ssb': 2}
+    result, layout, table = lib.xorif_compile_eaxc_layout(spec)
+    assert result == const.XORIF_SUCCESS
+    assert layout['du_bits'] + layout['bs_bits'] + layout['cc_bits'] + layout['ru_bits'] == 16
+    assert layout['du_bits'] <= caps['du_id_limit']
+    assert layout['bs_bits'] <= caps['bs_id_limit']
+    assert layout['cc_bits'] == 2
+    assert layout['ss_bits'] == 3
+    assert layout['ru_bits'] >= 5
+    assert layout['mask'] == 0x18
+    assert (layout['user_val'], layout['prach_val'], layout['ssb_val']) == (0x00, 0x08, 0x10)
+
+    if caps['ru_ports_map_width'] >= 1 + layout['ru_bits']:
+        dl = 1 << layout['ru_bits']
+        assert layout['table_size'] == 2 * dl
+        assert len(table) == layout['table_size']
+        assert table[0] == {'port': 0, 'type': 1, 'ccid': 0}
+        assert table[7] == {'port': 7, 'type': 1, 'ccid': 0}
+        assert table[8] == {'port': 0, 'type': 3, 'ccid': 0}
+        assert table[12]['type'] == 7
+        assert table[dl + 7] == {'port': 7, 'type': 0, 'ccid': 0}
+        assert table[dl + 0x10 + 1] == {'port': 1, 'type': 2, 'ccid': 0}
+        assert table[dl + 0x12]['type'] == 7
+        assert sum(1 for e in table if e['type'] != 7) == 8 + 4 + 8 + 2
+        assert lib.xorif_set_ru_ports_table_bulk(0, table) == const.XORIF_SUCCESS
+        assert lib.xorif_verify_ru_ports_table() == (const.XORIF_SUCCESS, 0)
+        assert lib.xorif_clear_ru_ports_table() == const.XORIF_SUCCESS
+
+    # Program it
+    assert lib.xorif_apply_eaxc_layout(layout) == const.XORIF_SUCCESS
+    assert lib.xorif_read_fhi_reg("DEFM_CID_CC_SHIFT") == (const.XORIF_SUCCESS, layout['ru_bits'])
+    assert lib.xorif_read_fhi_reg("DEFM_CID_U_MASK") == (const.XORIF_SUCCESS, 0x18)
+    assert lib.xorif_read_fhi_reg("DEFM_CID_PRACH_VALUE") == (const.XORIF_SUCCESS, 0x08)
+
+    # User streams only (no stream type field)
+    spec = {'num_du': 1, 'num_bs': 1, 'num_cc': 1, 'num_user': 1, 'num_prach': 0, 'num_ssb': 0}
+    result, layout, table = lib.xorif_compile_eaxc_layout(spec)
+    assert result == const.XORIF_SUCCESS
+    assert (layout['ss_bits'], layout['mask']) == (0, 0)
+    assert (layout['prach_val'], layout['ssb_val']) == (0xFFFF, 0xFFFF)
+
+    # Unmappable inputs
+    bad_list = [({'num_du': 1, 'num_bs': 1, 'num_cc': 0, 'num_user': 8, 'num_prach': 0, 'num_ssb': 0}, const.XORIF_INVALID_CONFIG),
+                ({'num_du': 1, 'num_bs': 1, 'num_cc': caps['max_cc'] + 1, 'num_user': 8, 'num_prach': 0, 'num_ssb': 0}, const.XORIF_INVALID_CC),
+                ({'num_du': 1, 'num_bs': 1, 'num_cc': 1, 'num_user': 33, 'num_prach': 0, 'num_ssb': 0}, const.XORIF_INVALID_SS),
+                ({'num_du': 1, 'num_bs': 1, 'num_cc': 1, 'num_user': min(caps['no_framer_ss'], caps['no_deframer_ss']) + 1, 'num_prach': 0, 'num_ssb': 0}, const.XORIF_INVALID_SS),
+                ({'num_du': 1, 'num_bs': 1, 'num_cc': 1, 'num_user': 1, 'num_prach': caps['no_framer_ss'] + 1, 'num_ssb': 0}, const.XORIF_INVALID_SS),
+                ({'num_du': 1, 'num_bs': 1, 'num_cc': 1, 'num_user': 1, 'num_prach': 0, 'num_ssb': caps['no_deframer_ss'] + 1}, const.XORIF_INVALID_SS),
+                ({'num_du': (1 << caps['du_id_limit']) + 1, 'num_bs': 1, 'num_cc': 1, 'num_user': 8, 'num_prach': 0, 'num_ssb': 0}, const.XORIF_INVALID_EAXC_ID),
+                ({'num_du': 16, 'num_bs': 64, 'num_cc': 8, 'num_user': 8, 'num_prach': 1, 'num_ssb': 0}, const.XORIF_INVALID_EAXC_ID)]
+    for spec, error in bad_list:
+        result, layout, table = lib.xorif_compile_eaxc_layout(spec)
+        assert result == error
+
 def test_fhi_register_read_api():
     """Check the FHI register read API."""
     assert lib.xorif_get_state() == 1
@@ -1038,6 +1398,56 @@ def test_monitor_api():
     print(value)
 
 
+def test_monitor_bulk_api():
+    """Test the bulk monitor read API."""
+    assert lib.xorif_get_state() == 1
+
+    assert lib.xorif_monitor_read_bulk([])[0] == const.XORIF_INVALID_CONFIG
+    assert lib.xorif_monitor_read_bulk([0, 64])[0] == const.XORIF_INVALID_CONFIG
+    assert lib.xorif_monitor_read_bulk([0] * 65)[0] == const.XORIF_INVALID_CONFIG
+    result, values, timestamp = lib.xorif_monitor_read_bulk([0, 1, 2, 1])
+    assert result == const.XORIF_SUCCESS
+    assert len(values) == 4
+    assert values[1] == values[3]
+    assert timestamp > 0
+
+    if "EXTRA_DEBUG" in lib.constants:
+        # Fake register bank returns the same value for all counters
+        assert lib.xorif_write_fhi_reg("CFG_MONITOR_READ_31__0", 0x89ABCDEF) == 0
+        assert lib.xorif_write_fhi_reg("CFG_MONITOR_READ_63_32", 0x1234567) == 0
+        result, values, timestamp = lib.xorif_monitor_read_bulk([5, 7, 63])
+        assert values == [0x01234567_89ABCDEF] * 3
+        assert lib.xorif_read_fhi_reg("CFG_MONITOR_SELECT_READ") == (0, 63)
+
+
+def test_monitor_stream_api():
+    """Test the monitor stream API."""
+    assert lib.xorif_get_state() == 1
+
+    assert lib.xorif_read_monitor_stream()[0] == const.XORIF_NOT_SUPPORTED
+    assert lib.xorif_start_monitor_stream(0, [0, 1]) == const.XORIF_INVALID_CONFIG
+    assert lib.xorif_start_monitor_stream(1000, [0, 1], 1) == const.XORIF_INVALID_CONFIG
+    assert lib.xorif_start_monitor_stream(1000, [99]) == const.XORIF_INVALID_CONFIG
+
+    assert lib.xorif_start_monitor_stream(1000, [0, 1, 2], 8) == const.XORIF_SUCCESS
+    try:
+        time.sleep(0.1)
+        result, samples, dropped = lib.xorif_read_monitor_stream(4)
+        assert result == const.XORIF_SUCCESS
+        assert len(samples) == 4
+        assert dropped > 0
+        assert all(len(s['values']) == 3 for s in samples)
+        assert all(a['timestamp'] < b['timestamp'] for a, b in zip(samples, samples[1:]))
+
+        # Remaining samples, then the buffer is drained
+        result, samples, dropped = lib.xorif_read_monitor_stream(64)
+        assert 4 <= len(samples) <= 8
+        assert lib.xorif_stop_monitor_stream() == const.XORIF_SUCCESS
+        assert lib.xorif_read_monitor_stream()[0] == const.XORIF_NOT_SUPPORTED
+    finally:
+        lib.xorif_stop_monitor_stream()
+
+
 def test_stall_monitor_api():
     """Test the stall monitor API."""
     assert lib.xorif_get_state() == 1
@@ -1046,3 +1456,569 @@ def test_stall_monitor_api():
     result, value = lib.xorif_stall_monitor_read()
     assert result == const.XORIF_SUCCESS
     print(value)
+
+
+def test_stall_sampler_api():
+    """Test the stall sampler API."""
+    assert lib.xorif_get_state() == 1
+
+    assert lib.xorif_start_stall_sampler(0, 100) == const.XORIF_INVALID_CONFIG
+    assert lib.xorif_start_stall_sampler(10, 0) == const.XORIF_INVALID_CONFIG
+    assert lib.xorif_start_stall_sampler(10, 100, 1, 99) == const.XORIF_INVALID_CONFIG
+    assert lib.xorif_get_stall_stats(99, 0)[0] == const.XORIF_INVALID_CONFIG
+    assert lib.xorif_get_stall_stats(const.STALL_SS_DL, 20)[0] == const.XORIF_INVALID_SS
+    assert lib.xorif_get_stall_stats(const.STALL_SS_UNSOL, 4)[0] == const.XORIF_INVALID_SS
+
+    assert lib.xorif_start_stall_sampler(10, 100) == const.XORIF_SUCCESS
+    try:
+        time.sleep(0.1)
+        result, status = lib.xorif_get_stall_sampler_status()
+        assert result == const.XORIF_SUCCESS
+        assert status['running'] == 1
+        assert status['period_ms'] == 10
+        assert status['samples'] > 0
+        result, value = lib.xorif_get_stall_stats(const.STALL_SS_UL, 15)
+        assert result == const.XORIF_SUCCESS
+        print(value)
+    finally:
+        assert lib.xorif_stop_stall_sampler() == const.XORIF_SUCCESS
+    assert lib.xorif_get_stall_sampler_status()[1]['running'] == 0
+
+
+@pytest.mark.skipif("EXTRA_DEBUG" not in lib.constants, reason="Needs the fake register bank")
+def test_stall_sampler_events():
+    """Test the stall sampler events, durations, rates and recovery action."""
+    assert lib.xorif_get_state() == 1
+
+    def stall(flag, value):
+        assert lib.xorif_write_fhi_reg(flag, value) == const.XORIF_SUCCESS
+        time.sleep(0.05)
+
+    assert lib.xorif_start_stall_sampler(5, 10000, 3, const.STALL_ACTION_LOG) == const.XORIF_SUCCESS
+    try:
+        # Two stalls on DL spatial stream 10, one ongoing stall on PRACH spatial stream 2
+        stall("FRAM_STALL_MONITOR_DL_SS_19_8", 0x4)
+        stall("FRAM_STALL_MONITOR_DL_SS_19_8", 0x0)
+        stall("FRAM_STALL_MONITOR_DL_SS_19_8", 0x4)
+        stall("FRAM_STALL_MONITOR_UL_PRACH_3_0", 0x4)
+        stall("FRAM_STALL_MONITOR_DL_SS_19_8", 0x0)
+
+        result, value = lib.xorif_get_stall_stats(const.STALL_SS_DL, 10)
+        assert result == const.XORIF_SUCCESS
+        assert value['events'] == 2
+        assert value['window_events'] == 2
+        assert value['stalled'] == 0
+        assert value['duration'] >= 80000000
+        assert value['duration'] >= value['max_duration'] >= 40000000
+        assert value['rate'] > 0
+
+        result, value = lib.xorif_get_stall_stats(const.STALL_SS_PRACH, 2)
+        assert value['events'] == 1
+        assert value['stalled'] == 1
+        assert value['duration'] > 0
+        assert lib.xorif_get_stall_stats(const.STALL_SS_DL, 9)[1]['events'] == 0
+
+        # Third stall crosses the threshold, and the window is cleared
+        stall("FRAM_STALL_MONITOR_DL_SS_19_8", 0x4)
+        result, status = lib.xorif_get_stall_sampler_status()
+        assert status['recoveries'] == 1
+        assert status['last_recovery'] > 0
+        assert status['events'] == 4
+        assert status['window_events'] == 0
+
+        # Carrier change (disabling an already disabled carrier), earlier tests may also have changed carriers
+        cc_events = lib.xorif_get_stall_stats(const.STALL_SS_DL, 10)[1]['cc_events']
+        assert lib.xorif_get_enabled_cc_mask() & 0x80 == 0
+        assert lib.xorif_disable_cc(7) == const.XORIF_SUCCESS
+        stall("FRAM_STALL_MONITOR_DL_SS_19_8", 0x0)
+        stall("FRAM_STALL_MONITOR_DL_SS_19_8", 0x4)
+        assert lib.xorif_get_stall_stats(const.STALL_SS_DL, 10)[1]['cc_events'] == cc_events + 1
+
+        assert lib.xorif_clear_stall_stats() == const.XORIF_SUCCESS
+        result, value = lib.xorif_get_stall_stats(const.STALL_SS_DL, 10)
+        assert value['events'] == 0
+        assert value['stalled'] == 1
+    finally:
+        lib.xorif_stop_stall_sampler()
+        lib.xorif_write_fhi_reg("FRAM_STALL_MONITOR_DL_SS_19_8", 0)
+        lib.xorif_write_fhi_reg("FRAM_STALL_MONITOR_UL_PRACH_3_0", 0)
+
+
+def test_arrival_histogram_api():
+    """Test the UL arrival-time histogram API (arguments)."""
+    assert lib.xorif_get_state() == 1
+
+    assert lib.xorif_configure_arrival_histogram(0, 10) == const.XORIF_INVALID_CONFIG
+    assert lib.xorif_configure_arrival_histogram(100, 0) == const.XORIF_INVALID_CONFIG
+    assert lib.xorif_configure_arrival_histogram(100, 257) == const.XORIF_INVALID_CONFIG
+    assert lib.xorif_configure_arrival_histogram(100, 256, -1000) == const.XORIF_SUCCESS
+    assert lib.xorif_add_arrival_samples(99, 0, [0]) == const.XORIF_INVALID_CC
+    assert lib.xorif_add_arrival_samples(0, 99, [0]) == const.XORIF_INVALID_ETH_PORT
+    assert lib.xorif_get_arrival_histogram(99, 0)[0] == const.XORIF_INVALID_CC
+    assert lib.xorif_get_arrival_percentile(0, 0, 101.0)[0] == const.XORIF_INVALID_CONFIG
+    assert lib.xorif_get_arrival_percentile(0, 0, 50.0)[0] == const.XORIF_INVALID_CONFIG # no samples
+
+    result, hist = lib.xorif_get_arrival_histogram(0, 0)
+    assert result == const.XORIF_SUCCESS
+    assert hist['num_bins'] == 256
+    assert hist['origin_ns'] == -1000
+    assert hist['samples'] == 0
+    assert hist['p99_ns'] == 0
+    assert lib.xorif_clear_arrival_histograms() == const.XORIF_SUCCESS
+
+
+def test_arrival_histogram_percentiles():
+    """Test the UL arrival-time histogram bins and percentiles against a known distribution."""
+    assert lib.xorif_get_state() == 1
+
+    # 100 ns bins from -1 us, with offsets -1000..8999 ns (uniform) plus outliers either side
+    assert lib.xorif_configure_arrival_histogram(100, 100, -1000) == const.XORIF_SUCCESS
+    offsets = list(range(-1000, 9000))
+    for n in range(0, len(offsets), 1000):
+        assert lib.xorif_add_arrival_samples(0, 0, offsets[n:n + 1000]) == const.XORIF_SUCCESS
+    assert lib.xorif_add_arrival_samples(0, 0, [-5000, 20000]) == const.XORIF_SUCCESS
+
+    result, hist = lib.xorif_get_arrival_histogram(0, 0)
+    assert result == const.XORIF_SUCCESS
+    assert hist['samples'] == 10002
+    assert hist['underflow'] == 1
+    assert hist['overflow'] == 1
+    assert hist['bins'][0] == 100
+    assert hist['bins'][99] == 100
+    assert sum(hist['bins']) == 10000
+    assert hist['min_ns'] == -5000
+    assert hist['max_ns'] == 20000
+    assert abs(hist['mean_ns'] - 4000) <= 2
+    assert abs(hist['p50_ns'] - 4000) <= 2
+    assert abs(hist['p90_ns'] - 8000) <= 2
+    assert abs(hist['p99_ns'] - 8900) <= 2
+    assert abs(hist['p999_ns'] - 8990) <= 2
+
+    result, offset = lib.xorif_get_arrival_percentile(0, 0, 10.0)
+    assert result == const.XORIF_SUCCESS
+    assert abs(offset - 0) <= 2
+    assert lib.xorif_get_arrival_percentile(0, 0, 0.0) == (const.XORIF_SUCCESS, -5000)
+    assert lib.xorif_get_arrival_percentile(0, 0, 100.0) == (const.XORIF_SUCCESS, 20000)
+
+    # Other carriers / ports are independent
+    assert lib.xorif_get_arrival_histogram(1, 0)[1]['samples'] == 0
+
+    # Clearing keeps the configuration
+    assert lib.xorif_clear_arrival_histograms() == const.XORIF_SUCCESS
+    result, hist = lib.xorif_get_arrival_histogram(0, 0)
+    assert hist['samples'] == 0
+    assert hist['bin_width_ns'] == 100
+
+
+def wait_for_dump(dumps, timeout=2.0):
+    """Wait for the flight recorder thread to write an automatic dump."""
+    end = time.time() + timeout
+    while time.time() < end:
+        result, status = lib.xorif_get_recorder_status()
+        if status['dumps'] > dumps:
+            return status
+        time.sleep(0.01)
+    return status
+
+
+def test_recorder_api(tmp_path):
+    """Test the flight recorder API (manual trigger, post-trigger records, dump and decode)."""
+    assert lib.xorif_get_state() == 1
+
+    assert lib.xorif_set_recorder_trigger(0x100) == const.XORIF_INVALID_CONFIG
+    assert lib.xorif_set_recorder_trigger(0, 0, 0, "x" * 256) == const.XORIF_INVALID_CONFIG
+    assert lib.xorif_get_recorder_status()[1]['frozen'] == 0
+
+    try:
+        # Always recording: API calls and register writes
+        assert lib.xorif_set_recorder_trigger(0, 0, 3) == const.XORIF_SUCCESS
+        assert lib.xorif_write_fhi_reg("ORAN_CC_NUMEROLOGY", 1) == const.XORIF_SUCCESS
+        assert lib.xorif_write_fhi_reg("ORAN_CC_NUMEROLOGY", 0) == const.XORIF_SUCCESS
+
+        # Manual trigger, then 3 records (the API calls below), then freeze
+        assert lib.xorif_trigger_recorder() == const.XORIF_SUCCESS
+        lib.xorif_get_state()
+        lib.xorif_get_state()
+        assert lib.xorif_get_recorder_status()[1]['frozen'] == 1
+        lib.xorif_get_sw_version()
+
+        result, status = lib.xorif_get_recorder_status()
+        assert status['trigger'] == const.RECORDER_TRIGGER_MANUAL
+        assert status['trigger_seq'] > 0
+        assert status['records'] == status['trigger_seq'] + 3
+
+        path = str(tmp_path / "recorder.bin")
+        assert lib.xorif_dump_recorder(path) == const.XORIF_SUCCESS
+        header, records = recorder_decode.decode(path)
+        assert header.trigger == const.RECORDER_TRIGGER_MANUAL
+        assert header.trigger_seq == status['trigger_seq']
+        assert 0 < header.num_records <= const.RECORDER_SIZE
+        assert header.num_records + header.lost == status['records']
+
+        # The records are in order, and end 3 records after the trigger
+        assert [r.seq for r in records] == list(range(records[0].seq, records[-1].seq + 1))
+        assert records[-1].seq == header.trigger_seq + 3
+        # (the API calls, errors and register writes have coarse timestamps, so only compare those)
+        coarse = [r for r in records if r.type in (const.RECORD_API, const.RECORD_ERROR, const.RECORD_REG_WRITE)]
+        assert all(coarse[i].timestamp <= coarse[i + 1].timestamp for i in range(len(coarse) - 1))
+        trigger = records[-4]
+        assert trigger.type == const.RECORD_TRIGGER
+        assert trigger.arg == const.RECORDER_TRIGGER_MANUAL
+        assert [(r.type, r.name) for r in records[-3:]] == [(const.RECORD_API, "xorif_get_state"),
+                                                           (const.RECORD_API, "xorif_get_state"),
+                                                           (const.RECORD_API, "xorif_get_recorder_status")]
+
+        # Register writes are recorded with the name and value
+        writes = [r for r in records if r.type == const.RECORD_REG_WRITE and r.name == "ORAN_CC_NUMEROLOGY"]
+        assert [w.data[3] for w in writes[-2:]] == [1, 0]
+        assert records[records.index(writes[-1]) - 1].name == "xorif_write_fhi_reg"
+
+        # Frozen, so a second trigger doesn't fire
+        assert lib.xorif_trigger_recorder() == const.XORIF_SUCCESS
+        assert lib.xorif_get_recorder_status()[1]['trigger_seq'] == status['trigger_seq']
+
+        # Re-arm
+        assert lib.xorif_rearm_recorder() == const.XORIF_SUCCESS
+        result, status = lib.xorif_get_recorder_status()
+        assert status['frozen'] == 0
+        assert status['trigger'] == 0
+        assert lib.xorif_dump_recorder("/nonexistent/recorder.bin") == const.XORIF_INVALID_CONFIG
+    finally:
+        lib.xorif_set_recorder_trigger(0)
+        lib.xorif_rearm_recorder()
+
+
+def test_recorder_error_trigger(tmp_path):
+    """Test the flight recorder error trigger (with automatic dump)."""
+    assert lib.xorif_get_state() == 1
+
+    path = str(tmp_path / "recorder_error.bin")
+    try:
+        dumps = lib.xorif_get_recorder_status()[1]['dumps']
+        assert lib.xorif_set_recorder_trigger(const.RECORDER_TRIGGER_ERROR, 0, 0, path) == const.XORIF_SUCCESS
+        assert lib.xorif_enable_cc(99) == const.XORIF_INVALID_CC
+
+        status = wait_for_dump(dumps)
+        assert status['frozen'] == 1
+        assert status['trigger'] == const.RECORDER_TRIGGER_ERROR
+        assert status['dump_result'] == const.XORIF_SUCCESS
+
+        header, records = recorder_decode.decode(path)
+        assert header.trigger == const.RECORDER_TRIGGER_ERROR
+        assert [(r.type, r.name) for r in records[-3:]] == [(const.RECORD_API, "xorif_enable_cc"),
+                                                           (const.RECORD_ERROR, "xorif_enable_cc"),
+                                                           (const.RECORD_TRIGGER, "xorif_enable_cc")]
+        assert records[-1].seq == header.trigger_seq
+        assert "xorif_enable_cc" in recorder_decode.describe(records[-1])
+    finally:
+        lib.xorif_set_recorder_trigger(0)
+        lib.xorif_rearm_recorder()
+
+
+def test_recorder_sampling(tmp_path):
+    """Test the flight recorder counter sampling."""
+    assert lib.xorif_get_state() == 1
+
+    path = str(tmp_path / "recorder_stats.bin")
+    try:
+        assert lib.xorif_set_recorder_sampling(10) == const.XORIF_SUCCESS
+        assert lib.xorif_get_recorder_status()[1]['sample_ms'] == 10
+        time.sleep(0.1)
+        assert lib.xorif_set_recorder_sampling(0) == const.XORIF_SUCCESS
+
+        assert lib.xorif_dump_recorder(path) == const.XORIF_SUCCESS
+        header, records = recorder_decode.decode(path)
+        samples = [r for r in records if r.type == const.RECORD_STATS]
+        assert len(samples) >= 5 * caps['num_eth_ports']
+        assert {r.arg for r in samples} == set(range(caps['num_eth_ports']))
+        assert "rx_good" in recorder_decode.describe(samples[0])
+    finally:
+        lib.xorif_set_recorder_sampling(0)
+
+
+def test_timeline_api(tmp_path):
+    """Test the timeline (span capture, and Chrome trace event export)."""
+    assert lib.xorif_start_timeline(const.TIMELINE_MAX_EVENTS + 1) == const.XORIF_INVALID_CONFIG
+    assert lib.xorif_write_timeline("/nonexistent/timeline.json") == const.XORIF_INVALID_CONFIG
+
+    try:
+        # Capture a (re-)initialization, CC configuration and RU port programming
+        assert lib.xorif_start_timeline() == const.XORIF_SUCCESS
+        lib.xorif_finish()
+        assert lib.xorif_init() == const.XORIF_SUCCESS
+        assert lib.xorif_configure_cc(0) == const.XORIF_SUCCESS
+        assert lib.xorif_set_ru_ports(8, caps['ss_id_limit'], 0xC0, 0x00, 0x80, 0x40) == const.XORIF_SUCCESS
+        assert lib.xorif_enable_cc(99) == const.XORIF_INVALID_CC
+        assert lib.xorif_stop_timeline() == const.XORIF_SUCCESS
+        lib.xorif_configure_cc(0)
+
+        result, status = lib.xorif_get_timeline_status()
+        assert status['enabled'] == 0
+        assert status['capacity'] == const.TIMELINE_DEFAULT_EVENTS
+        assert status['spans'] > 0
+        assert status['open'] == 0
+        assert status['lost'] == 0
+
+        path = str(tmp_path / "timeline.json")
+        assert lib.xorif_write_timeline(path) == const.XORIF_SUCCESS
+        with open(path) as f:
+            trace = json.load(f)
+        spans = [e for e in trace['traceEvents'] if e['ph'] == 'X']
+        assert len(spans) == status['spans']
+        assert all(e['dur'] >= 0 and e['args']['reg_writes'] >= 0 for e in spans)
+
+        def find(name):
+            return [e for e in spans if e['name'] == name]
+
+        # The phases are nested within the operation (and only captured while enabled)
+        init = find("xorif_init")[0]
+        device = find("xorif_fhi_init_device")[0]
+        assert init['ts'] <= device['ts'] and device['ts'] + device['dur'] <= init['ts'] + init['dur']
+        assert device['args']['reg_writes'] > 0
+        configure = find("xorif_configure_cc")
+        assert len(configure) == 1 and configure[0]['args']['cc'] == 0
+        phases = [e['name'] for e in spans if e['cat'] == 'cc' and e['name'] not in ("xorif_configure_cc", "xorif_enable_cc")]
+        assert phases[:3] == ["calculate", "allocate_memory", "program_dl_ul"]
+        assert "reload" in phases
+        start = configure[0]['ts']
+        end = start + configure[0]['dur']
+        for e in spans:
+            if e['name'] in phases:
+                assert start <= e['ts'] and e['ts'] + e['dur'] <= end
+        assert find("program_dl_ul")[0]['args']['reg_writes'] > 0
+        assert configure[0]['args']['reg_writes'] >= find("program_dl_ul")[0]['args']['reg_writes']
+        assert find("xorif_set_ru_ports")[0]['cat'] == "ru_ports"
+
+        # A span ends on an early (error) return
+        assert find("xorif_enable_cc")[0]['args']['cc'] == 99
+
+        # Capture stops when full
+        assert lib.xorif_start_timeline(2) == const.XORIF_SUCCESS
+        lib.xorif_configure_cc(0)
+        result, status = lib.xorif_get_timeline_status()
+        assert status['spans'] == 2
+        assert status['lost'] > 0
+    finally:
+        lib.xorif_stop_timeline()
+
+
+def test_register_scrubber():
+    """Test the register scrubber (a corrupted configuration register is reported by name, and restored)."""
+    assert lib.xorif_start_scrubber(const.SCRUB_MAX_BUDGET + 1, const.SCRUB_REPORT) == const.XORIF_INVALID_CONFIG
+    assert lib.xorif_start_scrubber(0, 2) == const.XORIF_INVALID_CONFIG
+    assert lib.xorif_scrub_registers(2)[0] == const.XORIF_INVALID_CONFIG
+
+    try:
+        # Re-initialize, so only this configuration is expected
+        lib.xorif_finish()
+        assert lib.xorif_scrub_registers()[0] == const.XORIF_FAILURE
+        assert lib.xorif_start_scrubber() == const.XORIF_FAILURE
+        assert lib.xorif_init() == const.XORIF_SUCCESS
+        assert lib.xorif_configure_cc(0) == const.XORIF_SUCCESS
+        assert lib.xorif_set_fhi_vlan_tag(1, 7, 0, 3) == const.XORIF_SUCCESS
+        assert lib.xorif_clear_scrubber_stats() == const.XORIF_SUCCESS
+        assert lib.xorif_scrub_registers() == (const.XORIF_SUCCESS, 0)
+        result, status = lib.xorif_get_scrubber_status()
+        assert status['registers'] > 0
+        assert status['passes'] == 1
+        assert status['reads'] == status['registers']
+
+        # A stray "poke" is reported with the field name (and the instance for repeated ranges)
+        assert lib.xorif_write_fhi_reg_offset("ETH_VLAN_ID", 0x100, 5) == const.XORIF_SUCCESS
+        assert lib.xorif_scrub_registers(const.SCRUB_REPORT) == (const.XORIF_SUCCESS, 1)
+        assert lib.xorif_scrub_registers(const.SCRUB_REPORT) == (const.XORIF_SUCCESS, 1)
+        result, log = lib.xorif_get_scrubber_log()
+        assert result == const.XORIF_SUCCESS
+        assert len(log) == 2
+        assert log[0]['name'] == b"ETH_VLAN_ID[1]"
+        assert log[0]['addr'] == 0xA110
+        assert (log[0]['expected'], log[0]['actual'], log[0]['restored']) == (7, 5, 0)
+
+        # Restore mode writes back the expected value (only the corrupted field is reported)
+        value = lib.xorif_read_fhi_reg_offset("ETH_VLAN_PCP", 0x100)[1]
+        assert lib.xorif_scrub_registers(const.SCRUB_RESTORE) == (const.XORIF_SUCCESS, 1)
+        assert lib.xorif_read_fhi_reg_offset("ETH_VLAN_ID", 0x100) == (const.XORIF_SUCCESS, 7)
+        assert lib.xorif_read_fhi_reg_offset("ETH_VLAN_PCP", 0x100) == (const.XORIF_SUCCESS, value)
+        assert lib.xorif_scrub_registers(const.SCRUB_REPORT) == (const.XORIF_SUCCESS, 0)
+        result, status = lib.xorif_get_scrubber_status()
+        assert (status['mismatches'], status['restored']) == (3, 1)
+        assert lib.xorif_get_scrubber_log(1)[1][0]['restored'] == 1
+
+        # The background scrubber finds (and restores) the corruption, within its budget
+        assert lib.xorif_write_fhi_reg("ORAN_CC_NUMRBS", 3) == const.XORIF_SUCCESS
+        assert lib.xorif_clear_scrubber_stats() == const.XORIF_SUCCESS
+        start = time.monotonic()
+        assert lib.xorif_start_scrubber(1000, const.SCRUB_RESTORE) == const.XORIF_SUCCESS
+        while lib.xorif_get_scrubber_status()[1]['restored'] == 0 and time.monotonic() - start < 5:
+            time.sleep(0.01)
+        result, status = lib.xorif_get_scrubber_status()
+        elapsed = time.monotonic() - start
+        assert (status['running'], status['budget'], status['mode']) == (1, 1000, const.SCRUB_RESTORE)
+        assert status['restored'] == 1
+        assert status['reads'] <= 1000 * elapsed + 2 * status['registers']
+        assert lib.xorif_get_scrubber_log(1)[1][0]['name'] == b"ORAN_CC_NUMRBS[0]"
+        assert lib.xorif_read_fhi_reg("ORAN_CC_NUMRBS")[1] != 3
+        assert lib.xorif_stop_scrubber() == const.XORIF_SUCCESS
+        assert lib.xorif_get_scrubber_status()[1]['running'] == 0
+    finally:
+        lib.xorif_stop_scrubber()
+
+def test_latency_budget():
+    """Test the latency budget calculator (stages, O-RAN windows and violations)."""
+    transport = {'t12_min': 10, 't12_max': 20, 't34_min': 10, 't34_max': 20}
+    assert lib.xorif_get_latency_budget(caps['max_cc'], transport)[0] == const.XORIF_INVALID_CC
+    assert lib.xorif_get_latency_budget(0, {'t12_min': 20, 't12_max': 10})[0] == const.XORIF_INVALID_CONFIG
+    assert lib.xorif_get_latency_budget(0, {'t34_min': -1})[0] == const.XORIF_INVALID_CONFIG
+
+    result, config = lib.xorif_get_cc_config(0)
+    try:
+        assert lib.xorif_set_cc_numerology(0, 0, 0) == const.XORIF_SUCCESS
+        assert lib.xorif_set_cc_dl_timing_parameters(0, 30, 30, 90) == const.XORIF_SUCCESS
+        assert lib.xorif_set_cc_ul_timing_parameters(0, 30, 90, 30) == const.XORIF_SUCCESS
+        assert lib.xorif_set_ul_bid_forward(0, 90) == const.XORIF_SUCCESS
+
+        # Stages add up, and the windows match the configuration
+        result, budget = lib.xorif_get_latency_budget(0, transport)
+        assert result == const.XORIF_SUCCESS
+        decap = budget['dl_decap']
+        assert budget['violations'] == 0
+        assert budget['sym_period'] == pytest.approx(71.43, abs=0.01)
+        assert (budget['dl_transport'], budget['dl_deskew'], budget['dl_decap']) == (20, 30, decap)
+        assert budget['dl_total'] == pytest.approx(50 + decap)
+        assert budget['dl_ctrl_total'] == pytest.approx(20 + 30 + 90 + decap)
+        assert budget['ul_total'] == pytest.approx(30 + budget['sym_period'] + 20)
+        assert (budget['t2a_min_up'], budget['t2a_max_up']) == (decap, decap + 30)
+        assert (budget['t1a_min_up'], budget['t1a_max_up']) == (decap + 20, decap + 40)
+        assert (budget['t2a_min_cp_ul'], budget['t2a_max_cp_ul']) == (90, 120)
+        assert (budget['ta4_min'], budget['ta4_max']) == (40, pytest.approx(50 + budget['sym_period']))
+        assert (budget['dl_data_symbols'], budget['dl_ctrl_symbols'], budget['ul_ctrl_symbols']) == (1, 2, 3)
+        assert budget['ul_bid_forward'] == 90
+
+        # Transport delay variation wider than the reception windows
+        result, budget = lib.xorif_get_latency_budget(0, {'t12_min': 0, 't12_max': 50})
+        assert budget['violations'] == const.LATENCY_T1A_UP | const.LATENCY_T1A_CP_DL | const.LATENCY_T1A_CP_UL
+
+        # O-DU limits
+        result, budget = lib.xorif_get_latency_budget(0, dict(transport, t1a_max_up=decap + 19, ta4_max=100))
+        assert budget['violations'] == const.LATENCY_T1A_DU_LIMIT | const.LATENCY_TA3_DU_LIMIT
+
+        # Buffering and UL beam-id forward time
+        assert lib.xorif_set_cc_dl_timing_parameters(0, 30, 2000, 90) == const.XORIF_SUCCESS
+        assert lib.xorif_set_ul_bid_forward(0, 10) == const.XORIF_SUCCESS
+        result, budget = lib.xorif_get_latency_budget(0, transport)
+        assert budget['violations'] == const.LATENCY_T2A_DATA_BUFFER | const.LATENCY_UL_BID_FORWARD
+        assert budget['dl_data_symbols'] > budget['max_data_symbols']
+        assert budget['ul_bid_forward'] == budget['sym_period']
+    finally:
+        lib.xorif_set_cc_config(0, config)
+
+def test_bandwidth_calculator():
+    """Test the bandwidth calculator against reference numbers (100 MHz, 30 kHz, 273 RBs)."""
+    params = {'link_rate': 25, 'mtu': 1500, 'dl_streams': 1, 'ul_streams': 4,
+              'prach_streams': 1, 'prach_rbs': 12, 'prach_symbols': 12, 'ssb_streams': 1, 'ssb_symbols': 16, 'cc_mask': 1}
+    assert lib.xorif_get_cc_bandwidth(caps['max_cc'], params)[0] == const.XORIF_INVALID_CC
+    assert lib.xorif_get_port_bandwidth(caps['num_eth_ports'], params)[0] == const.XORIF_INVALID_ETH_PORT
+    assert lib.xorif_get_cc_bandwidth(0, dict(params, mtu=20))[0] == const.XORIF_INVALID_CONFIG
+
+    result, config = lib.xorif_get_cc_config(0)
+    result, protocol = lib.xorif_get_fhi_port_config(0)
+    try:
+        new_config = dict(config, num_rbs=273, numerology=1, extended_cp=0,
+                          iq_comp_meth_dl=const.IQ_COMP_BLOCK_FP, iq_comp_width_dl=9, iq_comp_mplane_dl=1,
+                          iq_comp_meth_ul=const.IQ_COMP_BLOCK_FP, iq_comp_width_ul=9, iq_comp_mplane_ul=0)
+        assert lib.xorif_set_cc_config(0, new_config) == const.XORIF_SUCCESS
+        assert lib.xorif_set_fhi_protocol_alt(const.PROTOCOL_ECPRI, 0, const.IP_MODE_RAW) == const.XORIF_SUCCESS
+
+        # DL: 28 bytes per RB, 53 RBs per 1500 byte MTU, so 6 packets per symbol (5 x 1518 + 1 x 258 bytes)
+        result, bw = lib.xorif_get_cc_bandwidth(0, params)
+        assert result == const.XORIF_SUCCESS
+        assert bw['mtu'] == 1500
+        assert bw['dl']['iq_rate'] == pytest.approx(1712256000)
+        assert bw['dl']['bit_rate'] == pytest.approx((5 * 1538 + 278) * 8 * 28000)
+        assert bw['dl']['packet_rate'] == pytest.approx(6 * 28000)
+        assert bw['dl']['frame_size'] == 1518
+
+        # UL: dynamic compression (6 byte section headers), 52 RBs per packet, 4 spatial streams
+        assert bw['ul']['iq_rate'] == pytest.approx(4 * 1712256000)
+        assert bw['ul']['bit_rate'] == pytest.approx(4 * (5 * 1512 + 420) * 8 * 28000)
+        assert bw['ul']['packet_rate'] == pytest.approx(4 * 6 * 28000)
+
+        # PRACH and SSB (symbols per 10 ms frame)
+        assert bw['prach']['packet_rate'] == pytest.approx(1200)
+        assert bw['ssb']['packet_rate'] == pytest.approx(1600)
+
+        # Uncompressed 16-bit IQ
+        assert lib.xorif_set_cc_config(0, dict(new_config, iq_comp_meth_dl=const.IQ_COMP_NONE, iq_comp_width_dl=16)) == const.XORIF_SUCCESS
+        assert lib.xorif_get_cc_bandwidth(0, params)[1]['dl']['iq_rate'] == pytest.approx(2935296000)
+        assert lib.xorif_set_cc_config(0, new_config) == const.XORIF_SUCCESS
+
+        # VLAN and UDP/IPv4 overheads: 52 RBs per packet (5 x 1522 + 1 x 430 bytes)
+        assert lib.xorif_set_fhi_protocol_alt(const.PROTOCOL_ECPRI, 1, const.IP_MODE_IPV4) == const.XORIF_SUCCESS
+        result, bw = lib.xorif_get_cc_bandwidth(0, params)
+        assert bw['dl']['bit_rate'] == pytest.approx((5 * 1542 + 450) * 8 * 28000)
+        assert bw['dl']['frame_size'] == 1522
+        assert lib.xorif_set_fhi_protocol_alt(const.PROTOCOL_ECPRI, 0, const.IP_MODE_RAW) == const.XORIF_SUCCESS
+
+        # Port totals (DL + SSB, UL + PRACH), and link capacity
+        port = lib.xorif_get_cc_planned_eth_port(0)[1]
+        result, bw = lib.xorif_get_cc_bandwidth(0, params)
+        result, total = lib.xorif_get_port_bandwidth(port, params)
+        assert result == const.XORIF_SUCCESS
+        assert total['cc_mask'] == 1
+        assert total['dl']['bit_rate'] == pytest.approx(bw['dl']['bit_rate'] + bw['ssb']['bit_rate'])
+        assert total['ul']['packet_rate'] == pytest.approx(bw['ul']['packet_rate'] + bw['prach']['packet_rate'])
+        assert total['ul_utilization'] == pytest.approx(total['ul']['bit_rate'] / 25e9)
+        assert total['overload'] == 0
+        result, total = lib.xorif_get_port_bandwidth(port, dict(params, link_rate=5))
+        assert total['overload'] == const.BANDWIDTH_UL_OVERLOAD
+        result, total = lib.xorif_get_port_bandwidth(port, dict(params, link_rate=1))
+        assert total['overload'] == const.BANDWIDTH_DL_OVERLOAD | const.BANDWIDTH_UL_OVERLOAD
+    finally:
+        lib.xorif_set_cc_config(0, config)
+        lib.xorif_set_fhi_protocol_alt(protocol['transport'], protocol['vlan'], protocol['ip_mode'])
+
+def test_iq_compression_advisor():
+    """Test the IQ compression advisor (quality of each supported setting, and the recommendation)."""
+    params = {'num_rbs': 273, 'modulation': 8, 'backoff': 12, 'power_range': 0, 'target_evm': 1.0, 'seed': 1}
+    assert lib.xorif_advise_iq_compression(caps['max_cc'], const.CHAN_DL, params)[0] == const.XORIF_INVALID_CC
+    assert lib.xorif_advise_iq_compression(0, const.CHAN_PRACH + 1, params)[0] == const.XORIF_INVALID_CONFIG
+    assert lib.xorif_advise_iq_compression(0, const.CHAN_DL, dict(params, modulation=7))[0] == const.XORIF_INVALID_CONFIG
+    assert lib.xorif_advise_iq_compression(0, const.CHAN_DL, dict(params, target_evm=0))[0] == const.XORIF_INVALID_CONFIG
+
+    result, config = lib.xorif_get_cc_config(0)
+    try:
+        assert lib.xorif_set_cc_numerology(0, 1, 0) == const.XORIF_SUCCESS
+        result, advice = lib.xorif_advise_iq_compression(0, const.CHAN_DL, params)
+        assert result == const.XORIF_SUCCESS
+        assert advice['num_candidates'] > 0
+        bfp = {c['comp_width']: c for c in advice['candidates'] if c['comp_meth'] == const.IQ_COMP_BLOCK_FP}
+        none = {c['comp_width']: c for c in advice['candidates'] if c['comp_meth'] == const.IQ_COMP_NONE}
+
+        # Each extra bit gains ~6 dB of SQNR, and EVM agrees with SQNR
+        assert (bfp[12]['sqnr'] - bfp[8]['sqnr']) / 4 == pytest.approx(6.02, abs=0.5)
+        for width in range(8, 13):
+            assert bfp[width + 1]['sqnr'] > bfp[width]['sqnr']
+            assert bfp[width]['sqnr'] == pytest.approx(-20 * math.log10(bfp[width]['evm'] / 100))
+        assert none[16]['evm'] < 0.01
+        assert bfp[9]['iq_rate'] == pytest.approx(1712256000)
+
+        # The recommendation is the narrowest width that meets the target
+        best = advice['candidates'][advice['recommended']]
+        assert best['meets_target'] == 1 and best['evm'] <= 1.0
+        assert (best['comp_meth'], best['comp_width']) == (const.IQ_COMP_BLOCK_FP, 8)
+        assert all(c['meets_target'] == 0 for c in advice['candidates'] if c['comp_width'] < best['comp_width'])
+
+        # Block floating point copes with per-RB power variation, without compression needs more bits
+        result, advice = lib.xorif_advise_iq_compression(0, const.CHAN_UL, dict(params, power_range=20))
+        bfp = {c['comp_width']: c for c in advice['candidates'] if c['comp_meth'] == const.IQ_COMP_BLOCK_FP}
+        none = {c['comp_width']: c for c in advice['candidates'] if c['comp_meth'] == const.IQ_COMP_NONE}
+        assert bfp[9]['evm'] < none[9]['evm'] / 4
+        assert advice['candidates'][advice['recommended']]['comp_meth'] == const.IQ_COMP_BLOCK_FP
+
+        # Repeatable (for the same seed), and an unreachable target
+        assert lib.xorif_advise_iq_compression(0, const.CHAN_UL, dict(params, power_range=20))[1] == advice
+        result, advice = lib.xorif_advise_iq_compression(0, const.CHAN_DL, dict(params, target_evm=0.001))
+        assert result == const.XORIF_SUCCESS
+        assert advice['recommended'] == const.COMP_ADVICE_NONE
+    finally:
+        lib.xorif_set_cc_config(0, config)
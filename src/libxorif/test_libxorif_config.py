@@ -4,6 +4,7 @@ import sys
 import logging
 from collections import namedtuple
 from pprint import pprint
+from cffi import FFI
 import pytest
 
 sys.path.append('/usr/share/xorif')
@@ -15,6 +16,17 @@ lib.xorif_init()
 const = namedtuple("xorif_const", lib.constants.keys())(*lib.constants.values())
 caps = lib.xorif_get_capabilities()
 
+# Open C library directly (to access hidden test functions)
+ffi = FFI()
+ffi.cdef("""
+int xorif_test_cc_reg_writes(int cc);
+int xorif_test_set_fake_max_cc(uint16_t num_cc);
+int xorif_test_ru_ports_table_writes(int reset);
+void xorif_test_set_fake_ru_port(uint16_t address, uint32_t value);
+int xorif_test_modu_table_writes(int reset);
+""")
+c_lib = ffi.dlopen("libxorif.so.1")
+
 # Configure optional parts of tests
 OPTIMIZED = True
 
@@ -706,4 +718,228 @@ def test_reorder_config_cc_4():
         assert alloc['ssb_ctrl_size'] == 5 * 2
         assert alloc['ssb_data_ptrs_offset'] == 3
         assert alloc['ssb_data_buff_offset'] == 127 + 127 + 127
-        assert alloc['ssb_data_buff_size'] == 127 * 1
\ No newline at end of file
+        assert alloc['ssb_data_buff_size'] == 127 * 1
+
+@pytest.mark.skipif(caps['max_cc'] < 3, reason = "Insufficient component carrier supported")
+def test_hot_add_cc_3():
+    """Check that hot-add keeps live carriers in place."""
+    assert lib.xorif_get_state() == 1
+
+    # Ensure any existing component carriers are disabled
+    disable_all_cc()
+
+    # Configuration
+    config = default_config()
+
+    # Configure CC#0, CC#1 & CC#2, then remove CC#1 to leave a hole
+    for cc in range(3):
+        assert lib.xorif_set_cc_config(cc, config) == const.XORIF_SUCCESS
+        assert lib.xorif_configure_cc(cc) == const.XORIF_SUCCESS
+        assert lib.xorif_enable_cc(cc) == const.XORIF_SUCCESS
+    assert lib.xorif_disable_cc(1) == const.XORIF_SUCCESS
+    _, alloc0 = lib.xorif_get_fhi_cc_alloc(0)
+    _, alloc2 = lib.xorif_get_fhi_cc_alloc(2)
+
+    # Can't hot-add a live carrier
+    assert lib.xorif_configure_cc_hot_add(0) == const.XORIF_INVALID_CC
+    assert lib.xorif_configure_cc_hot_add(caps['max_cc']) == const.XORIF_INVALID_CC
+
+    # Hot-add a smaller CC#1, which should fill the hole
+    if "EXTRA_DEBUG" in lib.constants:
+        c_lib.xorif_test_cc_reg_writes(-1)
+    config['num_rbs'] = 10
+    assert lib.xorif_set_cc_config(1, config) == const.XORIF_SUCCESS
+    assert lib.xorif_configure_cc_hot_add(1) == const.XORIF_SUCCESS
+    assert lib.xorif_enable_cc(1) == const.XORIF_SUCCESS
+    print_alloc(1)
+
+    # Live carriers have not moved
+    assert lib.xorif_get_fhi_cc_alloc(0) == (const.XORIF_SUCCESS, alloc0)
+    assert lib.xorif_get_fhi_cc_alloc(2) == (const.XORIF_SUCCESS, alloc2)
+    result, alloc = lib.xorif_get_fhi_cc_alloc(1)
+    assert result == const.XORIF_SUCCESS
+    assert alloc['ul_ctrl_offset'] == 20
+    assert alloc['ul_ctrl_base_offset'] == 20
+    assert alloc['dl_ctrl_offset'] == 20
+    assert alloc['dl_data_ptrs_offset'] == 1
+    assert alloc['dl_data_buff_offset'] == 146
+
+    # ...and their registers were not written
+    if "EXTRA_DEBUG" in lib.constants:
+        assert c_lib.xorif_test_cc_reg_writes(0) == 0
+        assert c_lib.xorif_test_cc_reg_writes(2) == 0
+        assert c_lib.xorif_test_cc_reg_writes(1) > 0
+
+@pytest.mark.skipif(caps['max_cc'] < 3, reason = "Insufficient component carrier supported")
+def test_hot_add_cc_no_space():
+    """Check that a hot-add that doesn't fit fails without touching the h/w."""
+    assert lib.xorif_get_state() == 1
+
+    # Ensure any existing component carriers are disabled
+    disable_all_cc()
+
+    # Configuration
+    config = default_config()
+
+    # Configure CC#0 & CC#1
+    for cc in range(2):
+        assert lib.xorif_set_cc_config(cc, config) == const.XORIF_SUCCESS
+        assert lib.xorif_configure_cc(cc) == const.XORIF_SUCCESS
+        assert lib.xorif_enable_cc(cc) == const.XORIF_SUCCESS
+    # CC#2 is configured, but left disabled
+    assert lib.xorif_set_cc_config(2, config) == const.XORIF_SUCCESS
+    assert lib.xorif_configure_cc_hot_add(2) == const.XORIF_SUCCESS
+    allocs = [lib.xorif_get_fhi_cc_alloc(cc) for cc in range(3)]
+
+    # CC#2 now needs more uplink ctrl section memory than remains (2 symbols)
+    if "EXTRA_DEBUG" in lib.constants:
+        c_lib.xorif_test_cc_reg_writes(-1)
+    config['num_ctrl_per_sym_ul'] = 1024 * caps['max_ul_ctrl_1kwords'] // 2
+    assert lib.xorif_set_cc_config(2, config) == const.XORIF_SUCCESS
+    assert lib.xorif_configure_cc_hot_add(2) == const.XORIF_BUFFER_SPACE_EXCEEDED
+
+    # Nothing released, allocated or written (CC#2 keeps its existing placement)
+    assert [lib.xorif_get_fhi_cc_alloc(cc) for cc in range(3)] == allocs
+    if "EXTRA_DEBUG" in lib.constants:
+        for cc in range(3):
+            assert c_lib.xorif_test_cc_reg_writes(cc) == 0
+
+@pytest.mark.skipif("EXTRA_DEBUG" not in lib.constants, reason="No test code to count table writes")
+def test_ru_ports_table_shadow():
+    """Check that only changed RU port table entries are written, and readback verification."""
+    assert lib.xorif_get_state() == 1
+    if caps['ru_ports_map_width'] == 0:
+        pytest.skip("No RU port mapping table")
+    size = 1 << caps['ru_ports_map_width']
+
+    # First clear writes everything, second writes nothing
+    assert lib.xorif_clear_ru_ports_table() == const.XORIF_SUCCESS
+    c_lib.xorif_test_ru_ports_table_writes(1)
+    assert lib.xorif_clear_ru_ports_table() == const.XORIF_SUCCESS
+    assert c_lib.xorif_test_ru_ports_table_writes(1) == 0
+
+    # Bulk write of 64 entries, then re-write with 4 changes
+    table = [{'port': i % 16, 'type': i // 16, 'ccid': i % 4} for i in range(64)]
+    assert lib.xorif_set_ru_ports_table_bulk(0, table) == const.XORIF_SUCCESS
+    assert c_lib.xorif_test_ru_ports_table_writes(1) == 64
+    for i in (0, 10, 20, 63):
+        table[i]['port'] = 31
+    assert lib.xorif_set_ru_ports_table_bulk(0, table) == const.XORIF_SUCCESS
+    assert c_lib.xorif_test_ru_ports_table_writes(1) == 4
+
+    # The single-entry APIs share the same record
+    assert lib.xorif_set_ru_ports_table(0, 31, 0, 1) == const.XORIF_SUCCESS
+    assert c_lib.xorif_test_ru_ports_table_writes(1) == 0
+    assert lib.xorif_set_ru_ports_table_vcc(1, 1, 0, 1, 1) == const.XORIF_SUCCESS
+    assert c_lib.xorif_test_ru_ports_table_writes(1) == 0
+
+    # Read back matches
+    assert lib.xorif_verify_ru_ports_table() == (const.XORIF_SUCCESS, 0)
+
+    # Corrupt 2 entries, verification finds them, and the next write restores them
+    c_lib.xorif_test_set_fake_ru_port(5, 0)
+    c_lib.xorif_test_set_fake_ru_port(size - 1, 0)
+    assert lib.xorif_verify_ru_ports_table() == (const.XORIF_INVALID_RU_PORT_MAPPING, 2)
+    assert lib.xorif_set_ru_ports_table_bulk(0, table) == const.XORIF_SUCCESS
+    assert c_lib.xorif_test_ru_ports_table_writes(1) == 1
+    assert lib.xorif_clear_ru_ports_table() == const.XORIF_SUCCESS
+    assert lib.xorif_verify_ru_ports_table() == (const.XORIF_SUCCESS, 0)
+
+    # A reset may clear the table, so everything is written again afterwards
+    assert lib.xorif_reset_fhi(0) == const.XORIF_SUCCESS
+    c_lib.xorif_test_ru_ports_table_writes(1)
+    assert lib.xorif_clear_ru_ports_table() == const.XORIF_SUCCESS
+    assert c_lib.xorif_test_ru_ports_table_writes(1) == size
+
+@pytest.mark.skipif("EXTRA_DEBUG" not in lib.constants, reason="No test code to count table writes")
+def test_modu_table_shadow():
+    """Check per-port multi-O-DU tables, and that only changed entries are written."""
+    assert lib.xorif_get_state() == 1
+    num_ports = caps['num_eth_ports']
+
+    # Different table for each port
+    tables = [[{'address': f'02:00:00:00:{p:02x}:{du:02x}', 'id': 100 * p + du, 'dei': du % 2, 'pcp': du % 8}
+               for du in range(16)] for p in range(num_ports)]
+    c_lib.xorif_test_modu_table_writes(1)
+    for p in range(num_ports):
+        assert lib.xorif_set_modu_table(p, 0, tables[p]) == const.XORIF_SUCCESS
+    assert c_lib.xorif_test_modu_table_writes(1) == 16 * num_ports
+    for p in range(num_ports):
+        assert lib.xorif_get_modu_table(p, 0, 16) == (const.XORIF_SUCCESS, tables[p])
+
+    # Re-write with 2 changes on port 0
+    assert lib.xorif_set_modu_table(0, 0, tables[0]) == const.XORIF_SUCCESS
+    assert c_lib.xorif_test_modu_table_writes(1) == 0
+    tables[0][3]['pcp'] = 7
+    tables[0][15]['address'] = '02:ff:ff:ff:ff:ff'
+    assert lib.xorif_set_modu_table(0, 0, tables[0]) == const.XORIF_SUCCESS
+    assert c_lib.xorif_test_modu_table_writes(1) == 2
+    assert lib.xorif_get_modu_table(0, 14, 2) == (const.XORIF_SUCCESS, tables[0][14:16])
+
+    # The single-entry API (all ports) shares the same record
+    assert lib.xorif_set_modu_dest_mac_addr(3, tables[0][3]['address'], 300, 1, 7) == const.XORIF_SUCCESS
+    assert c_lib.xorif_test_modu_table_writes(1) == num_ports
+    assert lib.xorif_set_modu_dest_mac_addr(3, tables[0][3]['address'], 300, 1, 7) == const.XORIF_SUCCESS
+    assert c_lib.xorif_test_modu_table_writes(1) == 0
+    for p in range(num_ports):
+        result, table = lib.xorif_get_modu_table(p, 3, 1)
+        assert table[0] == {'address': tables[0][3]['address'], 'id': 300, 'dei': 1, 'pcp': 7}
+
+    # A reset may clear the tables, so the entries are written again afterwards
+    assert lib.xorif_reset_fhi(0) == const.XORIF_SUCCESS
+    c_lib.xorif_test_modu_table_writes(1)
+    assert lib.xorif_set_modu_table(0, 0, tables[0]) == const.XORIF_SUCCESS
+    assert c_lib.xorif_test_modu_table_writes(1) == 16
+
+    # Invalid values
+    assert lib.xorif_set_modu_table(num_ports, 0, tables[0]) == const.XORIF_INVALID_ETH_PORT
+    assert lib.xorif_set_modu_table(0, 1, tables[0]) == const.XORIF_INVALID_CONFIG
+    assert lib.xorif_get_modu_table(0, 16, 1)[0] == const.XORIF_INVALID_CONFIG
+    assert lib.xorif_set_modu_dest_mac_addr(16, '02:00:00:00:00:00') == const.XORIF_INVALID_CONFIG
+
+@pytest.mark.skipif("EXTRA_DEBUG" not in lib.constants, reason="No test code to change fake capabilities")
+def test_config_cc_16():
+    """Check 16 component carriers (simulated device)."""
+    global caps
+    assert lib.xorif_get_state() == 1
+
+    # Restart library with a 16 CC device
+    lib.xorif_finish()
+    assert c_lib.xorif_test_set_fake_max_cc(17) == const.XORIF_INVALID_CC
+    assert c_lib.xorif_test_set_fake_max_cc(16) == const.XORIF_SUCCESS
+    try:
+        assert lib.xorif_init() == const.XORIF_SUCCESS
+        caps16 = lib.xorif_get_capabilities()
+        assert caps16['max_cc'] == 16
+
+        # Configuration (no SSB, so all 16 fit in the simulated memories)
+        config = default_config()
+        config['num_rbs_ssb'] = 0
+
+        for cc in range(16):
+            assert lib.xorif_set_cc_config(cc, config) == const.XORIF_SUCCESS
+            assert lib.xorif_configure_cc(cc) == const.XORIF_SUCCESS
+            assert lib.xorif_enable_cc(cc) == const.XORIF_SUCCESS
+        assert lib.xorif_get_enabled_cc_mask() == 0xFFFF
+        assert lib.xorif_configure_cc(16) == const.XORIF_INVALID_CC
+        assert lib.xorif_enable_cc(16) == const.XORIF_INVALID_CC
+
+        # Per-CC registers of the top carrier
+        result, value = lib.xorif_read_fhi_reg_offset("ORAN_CC_NUMRBS", 15 * 0x70)
+        assert result == const.XORIF_SUCCESS
+        assert value == config['num_rbs']
+        result, alloc = lib.xorif_get_fhi_cc_alloc(15)
+        assert result == const.XORIF_SUCCESS
+        assert alloc['dl_data_ptrs_offset'] == 15
+
+        assert lib.xorif_disable_cc(15) == const.XORIF_SUCCESS
+        assert lib.xorif_get_enabled_cc_mask() == 0x7FFF
+        for cc in range(16):
+            assert lib.xorif_disable_cc(cc) == const.XORIF_SUCCESS
+        assert lib.xorif_get_enabled_cc_mask() == 0
+    finally:
+        # Restore the default device
+        lib.xorif_finish()
+        c_lib.xorif_test_set_fake_max_cc(8)
+        lib.xorif_init()
+        caps = lib.xorif_get_capabilities()
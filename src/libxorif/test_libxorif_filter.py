@@ -0,0 +1,216 @@
+#!/usr/bin/env python3
+
+import sys
+import logging
+import struct
+from collections import namedtuple
+import pytest
+
+sys.path.append('/usr/share/xorif')
+import pylibxorif
+
+lib = pylibxorif.LIBXORIF()
+lib.set_log_level(logging.DEBUG)
+lib.xorif_init()
+const = namedtuple("xorif_const", lib.constants.keys())(*lib.constants.values())
+caps = lib.xorif_get_capabilities()
+
+# Packet filter test harness: synthetic packets are written to pcap files, read
+# back, and checked against the compiled filter (emulating the de-framer, which
+# compares the first 64 bytes of the packet where the mask bit is 0)
+
+PCAP_MAGIC = 0xA1B2C3D4
+LINKTYPE_ETHERNET = 1
+
+
+def write_pcap(path, packets):
+    with open(path, 'wb') as f:
+        f.write(struct.pack('<IHHiIII', PCAP_MAGIC, 2, 4, 0, 0, 65535, LINKTYPE_ETHERNET))
+        for i, pkt in enumerate(packets):
+            f.write(struct.pack('<IIII', i, 0, len(pkt), len(pkt)))
+            f.write(pkt)
+
+
+def read_pcap(path):
+    packets = []
+    with open(path, 'rb') as f:
+        magic, _, _, _, _, _, linktype = struct.unpack('<IHHiIII', f.read(24))
+        assert magic == PCAP_MAGIC and linktype == LINKTYPE_ETHERNET
+        while True:
+            header = f.read(16)
+            if len(header) < 16:
+                break
+            _, _, caplen, _ = struct.unpack('<IIII', header)
+            packets.append(f.read(caplen))
+    return packets
+
+
+def filter_match(filter, mask, pkt):
+    for byte in range(64):
+        if not (mask[byte // 16] >> (byte % 16)) & 1:
+            value = (filter[byte // 4] >> (8 * (byte % 4))) & 0xFF
+            if byte >= len(pkt) or pkt[byte] != value:
+                return False
+    return True
+
+
+def make_packet(ethertype=None, vlan=None, ip=None, ip_protocol=17, ihl=5, udp_port=None,
+                transport='ecpri', msg_type=0, tc=0):
+    """Build a fronthaul packet; vlan = (id, pcp, dei), ip = None / 4 / 6."""
+    pkt = bytes.fromhex('001122334455') + bytes.fromhex('66778899aabb')
+    if vlan is not None:
+        vid, pcp, dei = vlan
+        pkt += struct.pack('>HH', 0x8100, (pcp << 13) | (dei << 12) | vid)
+    if ethertype is None:
+        ethertype = {None: 0xAEFE if transport == 'ecpri' else 0xFC3D, 4: 0x0800, 6: 0x86DD}[ip]
+    pkt += struct.pack('>H', ethertype)
+
+    if transport == 'ecpri':
+        payload = struct.pack('>BBH', 0x10, msg_type, 32) + bytes(32)
+    else:
+        payload = struct.pack('>BBHI', 0, 0, 32, 0) + bytes(32)
+
+    if ip is not None:
+        if ip_protocol == 17:
+            payload = struct.pack('>HHHH', 49152, udp_port or 0, 8 + len(payload), 0) + payload
+        if ip == 4:
+            options = bytes(4 * (ihl - 5))
+            pkt += struct.pack('>BBHHHBBH4s4s', 0x40 | ihl, 0, 20 + len(options) + len(payload), 0, 0,
+                               64, ip_protocol, 0, bytes(4), bytes(4)) + options
+        else:
+            pkt += struct.pack('>IHBB16s16s', (6 << 28) | (tc << 20), len(payload), ip_protocol, 64,
+                               bytes(16), bytes(16))
+    return pkt + payload
+
+
+def check_pcap(tmp_path, name, match, packets):
+    """Compile the filter, write (packet, expected) list to pcap, read back and check."""
+    result, filter, mask, exact = lib.xorif_compile_packet_filter(match)
+    assert result == const.XORIF_SUCCESS
+    path = tmp_path / f'{name}.pcap'
+    write_pcap(path, [p for p, _ in packets])
+    for pkt, (_, expected) in zip(read_pcap(path), packets):
+        if exact or expected:
+            assert filter_match(filter, mask, pkt) == expected
+    return exact
+
+
+def test_packet_filter_raw():
+    """Check the Raw mode filters are unchanged from the original defaults."""
+    legacy = {(const.PROTOCOL_ECPRI, 0): ({3: 0xFFFFFEAE}, [0xCFFF, 0xFFFF, 0xFFFF, 0xFFFF]),
+              (const.PROTOCOL_ECPRI, 1): ({3: 0xFFFF0081, 4: 0xFFFFFEAE}, [0xCFFF, 0xFFFC, 0xFFFF, 0xFFFF]),
+              (const.PROTOCOL_IEEE_1914_3, 0): ({3: 0xFFFF3DFC}, [0xCFFF, 0xFFFF, 0xFFFF, 0xFFFF]),
+              (const.PROTOCOL_IEEE_1914_3, 1): ({3: 0xFFFF0081, 4: 0xFFFF3DFC}, [0xCFFF, 0xFFFC, 0xFFFF, 0xFFFF])}
+    for (transport, vlan), (words, mask) in legacy.items():
+        match = {'transport': transport, 'ip_mode': const.IP_MODE_RAW, 'vlan': vlan}
+        result, f, m, exact = lib.xorif_compile_packet_filter(match)
+        assert result == const.XORIF_SUCCESS
+        assert exact == 1
+        assert f == [words.get(i, 0xFFFFFFFF) for i in range(16)]
+        assert m == mask
+
+
+def test_packet_filter_ecpri_vlan(tmp_path):
+    """eCPRI, VLAN, Raw, with VLAN ID / PCP and message type."""
+    match = {'transport': const.PROTOCOL_ECPRI, 'ip_mode': const.IP_MODE_RAW, 'vlan': 1,
+             'fields': const.PKT_MATCH_VLAN_ID | const.PKT_MATCH_VLAN_PCP | const.PKT_MATCH_ECPRI_MSG_TYPE,
+             'vlan_id': 0x123, 'vlan_pcp': 7, 'vlan_dei': 0, 'ecpri_msg_type': 2}
+    packets = [(make_packet(vlan=(0x123, 7, 0), msg_type=2), True),
+               (make_packet(vlan=(0x124, 7, 0), msg_type=2), False),
+               (make_packet(vlan=(0x023, 7, 0), msg_type=2), False),
+               (make_packet(vlan=(0x123, 5, 0), msg_type=2), False),
+               (make_packet(vlan=(0x123, 7, 0), msg_type=0), False),
+               (make_packet(msg_type=2), False),
+               (make_packet(vlan=(0x123, 7, 0), transport='1914.3'), False),
+               (make_packet(vlan=(0x123, 7, 0), ethertype=0x0806), False)]
+    assert check_pcap(tmp_path, 'ecpri_vlan', match, packets) == 1
+
+    # VLAN ID without PCP can only be partly matched
+    match['fields'] = const.PKT_MATCH_VLAN_ID
+    packets = [(make_packet(vlan=(0x123, 7, 0)), True),
+               (make_packet(vlan=(0x123, 3, 1)), True),
+               (make_packet(vlan=(0x124, 7, 0)), False)]
+    assert check_pcap(tmp_path, 'ecpri_vlan_id', match, packets) == 0
+
+
+def test_packet_filter_ipv4(tmp_path):
+    """eCPRI over IPv4 / UDP."""
+    match = {'transport': const.PROTOCOL_ECPRI, 'ip_mode': const.IP_MODE_IPV4, 'vlan': 0,
+             'fields': const.PKT_MATCH_UDP_PORT | const.PKT_MATCH_ECPRI_MSG_TYPE,
+             'udp_port': 0x1234, 'ecpri_msg_type': 0}
+    packets = [(make_packet(ip=4, udp_port=0x1234), True),
+               (make_packet(ip=4, udp_port=0x1235), False),
+               (make_packet(ip=4, udp_port=0x3412), False),
+               (make_packet(ip=4, udp_port=0x1234, msg_type=2), False),
+               (make_packet(ip=4, udp_port=0x1234, ihl=6), False),
+               (make_packet(ip=4, ip_protocol=6), False),
+               (make_packet(ip=6, udp_port=0x1234), False),
+               (make_packet(udp_port=0x1234), False)]
+    assert check_pcap(tmp_path, 'ecpri_ipv4', match, packets) == 1
+
+    # With VLAN
+    match['vlan'] = 1
+    packets = [(make_packet(ip=4, vlan=(10, 0, 0), udp_port=0x1234), True),
+               (make_packet(ip=4, udp_port=0x1234), False)]
+    assert check_pcap(tmp_path, 'ecpri_vlan_ipv4', match, packets) == 1
+
+
+def test_packet_filter_ipv6(tmp_path):
+    """eCPRI over IPv6 / UDP (message type is beyond the filter with VLAN)."""
+    match = {'transport': const.PROTOCOL_ECPRI, 'ip_mode': const.IP_MODE_IPV6, 'vlan': 0,
+             'fields': const.PKT_MATCH_UDP_PORT | const.PKT_MATCH_ECPRI_MSG_TYPE,
+             'udp_port': 5000, 'ecpri_msg_type': 0}
+    packets = [(make_packet(ip=6, udp_port=5000), True),
+               (make_packet(ip=6, udp_port=5000, tc=0xB8), True),
+               (make_packet(ip=6, udp_port=5001), False),
+               (make_packet(ip=6, udp_port=5000, msg_type=1), False),
+               (make_packet(ip=6, ip_protocol=6), False),
+               (make_packet(ip=4, udp_port=5000), False)]
+    assert check_pcap(tmp_path, 'ecpri_ipv6', match, packets) == 1
+
+    match['vlan'] = 1
+    packets = [(make_packet(ip=6, vlan=(10, 0, 0), udp_port=5000), True),
+               (make_packet(ip=6, vlan=(10, 0, 0), udp_port=5000, msg_type=1), True),
+               (make_packet(ip=6, vlan=(10, 0, 0), udp_port=5001), False)]
+    assert check_pcap(tmp_path, 'ecpri_vlan_ipv6', match, packets) == 0
+
+
+def test_packet_filter_ip_protocol(tmp_path):
+    """IEEE 1914.3 over IPv4, matching IP protocol only."""
+    match = {'transport': const.PROTOCOL_IEEE_1914_3, 'ip_mode': const.IP_MODE_IPV4, 'vlan': 0,
+             'fields': const.PKT_MATCH_IP_PROTOCOL, 'ip_protocol': 6}
+    packets = [(make_packet(ip=4, ip_protocol=6, transport='1914.3'), True),
+               (make_packet(ip=4, ip_protocol=17, transport='1914.3'), False)]
+    assert check_pcap(tmp_path, 'roe_ipv4', match, packets) == 1
+
+
+def test_packet_filter_errors():
+    """Check inconsistent specifications are rejected."""
+    bad_list = [{'transport': 2, 'ip_mode': const.IP_MODE_RAW},
+                {'transport': const.PROTOCOL_ECPRI, 'ip_mode': 2},
+                {'transport': const.PROTOCOL_ECPRI, 'ip_mode': const.IP_MODE_RAW, 'vlan': 0,
+                 'fields': const.PKT_MATCH_VLAN_ID},
+                {'transport': const.PROTOCOL_ECPRI, 'ip_mode': const.IP_MODE_RAW,
+                 'fields': const.PKT_MATCH_UDP_PORT},
+                {'transport': const.PROTOCOL_IEEE_1914_3, 'ip_mode': const.IP_MODE_RAW,
+                 'fields': const.PKT_MATCH_ECPRI_MSG_TYPE},
+                {'transport': const.PROTOCOL_ECPRI, 'ip_mode': const.IP_MODE_IPV4,
+                 'fields': const.PKT_MATCH_IP_PROTOCOL, 'ip_protocol': 6}]
+    for match in bad_list:
+        result, _, _, _ = lib.xorif_compile_packet_filter(match)
+        assert result == const.XORIF_INVALID_CONFIG
+
+
+def test_packet_filter_protocol_api():
+    """Check xorif_set_fhi_protocol() programs the compiled filter for IP modes."""
+    assert lib.xorif_set_fhi_protocol(const.PROTOCOL_ECPRI, 1, const.IP_MODE_IPV4) == const.XORIF_SUCCESS
+    match = {'transport': const.PROTOCOL_ECPRI, 'ip_mode': const.IP_MODE_IPV4, 'vlan': 1}
+    result, filter, mask, exact = lib.xorif_compile_packet_filter(match)
+    for port in range(caps['num_eth_ports']):
+        for i in range(4):
+            for j in range(4):
+                addr = 0x6100 + port * 0x100 + i * 0x20 + j * 4
+                assert lib.xorif_read_fhi_reg(f'0x{addr:04X}') == (const.XORIF_SUCCESS, filter[i * 4 + j])
+            addr = 0x6100 + port * 0x100 + i * 0x20 + 16
+            assert lib.xorif_read_fhi_reg(f'0x{addr:04X}') == (const.XORIF_SUCCESS, mask[i])
+    assert lib.xorif_set_fhi_protocol(const.PROTOCOL_ECPRI, 0, const.IP_MODE_RAW) == const.XORIF_SUCCESS
@@ -55,8 +55,9 @@ xocp_state_t xocp_state[XOCP_NUM_INSTANCES];
 #ifndef NO_HW
 int xorif_retrieve_device_info(struct metal_device **dev, struct metal_io_region **io);
 #endif
-typedef void (*ocp_callback_t)(uint16_t instance);
-void xorif_register_ocp(ocp_callback_t callback);
+typedef uint32_t (*ocp_status_t)(uint16_t instance);
+typedef void (*ocp_callback_t)(uint16_t instance, uint32_t status);
+void xorif_register_ocp(ocp_status_t status, ocp_callback_t callback);
 void xorif_deregister_ocp(void);
 
 /****************************/
@@ -265,38 +266,39 @@ static int program_schedule(int instance,
 }
 
 /**
- * @brief Interrupt handler for the device.
- * @param id IRQ identity
- * @param data Driver data
+ * @brief Read the interrupt status for the device (called from the shared interrupt handler).
+ * @param instance Driver instance
  * @returns
- *      - METAL_IRQ_HANDLED if the interrupt was handled
- *      - METAL_IRQ_NOT_HANDLED if the interrupt was not handled
+ *      - Interrupt status (0 if there are no events pending)
  */
-void xocp_irq_handler(uint16_t instance)
+uint32_t xocp_irq_status(uint16_t instance)
 {
-    TRACE("xocp_irq_handler(%d)\n", instance);
-    ASSERT_V(instance < XOCP_NUM_INSTANCES);
+    return RD_REG_ALT(instance, ISR_STATUS);
+}
 
+/**
+ * @brief Interrupt handler for the device (called from the shared interrupt handler).
+ * @param instance Driver instance
+ * @param isr_status Interrupt status (as read by #xocp_irq_status)
+ * @note
+ * Called only when there are events pending. There is no logging in the
+ * interrupt path (the shared handler defers it).
+ */
+void xocp_irq_handler(uint16_t instance, uint32_t isr_status)
+{
     xocp_state_t *ptr = &xocp_state[instance];
 
-    // Read and store the latest event status
-    uint32_t isr_status = RD_REG_ALT(ptr->instance, ISR_STATUS);
+    // Store the latest event status
+    ptr->events |= isr_status;
 
-    if (isr_status)
+    if (ptr->callback)
     {
-        ptr->events |= isr_status;
-
-        INFO("ISR status = 0x%X\n", isr_status);
-
-        if (ptr->callback)
-        {
-            ptr->callback(ptr->instance, isr_status);
-        }
-
-        // Clear all interrupts by toggling master enable
-        WR_REG(ptr->instance, OPXXCH_CFG_CHAN_PROC_MASTER_INT_ENABLE, 0);
-        WR_REG(ptr->instance, OPXXCH_CFG_CHAN_PROC_MASTER_INT_ENABLE, 1);
+        ptr->callback(ptr->instance, isr_status);
     }
+
+    // Clear all interrupts by toggling master enable
+    WR_REG(ptr->instance, OPXXCH_CFG_CHAN_PROC_MASTER_INT_ENABLE, 0);
+    WR_REG(ptr->instance, OPXXCH_CFG_CHAN_PROC_MASTER_INT_ENABLE, 1);
 }
 
 void xocp_debug(uint16_t level)
@@ -308,6 +310,7 @@ void xocp_debug(uint16_t level)
 int xocp_start(void)
 {
     TRACE("xocp_start()\n");
+    SPAN_SCOPE(__func__, "ocp", NULL, 0);
 
     xocp_state_t *ptr = NULL;
     int instance;
@@ -342,7 +345,7 @@ int xocp_start(void)
 #endif
 
     // Register the OCP with the ORIF
-    xorif_register_ocp(xocp_irq_handler);
+    xorif_register_ocp(xocp_irq_status, xocp_irq_handler);
 
     // Initialize the driver instance
     initialize_instance(ptr);
@@ -610,6 +613,7 @@ int xocp_write_reg_offset(uint16_t instance,
 int xocp_reset(uint16_t instance, uint8_t mode)
 {
     TRACE("xocp_reset(%d, %d)\n", instance, mode);
+    SPAN_SCOPE(__func__, "ocp", "instance", instance);
     ASSERT_NV(instance < XOCP_NUM_INSTANCES, XOCP_INVALID_INSTANCE);
     xocp_state_t *ptr = &xocp_state[instance];
     ASSERT_NV(ptr->state != XOCP_IDLE, XOCP_INVALID_STATE);
@@ -667,6 +671,7 @@ int xocp_set_cc_cfg(uint16_t instance,
                     const struct xocp_cc_data *data)
 {
     TRACE("xocp_set_cc_cfg(%d, %d, ...)\n", instance, cc);
+    SPAN_SCOPE(__func__, "ocp", "cc", cc);
     ASSERT_NV(instance < XOCP_NUM_INSTANCES, XOCP_INVALID_INSTANCE);
     xocp_state_t *ptr = &xocp_state[instance];
     ASSERT_NV(ptr->state != XOCP_IDLE, XOCP_INVALID_STATE);
@@ -705,6 +710,7 @@ int xocp_set_antenna_cfg(uint16_t instance,
                          const struct xocp_antenna_data *data)
 {
     TRACE("xocp_set_antenna_cfg(%d, ...)\n", instance);
+    SPAN_SCOPE(__func__, "ocp", "instance", instance);
     ASSERT_NV(instance < XOCP_NUM_INSTANCES, XOCP_INVALID_INSTANCE);
     xocp_state_t *ptr = &xocp_state[instance];
     ASSERT_NV(ptr->state != XOCP_IDLE, XOCP_INVALID_STATE);
@@ -730,6 +736,7 @@ int xocp_set_schedule(uint16_t instance,
                       const uint8_t sequence[])
 {
     TRACE("xocp_set_schedule(%d, %d, %d, ...)\n", instance, mode, length);
+    SPAN_SCOPE(__func__, "ocp", "length", length);
     ASSERT_NV(instance < XOCP_NUM_INSTANCES, XOCP_INVALID_INSTANCE);
     xocp_state_t *ptr = &xocp_state[instance];
     ASSERT_NV(ptr->state == XOCP_OPERATIONAL, XOCP_INVALID_STATE);
@@ -751,6 +758,7 @@ int xocp_set_schedule(uint16_t instance,
     {
         // Schedule DL
         INFO("Scheduling DL...\n");
+        SPAN_PHASE("program_schedule_dl", "ocp");
         result = program_schedule(instance, true, length, sequence);
         if (result != XOCP_SUCCESS)
         {
@@ -762,6 +770,7 @@ int xocp_set_schedule(uint16_t instance,
     {
         // Schedule UL
         INFO("Scheduling UL...\n");
+        SPAN_PHASE("program_schedule_ul", "ocp");
         result = program_schedule(instance, false, length, sequence);
         if (result != XOCP_SUCCESS)
         {
@@ -800,6 +809,7 @@ int xocp_set_trigger_cfg(uint16_t instance,
                          const struct xocp_triggers *triggers)
 {
     TRACE("xocp_set_trigger_cfg(%d, ...)\n", instance);
+    SPAN_SCOPE(__func__, "ocp", "instance", instance);
     ASSERT_NV(instance < XOCP_NUM_INSTANCES, XOCP_INVALID_INSTANCE);
     xocp_state_t *ptr = &xocp_state[instance];
     ASSERT_NV(ptr->state != XOCP_IDLE, XOCP_INVALID_STATE);
@@ -817,6 +827,7 @@ int xocp_set_trigger_cfg(uint16_t instance,
 int xocp_trigger_update(uint16_t instance)
 {
     TRACE("xocp_trigger_update(%d)\n", instance);
+    SPAN_SCOPE(__func__, "ocp", "instance", instance);
     ASSERT_NV(instance < XOCP_NUM_INSTANCES, XOCP_INVALID_INSTANCE);
     xocp_state_t *ptr = &xocp_state[instance];
     ASSERT_NV(ptr->state == XOCP_OPERATIONAL, XOCP_INVALID_STATE);
@@ -125,6 +125,17 @@
 #define ASSERT_NV(expression, value) assert(expression)
 #endif
 
+// Timeline spans (captured by the ORIF, when integrated)
+#ifdef INTEGRATED_OCP
+#include "xorif_timeline.h"
+#define SPAN_REG_WRITE() xorif_span_reg_write()
+#else
+#define SPAN_SCOPE(name, category, arg_name, arg)
+#define SPAN_PHASE(name, category)
+#define SPAN_PHASE_END()
+#define SPAN_REG_WRITE()
+#endif
+
 /**
  * @brief Structure typedef for holding driver instance state data.
  */
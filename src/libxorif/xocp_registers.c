@@ -165,6 +165,7 @@ void xocp_write_reg_internal(void *io,
     metal_io_write32((struct metal_io_region *)io, addr, x);
 #endif
 
+    SPAN_REG_WRITE();
     TRACE("WRITE_REG: %s (0x%04X)[%d:%d] <= 0x%X (%u)\n", name, addr, shift + width - 1, shift, value, value);
 }
 
@@ -0,0 +1,992 @@
+/*
+ * Copyright 2020 - 2023 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file xorif_alarms.c
+ * @author Steven Dickinson
+ * @brief Source file for libxorif alarm event functions (event queue, per-alarm counters, reaction policy, storm detection, deferred interrupt log and interrupt statistics).
+ * @addtogroup libxorif
+ * @{
+ */
+
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include "xorif_common.h"
+#include "xorif_registers.h"
+#include "xorif_alarms.h"
+
+// Per-alarm counters (written by the producer, cleared by the application)
+static struct
+{
+    uint64_t interrupts;            // Number of alarm interrupts (with non-zero status)
+    uint32_t count[NUM_ALARM_BITS]; // Occurrences per alarm bit
+    uint64_t last[NUM_ALARM_BITS];  // Time of the latest occurrence per alarm bit (ns)
+    uint32_t cc_disables;           // Policy actions taken...
+    uint32_t deframer_restarts;
+    uint32_t resets;
+    uint32_t suppressed;            // Log messages suppressed by rate-limiting
+} alarm_counts;
+
+// Alarm names (for logging)
+static const struct
+{
+    uint32_t mask;
+    const char *name;
+} alarm_names[] = {
+    {CFG_DEFM_INT_INFIFO_OF_MASK, "CFG_DEFM_INT_INFIFO_OF"},
+    {CFG_DEFM_INT_INFIFO_UF_MASK, "CFG_DEFM_INT_INFIFO_UF"},
+    {CFG_DEFM_INT_ETH_PIPE_C_BUF_OF_MASK, "CFG_DEFM_INT_ETH_PIPE_C_BUF_OF"},
+    {CFG_DEFM_INT_ETH_PIPE_TABLE_OF_MASK, "CFG_DEFM_INT_ETH_PIPE_TABLE_OF"},
+    {CFG_FRAM_INT_OUTFIFO_OF_MASK, "CFG_FRAM_INT_OUTFIFO_OF"},
+    {CFG_FRAM_INT_OUTFIFO_UF_MASK, "CFG_FRAM_INT_OUTFIFO_UF"},
+    {CFG_FRAM_INT_PRACH_SECTION_OVERFLOW_MASK, "CFG_FRAM_INT_PRACH_SECTION_OVERFLOW"},
+    {CFG_FRAM_INT_PRACH_SECTION_NOTFOUND_MASK, "CFG_FRAM_INT_PRACH_SECTION_NOTFOUND"},
+    {CFG_FRAM_INT_ENA_SECTION_OF_MASK, "CFG_FRAM_INT_ENA_SECTION_OF"},
+};
+#define NUM_ALARM_NAMES (sizeof(alarm_names) / sizeof(alarm_names[0]))
+
+// Alarm reaction policy (written by the application, read by the interrupt handler)
+static struct
+{
+    uint16_t action;     // Action (see enum xorif_alarm_action)
+    uint16_t cc_mask;    // Component carriers to disable
+    uint64_t log_time;   // Time of the previous log message (ns)
+    uint32_t suppressed; // Log messages suppressed since the previous one
+} alarm_policy[NUM_ALARM_BITS] = {[0 ... NUM_ALARM_BITS - 1] = {.action = ALARM_ACTION_RESET}};
+
+// Alarm event queue (lock-free, single producer / single consumer)
+// The producer (interrupt handler) only writes "head", the consumer only writes "tail"
+static struct
+{
+    pthread_mutex_t lock;                             // Serializes open / close / consumers (not used by the producer)
+    int fd;                                           // Event file descriptor (or -1 when closed)
+    int busy;                                         // Producer is using the queue
+    uint32_t head;                                    // Producer index (free running)
+    uint32_t tail;                                    // Consumer index (free running)
+    uint32_t seq;                                     // Sequence number for the next event
+    uint32_t dropped;                                 // Events lost since the previous read
+    struct xorif_alarm_event events[ALARM_QUEUE_SIZE]; // Event buffer
+} queue = {.lock = PTHREAD_MUTEX_INITIALIZER, .fd = -1};
+
+// Alarm storm detection (used by the interrupt handler, the alarm thread and the application)
+// The interrupt handler only uses atomics, and is the only writer of the detection state
+static struct
+{
+    pthread_mutex_t lock;                  // Serializes the application and the alarm thread (not used by the interrupt handler)
+    pthread_t thread;                      // Alarm thread (prints the deferred log, and re-enables the masked alarms)
+    int fd;                                // Event file descriptor to wake the alarm thread (-1 until the first start, then kept open)
+    int running;                           // Alarm thread is running
+    int stop;                              // Request to stop the alarm thread (atomic)
+    uint32_t threshold;                    // Occurrences within the window that start a storm (0 = disabled) (atomic)
+    uint32_t window_ms;                    // Detection window (atomic)
+    uint32_t backoff_ms;                   // Initial back-off period (atomic)
+    uint32_t config;                       // Incremented when the above are set (atomic)
+    uint32_t config_seen;                  // Configuration the detection state was last reset for
+    uint32_t enable;                       // Interrupt enable mask (set by the application) (atomic)
+    uint32_t masked;                       // Alarms currently masked (atomic)
+    uint64_t window_start[NUM_ALARM_BITS]; // Start of the current detection window (ns)
+    uint32_t window_count[NUM_ALARM_BITS]; // Occurrences in the current detection window
+    uint32_t backoff[NUM_ALARM_BITS];      // Current back-off period (ms) (atomic)
+    uint64_t mask_time[NUM_ALARM_BITS];    // Time the alarm was masked (ns) (atomic)
+    uint64_t unmask_time[NUM_ALARM_BITS];  // Time to re-enable the alarm, then the time it was re-enabled (ns) (atomic)
+    uint32_t storms[NUM_ALARM_BITS];       // Number of storms (atomic)
+    uint32_t coalesced[NUM_ALARM_BITS];    // Occurrences coalesced (atomic)
+    uint64_t masked_total[NUM_ALARM_BITS]; // Total time masked (ns), completed storms (protected by the lock)
+    uint32_t pending[NUM_ALARM_BITS];      // Occurrences coalesced since the previous event (atomic)
+} storm = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .fd = -1,
+    .threshold = ALARM_STORM_THRESHOLD,
+    .window_ms = ALARM_STORM_WINDOW,
+    .backoff_ms = ALARM_STORM_BACKOFF,
+};
+
+// Deferred interrupt log (lock-free, single producer / single consumer)
+// The interrupt handler records the messages, and the alarm thread prints them
+static struct
+{
+    uint32_t head;     // Producer index (free running)
+    uint32_t tail;     // Consumer index (free running)
+    uint32_t notified; // Producer index when the alarm thread was last woken
+    uint32_t dropped;  // Messages lost (log full)
+    struct
+    {
+        uint64_t timestamp; // Time of the interrupt (ns)
+        uint16_t type;      // Message type (see enum irq_log_type)
+        uint16_t bit;       // Alarm bit number
+        uint32_t value;     // Message value
+    } entries[IRQ_LOG_SIZE];
+} irq_log;
+
+// Interrupt statistics (written by the interrupt handler, cleared by the application)
+static struct
+{
+    uint64_t interrupts;                   // Number of interrupts
+    uint64_t fhi;                          // Interrupts with FHI alarms pending
+    uint64_t ocp;                          // Interrupts with OCP events pending
+    uint64_t spurious;                     // Interrupts with nothing pending
+    uint64_t total_ns;                     // Total handler latency
+    uint32_t min_ns;                       // Minimum handler latency
+    uint32_t max_ns;                       // Maximum handler latency
+    uint32_t last_ns;                      // Latest handler latency
+    uint32_t histogram[IRQ_LATENCY_BINS]; // Handler latency histogram
+} irq_stats = {.min_ns = UINT32_MAX};
+
+// Local function prototypes...
+
+static const char *alarm_name(int bit);
+static uint64_t time_ns(void);
+static void write_enable(void);
+static void unmask_alarms(uint32_t alarms, uint64_t now);
+static void wake_thread(void);
+static void flush_irq_log(void);
+static void *alarm_thread(void *arg);
+
+// API functions...
+
+int xorif_open_alarm_queue(int *fd)
+{
+    TRACE("xorif_open_alarm_queue(...)\n");
+
+    if (!fd)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+
+    pthread_mutex_lock(&queue.lock);
+    if (queue.fd < 0)
+    {
+        int efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (efd < 0)
+        {
+            pthread_mutex_unlock(&queue.lock);
+            PERROR("Failed to create alarm event file descriptor\n");
+            return XORIF_FAILURE;
+        }
+
+        // Start with an empty queue
+        uint32_t head = __atomic_load_n(&queue.head, __ATOMIC_ACQUIRE);
+        __atomic_store_n(&queue.tail, head, __ATOMIC_RELEASE);
+        __atomic_store_n(&queue.dropped, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&queue.fd, efd, __ATOMIC_RELEASE);
+        INFO("Alarm event queue opened\n");
+    }
+    *fd = queue.fd;
+    pthread_mutex_unlock(&queue.lock);
+
+    return XORIF_SUCCESS;
+}
+
+int xorif_close_alarm_queue(void)
+{
+    TRACE("xorif_close_alarm_queue()\n");
+
+    pthread_mutex_lock(&queue.lock);
+    int efd = __atomic_exchange_n(&queue.fd, -1, __ATOMIC_SEQ_CST);
+    if (efd >= 0)
+    {
+        // Wait for the producer to finish with the file descriptor
+        while (__atomic_load_n(&queue.busy, __ATOMIC_SEQ_CST))
+        {
+            sched_yield();
+        }
+        close(efd);
+        INFO("Alarm event queue closed\n");
+    }
+    pthread_mutex_unlock(&queue.lock);
+
+    return XORIF_SUCCESS;
+}
+
+int xorif_read_alarm_events(uint16_t max, struct xorif_alarm_event *events, uint16_t *num, uint32_t *dropped)
+{
+    TRACE("xorif_read_alarm_events(%d, ...)\n", max);
+
+    if (!events || !num)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+
+    pthread_mutex_lock(&queue.lock);
+    if (queue.fd < 0)
+    {
+        pthread_mutex_unlock(&queue.lock);
+        PERROR("Alarm event queue is not open\n");
+        return XORIF_NOT_SUPPORTED;
+    }
+
+    // Consume the notification first, so that later events notify again
+    uint64_t temp;
+    if (read(queue.fd, &temp, sizeof(temp)) < 0 && errno != EAGAIN)
+    {
+        PERROR("Failed to read alarm event file descriptor\n");
+    }
+
+    uint32_t tail = queue.tail;
+    uint32_t head = __atomic_load_n(&queue.head, __ATOMIC_ACQUIRE);
+    uint16_t n = 0;
+    while ((tail != head) && (n < max))
+    {
+        events[n++] = queue.events[tail % ALARM_QUEUE_SIZE];
+        ++tail;
+    }
+    __atomic_store_n(&queue.tail, tail, __ATOMIC_RELEASE);
+
+    if (tail != head)
+    {
+        // Events remain, so keep the file descriptor readable
+        temp = 1;
+        if (write(queue.fd, &temp, sizeof(temp)) < 0)
+        {
+            PERROR("Failed to write alarm event file descriptor\n");
+        }
+    }
+
+    *num = n;
+    uint32_t d = __atomic_exchange_n(&queue.dropped, 0, __ATOMIC_RELAXED);
+    if (dropped)
+    {
+        *dropped = d;
+    }
+    pthread_mutex_unlock(&queue.lock);
+
+    return XORIF_SUCCESS;
+}
+
+int xorif_get_fhi_alarm_counts(struct xorif_fhi_alarm_counts *ptr)
+{
+    TRACE("xorif_get_fhi_alarm_counts(...)\n");
+
+    if (!ptr)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+
+    ptr->interrupts = __atomic_load_n(&alarm_counts.interrupts, __ATOMIC_RELAXED);
+    for (int i = 0; i < NUM_ALARM_BITS; ++i)
+    {
+        ptr->count[i] = __atomic_load_n(&alarm_counts.count[i], __ATOMIC_RELAXED);
+        ptr->last[i] = __atomic_load_n(&alarm_counts.last[i], __ATOMIC_RELAXED);
+    }
+    ptr->cc_disables = __atomic_load_n(&alarm_counts.cc_disables, __ATOMIC_RELAXED);
+    ptr->deframer_restarts = __atomic_load_n(&alarm_counts.deframer_restarts, __ATOMIC_RELAXED);
+    ptr->resets = __atomic_load_n(&alarm_counts.resets, __ATOMIC_RELAXED);
+    ptr->suppressed = __atomic_load_n(&alarm_counts.suppressed, __ATOMIC_RELAXED);
+
+    return XORIF_SUCCESS;
+}
+
+void xorif_clear_fhi_alarm_counts(void)
+{
+    TRACE("xorif_clear_fhi_alarm_counts()\n");
+
+    __atomic_store_n(&alarm_counts.interrupts, 0, __ATOMIC_RELAXED);
+    for (int i = 0; i < NUM_ALARM_BITS; ++i)
+    {
+        __atomic_store_n(&alarm_counts.count[i], 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&alarm_counts.last[i], 0, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&alarm_counts.cc_disables, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&alarm_counts.deframer_restarts, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&alarm_counts.resets, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&alarm_counts.suppressed, 0, __ATOMIC_RELAXED);
+
+    pthread_mutex_lock(&storm.lock);
+    for (int i = 0; i < NUM_ALARM_BITS; ++i)
+    {
+        __atomic_store_n(&storm.storms[i], 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&storm.coalesced[i], 0, __ATOMIC_RELAXED);
+    }
+    memset(storm.masked_total, 0, sizeof(storm.masked_total));
+    pthread_mutex_unlock(&storm.lock);
+}
+
+int xorif_set_fhi_alarm_policy(uint32_t alarms, uint16_t action, uint16_t cc_mask)
+{
+    TRACE("xorif_set_fhi_alarm_policy(0x%X, %d, 0x%X)\n", alarms, action, cc_mask);
+
+    if ((alarms == 0) || (alarms & ~FHI_INTR_MASK))
+    {
+        PERROR("Invalid alarms (only interrupt alarms have a policy)\n");
+        return XORIF_INVALID_CONFIG;
+    }
+    else if (action > ALARM_ACTION_RESET)
+    {
+        PERROR("Invalid alarm action\n");
+        return XORIF_INVALID_CONFIG;
+    }
+
+    for (int i = 0; i < NUM_ALARM_BITS; ++i)
+    {
+        if (alarms & (1U << i))
+        {
+            __atomic_store_n(&alarm_policy[i].cc_mask, cc_mask, __ATOMIC_RELAXED);
+            __atomic_store_n(&alarm_policy[i].action, action, __ATOMIC_RELEASE);
+        }
+    }
+
+    return XORIF_SUCCESS;
+}
+
+int xorif_get_fhi_alarm_policy(uint32_t alarm, uint16_t *action, uint16_t *cc_mask)
+{
+    TRACE("xorif_get_fhi_alarm_policy(0x%X, ...)\n", alarm);
+
+    if (!action)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+    else if ((alarm & (alarm - 1)) || !(alarm & FHI_INTR_MASK))
+    {
+        PERROR("Invalid alarm (must be a single interrupt alarm)\n");
+        return XORIF_INVALID_CONFIG;
+    }
+
+    int i = __builtin_ctz(alarm);
+    *action = __atomic_load_n(&alarm_policy[i].action, __ATOMIC_ACQUIRE);
+    if (cc_mask)
+    {
+        *cc_mask = __atomic_load_n(&alarm_policy[i].cc_mask, __ATOMIC_RELAXED);
+    }
+
+    return XORIF_SUCCESS;
+}
+
+int xorif_set_fhi_alarm_storm(uint32_t threshold, uint32_t window_ms, uint32_t backoff_ms)
+{
+    TRACE("xorif_set_fhi_alarm_storm(%d, %d, %d)\n", threshold, window_ms, backoff_ms);
+
+    if (threshold && ((window_ms == 0) || (backoff_ms == 0)))
+    {
+        PERROR("Invalid alarm storm window / back-off\n");
+        return XORIF_INVALID_CONFIG;
+    }
+
+    pthread_mutex_lock(&storm.lock);
+    __atomic_store_n(&storm.threshold, threshold, __ATOMIC_RELAXED);
+    __atomic_store_n(&storm.window_ms, window_ms, __ATOMIC_RELAXED);
+    __atomic_store_n(&storm.backoff_ms, backoff_ms, __ATOMIC_RELAXED);
+
+    // The interrupt handler resets the detection state (windows and back-off periods)
+    __atomic_add_fetch(&storm.config, 1, __ATOMIC_RELEASE);
+    if (!threshold)
+    {
+        // Disabled, so re-enable any masked alarms
+        unmask_alarms(UINT32_MAX, time_ns());
+    }
+    pthread_mutex_unlock(&storm.lock);
+
+    return XORIF_SUCCESS;
+}
+
+int xorif_get_fhi_alarm_storm_stats(struct xorif_fhi_alarm_storm_stats *ptr)
+{
+    TRACE("xorif_get_fhi_alarm_storm_stats(...)\n");
+
+    if (!ptr)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+
+    pthread_mutex_lock(&storm.lock);
+    uint64_t now = time_ns();
+    ptr->masked = __atomic_load_n(&storm.masked, __ATOMIC_ACQUIRE);
+    for (int i = 0; i < NUM_ALARM_BITS; ++i)
+    {
+        ptr->storms[i] = __atomic_load_n(&storm.storms[i], __ATOMIC_RELAXED);
+        ptr->coalesced[i] = __atomic_load_n(&storm.coalesced[i], __ATOMIC_RELAXED);
+        ptr->masked_time[i] = storm.masked_total[i];
+        if (ptr->masked & (1U << i))
+        {
+            ptr->masked_time[i] += now - __atomic_load_n(&storm.mask_time[i], __ATOMIC_RELAXED);
+        }
+        ptr->backoff_ms[i] = __atomic_load_n(&storm.backoff[i], __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&storm.lock);
+
+    return XORIF_SUCCESS;
+}
+
+int xorif_get_irq_stats(struct xorif_irq_stats *ptr)
+{
+    TRACE("xorif_get_irq_stats(...)\n");
+
+    if (!ptr)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+
+    memset(ptr, 0, sizeof(struct xorif_irq_stats));
+    ptr->interrupts = __atomic_load_n(&irq_stats.interrupts, __ATOMIC_RELAXED);
+    ptr->fhi = __atomic_load_n(&irq_stats.fhi, __ATOMIC_RELAXED);
+    ptr->ocp = __atomic_load_n(&irq_stats.ocp, __ATOMIC_RELAXED);
+    ptr->spurious = __atomic_load_n(&irq_stats.spurious, __ATOMIC_RELAXED);
+    ptr->total_ns = __atomic_load_n(&irq_stats.total_ns, __ATOMIC_RELAXED);
+    ptr->min_ns = ptr->interrupts ? __atomic_load_n(&irq_stats.min_ns, __ATOMIC_RELAXED) : 0;
+    ptr->max_ns = __atomic_load_n(&irq_stats.max_ns, __ATOMIC_RELAXED);
+    ptr->last_ns = __atomic_load_n(&irq_stats.last_ns, __ATOMIC_RELAXED);
+    for (int i = 0; i < IRQ_LATENCY_BINS; ++i)
+    {
+        ptr->histogram[i] = __atomic_load_n(&irq_stats.histogram[i], __ATOMIC_RELAXED);
+    }
+    ptr->log_dropped = __atomic_load_n(&irq_log.dropped, __ATOMIC_RELAXED);
+
+    return XORIF_SUCCESS;
+}
+
+void xorif_clear_irq_stats(void)
+{
+    TRACE("xorif_clear_irq_stats()\n");
+
+    __atomic_store_n(&irq_stats.interrupts, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&irq_stats.fhi, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&irq_stats.ocp, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&irq_stats.spurious, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&irq_stats.total_ns, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&irq_stats.min_ns, UINT32_MAX, __ATOMIC_RELAXED);
+    __atomic_store_n(&irq_stats.max_ns, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&irq_stats.last_ns, 0, __ATOMIC_RELAXED);
+    for (int i = 0; i < IRQ_LATENCY_BINS; ++i)
+    {
+        __atomic_store_n(&irq_stats.histogram[i], 0, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&irq_log.dropped, 0, __ATOMIC_RELAXED);
+}
+
+// Internal functions...
+
+void xorif_alarm_storm_enable(uint32_t mask)
+{
+    __atomic_store_n(&storm.enable, mask, __ATOMIC_SEQ_CST);
+    write_enable();
+}
+
+uint32_t xorif_alarm_storm(uint32_t status, uint64_t timestamp)
+{
+    // Reset the detection state if the application has changed the configuration
+    uint32_t config = __atomic_load_n(&storm.config, __ATOMIC_ACQUIRE);
+    if (config != storm.config_seen)
+    {
+        storm.config_seen = config;
+        memset(storm.window_count, 0, sizeof(storm.window_count));
+        for (int i = 0; i < NUM_ALARM_BITS; ++i)
+        {
+            __atomic_store_n(&storm.backoff[i], 0, __ATOMIC_RELAXED);
+        }
+    }
+    uint32_t threshold = __atomic_load_n(&storm.threshold, __ATOMIC_RELAXED);
+    uint32_t window_ms = __atomic_load_n(&storm.window_ms, __ATOMIC_RELAXED);
+    uint32_t backoff_ms = __atomic_load_n(&storm.backoff_ms, __ATOMIC_RELAXED);
+
+    // Coalesce the masked alarms (which may still be latched in the status)
+    uint32_t coalesced = status & __atomic_load_n(&storm.masked, __ATOMIC_SEQ_CST);
+    uint32_t started = 0;
+    for (int i = 0; i < NUM_ALARM_BITS; ++i)
+    {
+        uint32_t bit = 1U << i;
+        if (coalesced & bit)
+        {
+            __atomic_fetch_add(&storm.coalesced[i], 1, __ATOMIC_RELAXED);
+            __atomic_fetch_add(&storm.pending[i], 1, __ATOMIC_RELAXED);
+            __atomic_fetch_add(&alarm_counts.count[i], 1, __ATOMIC_RELAXED);
+            __atomic_store_n(&alarm_counts.last[i], timestamp, __ATOMIC_RELAXED);
+        }
+        else if ((status & bit) && threshold)
+        {
+            // Count the occurrences in the detection window
+            if (timestamp - storm.window_start[i] > window_ms * 1000000ULL)
+            {
+                storm.window_start[i] = timestamp;
+                storm.window_count[i] = 0;
+            }
+            if (++storm.window_count[i] >= threshold)
+            {
+                // Storm: double the back-off if the previous storm ended recently
+                uint32_t backoff = __atomic_load_n(&storm.backoff[i], __ATOMIC_RELAXED);
+                uint64_t unmask_time = __atomic_load_n(&storm.unmask_time[i], __ATOMIC_RELAXED);
+                if (backoff && (timestamp - unmask_time <= 2 * backoff * 1000000ULL))
+                {
+                    backoff = (backoff < backoff_ms * ALARM_STORM_MAX_BACKOFF) ? 2 * backoff : backoff;
+                }
+                else
+                {
+                    backoff = backoff_ms;
+                }
+                __atomic_store_n(&storm.backoff[i], backoff, __ATOMIC_RELAXED);
+                __atomic_store_n(&storm.mask_time[i], timestamp, __ATOMIC_RELAXED);
+                __atomic_store_n(&storm.unmask_time[i], timestamp + backoff * 1000000ULL, __ATOMIC_RELAXED);
+                storm.window_count[i] = 0;
+                __atomic_fetch_add(&storm.storms[i], 1, __ATOMIC_RELAXED);
+                started |= bit;
+                IRQ_LOG(IRQ_LOG_STORM, i, backoff, timestamp);
+            }
+        }
+    }
+
+    if (started)
+    {
+        // Mask the alarms, and wake the alarm thread to re-enable them later
+        __atomic_fetch_or(&storm.masked, started, __ATOMIC_SEQ_CST);
+        write_enable();
+        wake_thread();
+    }
+
+    return status & ~coalesced;
+}
+
+int xorif_alarm_storm_init(void)
+{
+    int result = XORIF_SUCCESS;
+
+    pthread_mutex_lock(&storm.lock);
+    if (!storm.running)
+    {
+        if (storm.fd < 0)
+        {
+            int efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (efd < 0)
+            {
+                PERROR("Failed to create alarm thread file descriptor\n");
+                pthread_mutex_unlock(&storm.lock);
+                return XORIF_FAILURE;
+            }
+            __atomic_store_n(&storm.fd, efd, __ATOMIC_RELEASE);
+        }
+
+        __atomic_store_n(&storm.stop, 0, __ATOMIC_RELAXED);
+        storm.running = (pthread_create(&storm.thread, NULL, alarm_thread, NULL) == 0);
+        if (!storm.running)
+        {
+            PERROR("Failed to start alarm thread\n");
+            result = XORIF_FAILURE;
+        }
+    }
+    pthread_mutex_unlock(&storm.lock);
+
+    return result;
+}
+
+void xorif_alarm_storm_finish(void)
+{
+    pthread_mutex_lock(&storm.lock);
+    int running = storm.running;
+    storm.running = 0;
+    pthread_mutex_unlock(&storm.lock);
+
+    if (running)
+    {
+        __atomic_store_n(&storm.stop, 1, __ATOMIC_RELEASE);
+        wake_thread();
+        pthread_join(storm.thread, NULL);
+    }
+
+    // Print any remaining deferred log messages
+    flush_irq_log();
+
+    __atomic_store_n(&storm.masked, 0, __ATOMIC_SEQ_CST);
+}
+
+void xorif_alarm_event(uint32_t status, uint64_t timestamp)
+{
+    // Per-alarm counters
+    __atomic_fetch_add(&alarm_counts.interrupts, 1, __ATOMIC_RELAXED);
+    for (int i = 0; i < NUM_ALARM_BITS; ++i)
+    {
+        if (status & (1U << i))
+        {
+            __atomic_fetch_add(&alarm_counts.count[i], 1, __ATOMIC_RELAXED);
+            __atomic_store_n(&alarm_counts.last[i], timestamp, __ATOMIC_RELAXED);
+        }
+    }
+
+    // Queue the event (if the queue is open)
+    __atomic_store_n(&queue.busy, 1, __ATOMIC_SEQ_CST);
+    int efd = __atomic_load_n(&queue.fd, __ATOMIC_SEQ_CST);
+    if (efd >= 0)
+    {
+        uint32_t seq = queue.seq++;
+        uint32_t head = queue.head;
+        if (head - __atomic_load_n(&queue.tail, __ATOMIC_ACQUIRE) < ALARM_QUEUE_SIZE)
+        {
+            struct xorif_alarm_event *event = &queue.events[head % ALARM_QUEUE_SIZE];
+            event->timestamp = timestamp;
+            event->status = status;
+            event->seq = seq;
+            event->coalesced = 0;
+            for (int i = 0; i < NUM_ALARM_BITS; ++i)
+            {
+                if (status & (1U << i))
+                {
+                    event->coalesced += __atomic_exchange_n(&storm.pending[i], 0, __ATOMIC_RELAXED);
+                }
+            }
+            __atomic_store_n(&queue.head, head + 1, __ATOMIC_RELEASE);
+
+            // Notify the application (the eventfd counter cannot overflow in practice)
+            uint64_t one = 1;
+            ssize_t rc = write(efd, &one, sizeof(one));
+            (void)rc;
+        }
+        else
+        {
+            // Queue is full, so the event is lost
+            __atomic_fetch_add(&queue.dropped, 1, __ATOMIC_RELAXED);
+        }
+    }
+    __atomic_store_n(&queue.busy, 0, __ATOMIC_RELEASE);
+}
+
+uint32_t xorif_alarm_policy(uint32_t status, uint64_t timestamp, uint16_t *action, uint16_t *cc_mask)
+{
+    uint32_t recorded = 0;
+    *action = ALARM_ACTION_IGNORE;
+    *cc_mask = 0;
+
+    for (int i = 0; i < NUM_ALARM_NAMES; ++i)
+    {
+        if (status & alarm_names[i].mask)
+        {
+            int bit = __builtin_ctz(alarm_names[i].mask);
+            uint16_t a = __atomic_load_n(&alarm_policy[bit].action, __ATOMIC_ACQUIRE);
+            if (a != ALARM_ACTION_IGNORE)
+            {
+                recorded |= alarm_names[i].mask;
+            }
+            if (a == ALARM_ACTION_DISABLE_CC)
+            {
+                *cc_mask |= __atomic_load_n(&alarm_policy[bit].cc_mask, __ATOMIC_RELAXED);
+            }
+            *action = (a > *action) ? a : *action;
+
+            if (a >= ALARM_ACTION_LOG)
+            {
+                // Rate-limited log message
+                if (timestamp - alarm_policy[bit].log_time >= ALARM_LOG_INTERVAL)
+                {
+                    IRQ_LOG(IRQ_LOG_ALARM, bit, alarm_policy[bit].suppressed, timestamp);
+                    alarm_policy[bit].log_time = timestamp;
+                    alarm_policy[bit].suppressed = 0;
+                }
+                else
+                {
+                    ++alarm_policy[bit].suppressed;
+                    __atomic_fetch_add(&alarm_counts.suppressed, 1, __ATOMIC_RELAXED);
+                }
+            }
+        }
+    }
+
+    // Count the action (performed by the caller)
+    switch (*action)
+    {
+    case ALARM_ACTION_DISABLE_CC:
+        __atomic_fetch_add(&alarm_counts.cc_disables, 1, __ATOMIC_RELAXED);
+        break;
+
+    case ALARM_ACTION_RESTART_DEFRAMER:
+        __atomic_fetch_add(&alarm_counts.deframer_restarts, 1, __ATOMIC_RELAXED);
+        break;
+
+    case ALARM_ACTION_RESET:
+        __atomic_fetch_add(&alarm_counts.resets, 1, __ATOMIC_RELAXED);
+        break;
+
+    default:
+        break;
+    }
+
+    return recorded;
+}
+
+void xorif_irq_log(uint16_t type, uint16_t bit, uint32_t value, uint64_t timestamp)
+{
+    uint32_t head = irq_log.head;
+    if (head - __atomic_load_n(&irq_log.tail, __ATOMIC_ACQUIRE) >= IRQ_LOG_SIZE)
+    {
+        __atomic_fetch_add(&irq_log.dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    uint32_t index = head & (IRQ_LOG_SIZE - 1);
+    irq_log.entries[index].timestamp = timestamp;
+    irq_log.entries[index].type = type;
+    irq_log.entries[index].bit = bit;
+    irq_log.entries[index].value = value;
+    __atomic_store_n(&irq_log.head, head + 1, __ATOMIC_RELEASE);
+}
+
+void xorif_irq_log_notify(void)
+{
+    uint32_t head = irq_log.head;
+    if (head != irq_log.notified)
+    {
+        // Wake the alarm thread to print the new messages
+        irq_log.notified = head;
+        wake_thread();
+    }
+}
+
+void xorif_irq_stats_update(uint16_t sources, uint64_t entry, uint64_t exit)
+{
+    uint32_t latency = (exit - entry > UINT32_MAX) ? UINT32_MAX : (uint32_t)(exit - entry);
+
+    __atomic_fetch_add(&irq_stats.interrupts, 1, __ATOMIC_RELAXED);
+    if (sources & IRQ_SOURCE_FHI)
+    {
+        __atomic_fetch_add(&irq_stats.fhi, 1, __ATOMIC_RELAXED);
+    }
+    if (sources & IRQ_SOURCE_OCP)
+    {
+        __atomic_fetch_add(&irq_stats.ocp, 1, __ATOMIC_RELAXED);
+    }
+    if (!sources)
+    {
+        __atomic_fetch_add(&irq_stats.spurious, 1, __ATOMIC_RELAXED);
+    }
+
+    __atomic_fetch_add(&irq_stats.total_ns, latency, __ATOMIC_RELAXED);
+    __atomic_store_n(&irq_stats.last_ns, latency, __ATOMIC_RELAXED);
+    if (latency < __atomic_load_n(&irq_stats.min_ns, __ATOMIC_RELAXED))
+    {
+        __atomic_store_n(&irq_stats.min_ns, latency, __ATOMIC_RELAXED);
+    }
+    if (latency > __atomic_load_n(&irq_stats.max_ns, __ATOMIC_RELAXED))
+    {
+        __atomic_store_n(&irq_stats.max_ns, latency, __ATOMIC_RELAXED);
+    }
+
+    // Histogram bin 0 is < 1 us, bin n is < 2^n us (the last bin takes everything above)
+    uint32_t us = latency / 1000;
+    int bin = us ? 32 - __builtin_clz(us) : 0;
+    bin = (bin < IRQ_LATENCY_BINS) ? bin : IRQ_LATENCY_BINS - 1;
+    __atomic_fetch_add(&irq_stats.histogram[bin], 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Get the name of an alarm (for logging).
+ * @param[in] bit Alarm bit number
+ * @returns
+ *      - Alarm name
+ */
+static const char *alarm_name(int bit)
+{
+    for (int i = 0; i < NUM_ALARM_NAMES; ++i)
+    {
+        if (alarm_names[i].mask == (1U << bit))
+        {
+            return alarm_names[i].name;
+        }
+    }
+    return "?";
+}
+
+/**
+ * @brief Read the monotonic clock.
+ * @returns
+ *      - Time in nanoseconds
+ */
+static uint64_t time_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * @brief Write the interrupt enable register (the enable mask, less the alarms masked by storm detection).
+ * @note
+ * Lock-free, since the interrupt handler, the alarm thread and the application
+ * all write it. Each writer re-reads the masks after the write, and writes
+ * again if they changed, so the last write always matches the latest masks.
+ */
+static void write_enable(void)
+{
+    uint32_t value = __atomic_load_n(&storm.enable, __ATOMIC_SEQ_CST) & ~__atomic_load_n(&storm.masked, __ATOMIC_SEQ_CST);
+    uint32_t written;
+    do
+    {
+        written = value;
+        WRITE_REG_RAW(FHI_INTR_ENABLE_ADDR, written);
+        value = __atomic_load_n(&storm.enable, __ATOMIC_SEQ_CST) & ~__atomic_load_n(&storm.masked, __ATOMIC_SEQ_CST);
+    } while (value != written);
+}
+
+/**
+ * @brief Re-enable masked alarms (called with the storm lock held).
+ * @param[in] alarms Alarms to re-enable
+ * @param[in] now Current time (ns, monotonic clock)
+ */
+static void unmask_alarms(uint32_t alarms, uint64_t now)
+{
+    alarms &= __atomic_load_n(&storm.masked, __ATOMIC_SEQ_CST);
+    if (alarms)
+    {
+        for (int i = 0; i < NUM_ALARM_BITS; ++i)
+        {
+            if (alarms & (1U << i))
+            {
+                storm.masked_total[i] += now - __atomic_load_n(&storm.mask_time[i], __ATOMIC_RELAXED);
+                __atomic_store_n(&storm.unmask_time[i], now, __ATOMIC_RELAXED);
+            }
+        }
+        __atomic_fetch_and(&storm.masked, ~alarms, __ATOMIC_SEQ_CST);
+        write_enable();
+
+        for (int i = 0; i < NUM_ALARM_BITS; ++i)
+        {
+            if (alarms & (1U << i))
+            {
+                INFO("FHI IRQ: %s alarm storm ended (%u coalesced)\n", alarm_name(i), __atomic_load_n(&storm.pending[i], __ATOMIC_RELAXED));
+            }
+        }
+    }
+}
+
+/**
+ * @brief Wake the alarm thread (lock-free, for the interrupt handler).
+ * @note
+ * The event file descriptor is kept open once created, so the interrupt
+ * handler never writes to a closed descriptor.
+ */
+static void wake_thread(void)
+{
+    int efd = __atomic_load_n(&storm.fd, __ATOMIC_ACQUIRE);
+    if (efd >= 0)
+    {
+        uint64_t one = 1;
+        ssize_t rc = write(efd, &one, sizeof(one));
+        (void)rc;
+    }
+}
+
+/**
+ * @brief Print the deferred interrupt log messages (called by the consumer only).
+ */
+static void flush_irq_log(void)
+{
+    uint32_t tail = irq_log.tail;
+    uint32_t head = __atomic_load_n(&irq_log.head, __ATOMIC_ACQUIRE);
+
+    while (tail != head)
+    {
+        uint32_t index = tail & (IRQ_LOG_SIZE - 1);
+        uint16_t bit = irq_log.entries[index].bit;
+        uint32_t value = irq_log.entries[index].value;
+        (void)bit; // Only used for messages
+
+        switch (irq_log.entries[index].type)
+        {
+        case IRQ_LOG_FHI_STATUS:
+            INFO("fhi_irq_handler() status = 0x%X\n", value);
+            break;
+
+        case IRQ_LOG_OCP_STATUS:
+            INFO("fhi_irq_handler() OCP status = 0x%X\n", value);
+            break;
+
+        case IRQ_LOG_ALARM:
+            if (value)
+            {
+                INFO("FHI IRQ: %s (%u suppressed)\n", alarm_name(bit), value);
+            }
+            else
+            {
+                INFO("FHI IRQ: %s\n", alarm_name(bit));
+            }
+            break;
+
+        case IRQ_LOG_STORM:
+            INFO("FHI IRQ: %s alarm storm, masked for %u ms\n", alarm_name(bit), value);
+            break;
+
+        default:
+            break;
+        }
+
+        ++tail;
+        __atomic_store_n(&irq_log.tail, tail, __ATOMIC_RELEASE);
+    }
+}
+
+/**
+ * @brief Alarm thread (prints the deferred interrupt log messages, and
+ * re-enables the masked alarms after their back-off periods).
+ * @param[in] arg Not used
+ * @returns
+ *      - NULL
+ */
+static void *alarm_thread(void *arg)
+{
+    struct pollfd pfd = {.fd = storm.fd, .events = POLLIN};
+
+    while (!__atomic_load_n(&storm.stop, __ATOMIC_ACQUIRE))
+    {
+        // Print the deferred log messages (without holding any lock)
+        flush_irq_log();
+
+        // Re-enable the alarms whose back-off periods have expired
+        pthread_mutex_lock(&storm.lock);
+        uint64_t now = time_ns();
+        uint32_t masked = __atomic_load_n(&storm.masked, __ATOMIC_SEQ_CST);
+        uint32_t expired = 0;
+        uint64_t next = 0;
+        for (int i = 0; i < NUM_ALARM_BITS; ++i)
+        {
+            if (masked & (1U << i))
+            {
+                uint64_t unmask_time = __atomic_load_n(&storm.unmask_time[i], __ATOMIC_RELAXED);
+                if (unmask_time <= now)
+                {
+                    expired |= 1U << i;
+                }
+                else if (!next || (unmask_time < next))
+                {
+                    next = unmask_time;
+                }
+            }
+        }
+        unmask_alarms(expired, now);
+        pthread_mutex_unlock(&storm.lock);
+
+        // Wait for the next expiry (or a new message or storm, or a request to stop)
+        if (__atomic_load_n(&irq_log.head, __ATOMIC_ACQUIRE) != irq_log.tail)
+        {
+            continue;
+        }
+        int timeout_ms = next ? (int)((next - now + 999999) / 1000000) : -1;
+        if (poll(&pfd, 1, timeout_ms) > 0)
+        {
+            uint64_t temp;
+            ssize_t rc = read(pfd.fd, &temp, sizeof(temp));
+            (void)rc;
+        }
+    }
+
+    return NULL;
+}
+
+/** @} */
@@ -0,0 +1,173 @@
+/*
+ * Copyright 2020 - 2023 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file xorif_alarms.h
+ * @author Steven Dickinson
+ * @brief Header file for libxorif alarm event functions/definitions.
+ * @addtogroup libxorif
+ * @{
+ */
+
+#ifndef XORIF_ALARMS_H
+#define XORIF_ALARMS_H
+
+#include <inttypes.h>
+#include "xorif_api.h"
+
+/*******************************************/
+/*** Constants / macros / structs / etc. ***/
+/*******************************************/
+
+#define ALARM_QUEUE_SIZE 256 /**< Number of alarm events held by the alarm event queue (power of 2) */
+#define NUM_ALARM_BITS 32    /**< Number of alarm status bits (see enum #xorif_fhi_alarms) */
+#define ALARM_LOG_INTERVAL 1000000000ULL /**< Minimum time between log messages for each alarm (ns) */
+#define ALARM_STORM_THRESHOLD 1000 /**< Default number of occurrences of an alarm within the window that start a storm */
+#define ALARM_STORM_WINDOW 1000    /**< Default alarm storm detection window (ms) */
+#define ALARM_STORM_BACKOFF 1000   /**< Default initial alarm storm back-off period (ms) */
+#define ALARM_STORM_MAX_BACKOFF 64 /**< Maximum alarm storm back-off period (multiple of the initial period) */
+#define IRQ_LOG_SIZE 64             /**< Number of messages held by the deferred interrupt log (power of 2) */
+#define IRQ_SOURCE_FHI 0x1          /**< Interrupt source: FHI alarms */
+#define IRQ_SOURCE_OCP 0x2          /**< Interrupt source: OCP events */
+
+/**
+ * @brief Enumerations for deferred interrupt log message types.
+ */
+enum irq_log_type
+{
+    IRQ_LOG_FHI_STATUS = 0, /**< FHI interrupt status (value = status) */
+    IRQ_LOG_OCP_STATUS,     /**< OCP interrupt status (value = status) */
+    IRQ_LOG_ALARM,          /**< Alarm (bit = alarm bit, value = messages suppressed) */
+    IRQ_LOG_STORM,          /**< Alarm storm (bit = alarm bit, value = back-off in ms) */
+};
+
+/**
+ * @brief Macro to record a deferred interrupt log message (when debug logging is enabled).
+ */
+#ifdef DEBUG
+#define IRQ_LOG(type, bit, value, timestamp)                    \
+    {                                                           \
+        if (xorif_trace >= 2)                                   \
+        {                                                       \
+            xorif_irq_log((type), (bit), (value), (timestamp)); \
+        }                                                       \
+    }
+#else
+#define IRQ_LOG(type, bit, value, timestamp)
+#endif
+
+/***************************/
+/*** Function prototypes ***/
+/***************************/
+
+/**
+ * @brief Record an alarm event (called from the interrupt handler).
+ * @param[in] status Alarm status bits (see enum #xorif_fhi_alarms)
+ * @param[in] timestamp Time of the interrupt (ns, monotonic clock)
+ * @note
+ * The per-alarm counters are always updated. The event is queued (and the
+ * application notified) only when the alarm event queue is open.
+ * This function is lock-free, and must only be called by a single producer.
+ */
+void xorif_alarm_event(uint32_t status, uint64_t timestamp);
+
+/**
+ * @brief Apply the alarm reaction policy (called from the interrupt handler).
+ * @param[in] status Alarm status bits (see enum #xorif_fhi_alarms)
+ * @param[in] timestamp Time of the interrupt (ns, monotonic clock)
+ * @param[out] action Pointer to write-back the most severe action (see enum #xorif_alarm_action)
+ * @param[out] cc_mask Pointer to write-back the component carriers to disable
+ * @returns
+ *      - Alarm status bits to record (i.e. those not ignored)
+ * @note
+ * Logs the alarms (rate-limited) and counts the action; the caller performs it.
+ */
+uint32_t xorif_alarm_policy(uint32_t status, uint64_t timestamp, uint16_t *action, uint16_t *cc_mask);
+
+/**
+ * @brief Set the interrupt enable mask, and write it to the hardware (called by #xorif_enable_fhi_interrupts).
+ * @param[in] mask Interrupt enable mask
+ * @note
+ * The alarms masked by storm detection are left disabled in the hardware.
+ */
+void xorif_alarm_storm_enable(uint32_t mask);
+
+/**
+ * @brief Apply the alarm storm detection (called from the interrupt handler).
+ * @param[in] status Alarm status bits (see enum #xorif_fhi_alarms)
+ * @param[in] timestamp Time of the interrupt (ns, monotonic clock)
+ * @returns
+ *      - Alarm status bits to handle (i.e. those not coalesced)
+ * @note
+ * An alarm that occurs too often is masked in the hardware for a back-off
+ * period. Any further occurrences (e.g. latched in the status) are counted,
+ * and reported with the next event for that alarm.
+ * This function is lock-free (the alarm thread is woken to re-enable the
+ * alarm), and must only be called by a single producer.
+ */
+uint32_t xorif_alarm_storm(uint32_t status, uint64_t timestamp);
+
+/**
+ * @brief Start the alarm thread (called by #xorif_init).
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - XORIF_FAILURE if the thread can't be started
+ * @note
+ * The thread prints the deferred interrupt log messages, and re-enables the
+ * alarms masked by storm detection. It's started up-front, so the interrupt
+ * handler only has to wake it.
+ */
+int xorif_alarm_storm_init(void);
+
+/**
+ * @brief Stop the alarm thread (called by #xorif_finish).
+ * @note
+ * Any masked alarms are left masked, and any deferred log messages are printed.
+ */
+void xorif_alarm_storm_finish(void);
+
+/**
+ * @brief Record a deferred interrupt log message (called from the interrupt handler).
+ * @param[in] type Message type (see enum #irq_log_type)
+ * @param[in] bit Alarm bit number
+ * @param[in] value Message value
+ * @param[in] timestamp Time of the interrupt (ns, monotonic clock)
+ * @note
+ * The message is formatted and printed later by the alarm thread (see
+ * #xorif_irq_log_notify). Use the #IRQ_LOG macro, which only records the
+ * message when debug logging is enabled.
+ * This function is lock-free, and must only be called by a single producer.
+ */
+void xorif_irq_log(uint16_t type, uint16_t bit, uint32_t value, uint64_t timestamp);
+
+/**
+ * @brief Wake the alarm thread if any deferred log messages have been recorded (called at the end of the interrupt handler).
+ * @note
+ * This function is lock-free, and must only be called by a single producer.
+ */
+void xorif_irq_log_notify(void);
+
+/**
+ * @brief Update the interrupt statistics (called at the end of the interrupt handler).
+ * @param[in] sources Interrupt sources pending (IRQ_SOURCE_FHI | IRQ_SOURCE_OCP, 0 = spurious)
+ * @param[in] entry Time of entry to the interrupt handler (ns, monotonic clock)
+ * @param[in] exit Time of exit from the interrupt handler (ns, monotonic clock)
+ */
+void xorif_irq_stats_update(uint16_t sources, uint64_t entry, uint64_t exit);
+
+#endif /* XORIF_ALARMS_H */
+
+/** @} */
@@ -108,6 +108,17 @@ enum xorif_iq_comp_flags
 };
 #endif // XORIF_COMMON_IQ_COMP_CODES
 
+/**
+ * @brief Enumerated type for channel type.
+ */
+enum xorif_chan_type
+{
+    CHAN_UL = 0, /**< Uplink */
+    CHAN_DL,     /**< Downlink */
+    CHAN_SSB,    /**< SSB */
+    CHAN_PRACH,  /**< PRACH */
+};
+
 /** @brief Enumerated type for extra capability bitmap flags. */
 enum xorif_extra_flags
 {
@@ -223,6 +234,91 @@ struct xorif_cc_alloc
     uint16_t ssb_data_buff_size;   /**< SSB data buffer size */
 };
 
+/**
+ * @brief Structure for a multi-O-DU table entry (see #xorif_set_modu_table).
+ */
+struct xorif_modu_entry
+{
+    uint8_t address[6]; /**< Destination MAC address */
+    uint16_t id;        /**< VLAN ID */
+    uint16_t dei;       /**< VLAN DEI */
+    uint16_t pcp;       /**< VLAN PCP */
+};
+
+/**
+ * @brief Structure for an RU port mapping table entry.
+ */
+struct xorif_ru_port_map
+{
+    uint16_t port; /**< Internal port number */
+    uint16_t type; /**< Port type (see #xorif_set_ru_ports_table) */
+    uint16_t ccid; /**< "Virtual" CC ID (see #xorif_set_ru_ports_table_vcc) */
+};
+
+/**
+ * @brief Structure for the eAxC ID layout compiler inputs (see #xorif_compile_eaxc_layout).
+ */
+struct xorif_eaxc_spec
+{
+    uint16_t num_du;    /**< Number of DU ports */
+    uint16_t num_bs;    /**< Number of band sectors */
+    uint16_t num_cc;    /**< Number of component carriers */
+    uint16_t num_user;  /**< Number of user (PDxCH / PUxCH) spatial streams (antennas) per CC */
+    uint16_t num_prach; /**< Number of PRACH spatial streams per CC (0 = none) */
+    uint16_t num_ssb;   /**< Number of SSB spatial streams per CC (0 = none) */
+};
+
+/**
+ * @brief Structure for the eAxC ID layout compiler outputs (see #xorif_compile_eaxc_layout).
+ */
+struct xorif_eaxc_layout
+{
+    uint16_t du_bits;    /**< DU ID length (in bits) */
+    uint16_t bs_bits;    /**< Band sector ID length (in bits) */
+    uint16_t cc_bits;    /**< CC ID length (in bits) */
+    uint16_t ru_bits;    /**< RU ID length (in bits) */
+    uint16_t ss_bits;    /**< Spatial stream ID length (in bits) */
+    uint16_t mask;       /**< Mask used when testing for user/PRACH/SSB value */
+    uint16_t user_val;   /**< User ID value */
+    uint16_t prach_val;  /**< PRACH ID value (0xFFFF = not used) */
+    uint16_t ssb_val;    /**< SSB ID value (0xFFFF = not used) */
+    uint16_t table_size; /**< Number of RU ports table entries (mode 1), 0 = table not usable */
+};
+
+/**
+ * @brief Structure for a packet filter match specification (see #xorif_compile_packet_filter).
+ */
+struct xorif_packet_match
+{
+    uint16_t transport;      /**< Transport protocol (see #xorif_transport_protocol) */
+    uint16_t ip_mode;        /**< IP mode (see #xorif_ip_mode) */
+    uint16_t vlan;           /**< VLAN tagged (0 = no, 1 = yes) */
+    uint16_t ethertype;      /**< EtherType (0 = default for the transport / IP mode) */
+    uint16_t fields;         /**< Optional fields to match (see #xorif_packet_match_fields) */
+    uint16_t vlan_id;        /**< VLAN ID */
+    uint16_t vlan_pcp;       /**< VLAN PCP */
+    uint16_t vlan_dei;       /**< VLAN DEI */
+    uint16_t ip_protocol;    /**< IP protocol / next header */
+    uint16_t udp_port;       /**< UDP destination port */
+    uint16_t ecpri_msg_type; /**< eCPRI message type */
+};
+
+/**
+ * @brief Structure for the per-port Front-Haul Interface configuration (see #xorif_get_fhi_port_config).
+ */
+struct xorif_fhi_port_config
+{
+    uint16_t transport;       /**< Transport protocol (common to all ports) */
+    uint16_t vlan;            /**< VLAN tagged (common to all ports) */
+    uint16_t ip_mode;         /**< IP mode (common to all ports) */
+    uint16_t vlan_id;         /**< VLAN ID */
+    uint16_t vlan_dei;        /**< VLAN DEI */
+    uint16_t vlan_pcp;        /**< VLAN PCP */
+    uint32_t planned_cc_mask; /**< Component carriers planned on the port (see #xorif_set_cc_planned_eth_port) */
+    uint32_t filter[16];      /**< Packet filter words */
+    uint16_t mask[4];         /**< Packet filter masks */
+};
+
 /**
  * @brief Structure for Front-Haul Interface Ethernet statistic information.
  */
@@ -249,6 +345,31 @@ struct xorif_fhi_eth_stats
     uint16_t offset_earliest_c_pkt; /**< Largest captured difference between the the symbol number transported by a C-Plane packet and the internal timer counter */
 };
 
+/**
+ * @brief Structure for Front-Haul Interface Ethernet statistics over a time window (see #xorif_get_stats_window).
+ */
+struct xorif_fhi_eth_stats_window
+{
+    uint64_t start_time;             /**< Timestamp of the first sample in the window (ns) */
+    uint64_t end_time;               /**< Timestamp of the last sample in the window (ns) */
+    uint16_t num_samples;            /**< Number of samples in the window */
+    struct xorif_fhi_eth_stats rate; /**< Counter rates (per second) over the window; mean of the other values */
+    struct xorif_fhi_eth_stats min;  /**< Minimum counter rates (between samples); minimum of the other values */
+    struct xorif_fhi_eth_stats max;  /**< Maximum counter rates (between samples); maximum of the other values */
+};
+
+/**
+ * @brief Structure for Front-Haul Interface Ethernet statistics deltas (see #xorif_read_stats_consumer).
+ */
+struct xorif_fhi_eth_stats_delta
+{
+    uint32_t epoch;                   /**< Reset epoch (incremented when the counters are cleared or restarted) */
+    uint32_t resets;                  /**< Number of resets since the previous read */
+    uint64_t interval;                /**< Time since the previous read (ns) */
+    struct xorif_fhi_eth_stats delta; /**< Counter increments since the previous read; current value of the other fields */
+    struct xorif_fhi_eth_stats rate;  /**< Counter rates (per second) since the previous read; current value of the other fields */
+};
+
 /**
  * @brief Enumerations for Front-Haul Interface alarm/status information.
  */
@@ -268,6 +389,56 @@ enum xorif_fhi_alarms
     AXI_TIMEOUT = 0x80000000,              /**< AXI time-out */
 };
 
+/**
+ * @brief Structure for alarm storm statistics (see #xorif_get_fhi_alarm_storm_stats).
+ */
+struct xorif_fhi_alarm_storm_stats
+{
+    uint32_t masked;          /**< Bit-map of alarms currently masked (see enum #xorif_fhi_alarms) */
+    uint32_t storms[32];      /**< Number of storms for each alarm (indexed by bit number) */
+    uint32_t coalesced[32];   /**< Number of occurrences of each alarm coalesced during storms */
+    uint64_t masked_time[32]; /**< Total time each alarm has been masked (ns), including the current storm */
+    uint32_t backoff_ms[32];  /**< Latest back-off period for each alarm (ms, 0 = no storm yet) */
+};
+
+#define IRQ_LATENCY_BINS 16 /**< Number of bins in the interrupt handler latency histogram */
+
+/**
+ * @brief Structure for interrupt handler statistics (see #xorif_get_irq_stats).
+ * @note
+ * Histogram bin 0 counts latencies below 1 us, and bin n counts latencies
+ * from 2^(n-1) us up to 2^n us. The last bin counts everything above.
+ */
+struct xorif_irq_stats
+{
+    uint64_t interrupts;                  /**< Number of interrupts */
+    uint64_t fhi;                         /**< Number of interrupts with FHI alarms pending */
+    uint64_t ocp;                         /**< Number of interrupts with OCP events pending */
+    uint64_t spurious;                    /**< Number of interrupts with nothing pending */
+    uint64_t total_ns;                    /**< Total handler latency, entry to exit (ns) */
+    uint32_t min_ns;                      /**< Minimum handler latency (ns) */
+    uint32_t max_ns;                      /**< Maximum handler latency (ns) */
+    uint32_t last_ns;                     /**< Latest handler latency (ns) */
+    uint32_t histogram[IRQ_LATENCY_BINS]; /**< Handler latency histogram */
+    uint32_t log_dropped;                 /**< Number of deferred log messages lost */
+};
+
+/**
+ * @brief Enumerations for Front-Haul Interface alarm reaction policy actions (see #xorif_set_fhi_alarm_policy).
+ * @note
+ * The actions are in order of severity. Each includes the actions before it,
+ * apart from ignore.
+ */
+enum xorif_alarm_action
+{
+    ALARM_ACTION_IGNORE = 0,           /**< Ignore (the alarm is cleared, but not recorded) */
+    ALARM_ACTION_COUNT = 1,            /**< Record the alarm (status, counters and event queue) only */
+    ALARM_ACTION_LOG = 2,              /**< Record and log the alarm (rate-limited) */
+    ALARM_ACTION_DISABLE_CC = 3,       /**< Record, log and disable the component carriers in the policy's carrier mask */
+    ALARM_ACTION_RESTART_DEFRAMER = 4, /**< Record, log and restart the "de-framer" only */
+    ALARM_ACTION_RESET = 5,            /**< Record, log and reset the data-pipe ("framer" and "de-framer"), the default */
+};
+
 /**
  * @brief Enumerations for supported Front-Haul Interface transport protocols.
  */
@@ -287,11 +458,48 @@ enum xorif_ip_mode
     IP_MODE_IPV6 = 3, /**< IPv6 */
 };
 
+/**
+ * @brief Enumerations for optional packet filter match fields (see #xorif_packet_match).
+ */
+enum xorif_packet_match_fields
+{
+    PKT_MATCH_VLAN_ID = 0x1,         /**< Match VLAN ID */
+    PKT_MATCH_VLAN_PCP = 0x2,        /**< Match VLAN PCP and DEI */
+    PKT_MATCH_IP_PROTOCOL = 0x4,     /**< Match IP protocol (IPv4) / next header (IPv6) */
+    PKT_MATCH_UDP_PORT = 0x8,        /**< Match UDP destination port */
+    PKT_MATCH_ECPRI_MSG_TYPE = 0x10, /**< Match eCPRI message type */
+};
+
 /**
  * @brief Type definition for alarm interrupt call-back function.
  */
 typedef void (*isr_func_t)(uint32_t status);
 
+/**
+ * @brief Structure for an alarm event (see #xorif_read_alarm_events).
+ */
+struct xorif_alarm_event
+{
+    uint64_t timestamp; /**< Time of the interrupt (ns, monotonic clock) */
+    uint32_t status;    /**< Alarm status bits (see enum #xorif_fhi_alarms) */
+    uint32_t seq;       /**< Sequence number (gaps show lost events) */
+    uint32_t coalesced; /**< Number of earlier occurrences of these alarms coalesced by storm detection (not queued) */
+};
+
+/**
+ * @brief Structure for the per-alarm counters (see #xorif_get_fhi_alarm_counts).
+ */
+struct xorif_fhi_alarm_counts
+{
+    uint64_t interrupts; /**< Number of alarm interrupts */
+    uint32_t count[32];  /**< Number of occurrences of each alarm, including coalesced occurrences (indexed by bit number, see enum #xorif_fhi_alarms) */
+    uint64_t last[32];   /**< Time of the latest occurrence of each alarm (ns, monotonic clock, 0 = never) */
+    uint32_t cc_disables;       /**< Number of times component carriers were disabled by the alarm policy */
+    uint32_t deframer_restarts; /**< Number of "de-framer" restarts by the alarm policy */
+    uint32_t resets;            /**< Number of data-pipe resets by the alarm policy */
+    uint32_t suppressed;        /**< Number of alarm log messages suppressed by rate-limiting */
+};
+
 /**
  * @brief Structure for Front-Haul specific system "constants".
  */
@@ -313,6 +521,439 @@ struct xorif_stall_monitor
     uint8_t unsol_ss;   /**< Bitmap for unsolicited spatial streams. */
 };
 
+/**
+ * @brief Enumerations for "stall-monitor" spatial stream types (see #xorif_get_stall_stats).
+ */
+enum xorif_stall_ss_type
+{
+    STALL_SS_DL = 0,    /**< Downlink spatial streams (0-19) */
+    STALL_SS_UL = 1,    /**< Uplink spatial streams (0-15) */
+    STALL_SS_PRACH = 2, /**< PRACH spatial streams (0-3) */
+    STALL_SS_SSB = 3,   /**< SSB spatial streams (0-3) */
+    STALL_SS_UNSOL = 4, /**< Unsolicited spatial streams (0-3) */
+};
+
+/**
+ * @brief Enumerations for stall sampler recovery actions (see #xorif_start_stall_sampler).
+ */
+enum xorif_stall_action
+{
+    STALL_ACTION_NONE = 0,             /**< No action (the recovery count is still incremented) */
+    STALL_ACTION_LOG = 1,              /**< Log an error message */
+    STALL_ACTION_RESTART_FRAMER = 2,   /**< Restart the "framer" */
+    STALL_ACTION_RESTART_DATAPIPE = 3, /**< Restart the data-pipe ("framer" and "de-framer") */
+};
+
+/**
+ * @brief Structure for stall sampler results for one spatial stream (see #xorif_get_stall_stats).
+ */
+struct xorif_stall_stats
+{
+    uint32_t events;        /**< Number of stall events (flag going high) */
+    uint32_t stalled;       /**< Currently stalled (1) or not (0) */
+    uint64_t duration;      /**< Total stalled time (ns), including the current stall */
+    uint64_t max_duration;  /**< Longest stall (ns), including the current stall */
+    uint32_t window_events; /**< Number of stall events in the sliding window */
+    uint32_t cc_events;     /**< Number of stall events starting within one window of a carrier change */
+    double rate;            /**< Stall rate (events per second) over the sliding window */
+};
+
+/**
+ * @brief Structure for stall sampler status (see #xorif_get_stall_sampler_status).
+ */
+struct xorif_stall_sampler_status
+{
+    uint32_t running;       /**< Sampler is running (1) or not (0) */
+    uint32_t period_ms;     /**< Sampling period (ms) */
+    uint32_t window_ms;     /**< Sliding window (ms) */
+    uint32_t threshold;     /**< Recovery threshold (stall events within the window, 0 = disabled) */
+    uint32_t action;        /**< Recovery action (see #xorif_stall_action) */
+    uint64_t samples;       /**< Number of samples taken */
+    uint32_t events;        /**< Number of stall events (all spatial streams) */
+    uint32_t window_events; /**< Number of stall events in the sliding window (all spatial streams) */
+    uint32_t recoveries;    /**< Number of times the recovery action was triggered */
+    uint64_t last_recovery; /**< Time of the last recovery action (ns, monotonic clock, 0 = none) */
+};
+
+#define ARRIVAL_HIST_MAX_BINS 256 /**< Maximum number of bins in a UL arrival-time histogram */
+
+/**
+ * @brief Structure for a UL arrival-time histogram (see #xorif_get_arrival_histogram).
+ * @note
+ * Arrival offsets are in nanoseconds, relative to the start of the UL
+ * reception window (negative = early). Bin n covers offsets from
+ * origin_ns + n * bin_width_ns, up to (but not including) the next bin.
+ */
+struct xorif_arrival_histogram
+{
+    int32_t origin_ns;                   /**< Start of the first bin (ns) */
+    uint32_t bin_width_ns;               /**< Bin width (ns) */
+    uint16_t num_bins;                   /**< Number of bins */
+    uint64_t samples;                    /**< Number of samples */
+    uint64_t underflow;                  /**< Number of samples before the first bin */
+    uint64_t overflow;                   /**< Number of samples after the last bin */
+    int32_t min_ns;                      /**< Minimum offset (ns) */
+    int32_t max_ns;                      /**< Maximum offset (ns) */
+    int32_t mean_ns;                     /**< Mean offset (ns) */
+    int32_t p50_ns;                      /**< 50th percentile (median) offset (ns) */
+    int32_t p90_ns;                      /**< 90th percentile offset (ns) */
+    int32_t p99_ns;                      /**< 99th percentile offset (ns) */
+    int32_t p999_ns;                     /**< 99.9th percentile offset (ns) */
+    uint64_t hw_early;                   /**< Port C-Plane packets received before the window (since cleared) */
+    uint64_t hw_on_time;                 /**< Port C-Plane packets received within the window (since cleared) */
+    uint64_t hw_late;                    /**< Port C-Plane packets received after the window (since cleared) */
+    uint64_t bins[ARRIVAL_HIST_MAX_BINS]; /**< Number of samples in each bin */
+};
+
+/**
+ * @brief Structure for a "monitor block" sample (see #xorif_read_monitor_stream).
+ */
+struct xorif_monitor_sample
+{
+    uint64_t timestamp;    /**< Snapshot time (ns, monotonic clock) */
+    uint16_t num_counters; /**< Number of counter values */
+    uint64_t values[64];   /**< Counter values (in the order the counters were requested) */
+};
+
+#define RECORDER_SIZE 2048        /**< Number of records held by the flight recorder (power of 2) */
+#define RECORDER_DATA_WORDS 8     /**< Number of data words in a flight recorder record */
+#define RECORDER_NAME_LEN 48      /**< Size of the name in a flight recorder record (including the NUL) */
+#define RECORDER_MAGIC 0x43455258 /**< Flight recorder dump file magic number ("XREC") */
+#define RECORDER_VERSION 1        /**< Flight recorder dump file format version */
+
+/**
+ * @brief Enumerations for flight recorder record types (see #xorif_recorder_record).
+ */
+enum xorif_recorder_type
+{
+    RECORD_API = 1,       /**< API call (name = function) */
+    RECORD_ERROR = 2,     /**< Error (name = function reporting the error) */
+    RECORD_REG_WRITE = 3, /**< Register write (name = register, data = address, mask, shift, value) */
+    RECORD_ALARM = 4,     /**< Alarm interrupt (data = status, status handled, action, carriers to disable) */
+    RECORD_STATS = 5,     /**< Counter sample (arg = port, data = lower 32 bits of the counters, see #xorif_recorder_record) */
+    RECORD_STALL = 6,     /**< Stall flags change (data = flags [31:0], flags [63:32], onsets [31:0], onsets [63:32]) */
+    RECORD_TRIGGER = 7,   /**< Trigger (arg = trigger, data = trigger detail, name = function for errors) */
+};
+
+/**
+ * @brief Enumerations for flight recorder triggers (see #xorif_set_recorder_trigger).
+ */
+enum xorif_recorder_trigger
+{
+    RECORDER_TRIGGER_ALARM = 0x1,  /**< Alarm interrupt (with any of the selected alarms) */
+    RECORDER_TRIGGER_STALL = 0x2,  /**< Stall sampler threshold crossed */
+    RECORDER_TRIGGER_ERROR = 0x4,  /**< Error reported by the library */
+    RECORDER_TRIGGER_MANUAL = 0x8, /**< Manual trigger (see #xorif_trigger_recorder), always enabled */
+};
+
+/**
+ * @brief Structure for a flight recorder record (as stored in the dump file).
+ * @note
+ * For counter samples (#RECORD_STATS) the data words are the lower 32 bits of:
+ * total_rx_good_pkt_cnt, total_rx_bad_pkt_cnt, total_rx_bad_fcs_cnt,
+ * oran_rx_early, oran_rx_late, oran_rx_corrupt, oran_rx_error_drop and
+ * oran_tx_total (see #xorif_fhi_eth_stats).
+ */
+struct xorif_recorder_record
+{
+    uint64_t timestamp;                 /**< Time of the record (ns, monotonic clock, kernel tick resolution for API calls, errors and register writes) */
+    uint32_t seq;                       /**< Sequence number (from 1) */
+    uint16_t type;                      /**< Record type (see #xorif_recorder_type) */
+    uint16_t arg;                       /**< Type-specific argument */
+    uint32_t data[RECORDER_DATA_WORDS]; /**< Type-specific data */
+    char name[RECORDER_NAME_LEN];       /**< Function / register name (may be truncated) */
+};
+
+/**
+ * @brief Structure for a flight recorder dump file header.
+ * @note
+ * The dump file is the header followed by the records (oldest first), in the
+ * host byte order. It can be decoded offline with recorder_decode.py.
+ */
+struct xorif_recorder_header
+{
+    uint32_t magic;           /**< Magic number (#RECORDER_MAGIC) */
+    uint16_t version;         /**< Format version (#RECORDER_VERSION) */
+    uint16_t record_size;     /**< Size of each record (bytes) */
+    uint32_t num_records;     /**< Number of records that follow */
+    uint32_t trigger;         /**< Trigger that froze the recorder (see #xorif_recorder_trigger, 0 = none) */
+    uint32_t trigger_seq;     /**< Sequence number of the trigger record (0 = none) */
+    uint32_t lost;            /**< Records overwritten or incomplete at the time of the dump */
+    uint64_t mono_time;       /**< Time of the dump (ns, monotonic clock) */
+    uint64_t real_time;       /**< Time of the dump (ns, real-time clock), to convert the record timestamps */
+    uint32_t sw_version;      /**< Software version (see #xorif_get_sw_version) */
+    uint32_t hw_version;      /**< FHI hardware version (see #xorif_get_fhi_hw_version) */
+    uint32_t hw_internal_rev; /**< FHI hardware internal revision (see #xorif_get_fhi_hw_internal_rev) */
+    uint32_t reserved[3];     /**< Reserved (0) */
+};
+
+/**
+ * @brief Structure for flight recorder status (see #xorif_get_recorder_status).
+ */
+struct xorif_recorder_status
+{
+    uint32_t frozen;        /**< Recorder is frozen (1) or recording (0) */
+    uint32_t triggers;      /**< Enabled triggers (see #xorif_recorder_trigger) */
+    uint32_t alarm_mask;    /**< Alarms selected for the alarm trigger (see #xorif_fhi_alarms) */
+    uint32_t post_records;  /**< Number of records captured after the trigger, before freezing */
+    uint32_t sample_ms;     /**< Counter sampling period (ms, 0 = statistics collector samples only) */
+    uint32_t trigger;       /**< Trigger that fired (0 = none) */
+    uint32_t trigger_seq;   /**< Sequence number of the trigger record (0 = none) */
+    uint64_t trigger_time;  /**< Time of the trigger (ns, monotonic clock, 0 = none) */
+    uint64_t records;       /**< Number of records captured (the latest #RECORDER_SIZE are held) */
+    uint32_t dumps;         /**< Number of automatic dumps written */
+    int32_t dump_result;    /**< Result of the latest automatic dump (XORIF_SUCCESS or error code) */
+};
+
+#define TIMELINE_DEFAULT_EVENTS 4096 /**< Default number of spans held by the timeline (see #xorif_start_timeline) */
+#define TIMELINE_MAX_EVENTS 1048576  /**< Maximum number of spans held by the timeline */
+
+/**
+ * @brief Structure for timeline status (see #xorif_get_timeline_status).
+ */
+struct xorif_timeline_status
+{
+    uint32_t enabled;  /**< Timeline is capturing (1) or stopped (0) */
+    uint32_t capacity; /**< Number of spans that can be held */
+    uint32_t spans;    /**< Number of spans captured */
+    uint32_t open;     /**< Number of spans captured that haven't finished yet */
+    uint32_t lost;     /**< Number of spans not captured (timeline full) */
+};
+
+#define SCRUB_DEFAULT_BUDGET 1000 /**< Default register scrubber bandwidth budget (register reads per second) */
+#define SCRUB_MAX_BUDGET 1000000  /**< Maximum register scrubber bandwidth budget (register reads per second) */
+#define SCRUB_LOG_SIZE 32         /**< Number of mismatches held by the register scrubber log */
+#define SCRUB_NAME_LEN 48         /**< Maximum length of a register field name in the scrubber log (including terminator) */
+
+/**
+ * @brief Enumerations for register scrubber modes (see #xorif_start_scrubber).
+ */
+enum xorif_scrub_mode
+{
+    SCRUB_REPORT = 0,  /**< Report mismatches only */
+    SCRUB_RESTORE = 1, /**< Report mismatches, and restore the expected values */
+};
+
+/**
+ * @brief Structure for a register scrubber mismatch (see #xorif_get_scrubber_log).
+ * @note
+ * The name is the register field from the register map, with the instance
+ * (component carrier, Ethernet port or symbol index) in brackets for
+ * repeated register ranges, e.g. "ORAN_CC_NUMRBS[2]". The values are the
+ * whole register word, limited to the bits of the field (see mask).
+ */
+struct xorif_scrub_mismatch
+{
+    uint64_t timestamp;        /**< Time the mismatch was found (ns, monotonic clock) */
+    uint32_t addr;             /**< Register address offset */
+    uint32_t mask;             /**< Register field mask */
+    uint32_t expected;         /**< Expected value (as last written by the library) */
+    uint32_t actual;           /**< Actual value read */
+    uint32_t restored;         /**< Expected value was restored (1) or not (0) */
+    char name[SCRUB_NAME_LEN]; /**< Register field name */
+};
+
+/**
+ * @brief Structure for register scrubber status (see #xorif_get_scrubber_status).
+ */
+struct xorif_scrubber_status
+{
+    uint32_t running;    /**< Background scrubber is running (1) or stopped (0) */
+    uint32_t budget;     /**< Bandwidth budget (register reads per second) */
+    uint32_t mode;       /**< Scrubber mode (see #xorif_scrub_mode) */
+    uint32_t registers;  /**< Number of register words currently checked */
+    uint64_t passes;     /**< Number of complete passes over the register ranges */
+    uint64_t reads;      /**< Number of register reads */
+    uint32_t mismatches; /**< Number of register field mismatches found */
+    uint32_t restored;   /**< Number of register field mismatches restored */
+    uint32_t retries;    /**< Number of range checks repeated (the library wrote the range during the check) */
+};
+
+/**
+ * @brief Structure for the fronthaul transport delays and O-DU limits (see #xorif_get_latency_budget).
+ */
+struct xorif_transport_delay
+{
+    double t12_min;    /**< Minimum downlink transport delay, O-DU to O-RU (in microseconds) */
+    double t12_max;    /**< Maximum downlink transport delay, O-DU to O-RU (in microseconds) */
+    double t34_min;    /**< Minimum uplink transport delay, O-RU to O-DU (in microseconds) */
+    double t34_max;    /**< Maximum uplink transport delay, O-RU to O-DU (in microseconds) */
+    double t1a_max_up; /**< O-DU limit, maximum downlink U-plane transmit advance (in microseconds, 0 = not checked) */
+    double ta4_max;    /**< O-DU limit, maximum uplink U-plane reception delay (in microseconds, 0 = not checked) */
+};
+
+/**
+ * @brief Enumerations for latency budget violations (bit-map, see #xorif_latency_budget).
+ */
+enum xorif_latency_violation
+{
+    LATENCY_T1A_UP = (1 << 0),          /**< T1a_up window closed (DL transport delay variation exceeds the U-plane reception window) */
+    LATENCY_T1A_CP_DL = (1 << 1),       /**< T1a_cp_dl window closed (DL transport delay variation exceeds the DL C-plane reception window) */
+    LATENCY_T1A_CP_UL = (1 << 2),       /**< T1a_cp_ul window closed (DL transport delay variation exceeds the UL C-plane reception window) */
+    LATENCY_T1A_DU_LIMIT = (1 << 3),    /**< T1a_min_up exceeds the O-DU limit (the O-DU can't transmit early enough) */
+    LATENCY_T2A_DATA_BUFFER = (1 << 4), /**< T2a_max_up needs more DL data symbols than the "de-framer" supports */
+    LATENCY_T2A_CTRL_BUFFER = (1 << 5), /**< T2a_max_cp_dl or T2a_max_cp_ul needs more control symbols than the "de-framer" supports */
+    LATENCY_TA3_DU_LIMIT = (1 << 6),    /**< Ta3_max + T34_max exceeds the O-DU limit (UL U-plane arrives too late) */
+    LATENCY_UL_BID_FORWARD = (1 << 7),  /**< UL beam-id forward time is out of range (it is limited when configured) */
+};
+
+/**
+ * @brief Structure for the latency budget of a component carrier (see #xorif_get_latency_budget).
+ * @note
+ * All times are in microseconds. The O-RU windows (T2a and Ta3) are relative
+ * to the air interface, and the O-DU windows (T1a and Ta4) include the
+ * transport delay. The downlink total is the worst-case time from O-DU
+ * transmission (at the start of the T1a_up window) to air, and the uplink
+ * total is the worst-case time from air to O-DU reception (Ta4_max).
+ */
+struct xorif_latency_budget
+{
+    double sym_period;         /**< Symbol period */
+    double dl_transport;       /**< DL stage: transport delay (T12_max) */
+    double dl_deskew;          /**< DL stage: U-plane reception window / deskew buffer (delay_comp_up) */
+    double dl_decap;           /**< DL stage: "de-framer" decapsulation delay (FH_DECAP_DLY) */
+    double dl_total;           /**< DL U-plane total */
+    double dl_ctrl_advance;    /**< DL C-plane stage: advance over the U-plane (Tcp_adv_dl) */
+    double dl_ctrl_deskew;     /**< DL C-plane stage: reception window (delay_comp_cp_dl) */
+    double dl_ctrl_total;      /**< DL C-plane total (transport, reception window, advance and decapsulation) */
+    double ul_radio;           /**< UL stage: radio channel delay, air to "framer" (ul_radio_ch_dly) */
+    double ul_framing;         /**< UL stage: "framer" packetization (1 symbol) */
+    double ul_transport;       /**< UL stage: transport delay (T34_max) */
+    double ul_total;           /**< UL U-plane total */
+    double ul_ctrl_advance;    /**< UL C-plane stage: advance (T2a_min_cp_ul) */
+    double ul_ctrl_deskew;     /**< UL C-plane stage: reception window (delay_comp_cp_ul) */
+    double ul_bid_forward;     /**< UL beam-id forward time (as configured, after limiting) */
+    double t2a_min_up;         /**< O-RU DL U-plane reception window start (T2a_min_up) */
+    double t2a_max_up;         /**< O-RU DL U-plane reception window end (T2a_max_up) */
+    double t2a_min_cp_dl;      /**< O-RU DL C-plane reception window start (T2a_min_cp_dl) */
+    double t2a_max_cp_dl;      /**< O-RU DL C-plane reception window end (T2a_max_cp_dl) */
+    double t2a_min_cp_ul;      /**< O-RU UL C-plane reception window start (T2a_min_cp_ul) */
+    double t2a_max_cp_ul;      /**< O-RU UL C-plane reception window end (T2a_max_cp_ul) */
+    double ta3_min;            /**< O-RU UL U-plane transmission window start (Ta3_min) */
+    double ta3_max;            /**< O-RU UL U-plane transmission window end (Ta3_max) */
+    double t1a_min_up;         /**< O-DU DL U-plane transmission window start (T1a_min_up) */
+    double t1a_max_up;         /**< O-DU DL U-plane transmission window end (T1a_max_up) */
+    double t1a_min_cp_dl;      /**< O-DU DL C-plane transmission window start (T1a_min_cp_dl) */
+    double t1a_max_cp_dl;      /**< O-DU DL C-plane transmission window end (T1a_max_cp_dl) */
+    double t1a_min_cp_ul;      /**< O-DU UL C-plane transmission window start (T1a_min_cp_ul) */
+    double t1a_max_cp_ul;      /**< O-DU UL C-plane transmission window end (T1a_max_cp_ul) */
+    double ta4_min;            /**< O-DU UL U-plane reception window start (Ta4_min) */
+    double ta4_max;            /**< O-DU UL U-plane reception window end (Ta4_max) */
+    uint16_t dl_data_symbols;  /**< DL data buffer depth needed (symbols) */
+    uint16_t dl_ctrl_symbols;  /**< DL control buffer depth needed (symbols) */
+    uint16_t ul_ctrl_symbols;  /**< UL control buffer depth needed (symbols) */
+    uint16_t max_data_symbols; /**< Maximum DL data buffer depth (symbols) */
+    uint16_t max_ctrl_symbols; /**< Maximum control buffer depth (symbols) */
+    uint32_t violations;       /**< Violations (bit-map, see #xorif_latency_violation, 0 = none) */
+};
+
+#define BANDWIDTH_DEFAULT_LINK_RATE 25 /**< Default Ethernet link rate for the bandwidth calculator (Gbps) */
+
+/**
+ * @brief Enumerations for link capacity exceeded (bit-map, see #xorif_port_bandwidth).
+ */
+enum xorif_bandwidth_overload
+{
+    BANDWIDTH_DL_OVERLOAD = (1 << 0), /**< Downlink (DL + SSB) exceeds the link rate */
+    BANDWIDTH_UL_OVERLOAD = (1 << 1), /**< Uplink (UL + PRACH) exceeds the link rate */
+};
+
+/**
+ * @brief Structure for the bandwidth calculator parameters (see #xorif_get_cc_bandwidth).
+ */
+struct xorif_bandwidth_params
+{
+    double link_rate;       /**< Ethernet link rate (Gbps, 0 = #BANDWIDTH_DEFAULT_LINK_RATE) */
+    uint16_t mtu;           /**< MTU (bytes, 0 = as configured, see #xorif_set_mtu_size) */
+    uint16_t dl_streams;    /**< Number of DL spatial streams (eAxC) per component carrier */
+    uint16_t ul_streams;    /**< Number of UL spatial streams (eAxC) per component carrier */
+    uint16_t prach_streams; /**< Number of PRACH spatial streams (eAxC) per component carrier */
+    uint16_t ssb_streams;   /**< Number of SSB spatial streams (eAxC) per component carrier */
+    uint16_t prach_rbs;     /**< Number of PRACH RBs per symbol (e.g. 12 for short formats) */
+    uint16_t prach_symbols; /**< Number of PRACH symbols per 10 ms frame */
+    uint16_t ssb_symbols;   /**< Number of SSB symbols per 10 ms frame */
+    uint32_t cc_mask;       /**< Component carriers included in the port totals (0 = enabled component carriers) */
+};
+
+/**
+ * @brief Structure for the bandwidth of a U-plane flow (see #xorif_get_cc_bandwidth).
+ */
+struct xorif_flow_bandwidth
+{
+    double iq_rate;      /**< IQ data rate, excluding headers (bits per second) */
+    double bit_rate;     /**< Line rate, including all headers, preamble and inter-frame gap (bits per second) */
+    double packet_rate;  /**< Packet rate (packets per second) */
+    uint16_t frame_size; /**< Largest Ethernet frame (bytes, MAC header to FCS) */
+};
+
+/**
+ * @brief Structure for the bandwidth of a component carrier (see #xorif_get_cc_bandwidth).
+ */
+struct xorif_cc_bandwidth
+{
+    uint16_t eth_port;                 /**< Planned Ethernet port (see #xorif_set_cc_planned_eth_port) */
+    uint16_t mtu;                      /**< MTU used (bytes) */
+    struct xorif_flow_bandwidth dl;    /**< DL U-plane (all DL spatial streams) */
+    struct xorif_flow_bandwidth ul;    /**< UL U-plane (all UL spatial streams) */
+    struct xorif_flow_bandwidth prach; /**< PRACH U-plane (all PRACH spatial streams) */
+    struct xorif_flow_bandwidth ssb;   /**< SSB U-plane (all SSB spatial streams) */
+};
+
+/**
+ * @brief Structure for the bandwidth of an Ethernet port (see #xorif_get_port_bandwidth).
+ */
+struct xorif_port_bandwidth
+{
+    uint32_t cc_mask;               /**< Component carriers included (assigned to the port) */
+    double link_rate;               /**< Ethernet link rate (Gbps) */
+    struct xorif_flow_bandwidth dl; /**< Downlink total (DL + SSB) */
+    struct xorif_flow_bandwidth ul; /**< Uplink total (UL + PRACH) */
+    double dl_utilization;          /**< Downlink link utilization (0.0 to 1.0, or more if overloaded) */
+    double ul_utilization;          /**< Uplink link utilization (0.0 to 1.0, or more if overloaded) */
+    uint16_t overload;              /**< Link capacity exceeded (bit-map, see #xorif_bandwidth_overload, 0 = none) */
+};
+
+#define COMP_ADVICE_MAX_CANDIDATES 32 /**< Maximum number of candidates evaluated by the IQ compression advisor */
+#define COMP_ADVICE_NONE 0xFFFF       /**< No candidate meets the quality target (see #xorif_comp_advice) */
+
+/**
+ * @brief Structure for the IQ compression advisor parameters (see #xorif_advise_iq_compression).
+ */
+struct xorif_comp_advice_params
+{
+    uint16_t num_rbs;     /**< Number of RBs per symbol (0 = as configured for the component carrier) */
+    uint16_t num_symbols; /**< Number of OFDM symbols in the test vector (0 = 14) */
+    uint16_t modulation;  /**< Modulation, bits per RE (2 = QPSK, 4 = 16QAM, 6 = 64QAM, 8 = 256QAM, 10 = 1024QAM, 0 = 8) */
+    double backoff;       /**< RMS level below full scale (dB) */
+    double power_range;   /**< Per-RB power variation, below the RMS level (dB, uniformly distributed, 0 = flat) */
+    double target_evm;    /**< Quality target, maximum EVM (%) */
+    uint32_t seed;        /**< Test vector random seed */
+};
+
+/**
+ * @brief Structure for an evaluated IQ compression setting (see #xorif_comp_advice).
+ */
+struct xorif_comp_candidate
+{
+    uint16_t comp_meth;    /**< IQ compression method (see #xorif_iq_comp) */
+    uint16_t comp_width;   /**< IQ compressed width */
+    double evm;            /**< EVM (%) */
+    double sqnr;           /**< SQNR (dB) */
+    double iq_rate;        /**< IQ data rate per spatial stream (bits per second) */
+    double bit_rate;       /**< Line rate per spatial stream (bits per second, see #xorif_get_cc_bandwidth) */
+    uint16_t meets_target; /**< Meets the quality target (0 = no, 1 = yes) */
+};
+
+/**
+ * @brief Structure for the IQ compression advice (see #xorif_advise_iq_compression).
+ */
+struct xorif_comp_advice
+{
+    uint16_t num_candidates;                                            /**< Number of candidates evaluated */
+    uint16_t recommended;                                               /**< Recommended candidate (index, or #COMP_ADVICE_NONE) */
+    struct xorif_comp_candidate candidates[COMP_ADVICE_MAX_CANDIDATES]; /**< Candidates (by method, then width) */
+};
+
 /**********************************************/
 /*** Function prototypes (common interface) ***/
 /**********************************************/
@@ -402,6 +1043,23 @@ int xorif_has_oran_channel_processor(void);
  */
 int xorif_configure_cc(uint16_t cc);
 
+/**
+ * @brief Configure a component carrier, while other carriers are running ("hot-add").
+ * @param[in] cc Component carrier to configure (must be disabled)
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - XORIF_INVALID_CC if the component carrier is enabled
+ *      - XORIF_BUFFER_SPACE_EXCEEDED if the carrier doesn't fit in the free space
+ *      - Error code on failure
+ * @note
+ * Unlike xorif_configure_cc(), the buffer allocations (see xorif_get_fhi_cc_alloc())
+ * of all other component carriers are kept fixed, and the new carrier is placed in
+ * the remaining free space (smallest free region that fits). All memories are
+ * checked before any allocation or register write, so on failure the device is
+ * left untouched and the error log names the memory that doesn't fit.
+ */
+int xorif_configure_cc_hot_add(uint16_t cc);
+
 /**
  * @brief Enables the specified component carrier.
  * @param[in] cc Component carrier to configure
@@ -428,7 +1086,7 @@ int xorif_disable_cc(uint16_t cc);
  * bit n == 0 means component carrier n disabled
  * bit n == 1 means component carrier n enabled
  */
-uint8_t xorif_get_enabled_cc_mask(void);
+uint16_t xorif_get_enabled_cc_mask(void);
 
 /**
  * @brief Set the configuration for the component carrier.
@@ -879,54 +1537,161 @@ int xorif_write_fhi_reg_offset(const char *name, uint16_t offset, uint32_t value
 int xorif_get_fhi_eth_stats(int port, struct xorif_fhi_eth_stats *ptr);
 
 /**
- * @brief Set the destination ethernet MAC address for the specified port.
- * @param[in] port Ethernet port
- * @param[in] address MAC address (6 byte array)
+ * @brief Get Front-Haul Interface Ethernet statistics for all ports from a single snapshot.
+ * @param[in] num_ports Number of Ethernet ports (ports 0 to num_ports - 1)
+ * @param[out] ptr Pointer to array of statistics data structures (one per port)
  * @returns
  *      - XORIF_SUCCESS on success
  *      - Error code on failure
+ * @note
+ * The counters of all ports are captured at the same time.
+ * The counters are accumulated in software (since the last
+ * #xorif_clear_fhi_stats), so they never wrap or go backwards, even if the
+ * hardware counters restart. The rates and offsets are the current values.
  */
-int xorif_set_fhi_dest_mac_addr(int port, const uint8_t address[]);
+int xorif_get_fhi_eth_stats_all(uint16_t num_ports, struct xorif_fhi_eth_stats *ptr);
 
 /**
- * @brief Set the source ethernet MAC address for the specified port.
- * @param[in] port Ethernet port
- * @param[in] address MAC address (6 byte array)
+ * @brief Start the statistics collector.
+ * @param[in] period_ms Sampling period (in milliseconds)
+ * @param[in] depth Number of samples to hold (2 to 4096)
+ * @param[in] ptp_device PTP clock device for the timestamps (e.g. "/dev/ptp0"),
+ * or NULL for the monotonic clock
  * @returns
  *      - XORIF_SUCCESS on success
  *      - Error code on failure
+ * @note
+ * The collector thread samples the statistics of all ports periodically,
+ * and holds the most recent samples. While it's running, the accumulated
+ * statistics (#xorif_get_fhi_eth_stats_all, #xorif_get_stats_sample and
+ * #xorif_get_stats_window) are served from memory, so readers don't access
+ * the hardware or interfere with each other. #xorif_get_fhi_eth_stats always
+ * reads the raw hardware counters.
+ * If the collector is already running, it is re-started with the new settings.
  */
-int xorif_set_fhi_src_mac_addr(int port, const uint8_t address[]);
+int xorif_start_stats_collector(uint32_t period_ms, uint16_t depth, const char *ptp_device);
 
 /**
- * @brief Enable / disable the multi-O-DU MAC address / VLAN tag mapping.
- * @param[in] enable (0 = disable, 1 = enable)
+ * @brief Stop the statistics collector.
  * @returns
  *      - XORIF_SUCCESS on success
  *      - Error code on failure
- * @note
- * This API enables/disables the O-DU MAC address (and VLAN tag) mapping
- * for multi-O-DU support. When this is disabled, the MAC address and VLAN
- * tag are set by #xorif_set_fhi_dest_mac_addr and #xorif_set_fhi_vlan_tag
- * API calls. When this is enabled, the MAC address and VLAN tag can be set
- * by #xorif_set_modu_dest_mac_addr for different DU port address.
  */
-int xorif_set_modu_mode(uint16_t enable);
+int xorif_stop_stats_collector(void);
 
 /**
- * @brief Set the multi-O-DU MAC address / VLAN tag mapping for DU port address.
- * @param[in] du O-DU port address
- * @param[in] address MAC address (6 byte array)
- * @param[in] id VLAN ID
- * @param[in] dei VLAN DEI
- * @param[in] pcp VLAN PCP
+ * @brief Get a statistics sample from the statistics collector.
+ * @param[in] port Ethernet port
+ * @param[in] age Sample age (0 = latest, 1 = previous, etc.)
+ * @param[out] ptr Pointer to statistics data structure
+ * @param[out] timestamp Pointer to sample timestamp in nanoseconds (can be NULL)
  * @returns
  *      - XORIF_SUCCESS on success
  *      - Error code on failure
- * @note
- * This API allows different destination MAC addresses and VLAN IDs to be
- * assigned by DU port address. This applies for uplink packets only.
- * If VLAN is not required, then the relevant fields (id, dei, pcp) should
+ */
+int xorif_get_stats_sample(int port, uint16_t age, struct xorif_fhi_eth_stats *ptr, uint64_t *timestamp);
+
+/**
+ * @brief Get the statistics rates and min/max values over a time window from the statistics collector.
+ * @param[in] port Ethernet port
+ * @param[in] window_ms Window length (in milliseconds, 0 = all samples)
+ * @param[out] ptr Pointer to statistics window data structure
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * The window ends with the latest sample. Counter rates need at least 2
+ * samples in the window.
+ */
+int xorif_get_stats_window(int port, uint32_t window_ms, struct xorif_fhi_eth_stats_window *ptr);
+
+/**
+ * @brief Open a statistics consumer handle.
+ * @param[out] handle Pointer to consumer handle
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * Each consumer has its own baseline, so independent tools can read deltas
+ * and rates (see #xorif_read_stats_consumer) without interfering with each
+ * other. The baseline is set to the current counters when the handle is opened.
+ */
+int xorif_open_stats_consumer(uint16_t *handle);
+
+/**
+ * @brief Close a statistics consumer handle.
+ * @param[in] handle Consumer handle
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ */
+int xorif_close_stats_consumer(uint16_t handle);
+
+/**
+ * @brief Read the statistics deltas and rates since the consumer's previous read.
+ * @param[in] handle Consumer handle
+ * @param[in] port Ethernet port
+ * @param[out] ptr Pointer to statistics delta data structure
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * Counter deltas are kept correct across #xorif_clear_fhi_stats,
+ * #xorif_reset_fhi and data-pipe restarts. These are reported as resets (the
+ * reset epoch is incremented), so that absolute values can be re-based.
+ * The values are served from the statistics collector if it's running.
+ */
+int xorif_read_stats_consumer(uint16_t handle, int port, struct xorif_fhi_eth_stats_delta *ptr);
+
+/**
+ * @brief Set the destination ethernet MAC address for the specified port.
+ * @param[in] port Ethernet port
+ * @param[in] address MAC address (6 byte array)
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ */
+int xorif_set_fhi_dest_mac_addr(int port, const uint8_t address[]);
+
+/**
+ * @brief Set the source ethernet MAC address for the specified port.
+ * @param[in] port Ethernet port
+ * @param[in] address MAC address (6 byte array)
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ */
+int xorif_set_fhi_src_mac_addr(int port, const uint8_t address[]);
+
+/**
+ * @brief Enable / disable the multi-O-DU MAC address / VLAN tag mapping.
+ * @param[in] enable (0 = disable, 1 = enable)
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * This API enables/disables the O-DU MAC address (and VLAN tag) mapping
+ * for multi-O-DU support. When this is disabled, the MAC address and VLAN
+ * tag are set by #xorif_set_fhi_dest_mac_addr and #xorif_set_fhi_vlan_tag
+ * API calls. When this is enabled, the MAC address and VLAN tag can be set
+ * by #xorif_set_modu_dest_mac_addr for different DU port address.
+ */
+int xorif_set_modu_mode(uint16_t enable);
+
+/**
+ * @brief Set the multi-O-DU MAC address / VLAN tag mapping for DU port address.
+ * @param[in] du O-DU port address
+ * @param[in] address MAC address (6 byte array)
+ * @param[in] id VLAN ID
+ * @param[in] dei VLAN DEI
+ * @param[in] pcp VLAN PCP
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * This API allows different destination MAC addresses and VLAN IDs to be
+ * assigned by DU port address. This applies for uplink packets only.
+ * If VLAN is not required, then the relevant fields (id, dei, pcp) should
  * be set to 0.
  * The configuration is applied to all Ethernet ports.
  */
@@ -936,6 +1701,36 @@ int xorif_set_modu_dest_mac_addr(uint16_t du,
                                  uint16_t dei,
                                  uint16_t pcp);
 
+/**
+ * @brief Set a range of the multi-O-DU MAC address / VLAN tag table for the specified port.
+ * @param[in] port Ethernet port
+ * @param[in] du First O-DU port address
+ * @param[in] number Number of entries
+ * @param[in] table Pointer to array of table entries
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * Each port has its own table (c.f. #xorif_set_modu_dest_mac_addr, which
+ * sets the same entry for all ports). The library keeps a copy of the
+ * programmed table, and only the entries that have changed are written.
+ */
+int xorif_set_modu_table(int port, uint16_t du, uint16_t number, const struct xorif_modu_entry *table);
+
+/**
+ * @brief Get a range of the multi-O-DU MAC address / VLAN tag table for the specified port.
+ * @param[in] port Ethernet port
+ * @param[in] du First O-DU port address
+ * @param[in] number Number of entries
+ * @param[out] table Pointer to array of table entries
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * The entries are read back from the hardware.
+ */
+int xorif_get_modu_table(int port, uint16_t du, uint16_t number, struct xorif_modu_entry *table);
+
 /**
  * @brief Sets the uplink MTU size.
  * @param size Size of MTU
@@ -964,9 +1759,10 @@ int xorif_set_mtu_size(uint16_t size);
  * In addition to configuring the protocol, this function also configures
  * the packet filters for all the Ethernet ports.
  * The default filter configuration is very basic, and just configures the
- * filter for the transport protocol (eCPRI or IEEE 1914.3) and VLAN tagging.
- * Use the #xorif_set_fhi_packet_filter function for more precise control
- * of the filter configuration.
+ * filter for the transport protocol (eCPRI or IEEE 1914.3), VLAN tagging and
+ * IP mode (see #xorif_compile_packet_filter).
+ * Use the #xorif_compile_packet_filter and #xorif_set_fhi_packet_filter
+ * functions for more precise control of the filter configuration.
  * Use #xorif_set_fhi_protocol_alt to set the protocol without affecting
  * the packet filter configuration.
  */
@@ -1020,6 +1816,83 @@ int xorif_set_fhi_vlan_tag(int port, uint16_t id, uint16_t dei, uint16_t pcp);
  */
 int xorif_set_fhi_packet_filter(int port, const uint32_t filter[16], uint16_t mask[4]);
 
+/**
+ * @brief Compile a packet filter from a match specification.
+ * @param[in] match Pointer to the match specification
+ * @param[out] filter Pointer to an array of 16 x 32-bit words
+ * @param[out] mask Pointer to an array of 4 x 16-bit words
+ * @param[out] exact Pointer to exact flag (1 = filter matches exactly the specification,
+ * 0 = filter passes a super-set), can be NULL
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * The result is suitable for #xorif_set_fhi_packet_filter.
+ * The filter always matches the EtherType (after the VLAN tag if used). For
+ * IP modes it also matches the IP protocol (UDP by default for eCPRI), and
+ * IPv4 packets are assumed to have no options.
+ * The filter works on whole bytes within the first 64 bytes of the packet.
+ * Fields that share a byte with unspecified values (e.g. VLAN ID without
+ * PCP/DEI) or that lie beyond the first 64 bytes can't be fully matched; the
+ * filter then passes a super-set of the specification, and "exact" is 0.
+ */
+int xorif_compile_packet_filter(const struct xorif_packet_match *match,
+                                uint32_t filter[16],
+                                uint16_t mask[4],
+                                uint16_t *exact);
+
+/**
+ * @brief Set the packet filter for the specified port from a match specification.
+ * @param[in] port Ethernet port
+ * @param[in] match Pointer to the match specification
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * Each port can have its own filter (e.g. a different VLAN ID or UDP port).
+ * The transport protocol, VLAN and IP mode are a common framer setting
+ * (see #xorif_set_fhi_protocol) and the specification must agree with them.
+ */
+int xorif_set_fhi_port_filter(int port, const struct xorif_packet_match *match);
+
+/**
+ * @brief Record the Ethernet port planned for a component carrier (a planning tag only).
+ * @param[in] cc Component carrier
+ * @param[in] port Ethernet port
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * By default, all component carriers are planned on port 0.
+ * This doesn't steer any traffic: the IP core has no per-CC port selection,
+ * so nothing is programmed. The tag is held by the library, and is used by
+ * #xorif_get_fhi_port_config and the bandwidth calculator
+ * (#xorif_get_port_bandwidth) to check a plan for balancing the carriers
+ * across the Ethernet links. The traffic itself follows the per-port MAC,
+ * VLAN and filter settings.
+ */
+int xorif_set_cc_planned_eth_port(uint16_t cc, uint16_t port);
+
+/**
+ * @brief Get the Ethernet port planned for a component carrier (see #xorif_set_cc_planned_eth_port).
+ * @param[in] cc Component carrier
+ * @param[out] port Pointer to Ethernet port
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ */
+int xorif_get_cc_planned_eth_port(uint16_t cc, uint16_t *port);
+
+/**
+ * @brief Get the configuration of the specified Ethernet port.
+ * @param[in] port Ethernet port
+ * @param[out] ptr Pointer to port configuration structure
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ */
+int xorif_get_fhi_port_config(int port, struct xorif_fhi_port_config *ptr);
+
 /**
  * @brief Set the eAxC ID (c.f. ecpriRtcid and ecpriPcid)
  * @param[in] du_bits DU ID length (in bits)
@@ -1201,6 +2074,76 @@ int xorif_set_ru_ports_table_vcc(uint16_t address,
                                  uint16_t ccid,
                                  uint16_t number);
 
+/**
+ * @brief Assign a block of RU port id mappings from a table.
+ * @param[in] address The base (external) address to use
+ * @param[in] number The number of entries in the table
+ * @param[in] map Pointer to the table of mappings (port, type and ccid)
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * Entry "i" of the table is assigned to address "address + i".
+ * The library keeps a copy of the mapping table, and only entries that differ
+ * from the copy are written to the h/w (this applies to all the RU ports table
+ * APIs). The whole address range is checked before anything is written.
+ */
+int xorif_set_ru_ports_table_bulk(uint16_t address,
+                                  uint16_t number,
+                                  const struct xorif_ru_port_map *map);
+
+/**
+ * @brief Verify the RU ports mapping table against the programmed values.
+ * @param[out] num_errors Pointer to the number of mismatched entries (can be NULL)
+ * @returns
+ *      - XORIF_SUCCESS on success (no mismatches)
+ *      - Error code on failure
+ * @note
+ * Each programmed entry is read back from the h/w and compared with the
+ * library's copy. Mismatched entries are forgotten, so that they are
+ * re-written by the next RU ports table API call that covers them.
+ */
+int xorif_verify_ru_ports_table(uint16_t *num_errors);
+
+/**
+ * @brief Compile the eAxC ID bit layout and RU port mapping for a set of streams.
+ * @param[in] spec Pointer to the required DUs, band sectors, carriers and streams
+ * @param[out] layout Pointer to the resulting layout
+ * @param[out] table Pointer to storage for the RU ports table contents (can be NULL)
+ * @param[in] table_len Number of entries available in the table storage
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * Nothing is written to the h/w (see #xorif_apply_eaxc_layout).
+ * The DU, BS, CC and spatial stream fields are given the smallest widths that
+ * can hold the required numbers. The RU ID is split into a stream type field
+ * (user / PRACH / SSB) above the spatial stream field. Any remaining bits of the
+ * 16-bit eAxC ID are given to the DU field, then BS, then CC, then RU, within the
+ * limits of the device. Inputs that can't be mapped (including more streams
+ * than the device's framer / de-framer spatial streams) are rejected.
+ * The layout's mask and values are suitable for #xorif_set_ru_ports.
+ * The table contents are for RU ports table mode 1 (address = direction + RU ID,
+ * with uplink first), for use with #xorif_set_ru_ports_table_bulk. Unused
+ * addresses are set to "all ones" (UNKNOWN). The table storage must hold
+ * layout.table_size entries; if the device table is too small, table_size is 0.
+ */
+int xorif_compile_eaxc_layout(const struct xorif_eaxc_spec *spec,
+                              struct xorif_eaxc_layout *layout,
+                              struct xorif_ru_port_map *table,
+                              uint16_t table_len);
+
+/**
+ * @brief Program the eAxC ID bits and (mask-based) RU port mapping from a compiled layout.
+ * @param[in] layout Pointer to the layout (see #xorif_compile_eaxc_layout)
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * Equivalent to calling #xorif_set_fhi_eaxc_id and #xorif_set_ru_ports.
+ */
+int xorif_apply_eaxc_layout(const struct xorif_eaxc_layout *layout);
+
 /**
  * @brief Enable / disable Front-Haul Interface interrupts.
  * @param[in] mask Mask (bit-map of interrupt sources)
@@ -1219,13 +2162,161 @@ int xorif_enable_fhi_interrupts(uint32_t mask);
  *      - XORIF_SUCCESS on success
  *      - Error code on failure
  * @note
- * When an alarm interrupt occurs, the interrupt handler calls the call-back
- * function (if it exists) and then performs default handling to log the error
- * and clear the alarm.
- * The call-back function should be short.
+ * When an alarm interrupt occurs, the interrupt handler applies the alarm
+ * reaction policy (see #xorif_set_fhi_alarm_policy), clears the alarm, and then
+ * calls the call-back function (if it exists).
+ * The call-back function should be short. Applications that need to do more
+ * work should use the alarm event queue instead (see #xorif_open_alarm_queue).
  */
 int xorif_register_fhi_isr(isr_func_t callback);
 
+/**
+ * @brief Open the alarm event queue.
+ * @param[out] fd Pointer to write-back the event file descriptor
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * When the queue is open, the interrupt handler adds an event (with a
+ * timestamp) to the queue for each alarm interrupt, and notifies the
+ * application through the event file descriptor (an eventfd). The file
+ * descriptor becomes readable when there are events in the queue; use it with
+ * poll / select / epoll, and then call #xorif_read_alarm_events. Do not read
+ * or close the file descriptor directly.
+ * @note
+ * The queue holds up to 256 events; further events are lost (and counted)
+ * until the queue is read. Opening an open queue returns the same descriptor.
+ */
+int xorif_open_alarm_queue(int *fd);
+
+/**
+ * @brief Close the alarm event queue.
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ */
+int xorif_close_alarm_queue(void);
+
+/**
+ * @brief Read (and remove) events from the alarm event queue.
+ * @param[in] max Maximum number of events to read
+ * @param[out] events Pointer to array of events to write-back (size >= max)
+ * @param[out] num Pointer to write-back the number of events read
+ * @param[out] dropped Pointer to write-back the number of events lost since the previous read (can be NULL)
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * Events are returned oldest first. The event file descriptor stays readable
+ * while there are unread events.
+ */
+int xorif_read_alarm_events(uint16_t max, struct xorif_alarm_event *events, uint16_t *num, uint32_t *dropped);
+
+/**
+ * @brief Get the per-alarm counters.
+ * @param[out] ptr Pointer to structure to write-back the counters
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * The counters are updated by the interrupt handler (whether or not the alarm
+ * event queue is open), and are not affected by #xorif_clear_fhi_alarms.
+ */
+int xorif_get_fhi_alarm_counts(struct xorif_fhi_alarm_counts *ptr);
+
+/**
+ * @brief Clear the per-alarm counters.
+ */
+void xorif_clear_fhi_alarm_counts(void);
+
+/**
+ * @brief Set the reaction policy for one or more alarms.
+ * @param[in] alarms Bit-map of alarms (see enum #xorif_fhi_alarms)
+ * @param[in] action Action (see enum #xorif_alarm_action)
+ * @param[in] cc_mask Bit-map of component carriers to disable (for ALARM_ACTION_DISABLE_CC)
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * The interrupt handler applies the most severe action of the alarms that
+ * are raised; the other alarms are still recorded and logged according to
+ * their own policy. By default, all alarms reset the data-pipe.
+ * @note
+ * The hardware alarms do not identify the component carrier, so the carriers
+ * to disable are part of the policy. Disabled carriers are not de-allocated,
+ * and can be re-enabled with #xorif_enable_cc.
+ * @note
+ * Log messages are limited to one per second for each alarm. The number of
+ * suppressed messages is reported with the next message for that alarm.
+ */
+int xorif_set_fhi_alarm_policy(uint32_t alarms, uint16_t action, uint16_t cc_mask);
+
+/**
+ * @brief Get the reaction policy for an alarm.
+ * @param[in] alarm Alarm (see enum #xorif_fhi_alarms)
+ * @param[out] action Pointer to write-back the action (see enum #xorif_alarm_action)
+ * @param[out] cc_mask Pointer to write-back the bit-map of component carriers to disable (can be NULL)
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ */
+int xorif_get_fhi_alarm_policy(uint32_t alarm, uint16_t *action, uint16_t *cc_mask);
+
+/**
+ * @brief Configure alarm storm detection.
+ * @param[in] threshold Number of occurrences of an alarm within the window that start a storm (0 = disabled)
+ * @param[in] window_ms Detection window (ms)
+ * @param[in] backoff_ms Initial back-off period (ms)
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * During a storm, the alarm's interrupt is masked for the back-off period.
+ * Occurrences that are still seen (e.g. latched in the status when another
+ * alarm interrupts) are coalesced: they are counted, but not logged, queued,
+ * acted on or passed to the call-back. The coalesced count is reported with
+ * the next event for that alarm (see #xorif_alarm_event). The alarm is
+ * re-enabled automatically after the back-off period. If the alarm storms
+ * again soon after, the back-off period is doubled (up to 64 times the
+ * initial period).
+ * @note
+ * By default, storm detection is enabled with 1000 occurrences in 1000 ms
+ * and a 1000 ms back-off. Disabling storm detection re-enables any masked
+ * alarms.
+ */
+int xorif_set_fhi_alarm_storm(uint32_t threshold, uint32_t window_ms, uint32_t backoff_ms);
+
+/**
+ * @brief Get the alarm storm statistics.
+ * @param[out] ptr Pointer to structure to write-back the statistics
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * The statistics are cleared by #xorif_clear_fhi_alarm_counts.
+ */
+int xorif_get_fhi_alarm_storm_stats(struct xorif_fhi_alarm_storm_stats *ptr);
+
+/**
+ * @brief Get the interrupt handler statistics.
+ * @param[out] ptr Pointer to structure to write-back the statistics
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * The FHI and OCP share an interrupt. The handler reads the pending sources
+ * once, and only runs the handlers for those pending. Log messages are
+ * deferred, and printed outside the interrupt path. The handler latency is
+ * measured from entry to exit (including any call-backs), and can be
+ * benchmarked in simulation (NO_HW) using the error injection test function.
+ */
+int xorif_get_irq_stats(struct xorif_irq_stats *ptr);
+
+/**
+ * @brief Clear the interrupt handler statistics.
+ */
+void xorif_clear_irq_stats(void);
+
 /**
  * @brief Set system "constants".
  * @param[in] ptr Point to system constants structure
@@ -1283,6 +2374,60 @@ int xorif_monitor_snapshot(void);
  */
 int xorif_monitor_read(uint8_t counter, uint64_t *value);
 
+/**
+ * @brief Read a list of "monitor block" counters from a single snapshot.
+ * @param num Number of counters (1 to 64)
+ * @param counters Array of counters to read (see PG370 for details)
+ * @param values Array to write back the counter values
+ * @param timestamp Pointer to write back the snapshot time in nanoseconds (monotonic clock, can be NULL)
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * The snapshot is taken by this function (no need for #xorif_monitor_snapshot).
+ * Each counter costs 2 register writes and 2 register reads; repeated counters
+ * are read once.
+ */
+int xorif_monitor_read_bulk(uint16_t num, const uint8_t counters[], uint64_t values[], uint64_t *timestamp);
+
+/**
+ * @brief Start streaming "monitor block" samples.
+ * @param period_us Sampling period (in microseconds)
+ * @param num Number of counters (1 to 64)
+ * @param counters Array of counters to sample
+ * @param depth Number of samples to buffer (2 to 4096)
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * A thread samples the counters periodically (see #xorif_monitor_read_bulk),
+ * and buffers the samples until they are read with #xorif_read_monitor_stream.
+ * If the stream is already running, it is re-started with the new settings.
+ */
+int xorif_start_monitor_stream(uint32_t period_us, uint16_t num, const uint8_t counters[], uint16_t depth);
+
+/**
+ * @brief Stop streaming "monitor block" samples.
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ */
+int xorif_stop_monitor_stream(void);
+
+/**
+ * @brief Read (and remove) the buffered "monitor block" samples, oldest first.
+ * @param max Maximum number of samples to read
+ * @param samples Array to write back the samples
+ * @param num Pointer to write back the number of samples read
+ * @param dropped Pointer to write back the number of samples lost since the previous read (can be NULL)
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * Samples are lost (oldest first) if the buffer is not read often enough.
+ */
+int xorif_read_monitor_stream(uint16_t max, struct xorif_monitor_sample *samples, uint16_t *num, uint32_t *dropped);
+
 /**
  * @brief Take snapshot of the "stall-monitor" flags.
  * @returns
@@ -1309,6 +2454,417 @@ int xorif_stall_monitor_snapshot(void);
  */
 int xorif_stall_monitor_read(struct xorif_stall_monitor *ptr);
 
+/**
+ * @brief Start the stall sampler.
+ * @param[in] period_ms Sampling period (ms)
+ * @param[in] window_ms Sliding window for the stall rates (ms)
+ * @param[in] threshold Number of stall events on any one spatial stream within
+ * the window that triggers the recovery action (0 = disabled)
+ * @param[in] action Recovery action (see #xorif_stall_action)
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * The sampler uses a background thread to poll the "stall-monitor" flags, and
+ * records stall events and durations for each spatial stream. A stall event
+ * starts when a flag goes high and ends when it goes low. Since the hardware
+ * refreshes the flags every 10ms, a period of 10ms (or a small multiple) is
+ * recommended. The window is rounded up to a whole number of periods (up to
+ * 4096).
+ * @note
+ * After a recovery action the sliding window is cleared, so the action is not
+ * triggered again until the threshold is re-crossed.
+ * @note
+ * Starting the sampler again restarts it with the new settings, and clears
+ * the results.
+ */
+int xorif_start_stall_sampler(uint32_t period_ms, uint32_t window_ms, uint32_t threshold, uint16_t action);
+
+/**
+ * @brief Stop the stall sampler.
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * The results are kept (and can still be read) until the sampler is re-started.
+ */
+int xorif_stop_stall_sampler(void);
+
+/**
+ * @brief Clear the stall sampler results.
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ */
+int xorif_clear_stall_stats(void);
+
+/**
+ * @brief Get the stall sampler results for a spatial stream.
+ * @param[in] type Spatial stream type (see #xorif_stall_ss_type)
+ * @param[in] ss Spatial stream
+ * @param[out] ptr Pointer to structure to write-back the results
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ */
+int xorif_get_stall_stats(uint16_t type, uint16_t ss, struct xorif_stall_stats *ptr);
+
+/**
+ * @brief Get the stall sampler status.
+ * @param[out] ptr Pointer to structure to write-back the status
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ */
+int xorif_get_stall_sampler_status(struct xorif_stall_sampler_status *ptr);
+
+/**
+ * @brief Configure (and clear) the UL arrival-time histograms.
+ * @param[in] bin_width_ns Bin width (ns)
+ * @param[in] num_bins Number of bins (1 to ARRIVAL_HIST_MAX_BINS)
+ * @param[in] origin_ns Start of the first bin, relative to the start of the UL reception window (ns)
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * There is a histogram for each component carrier and Ethernet port. The
+ * hardware only counts packets as early, on-time or late (per port), and
+ * captures the largest offset of the earliest packet (per port, held until
+ * read), which isn't relative to a carrier's UL window. So the histograms are
+ * filled by a software sampling model or a capture (see
+ * #xorif_add_arrival_samples). The port's hardware counts are reported
+ * alongside, to cross-check the samples against the current window.
+ */
+int xorif_configure_arrival_histogram(uint32_t bin_width_ns, uint16_t num_bins, int32_t origin_ns);
+
+/**
+ * @brief Clear the UL arrival-time histograms (keeping the configuration).
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ */
+int xorif_clear_arrival_histograms(void);
+
+/**
+ * @brief Add UL packet arrival offsets to a histogram.
+ * @param[in] cc Component carrier
+ * @param[in] port Ethernet port
+ * @param[in] num Number of samples
+ * @param[in] offsets Array of arrival offsets, relative to the start of the UL reception window (ns)
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ */
+int xorif_add_arrival_samples(uint16_t cc, int port, uint16_t num, const int32_t offsets[]);
+
+/**
+ * @brief Get a UL arrival-time histogram (with percentiles).
+ * @param[in] cc Component carrier
+ * @param[in] port Ethernet port
+ * @param[out] ptr Pointer to structure to write-back the histogram
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * Percentiles are interpolated within the bins (and limited to the minimum
+ * and maximum offsets). They are 0 when there are no samples.
+ */
+int xorif_get_arrival_histogram(uint16_t cc, int port, struct xorif_arrival_histogram *ptr);
+
+/**
+ * @brief Get a percentile of a UL arrival-time histogram.
+ * @param[in] cc Component carrier
+ * @param[in] port Ethernet port
+ * @param[in] percentile Percentile (0 to 100)
+ * @param[out] offset_ns Pointer to write-back the arrival offset (ns)
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * For example, a window that starts at the 0.1th percentile and ends at the
+ * 99.9th percentile would receive 99.8% of the (sampled) packets on-time.
+ */
+int xorif_get_arrival_percentile(uint16_t cc, int port, double percentile, int32_t *offset_ns);
+
+/**
+ * @brief Set the flight recorder triggers.
+ * @param[in] triggers Triggers to enable (bit-mask, see enum #xorif_recorder_trigger)
+ * @param[in] alarm_mask Alarms that fire the alarm trigger (bit-mask, see enum #xorif_fhi_alarms)
+ * @param[in] post_records Number of records to capture after the trigger, before freezing
+ * @param[in] dump_file File to dump to when frozen (or NULL / "" to freeze without dumping)
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * The flight recorder is always on (unless it's compiled out by a hardware
+ * profile, in which case the flight recorder functions return
+ * XORIF_NOT_SUPPORTED). It holds the latest #RECORDER_SIZE records of API
+ * calls, errors, alarms, counter samples and stall flag changes, and of the
+ * register writes while it's armed (i.e. triggers or post-trigger records are
+ * set). When an enabled trigger fires, the recorder captures another
+ * "post_records" records (or as many as it can within 1 second), then
+ * freezes, and (optionally) a background thread dumps it to the file
+ * (overwriting it). Only the first trigger fires;
+ * use #xorif_rearm_recorder to start recording again.
+ * The triggers, sampling and dump file are reset by #xorif_finish.
+ */
+int xorif_set_recorder_trigger(uint32_t triggers, uint32_t alarm_mask, uint16_t post_records, const char *dump_file);
+
+/**
+ * @brief Set the flight recorder counter sampling period.
+ * @param[in] period_ms Sampling period (ms, 0 = off)
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * The recorder always records the statistics collector's samples (when it's
+ * running). Otherwise, the recorder can take its own samples of the Ethernet
+ * statistics counters.
+ */
+int xorif_set_recorder_sampling(uint32_t period_ms);
+
+/**
+ * @brief Trigger the flight recorder manually.
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * Does nothing if a trigger has already fired (see #xorif_rearm_recorder).
+ */
+int xorif_trigger_recorder(void);
+
+/**
+ * @brief Re-arm the flight recorder (after it's been triggered).
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * Recording resumes (keeping the records held so far).
+ */
+int xorif_rearm_recorder(void);
+
+/**
+ * @brief Dump the flight recorder to a file.
+ * @param[in] dump_file File name
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * The recorder doesn't need to be frozen, but any records in-progress are
+ * skipped (and counted as lost). See #xorif_recorder_header for the format.
+ */
+int xorif_dump_recorder(const char *dump_file);
+
+/**
+ * @brief Get the flight recorder status.
+ * @param[out] ptr Pointer to structure to write-back the status
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ */
+int xorif_get_recorder_status(struct xorif_recorder_status *ptr);
+
+/**
+ * @brief Start capturing the timeline (spans of the major library operations).
+ * @param[in] max_events Number of spans to hold (0 = #TIMELINE_DEFAULT_EVENTS)
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * Each span records the start time and duration of an operation (e.g.
+ * xorif_init(), the phases of xorif_configure_cc(), RU port table programming,
+ * or xocp_set_schedule()), and the number of register writes it made.
+ * Any spans held are discarded. Capture stops when the timeline is full (the
+ * spans that don't fit are counted as lost). The timeline is independent of
+ * the library state, so it can be started before #xorif_init (to capture it).
+ * It can be (re-)started while other threads are using the library; the spans
+ * still open from the last capture are dropped.
+ */
+int xorif_start_timeline(uint32_t max_events);
+
+/**
+ * @brief Stop capturing the timeline.
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * The spans held are kept (see #xorif_write_timeline).
+ */
+int xorif_stop_timeline(void);
+
+/**
+ * @brief Write the timeline to a file, in Chrome trace event format (JSON).
+ * @param[in] file File name
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * The file can be opened with Perfetto (https://ui.perfetto.dev) or
+ * chrome://tracing. Times are relative to the start of the timeline.
+ * Spans that haven't finished are written as "begin" events.
+ */
+int xorif_write_timeline(const char *file);
+
+/**
+ * @brief Get the timeline status.
+ * @param[out] ptr Pointer to structure to write-back the status
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ */
+int xorif_get_timeline_status(struct xorif_timeline_status *ptr);
+
+/**
+ * @brief Start the background register scrubber.
+ * @param[in] budget Bandwidth budget (register reads per second, 0 = #SCRUB_DEFAULT_BUDGET)
+ * @param[in] mode Scrubber mode (see #xorif_scrub_mode)
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * The scrubber checks that the FHI configuration registers still hold the
+ * values written by the library (e.g. after a stray "devmem" write). Each
+ * configured register range is read, and a checksum of the bits written by
+ * the library is compared with the expected values. For a mismatch, the range
+ * is compared word by word, and each corrupted register field is reported
+ * (see #xorif_get_scrubber_log), and optionally restored.
+ * The scrubber runs at the lowest scheduling priority, and paces its register
+ * reads to the budget, so it doesn't compete with the data-path control.
+ * Only the bits written by the library (since #xorif_init) are checked, and
+ * the registers with side-effects (e.g. strobes, the RU port mapping table)
+ * and status / statistics registers are excluded. Writes made with the direct
+ * register access functions (e.g. #xorif_write_fhi_reg, as used by "poke")
+ * aren't part of the configuration, so they are reported as corruption.
+ * Any running scrubber is stopped first.
+ */
+int xorif_start_scrubber(uint32_t budget, uint16_t mode);
+
+/**
+ * @brief Stop the background register scrubber.
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * The results are kept (see #xorif_get_scrubber_status and #xorif_get_scrubber_log).
+ */
+int xorif_stop_scrubber(void);
+
+/**
+ * @brief Run a single pass of the register scrubber (synchronously, with no bandwidth limit).
+ * @param[in] mode Scrubber mode (see #xorif_scrub_mode)
+ * @param[out] mismatches Pointer to write-back the number of register field mismatches found (or NULL)
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ */
+int xorif_scrub_registers(uint16_t mode, uint32_t *mismatches);
+
+/**
+ * @brief Get the register scrubber status.
+ * @param[out] ptr Pointer to structure to write-back the status
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ */
+int xorif_get_scrubber_status(struct xorif_scrubber_status *ptr);
+
+/**
+ * @brief Get the latest register scrubber mismatches.
+ * @param[in] max Maximum number of mismatches to write-back
+ * @param[out] list Pointer to array to write-back the latest mismatches (oldest first)
+ * @param[out] num Pointer to write-back the number of mismatches
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * The log holds the latest #SCRUB_LOG_SIZE mismatches.
+ */
+int xorif_get_scrubber_log(uint16_t max, struct xorif_scrub_mismatch *list, uint16_t *num);
+
+/**
+ * @brief Clear the register scrubber results (status counts and log).
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ */
+int xorif_clear_scrubber_stats(void);
+
+/**
+ * @brief Calculate the end-to-end latency budget of a component carrier configuration.
+ * @param[in] cc Component carrier
+ * @param[in] transport Pointer to the transport delays (and optional O-DU limits)
+ * @param[out] ptr Pointer to structure to write-back the latency budget
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * The budget is calculated from the requested configuration (i.e. the timing
+ * parameters, numerology and FH_DECAP_DLY system constant), and doesn't need
+ * the component carrier to be configured. It is broken down by stage, with the
+ * O-RAN T2a / Ta3 windows of the O-RU and the T1a / Ta4 windows of the O-DU.
+ * Windows that are closed by the transport delay variation, or that need more
+ * buffering than the hardware has, are reported as violations (the budget is
+ * still calculated). The UL U-plane transmission window (Ta3) is an estimate,
+ * from the radio channel delay plus 1 symbol for packetization.
+ */
+int xorif_get_latency_budget(uint16_t cc, const struct xorif_transport_delay *transport, struct xorif_latency_budget *ptr);
+
+/**
+ * @brief Calculate the expected U-plane bit rates and packet rates of a component carrier.
+ * @param[in] cc Component carrier
+ * @param[in] params Pointer to the calculator parameters
+ * @param[out] ptr Pointer to structure to write-back the bandwidth
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * The rates are calculated from the requested configuration (i.e. the number
+ * of RBs, numerology and IQ compression), the number of spatial streams and
+ * the protocol settings (see #xorif_set_fhi_protocol). The rates include the
+ * eCPRI / IEEE 1914.3, O-RAN, UDP/IP, VLAN and Ethernet overheads, with each
+ * symbol packed into the fewest packets the MTU allows (one section per
+ * packet). The rates are for full load, in each direction.
+ */
+int xorif_get_cc_bandwidth(uint16_t cc, const struct xorif_bandwidth_params *params, struct xorif_cc_bandwidth *ptr);
+
+/**
+ * @brief Calculate the expected U-plane bit rates and packet rates of an Ethernet port.
+ * @param[in] port Ethernet port
+ * @param[in] params Pointer to the calculator parameters
+ * @param[out] ptr Pointer to structure to write-back the bandwidth
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * The totals are for the component carriers (in the parameter's mask)
+ * assigned to the port (see #xorif_get_cc_bandwidth). The link is reported as
+ * overloaded if either direction exceeds the link rate.
+ */
+int xorif_get_port_bandwidth(uint16_t port, const struct xorif_bandwidth_params *params, struct xorif_port_bandwidth *ptr);
+
+/**
+ * @brief Evaluate the supported IQ compression settings of a channel, and recommend the narrowest that meets a quality target.
+ * @param[in] cc Component carrier
+ * @param[in] chan Channel type (see #xorif_chan_type)
+ * @param[in] params Pointer to the advisor parameters
+ * @param[out] ptr Pointer to structure to write-back the advice
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * Each supported setting (see #xorif_get_capabilities) is applied to a
+ * synthetic OFDM test vector, i.e. random QAM symbols on each RE, as carried
+ * in the frequency domain by the U-plane. The EVM and SQNR are measured
+ * against the ideal symbols (so they include the 16-bit quantization). The
+ * bandwidth is for one spatial stream at full load (see #xorif_get_cc_bandwidth).
+ * The recommendation is the narrowest width that meets the target (the lowest
+ * bandwidth, for equal widths). It can be applied with the IQ compression
+ * functions, e.g. #xorif_set_cc_dl_iq_compression, or per spatial stream with
+ * #xorif_set_cc_dl_iq_compression_per_ss. Modulation compression is only
+ * lossless for constellation-aligned data, so it isn't evaluated.
+ */
+int xorif_advise_iq_compression(uint16_t cc, enum xorif_chan_type chan, const struct xorif_comp_advice_params *params, struct xorif_comp_advice *ptr);
+
 #ifdef __cplusplus
 }
 #endif
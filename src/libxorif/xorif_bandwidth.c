@@ -0,0 +1,616 @@
+/*
+ * Copyright 2020 - 2023 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file xorif_bandwidth.c
+ * @author Steven Dickinson
+ * @brief Source file for libxorif bandwidth (bit rate and packet rate) calculator and IQ compression advisor functions.
+ * @addtogroup libxorif
+ * @{
+ */
+
+#include <math.h>
+#include "xorif_common.h"
+#include "xorif_fh_func.h"
+#include "xorif_registers.h"
+#include "xorif_utils.h"
+
+// Ethernet overheads (in bytes)
+#define ETH_L1_OVERHEAD 20 // Preamble, SFD and inter-frame gap
+#define ETH_L2_OVERHEAD 18 // MAC header and FCS
+#define ETH_VLAN_TAG 4     // VLAN tag
+#define ETH_MIN_FRAME 64   // Minimum frame size (MAC header to FCS)
+
+// Transport overheads (in bytes)
+#define IPV4_HEADER 20 // IPv4 header
+#define IPV6_HEADER 40 // IPv6 header
+#define UDP_HEADER 8   // UDP header
+#define ECPRI_HEADER 8 // eCPRI common header, PC_ID and SEQ_ID
+#define ROE_HEADER 8   // IEEE 1914.3 (RoE) header
+
+// O-RAN U-plane overheads (in bytes)
+#define ORAN_APP_HEADER 4  // Application common header
+#define ORAN_SECT_HEADER 4 // Section header (static compression, i.e. M-plane)
+#define ORAN_COMP_HEADER 2 // udCompHdr and reserved (dynamic compression)
+
+// IQ compression advisor test vector
+#define ADVICE_DEFAULT_SYMBOLS 14   // Default number of OFDM symbols
+#define ADVICE_DEFAULT_MODULATION 8 // Default modulation (256QAM)
+#define IQ_PER_RB (RE_PER_RB * 2)   // Number of I and Q samples per RB
+#define IQ_FULL_SCALE 32767.0       // Full scale (16-bit samples)
+
+// Packet headers (protocol settings)
+struct packet_headers
+{
+    uint16_t l2;  // Ethernet overhead per frame (MAC header, VLAN tag and FCS)
+    uint16_t l3;  // Transport overhead per frame, within the MTU (IP, UDP, eCPRI / RoE and O-RAN application header)
+    uint16_t mtu; // MTU (bytes)
+};
+
+// Local function prototypes...
+
+static int get_headers(const struct xorif_bandwidth_params *params, struct packet_headers *hdr);
+static uint16_t calc_prb_size(uint16_t comp_meth, uint16_t comp_width);
+static int calc_flow(const struct packet_headers *hdr,
+                     uint16_t num_rbs,
+                     uint16_t comp_meth,
+                     uint16_t comp_width,
+                     uint16_t mplane,
+                     double sym_rate,
+                     struct xorif_flow_bandwidth *ptr);
+static void add_flow(struct xorif_flow_bandwidth *total, const struct xorif_flow_bandwidth *flow);
+static int calc_cc(uint16_t cc, const struct xorif_bandwidth_params *params, const struct packet_headers *hdr, struct xorif_cc_bandwidth *ptr);
+static uint32_t next_random(uint32_t *state);
+static double make_test_vector(const struct xorif_comp_advice_params *params, uint32_t num_prbs, double *ideal, int16_t *samples);
+static void compress_prb(uint16_t comp_meth, uint16_t comp_width, const int16_t *in, int32_t *out);
+
+// API functions...
+
+int xorif_get_cc_bandwidth(uint16_t cc, const struct xorif_bandwidth_params *params, struct xorif_cc_bandwidth *ptr)
+{
+    TRACE("xorif_get_cc_bandwidth(%d, ...)\n", cc);
+
+    if (cc >= MAX_NUM_CC || cc >= xorif_fhi_get_max_cc())
+    {
+        PERROR("Invalid CC value\n");
+        return XORIF_INVALID_CC;
+    }
+    else if (!params || !ptr)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+
+    struct packet_headers hdr;
+    int result = get_headers(params, &hdr);
+    if (result != XORIF_SUCCESS)
+    {
+        return result;
+    }
+
+    return calc_cc(cc, params, &hdr, ptr);
+}
+
+int xorif_get_port_bandwidth(uint16_t port, const struct xorif_bandwidth_params *params, struct xorif_port_bandwidth *ptr)
+{
+    TRACE("xorif_get_port_bandwidth(%d, ...)\n", port);
+
+    if (port >= xorif_fhi_get_num_eth_ports())
+    {
+        PERROR("Invalid Ethernet port value\n");
+        return XORIF_INVALID_ETH_PORT;
+    }
+    else if (!params || !ptr)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+    else if (params->link_rate < 0)
+    {
+        PERROR("Invalid link rate\n");
+        return XORIF_INVALID_CONFIG;
+    }
+
+    struct packet_headers hdr;
+    int result = get_headers(params, &hdr);
+    if (result != XORIF_SUCCESS)
+    {
+        return result;
+    }
+
+    memset(ptr, 0, sizeof(struct xorif_port_bandwidth));
+    ptr->link_rate = (params->link_rate > 0) ? params->link_rate : BANDWIDTH_DEFAULT_LINK_RATE;
+
+    uint32_t cc_mask = params->cc_mask ? params->cc_mask : xorif_fhi_get_enabled_mask();
+    for (int cc = 0; cc < MAX_NUM_CC && cc < xorif_fhi_get_max_cc(); ++cc)
+    {
+        if (cc_mask & (1 << cc))
+        {
+            struct xorif_cc_bandwidth bw;
+            result = calc_cc(cc, params, &hdr, &bw);
+            if (result != XORIF_SUCCESS)
+            {
+                return result;
+            }
+            if (bw.eth_port == port)
+            {
+                ptr->cc_mask |= (1 << cc);
+                add_flow(&ptr->dl, &bw.dl);
+                add_flow(&ptr->dl, &bw.ssb);
+                add_flow(&ptr->ul, &bw.ul);
+                add_flow(&ptr->ul, &bw.prach);
+            }
+        }
+    }
+
+    // Check link capacity
+    ptr->dl_utilization = ptr->dl.bit_rate / (ptr->link_rate * 1e9);
+    ptr->ul_utilization = ptr->ul.bit_rate / (ptr->link_rate * 1e9);
+    if (ptr->dl_utilization > 1.0)
+    {
+        ptr->overload |= BANDWIDTH_DL_OVERLOAD;
+    }
+    if (ptr->ul_utilization > 1.0)
+    {
+        ptr->overload |= BANDWIDTH_UL_OVERLOAD;
+    }
+
+    if (ptr->overload)
+    {
+        INFO("Ethernet port %d exceeds the link rate (DL %.1f%%, UL %.1f%% of %g Gbps)\n",
+             port, ptr->dl_utilization * 100, ptr->ul_utilization * 100, ptr->link_rate);
+    }
+
+    return XORIF_SUCCESS;
+}
+
+int xorif_advise_iq_compression(uint16_t cc, enum xorif_chan_type chan, const struct xorif_comp_advice_params *params, struct xorif_comp_advice *ptr)
+{
+    TRACE("xorif_advise_iq_compression(%d, %d, ...)\n", cc, chan);
+
+    if (cc >= MAX_NUM_CC || cc >= xorif_fhi_get_max_cc())
+    {
+        PERROR("Invalid CC value\n");
+        return XORIF_INVALID_CC;
+    }
+    else if (!params || !ptr)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+    else if (chan > CHAN_PRACH)
+    {
+        PERROR("Invalid channel type\n");
+        return XORIF_INVALID_CONFIG;
+    }
+    else if ((params->modulation > 10) || (params->modulation & 1))
+    {
+        PERROR("Invalid modulation\n");
+        return XORIF_INVALID_CONFIG;
+    }
+    else if ((params->num_rbs > MAX_NUM_RBS) || (params->backoff < 0) || (params->power_range < 0) || (params->target_evm <= 0))
+    {
+        PERROR("Invalid advisor parameter\n");
+        return XORIF_INVALID_CONFIG;
+    }
+
+    // Channel configuration
+    const struct xorif_cc_config *cfg = &cc_config[cc];
+    uint16_t numerology = cfg->numerology;
+    uint16_t extended_cp = cfg->extended_cp;
+    uint16_t num_rbs = cfg->num_rbs;
+    uint16_t mplane;
+    switch (chan)
+    {
+    case CHAN_DL:
+        mplane = cfg->iq_comp_mplane_dl;
+        break;
+
+    case CHAN_SSB:
+        numerology = cfg->numerology_ssb;
+        extended_cp = cfg->extended_cp_ssb;
+        num_rbs = cfg->num_rbs_ssb;
+        mplane = cfg->iq_comp_mplane_ssb;
+        break;
+
+    case CHAN_PRACH:
+        mplane = cfg->iq_comp_mplane_prach;
+        break;
+
+    case CHAN_UL:
+    default:
+        mplane = cfg->iq_comp_mplane_ul;
+        break;
+    }
+
+    num_rbs = params->num_rbs ? params->num_rbs : num_rbs;
+    if (num_rbs == 0)
+    {
+        PERROR("Invalid number of RBs\n");
+        return XORIF_INVALID_CONFIG;
+    }
+
+    struct xorif_bandwidth_params bw_params = {0};
+    struct packet_headers hdr;
+    int result = get_headers(&bw_params, &hdr);
+    if (result != XORIF_SUCCESS)
+    {
+        return result;
+    }
+
+    // Generate the test vector
+    uint32_t num_prbs = num_rbs * (params->num_symbols ? params->num_symbols : ADVICE_DEFAULT_SYMBOLS);
+    double *ideal = malloc(num_prbs * IQ_PER_RB * sizeof(double));
+    int16_t *samples = malloc(num_prbs * IQ_PER_RB * sizeof(int16_t));
+    if (!ideal || !samples)
+    {
+        free(ideal);
+        free(samples);
+        PERROR("Failed to allocate test vector\n");
+        return XORIF_MEMORY_ALLOCATION_FAIL;
+    }
+    double signal = make_test_vector(params, num_prbs, ideal, samples);
+
+    // Evaluate each supported setting
+    static const uint16_t methods[] = {IQ_COMP_NONE, IQ_COMP_BLOCK_FP};
+    double sym_rate = 100 * 10 * (1 << numerology) * (extended_cp ? 12 : 14);
+    memset(ptr, 0, sizeof(struct xorif_comp_advice));
+    ptr->recommended = COMP_ADVICE_NONE;
+    for (int m = 0; (m < (int)(sizeof(methods) / sizeof(methods[0]))) && (result == XORIF_SUCCESS); ++m)
+    {
+        for (uint16_t width = 1; (width <= 16) && (result == XORIF_SUCCESS); ++width)
+        {
+            if (!check_iq_comp_mode(width, methods[m], chan) || (ptr->num_candidates >= COMP_ADVICE_MAX_CANDIDATES))
+            {
+                continue;
+            }
+
+            double error = 0;
+            for (uint32_t i = 0; i < num_prbs * IQ_PER_RB; i += IQ_PER_RB)
+            {
+                int32_t out[IQ_PER_RB];
+                compress_prb(methods[m], width, &samples[i], out);
+                for (int j = 0; j < IQ_PER_RB; ++j)
+                {
+                    double diff = out[j] - ideal[i + j];
+                    error += diff * diff;
+                }
+            }
+
+            struct xorif_flow_bandwidth flow;
+            result = calc_flow(&hdr, num_rbs, methods[m], width, mplane, sym_rate, &flow);
+
+            struct xorif_comp_candidate *cand = &ptr->candidates[ptr->num_candidates];
+            cand->comp_meth = methods[m];
+            cand->comp_width = width;
+            cand->evm = 100.0 * sqrt(error / signal);
+            cand->sqnr = 10.0 * log10(signal / error);
+            cand->iq_rate = flow.iq_rate;
+            cand->bit_rate = flow.bit_rate;
+            cand->meets_target = (cand->evm <= params->target_evm);
+
+            // Narrowest width, then the lowest bandwidth
+            const struct xorif_comp_candidate *best = &ptr->candidates[ptr->recommended];
+            if (cand->meets_target &&
+                ((ptr->recommended == COMP_ADVICE_NONE) || (cand->comp_width < best->comp_width) ||
+                 ((cand->comp_width == best->comp_width) && (cand->bit_rate < best->bit_rate))))
+            {
+                ptr->recommended = ptr->num_candidates;
+            }
+            ++ptr->num_candidates;
+        }
+    }
+
+    free(ideal);
+    free(samples);
+
+    if ((result == XORIF_SUCCESS) && (ptr->recommended == COMP_ADVICE_NONE))
+    {
+        INFO("No IQ compression setting meets the target (%g%% EVM)\n", params->target_evm);
+    }
+
+    return result;
+}
+
+// Local functions...
+
+/**
+ * @brief Get the packet headers from the protocol settings.
+ * @param[in] params Pointer to the calculator parameters
+ * @param[out] hdr Pointer to the packet headers
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ */
+static int get_headers(const struct xorif_bandwidth_params *params, struct packet_headers *hdr)
+{
+    uint16_t transport = READ_REG(FRAM_PROTOCOL_DEFINITION);
+    uint16_t vlan = READ_REG(FRAM_GEN_VLAN_TAG);
+    uint16_t ip_mode = READ_REG(FRAM_SEL_IPV_ADDRESS_TYPE);
+
+    hdr->l2 = ETH_L2_OVERHEAD + (vlan ? ETH_VLAN_TAG : 0);
+    hdr->l3 = ((transport == PROTOCOL_IEEE_1914_3) ? ROE_HEADER : ECPRI_HEADER) + ORAN_APP_HEADER;
+    if (ip_mode == IP_MODE_IPV4)
+    {
+        hdr->l3 += IPV4_HEADER + UDP_HEADER;
+    }
+    else if (ip_mode == IP_MODE_IPV6)
+    {
+        hdr->l3 += IPV6_HEADER + UDP_HEADER;
+    }
+
+    // MTU (the configured value, limited by the hardware maximum)
+    hdr->mtu = params->mtu;
+    if (hdr->mtu == 0)
+    {
+        hdr->mtu = READ_REG(FRAM_MTU_SIZE);
+        if ((hdr->mtu == 0) || (hdr->mtu > FHI_CAPS.max_framer_ethernet_pkt))
+        {
+            hdr->mtu = FHI_CAPS.max_framer_ethernet_pkt;
+        }
+    }
+
+    if (hdr->mtu <= hdr->l3 + ORAN_SECT_HEADER + ORAN_COMP_HEADER)
+    {
+        PERROR("Invalid MTU size\n");
+        return XORIF_INVALID_CONFIG;
+    }
+
+    return XORIF_SUCCESS;
+}
+
+/**
+ * @brief Calculate the size of a compressed RB (c.f. calc_data_buff_size).
+ * @param[in] comp_meth IQ compression method
+ * @param[in] comp_width IQ compressed width (0 = 16 bits)
+ * @returns
+ *      - Size of RB in bytes
+ */
+static uint16_t calc_prb_size(uint16_t comp_meth, uint16_t comp_width)
+{
+    comp_width = (comp_width == 0) ? 16 : comp_width;
+
+    // (n bits I + n bits Q) per RE and round-up
+    uint16_t size = CEIL_DIV((comp_width * 2 * RE_PER_RB), 8);
+
+    // Plus 1 byte for the compression parameter (udCompParam)
+    if ((comp_meth == IQ_COMP_BLOCK_FP) || (comp_meth == IQ_COMP_BLOCK_SCALE) || (comp_meth == IQ_COMP_U_LAW))
+    {
+        size += 1;
+    }
+
+    return size;
+}
+
+/**
+ * @brief Calculate the bandwidth of a U-plane flow (one spatial stream).
+ * @param[in] hdr Pointer to the packet headers
+ * @param[in] num_rbs Number of RBs per symbol
+ * @param[in] comp_meth IQ compression method
+ * @param[in] comp_width IQ compressed width
+ * @param[in] mplane Flag indicating M-plane (1) or C-plane (0) compression
+ * @param[in] sym_rate Symbols per second
+ * @param[out] ptr Pointer to the flow bandwidth
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * Each symbol is packed into the fewest packets, with one section per packet.
+ */
+static int calc_flow(const struct packet_headers *hdr,
+                     uint16_t num_rbs,
+                     uint16_t comp_meth,
+                     uint16_t comp_width,
+                     uint16_t mplane,
+                     double sym_rate,
+                     struct xorif_flow_bandwidth *ptr)
+{
+    memset(ptr, 0, sizeof(struct xorif_flow_bandwidth));
+    if ((num_rbs == 0) || (sym_rate == 0))
+    {
+        return XORIF_SUCCESS;
+    }
+
+    uint16_t prb_size = calc_prb_size(comp_meth, comp_width);
+    uint16_t overhead = hdr->l3 + ORAN_SECT_HEADER + (mplane ? 0 : ORAN_COMP_HEADER);
+    uint16_t rbs_per_packet = (hdr->mtu - overhead) / prb_size;
+    if (rbs_per_packet == 0)
+    {
+        PERROR("Invalid MTU size\n");
+        return XORIF_INVALID_CONFIG;
+    }
+
+    // Full packets, plus the remainder
+    uint16_t num_packets = CEIL_DIV(num_rbs, rbs_per_packet);
+    uint16_t last_rbs = num_rbs - (num_packets - 1) * rbs_per_packet;
+    uint16_t full_frame = hdr->l2 + overhead + rbs_per_packet * prb_size;
+    uint16_t last_frame = hdr->l2 + overhead + last_rbs * prb_size;
+
+    // Short frames are padded
+    full_frame = (full_frame < ETH_MIN_FRAME) ? ETH_MIN_FRAME : full_frame;
+    last_frame = (last_frame < ETH_MIN_FRAME) ? ETH_MIN_FRAME : last_frame;
+    double bytes = (num_packets - 1) * (full_frame + ETH_L1_OVERHEAD) + (last_frame + ETH_L1_OVERHEAD);
+
+    ptr->iq_rate = num_rbs * prb_size * 8 * sym_rate;
+    ptr->bit_rate = bytes * 8 * sym_rate;
+    ptr->packet_rate = num_packets * sym_rate;
+    ptr->frame_size = (num_packets > 1) ? full_frame : last_frame;
+    return XORIF_SUCCESS;
+}
+
+/**
+ * @brief Add a flow to a total.
+ * @param[in,out] total Pointer to the total
+ * @param[in] flow Pointer to the flow
+ */
+static void add_flow(struct xorif_flow_bandwidth *total, const struct xorif_flow_bandwidth *flow)
+{
+    total->iq_rate += flow->iq_rate;
+    total->bit_rate += flow->bit_rate;
+    total->packet_rate += flow->packet_rate;
+    if (flow->frame_size > total->frame_size)
+    {
+        total->frame_size = flow->frame_size;
+    }
+}
+
+/**
+ * @brief Calculate the bandwidth of a component carrier.
+ * @param[in] cc Component carrier
+ * @param[in] params Pointer to the calculator parameters
+ * @param[in] hdr Pointer to the packet headers
+ * @param[out] ptr Pointer to the component carrier bandwidth
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ */
+static int calc_cc(uint16_t cc, const struct xorif_bandwidth_params *params, const struct packet_headers *hdr, struct xorif_cc_bandwidth *ptr)
+{
+    const struct xorif_cc_config *cfg = &cc_config[cc];
+
+    memset(ptr, 0, sizeof(struct xorif_cc_bandwidth));
+    xorif_get_cc_planned_eth_port(cc, &ptr->eth_port);
+    ptr->mtu = hdr->mtu;
+
+    // Symbols per second (10 sub-frames per frame, 100 frames per second)
+    double sym_rate = 100 * 10 * (1 << cfg->numerology) * (cfg->extended_cp ? 12 : 14);
+
+    // Spatial streams are identical, so scale a single stream
+    int result;
+    struct xorif_flow_bandwidth flow;
+    struct
+    {
+        struct xorif_flow_bandwidth *ptr;
+        uint16_t streams;
+        uint16_t num_rbs;
+        uint16_t comp_meth;
+        uint16_t comp_width;
+        uint16_t mplane;
+        double sym_rate;
+    } flows[] = {
+        {&ptr->dl, params->dl_streams, cfg->num_rbs, cfg->iq_comp_meth_dl, cfg->iq_comp_width_dl, cfg->iq_comp_mplane_dl, sym_rate},
+        {&ptr->ul, params->ul_streams, cfg->num_rbs, cfg->iq_comp_meth_ul, cfg->iq_comp_width_ul, cfg->iq_comp_mplane_ul, sym_rate},
+        {&ptr->prach, params->prach_streams, params->prach_rbs, cfg->iq_comp_meth_prach, cfg->iq_comp_width_prach, cfg->iq_comp_mplane_prach, params->prach_symbols * 100.0},
+        {&ptr->ssb, HAS_SSB ? params->ssb_streams : 0, cfg->num_rbs_ssb, cfg->iq_comp_meth_ssb, cfg->iq_comp_width_ssb, cfg->iq_comp_mplane_ssb, params->ssb_symbols * 100.0},
+    };
+
+    for (int i = 0; i < (int)(sizeof(flows) / sizeof(flows[0])); ++i)
+    {
+        result = calc_flow(hdr, flows[i].num_rbs, flows[i].comp_meth, flows[i].comp_width, flows[i].mplane, flows[i].sym_rate, &flow);
+        if (result != XORIF_SUCCESS)
+        {
+            return result;
+        }
+        flows[i].ptr->iq_rate = flow.iq_rate * flows[i].streams;
+        flows[i].ptr->bit_rate = flow.bit_rate * flows[i].streams;
+        flows[i].ptr->packet_rate = flow.packet_rate * flows[i].streams;
+        flows[i].ptr->frame_size = flows[i].streams ? flow.frame_size : 0;
+    }
+
+    return XORIF_SUCCESS;
+}
+
+/**
+ * @brief Next pseudo-random number (xorshift32, so the test vectors are repeatable).
+ * @param[in,out] state Pointer to generator state (non-zero)
+ * @returns
+ *      - Pseudo-random number
+ */
+static uint32_t next_random(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+/**
+ * @brief Make a synthetic OFDM test vector (random QAM symbols on each RE, in the frequency domain).
+ * @param[in] params Pointer to the advisor parameters
+ * @param[in] num_prbs Number of PRBs (RBs x symbols)
+ * @param[out] ideal Pointer to the ideal I and Q samples
+ * @param[out] samples Pointer to the 16-bit I and Q samples (rounded and clipped)
+ * @returns
+ *      - Signal energy (sum of the squared ideal samples)
+ */
+static double make_test_vector(const struct xorif_comp_advice_params *params, uint32_t num_prbs, double *ideal, int16_t *samples)
+{
+    // Constellation levels per axis, and the scale for unit RMS
+    uint16_t bits = params->modulation ? params->modulation : ADVICE_DEFAULT_MODULATION;
+    int levels = 1 << (bits / 2);
+    double scale = IQ_FULL_SCALE * pow(10, -params->backoff / 20) / sqrt(2.0 * (levels * levels - 1) / 3);
+
+    uint32_t state = params->seed ? params->seed : 1;
+    double energy = 0;
+    for (uint32_t prb = 0; prb < num_prbs; ++prb)
+    {
+        double gain = scale * pow(10, -params->power_range * (next_random(&state) / 4294967296.0) / 20);
+        for (int i = 0; i < IQ_PER_RB; ++i)
+        {
+            double value = gain * (2 * (int)(next_random(&state) % levels) - (levels - 1));
+            double clipped = (value > IQ_FULL_SCALE) ? IQ_FULL_SCALE : (value < -IQ_FULL_SCALE - 1) ? -IQ_FULL_SCALE - 1 : value;
+            ideal[prb * IQ_PER_RB + i] = value;
+            samples[prb * IQ_PER_RB + i] = (int16_t)lround(clipped);
+            energy += value * value;
+        }
+    }
+
+    return energy;
+}
+
+/**
+ * @brief Compress and de-compress the I and Q samples of a PRB.
+ * @param[in] comp_meth IQ compression method (none or block floating point)
+ * @param[in] comp_width IQ compressed width (1-16)
+ * @param[in] in Pointer to the 16-bit I and Q samples
+ * @param[out] out Pointer to the de-compressed I and Q samples
+ * @note
+ * Block floating point uses the exponent that fits the largest sample into
+ * the (signed) mantissa, and rounds. No compression uses the MSBs of the
+ * 16-bit samples.
+ */
+static void compress_prb(uint16_t comp_meth, uint16_t comp_width, const int16_t *in, int32_t *out)
+{
+    int shift = 16 - comp_width;
+    if (comp_meth == IQ_COMP_BLOCK_FP)
+    {
+        // Number of magnitude bits needed (the OR has the same bit-length as the largest)
+        int32_t mags = 0;
+        for (int i = 0; i < IQ_PER_RB; ++i)
+        {
+            mags |= (in[i] < 0) ? ~in[i] : in[i];
+        }
+        int bits = 0;
+        while (mags >> bits)
+        {
+            ++bits;
+        }
+        shift = (bits + 1 > comp_width) ? bits + 1 - comp_width : 0;
+    }
+
+    int32_t max = (1 << (comp_width - 1)) - 1;
+    int32_t min = -(1 << (comp_width - 1));
+    for (int i = 0; i < IQ_PER_RB; ++i)
+    {
+        int32_t value = shift ? ((in[i] + (1 << (shift - 1))) >> shift) : in[i];
+        value = (value > max) ? max : (value < min) ? min : value;
+        out[i] = value * (1 << shift);
+    }
+}
+
+/** @} */
@@ -26,6 +26,7 @@
 
 #include "xorif_common.h"
 #include "xorif_fh_func.h"
+#include "xorif_alarms.h"
 #include "xorif_utils.h"
 #include "xorif_registers.h"
 
@@ -33,7 +34,7 @@
 uint16_t xorif_state = 0;
 int xorif_trace = 0;
 struct xorif_caps fhi_caps;
-struct xorif_cc_config cc_config[MAX_NUM_CC];
+struct xorif_cc_config *cc_config = NULL;
 struct xorif_device_info fh_device;
 #ifdef EXTRA_DEBUG
 FILE *log_file = NULL;
@@ -77,12 +78,28 @@ int xorif_retrieve_device_info(struct metal_device **dev, struct metal_io_region
 
 /**
  * @brief Initialize the configuration data.
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - XORIF_MEMORY_ALLOCATION_FAIL on failure
+ * @note
+ * The per-CC configuration is sized by the number of component carriers
+ * reported in the capabilities, so must be called after xorif_fhi_init_device().
  */
-static void initialize_configuration(void)
+static int initialize_configuration(void)
 {
+    int num_cc = xorif_fhi_get_max_cc();
+
+    // Allocate the component carrier state and configuration
+    free(cc_config);
+    cc_config = calloc(num_cc ? num_cc : 1, sizeof(struct xorif_cc_config));
+    if (!cc_config)
+    {
+        PERROR("Failed to allocate component carrier configuration\n");
+        return XORIF_MEMORY_ALLOCATION_FAIL;
+    }
+
     // Initialize the component carrier state and configuration
-    memset(cc_config, 0, sizeof(cc_config));
-    for (int i = 0; i < MAX_NUM_CC; ++i)
+    for (int i = 0; i < num_cc; ++i)
     {
         // Populate structure with defaults
         cc_config[i].num_rbs = 0;
@@ -118,6 +135,8 @@ static void initialize_configuration(void)
         cc_config[i].num_frames_per_sym = DEFAULT_FRAMES_PER_SYM;
         cc_config[i].num_frames_per_sym_ssb = DEFAULT_FRAMES_PER_SYM_SSB;
     }
+
+    return XORIF_SUCCESS;
 }
 
 int xorif_get_state(void)
@@ -154,6 +173,7 @@ void xorif_debug(int level)
 int xorif_init(const char *device_name)
 {
     TRACE("xorif_init(%s)\n", device_name ? device_name : "NULL");
+    SPAN_SCOPE(__func__, "init", NULL, 0);
 
     // See if we're already initialized
     if (xorif_state != 0)
@@ -183,6 +203,7 @@ int xorif_init(const char *device_name)
 
         // Initialize libmetal
         INFO("Initializing libmetal framework\n");
+        SPAN_PHASE("metal_init", "init");
         if (metal_init(&init_param))
         {
             PERROR("Failed to initialize libmetal framework\n");
@@ -192,6 +213,7 @@ int xorif_init(const char *device_name)
 #endif
 
     // Get best-match device name
+    SPAN_PHASE("get_device_name", "init");
     device_name = get_device_name(device_name, compatible);
     if (device_name == NULL)
     {
@@ -203,6 +225,7 @@ int xorif_init(const char *device_name)
         // Add FHI device
         INFO("FHI device is '%s'\n", device_name);
 
+        SPAN_PHASE("add_device", "init");
         if (add_device(&fh_device, "platform", device_name, fhi_irq_handler) != XORIF_SUCCESS)
         {
             PERROR("Failed to add FHI device '%s'\n", device_name);
@@ -211,10 +234,24 @@ int xorif_init(const char *device_name)
     }
 
     // Initialize FHI device
-    xorif_fhi_init_device();
+    SPAN_PHASE_END();
+    if (xorif_fhi_init_device() != XORIF_SUCCESS)
+    {
+        return XORIF_INVALID_CONFIG;
+    }
 
     // Initialize the default component configuration
-    initialize_configuration();
+    SPAN_PHASE("initialize_configuration", "init");
+    if (initialize_configuration() != XORIF_SUCCESS)
+    {
+        return XORIF_MEMORY_ALLOCATION_FAIL;
+    }
+
+    // Start the alarm thread (the interrupt handler only wakes it)
+    if (xorif_alarm_storm_init() != XORIF_SUCCESS)
+    {
+        return XORIF_FAILURE;
+    }
 
     // Update state to 'operational'
     xorif_state = 1;
@@ -229,6 +266,19 @@ void xorif_finish(void)
 
     if (xorif_state != 0)
     {
+        // Stop the statistics collector, monitor stream, stall sampler and register scrubber (if running)
+        xorif_stop_stats_collector();
+        xorif_stop_monitor_stream();
+        xorif_stop_stall_sampler();
+        xorif_stop_scrubber();
+
+        // Close the alarm event queue (if open), and stop the alarm thread
+        xorif_close_alarm_queue();
+        xorif_alarm_storm_finish();
+
+        // Stop the flight recorder thread (the records are kept)
+        xorif_recorder_finish();
+
 #ifndef NO_HW
         // Close FHI device
         if (fh_device.dev != NULL)
@@ -251,6 +301,14 @@ void xorif_finish(void)
         metal_finish();
 #endif
 #endif
+        // Release the component carrier configuration
+        // Note, the per-CC/port functions check against these, so they fail
+        // (rather than use the released configuration) until re-initialized
+        free(cc_config);
+        cc_config = NULL;
+        fhi_caps.max_cc = 0;
+        fhi_caps.num_eth_ports = 0;
+
         // Set state to 'not operational'
         xorif_state = 0;
     }
@@ -322,9 +380,24 @@ int xorif_configure_cc(uint16_t cc)
     return xorif_fhi_configure_cc(cc);
 }
 
+int xorif_configure_cc_hot_add(uint16_t cc)
+{
+    TRACE("xorif_configure_cc_hot_add(%d)\n", cc);
+
+    if (cc >= MAX_NUM_CC || cc >= xorif_fhi_get_max_cc())
+    {
+        PERROR("Invalid CC value\n");
+        return XORIF_INVALID_CC;
+    }
+
+    // Configure the FHI
+    return xorif_fhi_configure_cc_hot_add(cc);
+}
+
 int xorif_enable_cc(uint16_t cc)
 {
     TRACE("xorif_enable_cc(%d)\n", cc);
+    SPAN_SCOPE(__func__, "cc", "cc", cc);
 
     if (cc >= MAX_NUM_CC || cc >= xorif_fhi_get_max_cc())
     {
@@ -340,6 +413,7 @@ int xorif_enable_cc(uint16_t cc)
 int xorif_disable_cc(uint16_t cc)
 {
     TRACE("xorif_disable_cc(%d)\n", cc);
+    SPAN_SCOPE(__func__, "cc", "cc", cc);
 
     if (cc >= MAX_NUM_CC || cc >= xorif_fhi_get_max_cc())
     {
@@ -352,7 +426,7 @@ int xorif_disable_cc(uint16_t cc)
     }
 }
 
-uint8_t xorif_get_enabled_cc_mask(void)
+uint16_t xorif_get_enabled_cc_mask(void)
 {
     TRACE("xorif_get_enabled_cc_mask()\n");
     return xorif_fhi_get_enabled_mask();
@@ -469,6 +543,11 @@ int xorif_set_cc_num_rbs_ssb(uint16_t cc, uint16_t num_rbs)
         PERROR("Invalid CC value\n");
         return XORIF_INVALID_CC;
     }
+    else if (!HAS_SSB)
+    {
+        PERROR("SSB not supported\n");
+        return XORIF_NOT_SUPPORTED;
+    }
     else if (!(num_rbs == SSB_NUM_RBS || num_rbs == 0))
     {
         PERROR("Invalid number of RBs\n");
@@ -489,6 +568,11 @@ int xorif_set_cc_numerology_ssb(uint16_t cc, uint16_t numerology, uint16_t exten
         PERROR("Invalid CC value\n");
         return XORIF_INVALID_CC;
     }
+    else if (!HAS_SSB)
+    {
+        PERROR("SSB not supported\n");
+        return XORIF_NOT_SUPPORTED;
+    }
     else if (!check_numerology(numerology, extended_cp))
     {
         PERROR("Invalid numerology\n");
@@ -659,6 +743,11 @@ int xorif_set_cc_iq_compression_ssb(uint16_t cc,
         PERROR("Invalid CC value\n");
         return XORIF_INVALID_CC;
     }
+    else if (!HAS_SSB)
+    {
+        PERROR("SSB not supported\n");
+        return XORIF_NOT_SUPPORTED;
+    }
     else if (!check_iq_comp_mode(bit_width, comp_method, CHAN_SSB))
     {
         PERROR("IQ compression method/width not supported (SSB)\n");
@@ -684,6 +773,11 @@ int xorif_set_cc_iq_compression_prach(uint16_t cc,
         PERROR("Invalid CC value\n");
         return XORIF_INVALID_CC;
     }
+    else if (!HAS_PRACH)
+    {
+        PERROR("PRACH not supported\n");
+        return XORIF_NOT_SUPPORTED;
+    }
     else if (!check_iq_comp_mode(bit_width, comp_method, CHAN_PRACH))
     {
         PERROR("IQ compression method/width not supported (PRACH)\n");
@@ -762,6 +856,11 @@ int xorif_set_cc_sections_per_symbol_ssb(uint16_t cc,
         PERROR("Invalid CC value\n");
         return XORIF_INVALID_CC;
     }
+    else if (!HAS_SSB)
+    {
+        PERROR("SSB not supported\n");
+        return XORIF_NOT_SUPPORTED;
+    }
     // No upper limit, only buffer space which is checked during configuration
 
     cc_config[cc].num_sect_per_sym_ssb = num_sect;
@@ -779,6 +878,11 @@ int xorif_set_cc_frames_per_symbol_ssb(uint16_t cc, uint16_t num_frames)
         PERROR("Invalid CC value\n");
         return XORIF_INVALID_CC;
     }
+    else if (!HAS_SSB)
+    {
+        PERROR("SSB not supported\n");
+        return XORIF_NOT_SUPPORTED;
+    }
     // No upper limit, only buffer space which is checked during configuration
 
     cc_config[cc].num_frames_per_sym_ssb = num_frames;
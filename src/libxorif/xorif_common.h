@@ -41,6 +41,27 @@
 #include "xorif_api.h"
 #include "xorif_system.h"
 
+// Hardware profile
+// A specialized build (make PROFILE=<name>) fixes the capabilities at compile-time
+// so that checks against them fold away; otherwise they're read from the device
+#ifdef XORIF_PROFILE
+#include XORIF_PROFILE
+#define FHI_CAPS xorif_profile_caps
+#if HAS_OCP && !defined(INTEGRATED_OCP)
+#error "Hardware profile requires OCP=1"
+#elif !HAS_OCP && defined(INTEGRATED_OCP)
+#error "Hardware profile doesn't support OCP (remove OCP=1)"
+#endif
+#else
+#define FHI_CAPS fhi_caps
+#define HAS_SSB 1
+#define HAS_PRACH 1
+#define HAS_RECORDER 1
+#endif
+
+#include "xorif_recorder.h"
+#include "xorif_timeline.h"
+
 /*******************************************/
 /*** Constants / macros / structs / etc. ***/
 /*******************************************/
@@ -61,9 +82,13 @@
 #define ANSI_COLOR_RESET "\x1b[0m"
 
 // Debug / logging macros
+// Note, the API calls (TRACE) and errors (PERROR) are recorded by the flight
+// recorder (unless HAS_RECORDER is 0); TRACE_REG is for register accesses
+// (recorded separately)
 #ifdef DEBUG
 #define PERROR(format, ...)                                      \
     {                                                            \
+        xorif_record_error(__func__);                            \
         fprintf(stderr, ANSI_COLOR_RED);                         \
         fprintf(stderr, "XORIF> ERROR: " format, ##__VA_ARGS__); \
         fprintf(stderr, ANSI_COLOR_RESET);                       \
@@ -71,6 +96,16 @@
     }
 
 #define TRACE(format, ...)                           \
+    {                                                \
+        xorif_record_api(__func__);                  \
+        if (xorif_trace >= 1)                        \
+        {                                            \
+            printf("XORIF> " format, ##__VA_ARGS__); \
+            fflush(stdout);                          \
+        }                                            \
+    }
+
+#define TRACE_REG(format, ...)                       \
     {                                                \
         if (xorif_trace >= 1)                        \
         {                                            \
@@ -115,8 +150,9 @@
     }
 
 #else
-#define PERROR(format, ...)
-#define TRACE(format, ...)
+#define PERROR(format, ...) xorif_record_error(__func__)
+#define TRACE(format, ...) xorif_record_api(__func__)
+#define TRACE_REG(format, ...)
 #define INFO(format, ...)
 #define ASSERT(expression)
 #define ASSERT_V(expression)
@@ -153,7 +189,7 @@ struct xorif_device_info
 extern uint16_t xorif_state;
 extern int xorif_trace;
 extern struct xorif_caps fhi_caps;
-extern struct xorif_cc_config cc_config[MAX_NUM_CC];
+extern struct xorif_cc_config *cc_config;
 extern struct xorif_device_info fh_device;
 #ifdef NO_HW
 extern uint32_t fake_reg_bank[0x10000 / 4];
@@ -23,10 +23,14 @@
  */
 
 #include <math.h>
+#include <time.h>
 #include "xorif_common.h"
 #include "xorif_fh_func.h"
 #include "xorif_utils.h"
 #include "xorif_registers.h"
+#include "xorif_stats.h"
+#include "xorif_alarms.h"
+#include "xorif_scrubber.h"
 
 // FHI alarm flags and counters
 static uint32_t fhi_alarm_status = 0;
@@ -37,6 +41,9 @@ static isr_func_t fhi_callback = NULL;
 #ifdef NO_HW
 // Fake register bank
 uint32_t fake_reg_bank[0x10000 / 4];
+
+// Number of component carriers reported by the fake register bank
+static uint16_t fake_max_cc = 8;
 #endif
 
 // Clock default value (gets set later from register)
@@ -71,14 +78,37 @@ static uint16_t num_bs_bits = 0;
 static uint16_t num_cc_bits = 0;
 
 #ifdef INTEGRATED_OCP
-// Storage for callback handler for OCP interrupts
-typedef void (*ocp_callback_t)(uint16_t instance);
+// Storage for status and callback handler for OCP interrupts
+typedef uint32_t (*ocp_status_t)(uint16_t instance);
+typedef void (*ocp_callback_t)(uint16_t instance, uint32_t status);
+ocp_status_t ocp_status = NULL;
 ocp_callback_t ocp_callback = NULL;
 #endif
 
 // Unknown "stream type" for RU port mapping (used to de-allocate the address)
 #define UNKNOWN_STREAM_TYPE 0x7
 
+// RU port mapping table shadow (entries are the <ccid> | <port> | <type> fields)
+#define RU_PORTS_TABLE_MAX_SIZE 2048
+#define RU_PORTS_ENTRY_MASK (DEFM_CID_MAP_WR_STREAM_CCID_MASK | DEFM_CID_MAP_WR_STREAM_PORTID_MASK | \
+                             DEFM_CID_MAP_WR_STREAM_TYPE_MASK)
+#define RU_PORTS_ENTRY_UNKNOWN 0xFFFFFFFF
+static uint32_t ru_ports_shadow[RU_PORTS_TABLE_MAX_SIZE];
+#ifdef EXTRA_DEBUG
+static int ru_ports_table_writes = 0;
+#endif
+
+// Multi-O-DU table shadow (entries are <MAC address 47:0> << 16 | <VLAN tag>)
+#define MODU_TABLE_SIZE (ETH_DU_TABLE_WR_TABLE_ADDR_MASK + 1)
+static uint64_t modu_shadow[MAX_NUM_ETH_PORTS][MODU_TABLE_SIZE];
+static uint16_t modu_shadow_valid[MAX_NUM_ETH_PORTS];
+#ifdef EXTRA_DEBUG
+static int modu_table_writes = 0;
+#endif
+
+// Ethernet port planned for each component carrier (bookkeeping only, the IP core has no per-CC port selection)
+static uint16_t planned_eth_port[MAX_NUM_CC];
+
 // Local function prototypes...
 static uint16_t calc_sym_num(uint16_t numerology, uint16_t extended_cp, double time);
 static uint16_t calc_data_buff_size(uint16_t num_rbs,
@@ -89,6 +119,10 @@ static uint16_t calc_data_buff_size(uint16_t num_rbs,
                                     uint16_t num_frames);
 static void initialize_memory(void);
 static void deallocate_memory(int cc);
+static int configure_cc(uint16_t cc, int hot_add);
+static int write_ru_ports_entry(uint16_t address, uint32_t entry);
+static uint64_t pack_modu_entry(const struct xorif_modu_entry *ptr);
+static int write_modu_entry(int port, uint16_t du, uint64_t entry);
 #ifdef NO_HW
 static void init_fake_reg_bank(void);
 #endif
@@ -98,9 +132,11 @@ static void init_fake_reg_bank(void);
 int xorif_reset_fhi(uint16_t mode)
 {
     TRACE("xorif_reset_fhi(%d)\n", mode);
+    SPAN_SCOPE(__func__, "init", "mode", mode);
 
     // Reset framer/de-framer
     WRITE_REG(FRAM_DISABLE, 1);
+    xorif_stats_restart();
     WRITE_REG(DEFM_RESTART, 1);
 
     // Reset component carrier enables
@@ -109,6 +145,12 @@ int xorif_reset_fhi(uint16_t mode)
     // Initialize memory allocation system
     initialize_memory();
 
+    // Contents of the RU port mapping table are unknown (the reset may have cleared it)
+    memset(ru_ports_shadow, 0xFF, sizeof(ru_ports_shadow));
+
+    // Contents of the multi-O-DU tables are unknown (the reset may have cleared them)
+    memset(modu_shadow_valid, 0, sizeof(modu_shadow_valid));
+
     // Clear alarms and counters
     xorif_clear_fhi_alarms();
     xorif_clear_fhi_stats();
@@ -168,8 +210,8 @@ void xorif_clear_fhi_stats(void)
 {
     TRACE("xorif_clear_fhi_stats()\n");
 
-    // Take snapshot (with reset)
-    WRITE_REG_RAW(DEFM_SNAP_SHOT_ADDR, 0xFFFFFFFF);
+    // Take snapshot (with reset), and clear the software accumulators
+    xorif_stats_clear();
 }
 
 int xorif_get_fhi_eth_stats(int port, struct xorif_fhi_eth_stats *ptr)
@@ -302,25 +344,98 @@ int xorif_set_modu_dest_mac_addr(uint16_t du,
 {
     TRACE("xorif_set_modu_dest_mac_addr(%d, ..., %d, %d, %d)\n", du, id, dei, pcp);
 
+    if (du >= MODU_TABLE_SIZE)
+    {
+        PERROR("Invalid O-DU port address\n");
+        return XORIF_INVALID_CONFIG;
+    }
+
+    struct xorif_modu_entry e = {.id = id, .dei = dei, .pcp = pcp};
+    memcpy(e.address, address, sizeof(e.address));
+    uint64_t entry = pack_modu_entry(&e);
+
     // Configure for all Ethernet ports
     for (int i = 0; i < xorif_fhi_get_num_eth_ports(); ++i)
     {
-        // MAC address
-        uint32_t addr_hi = address[0] << 8 | address[1];
-        uint32_t addr_lo = address[2] << 24 | address[3] << 16 | address[4] << 8 | address[5];
-        WRITE_REG_OFFSET(ETH_DU_TABLE_WR_DEST_ADDR_47_32, i * 0x100, addr_hi);
-        WRITE_REG_OFFSET(ETH_DU_TABLE_WR_DEST_ADDR_31_0, i * 0x100, addr_lo);
+        write_modu_entry(i, du, entry);
+    }
+    return XORIF_SUCCESS;
+}
 
-        // VLAN tag
-        WRITE_REG_OFFSET(ETH_DU_TABLE_WR_VLAN_ID, i * 0x100, id);
-        WRITE_REG_OFFSET(ETH_DU_TABLE_WR_VLAN_DEI, i * 0x100, dei);
-        WRITE_REG_OFFSET(ETH_DU_TABLE_WR_VLAN_PCP, i * 0x100, pcp);
+int xorif_set_modu_table(int port, uint16_t du, uint16_t number, const struct xorif_modu_entry *table)
+{
+    TRACE("xorif_set_modu_table(%d, %d, %d, ...)\n", port, du, number);
 
-        // DU port address
-        WRITE_REG_OFFSET(ETH_DU_TABLE_WR_TABLE_ADDR, i * 0x100, du);
+    if (port >= xorif_fhi_get_num_eth_ports())
+    {
+        PERROR("Invalid Ethernet port value\n");
+        return XORIF_INVALID_ETH_PORT;
+    }
+    else if (!table)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+    else if ((du + number) > MODU_TABLE_SIZE)
+    {
+        PERROR("Invalid O-DU port address range\n");
+        return XORIF_INVALID_CONFIG;
+    }
+
+    // Only the entries that differ from the shadow are written
+    for (int i = 0; i < number; ++i)
+    {
+        write_modu_entry(port, du + i, pack_modu_entry(&table[i]));
+    }
+    return XORIF_SUCCESS;
+}
+
+int xorif_get_modu_table(int port, uint16_t du, uint16_t number, struct xorif_modu_entry *table)
+{
+    TRACE("xorif_get_modu_table(%d, %d, %d, ...)\n", port, du, number);
+
+    if (port >= xorif_fhi_get_num_eth_ports())
+    {
+        PERROR("Invalid Ethernet port value\n");
+        return XORIF_INVALID_ETH_PORT;
+    }
+    else if (!table)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+    else if ((du + number) > MODU_TABLE_SIZE)
+    {
+        PERROR("Invalid O-DU port address range\n");
+        return XORIF_INVALID_CONFIG;
+    }
 
-        // WR strobe (set high, it auto-clears)
-        WRITE_REG_OFFSET(ETH_DU_TABLE_WR_STROBE, i * 0x100, 1);
+    for (int i = 0; i < number; ++i)
+    {
+        // Read back from the hardware (RD strobe, then read the entry)
+        WRITE_REG_RAW_ALT("ETH_DU_TABLE_RD_STROBE_ADDR", ETH_DU_TABLE_RD_STROBE_ADDR + (port * 0x100),
+                          (1U << 31) | (du + i));
+        uint32_t addr_hi = READ_REG_OFFSET(ETH_DU_TABLE_RD_DEST_ADDR_47_32, port * 0x100);
+        uint32_t addr_lo = READ_REG_OFFSET(ETH_DU_TABLE_RD_DEST_ADDR_31_0, port * 0x100);
+        uint32_t vlan = READ_REG_RAW_ALT("ETH_DU_TABLE_RD_VLAN_ADDR", ETH_DU_TABLE_RD_VLAN_ID_ADDR + (port * 0x100)) & 0xFFFF;
+
+        struct xorif_modu_entry *e = &table[i];
+        e->address[0] = addr_hi >> 8;
+        e->address[1] = addr_hi;
+        e->address[2] = addr_lo >> 24;
+        e->address[3] = addr_lo >> 16;
+        e->address[4] = addr_lo >> 8;
+        e->address[5] = addr_lo;
+        e->id = vlan & 0xFFF;
+        e->dei = (vlan >> 12) & 0x1;
+        e->pcp = (vlan >> 13) & 0x7;
+
+        // The hardware is the reference, so update the shadow
+        if (port < MAX_NUM_ETH_PORTS)
+        {
+            modu_shadow[port][du + i] = pack_modu_entry(e);
+            modu_shadow_valid[port] |= (1 << (du + i));
+        }
     }
     return XORIF_SUCCESS;
 }
@@ -329,7 +444,7 @@ int xorif_set_mtu_size(uint16_t size)
 {
     TRACE("xorif_set_mtu_size(%d)\n", size);
 
-    if (size < 1 || size > fhi_caps.max_framer_ethernet_pkt)
+    if (size < 1 || size > FHI_CAPS.max_framer_ethernet_pkt)
     {
         PERROR("Invalid MTU size\n");
         return XORIF_INVALID_CONFIG;
@@ -354,6 +469,107 @@ int xorif_set_fhi_protocol(enum xorif_transport_protocol transport,
     uint32_t filter[16];
     uint16_t mask[4];
 
+    // Default packet filter for the transport, VLAN and IP mode
+    struct xorif_packet_match match = {.transport = transport, .ip_mode = ip_mode, .vlan = vlan};
+    if (xorif_compile_packet_filter(&match, filter, mask, NULL) != XORIF_SUCCESS)
+    {
+        // No packet filter
+        for (int i = 0; i < 4; ++i)
+        {
+            mask[i] = 0xFFFF;
+        }
+        for (int i = 0; i < 16; ++i)
+        {
+            filter[i] = 0xFFFFFFFF;
+        }
+    }
+
+    // Configure the same packet filter for all Ethernet ports
+    for (int i = 0; i < xorif_fhi_get_num_eth_ports(); ++i)
+    {
+        xorif_set_fhi_packet_filter(i, filter, mask);
+    }
+
+    return XORIF_SUCCESS;
+}
+
+/**
+ * @brief Set one byte of a packet filter (and clear its mask bit).
+ * @param[in,out] filter Pointer to an array of 16 x 32-bit words
+ * @param[in,out] mask Pointer to an array of 4 x 16-bit words
+ * @param[in] byte Byte position in the packet
+ * @param[in] value Byte value
+ * @returns
+ *      - 1 if the byte is within the filter
+ *      - 0 if the byte is beyond the filter
+ */
+static int set_filter_byte(uint32_t *filter, uint16_t *mask, int byte, uint8_t value)
+{
+    if (byte >= 64)
+    {
+        return 0;
+    }
+
+    // Filter bytes are little-endian within each 32-bit word
+    int shift = 8 * (byte % 4);
+    filter[byte / 4] = (filter[byte / 4] & ~(0xFFU << shift)) | ((uint32_t)value << shift);
+    mask[byte / 16] &= ~(1U << (byte % 16));
+    return 1;
+}
+
+int xorif_compile_packet_filter(const struct xorif_packet_match *match,
+                                uint32_t filter[16],
+                                uint16_t mask[4],
+                                uint16_t *exact)
+{
+    TRACE("xorif_compile_packet_filter(...)\n");
+
+    if (!match || !filter || !mask)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+
+    uint16_t fields = match->fields;
+    uint16_t is_ip = (match->ip_mode != IP_MODE_RAW);
+    uint16_t is_ecpri = (match->transport == PROTOCOL_ECPRI);
+
+    // Check the specification is consistent
+    if ((match->transport != PROTOCOL_ECPRI) && (match->transport != PROTOCOL_IEEE_1914_3))
+    {
+        PERROR("Invalid transport protocol\n");
+        return XORIF_INVALID_CONFIG;
+    }
+    if ((match->ip_mode != IP_MODE_RAW) && (match->ip_mode != IP_MODE_IPV4) && (match->ip_mode != IP_MODE_IPV6))
+    {
+        PERROR("Invalid IP mode\n");
+        return XORIF_INVALID_CONFIG;
+    }
+    if (!match->vlan && (fields & (PKT_MATCH_VLAN_ID | PKT_MATCH_VLAN_PCP)))
+    {
+        PERROR("VLAN fields can't be matched without VLAN tagging\n");
+        return XORIF_INVALID_CONFIG;
+    }
+    if (!is_ip && (fields & (PKT_MATCH_IP_PROTOCOL | PKT_MATCH_UDP_PORT)))
+    {
+        PERROR("IP / UDP fields can't be matched in Raw mode\n");
+        return XORIF_INVALID_CONFIG;
+    }
+    if (!is_ecpri && (fields & PKT_MATCH_ECPRI_MSG_TYPE))
+    {
+        PERROR("eCPRI message type can't be matched for IEEE 1914.3\n");
+        return XORIF_INVALID_CONFIG;
+    }
+
+    // UDP is implied by eCPRI over IP, or by matching the UDP port
+    uint16_t udp = is_ip && (is_ecpri || (fields & PKT_MATCH_UDP_PORT));
+    uint16_t ip_protocol = (fields & PKT_MATCH_IP_PROTOCOL) ? match->ip_protocol : 17;
+    if (udp && (ip_protocol != 17))
+    {
+        PERROR("IP protocol must be UDP (17) for eCPRI over IP or UDP port matching\n");
+        return XORIF_INVALID_CONFIG;
+    }
+
     // Initialize defaults (no packet filter)
     for (int i = 0; i < 4; ++i)
     {
@@ -364,55 +580,100 @@ int xorif_set_fhi_protocol(enum xorif_transport_protocol transport,
         filter[i] = 0xFFFFFFFF;
     }
 
-    // There are 2 "transport", 3 "ip modes" and 2 VLAN options, i.e. 12 configurations!
-    // Packet filters can only be defined for some of them. For the others, the user
-    // will have to configure manually.
+    int ok = 1;
 
-    // Only "Raw" mode is handled currently
-    if (ip_mode == IP_MODE_RAW)
+    // Ethernet header: <dest MAC> <source MAC> [<TPID> <TCI>] <EtherType>
+    int l = 12;
+    if (match->vlan)
     {
-        switch (transport)
+        uint16_t tci = ((match->vlan_pcp & 0x7) << 13) | ((match->vlan_dei & 0x1) << 12) | (match->vlan_id & 0xFFF);
+        set_filter_byte(filter, mask, l, 0x81);
+        set_filter_byte(filter, mask, l + 1, 0x00);
+
+        // TCI: PCP, DEI and upper bits of VLAN ID share the first byte
+        if ((fields & PKT_MATCH_VLAN_ID) && (fields & PKT_MATCH_VLAN_PCP))
         {
-        case PROTOCOL_ECPRI:
-            if (vlan)
-            {
-                // ECPRI, VLAN, RAW
-                mask[0] = 0xCFFF;
-                mask[1] = 0xFFFC;
-                filter[3] = 0xFFFF0081;
-                filter[4] = 0xFFFFFEAE;
-            }
-            else
-            {
-                // ECPRI, RAW
-                mask[0] = 0xCFFF;
-                filter[3] = 0xFFFFFEAE;
-            }
-            break;
+            set_filter_byte(filter, mask, l + 2, tci >> 8);
+        }
+        else if (fields & (PKT_MATCH_VLAN_ID | PKT_MATCH_VLAN_PCP))
+        {
+            INFO("VLAN ID and PCP/DEI share a byte, matching is partial\n");
+            ok = 0;
+        }
+        if (fields & PKT_MATCH_VLAN_ID)
+        {
+            set_filter_byte(filter, mask, l + 3, tci & 0xFF);
+        }
+        l += 4;
+    }
 
-        case PROTOCOL_IEEE_1914_3:
-            if (vlan)
-            {
-                // 1914.3, VLAN, RAW
-                mask[0] = 0xCFFF;
-                mask[1] = 0xFFFC;
-                filter[3] = 0xFFFF0081;
-                filter[4] = 0xFFFF3DFC;
-            }
-            else
-            {
-                // 1914.3, RAW
-                mask[0] = 0xCFFF;
-                filter[3] = 0xFFFF3DFC;
-            }
-            break;
+    uint16_t ethertype = match->ethertype;
+    if (!ethertype)
+    {
+        if (match->ip_mode == IP_MODE_IPV4)
+        {
+            ethertype = 0x0800;
+        }
+        else if (match->ip_mode == IP_MODE_IPV6)
+        {
+            ethertype = 0x86DD;
+        }
+        else
+        {
+            ethertype = is_ecpri ? 0xAEFE : 0xFC3D;
         }
     }
+    set_filter_byte(filter, mask, l, ethertype >> 8);
+    set_filter_byte(filter, mask, l + 1, ethertype & 0xFF);
+    l += 2;
 
-    // Configure the same packet filter for all Ethernet ports
-    for (int i = 0; i < xorif_fhi_get_num_eth_ports(); ++i)
+    // IP / UDP headers
+    int payload = l;
+    if (match->ip_mode == IP_MODE_IPV4)
     {
-        xorif_set_fhi_packet_filter(i, filter, mask);
+        if (udp)
+        {
+            // Version 4, no options (so that the UDP header is at a fixed position)
+            ok &= set_filter_byte(filter, mask, l, 0x45);
+        }
+        if (udp || (fields & PKT_MATCH_IP_PROTOCOL))
+        {
+            ok &= set_filter_byte(filter, mask, l + 9, ip_protocol);
+        }
+        payload = l + 20;
+    }
+    else if (match->ip_mode == IP_MODE_IPV6)
+    {
+        if (udp || (fields & PKT_MATCH_IP_PROTOCOL))
+        {
+            ok &= set_filter_byte(filter, mask, l + 6, ip_protocol);
+        }
+        payload = l + 40;
+    }
+
+    if (udp)
+    {
+        if (fields & PKT_MATCH_UDP_PORT)
+        {
+            ok &= set_filter_byte(filter, mask, payload + 2, match->udp_port >> 8);
+            ok &= set_filter_byte(filter, mask, payload + 3, match->udp_port & 0xFF);
+        }
+        payload += 8;
+    }
+
+    // eCPRI common header: <revision / C> <message type> <payload size>
+    if (fields & PKT_MATCH_ECPRI_MSG_TYPE)
+    {
+        ok &= set_filter_byte(filter, mask, payload + 1, match->ecpri_msg_type);
+    }
+
+    if (!ok)
+    {
+        INFO("Packet filter passes a super-set of the specification\n");
+    }
+    if (exact)
+    {
+        *exact = ok;
     }
 
     return XORIF_SUCCESS;
@@ -482,20 +743,148 @@ int xorif_set_fhi_packet_filter(int port, const uint32_t filter[16], uint16_t ma
     return XORIF_SUCCESS;
 }
 
+int xorif_set_fhi_port_filter(int port, const struct xorif_packet_match *match)
+{
+    TRACE("xorif_set_fhi_port_filter(%d, ...)\n", port);
+
+    if (port >= xorif_fhi_get_num_eth_ports())
+    {
+        PERROR("Invalid Ethernet port value\n");
+        return XORIF_INVALID_ETH_PORT;
+    }
+    else if (!match)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+
+    // The protocol, VLAN and IP mode are common to all ports (framer setting)
+    if ((match->transport != READ_REG(FRAM_PROTOCOL_DEFINITION)) ||
+        (match->vlan != READ_REG(FRAM_GEN_VLAN_TAG)) ||
+        (match->ip_mode != READ_REG(FRAM_SEL_IPV_ADDRESS_TYPE)))
+    {
+        PERROR("Packet filter doesn't match the common protocol settings\n");
+        return XORIF_INVALID_CONFIG;
+    }
+
+    uint32_t filter[16];
+    uint16_t mask[4];
+
+    int result = xorif_compile_packet_filter(match, filter, mask, NULL);
+    if (result != XORIF_SUCCESS)
+    {
+        return result;
+    }
+
+    return xorif_set_fhi_packet_filter(port, filter, mask);
+}
+
+int xorif_set_cc_planned_eth_port(uint16_t cc, uint16_t port)
+{
+    TRACE("xorif_set_cc_planned_eth_port(%d, %d)\n", cc, port);
+
+    if ((cc >= MAX_NUM_CC) || (cc >= xorif_fhi_get_max_cc()))
+    {
+        PERROR("Component carrier %d is not supported\n", cc);
+        return XORIF_INVALID_CC;
+    }
+    else if (port >= xorif_fhi_get_num_eth_ports())
+    {
+        PERROR("Invalid Ethernet port value\n");
+        return XORIF_INVALID_ETH_PORT;
+    }
+
+    planned_eth_port[cc] = port;
+
+    return XORIF_SUCCESS;
+}
+
+int xorif_get_cc_planned_eth_port(uint16_t cc, uint16_t *port)
+{
+    TRACE("xorif_get_cc_planned_eth_port(%d, ...)\n", cc);
+
+    if ((cc >= MAX_NUM_CC) || (cc >= xorif_fhi_get_max_cc()))
+    {
+        PERROR("Component carrier %d is not supported\n", cc);
+        return XORIF_INVALID_CC;
+    }
+    else if (!port)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+
+    *port = planned_eth_port[cc];
+
+    return XORIF_SUCCESS;
+}
+
+int xorif_get_fhi_port_config(int port, struct xorif_fhi_port_config *ptr)
+{
+    TRACE("xorif_get_fhi_port_config(%d, ...)\n", port);
+
+    if (port >= xorif_fhi_get_num_eth_ports())
+    {
+        PERROR("Invalid Ethernet port value\n");
+        return XORIF_INVALID_ETH_PORT;
+    }
+    else if (!ptr)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+
+    memset(ptr, 0, sizeof(struct xorif_fhi_port_config));
+
+    // Common protocol settings
+    ptr->transport = READ_REG(FRAM_PROTOCOL_DEFINITION);
+    ptr->vlan = READ_REG(FRAM_GEN_VLAN_TAG);
+    ptr->ip_mode = READ_REG(FRAM_SEL_IPV_ADDRESS_TYPE);
+
+    // Per-port VLAN tag
+    ptr->vlan_id = READ_REG_OFFSET(ETH_VLAN_ID, port * 0x100);
+    ptr->vlan_dei = READ_REG_OFFSET(ETH_VLAN_DEI, port * 0x100);
+    ptr->vlan_pcp = READ_REG_OFFSET(ETH_VLAN_PCP, port * 0x100);
+
+    // Component carriers planned on this port
+    for (int cc = 0; cc < xorif_fhi_get_max_cc() && cc < MAX_NUM_CC; ++cc)
+    {
+        if (planned_eth_port[cc] == port)
+        {
+            ptr->planned_cc_mask |= (1 << cc);
+        }
+    }
+
+    // Per-port packet filter (same layout as xorif_set_fhi_packet_filter)
+    for (int i = 0; i < 4; ++i)
+    {
+        for (int j = 0; j < 4; ++j)
+        {
+            uint32_t addr = DEFM_USER_DATA_FILTER_ADDR + (port * 0x100) + (i * 0x20) + (j * 4);
+            ptr->filter[i * 4 + j] = READ_REG_RAW_ALT("DEFM_USER_DATA_FILTER_WORD_ADDR", addr);
+        }
+        uint32_t addr = DEFM_USER_DATA_FILTER_ADDR + (port * 0x100) + (i * 0x20) + (4 * 4);
+        ptr->mask[i] = READ_REG_RAW_ALT("DEFM_USER_DATA_FILTER_MASK_ADDR", addr);
+    }
+
+    return XORIF_SUCCESS;
+}
+
 int xorif_set_fhi_eaxc_id(uint16_t du_bits,
                           uint16_t bs_bits,
                           uint16_t cc_bits,
                           uint16_t ru_bits)
 {
     TRACE("xorif_set_fhi_eaxc_id(%d, %d, %d, %d)\n", du_bits, bs_bits, cc_bits, ru_bits);
+    SPAN_SCOPE(__func__, "ru_ports", NULL, 0);
 
     if ((du_bits + bs_bits + cc_bits + ru_bits) != 16)
     {
         PERROR("Total ID bits does not equal 16\n");
         return XORIF_INVALID_EAXC_ID;
     }
-    else if ((du_bits > fhi_caps.du_id_limit) || (bs_bits > fhi_caps.bs_id_limit) ||
-             (cc_bits > fhi_caps.cc_id_limit) || (ru_bits > fhi_caps.ru_id_limit))
+    else if ((du_bits > FHI_CAPS.du_id_limit) || (bs_bits > FHI_CAPS.bs_id_limit) ||
+             (cc_bits > FHI_CAPS.cc_id_limit) || (ru_bits > FHI_CAPS.ru_id_limit))
     {
         PERROR("Number of ID bits is larger than allowed\n");
         return XORIF_INVALID_EAXC_ID;
@@ -514,6 +903,7 @@ int xorif_set_fhi_eaxc_id(uint16_t du_bits,
     uint16_t cc_mask = (1 << cc_bits) - 1;
     uint16_t bs_mask = (1 << bs_bits) - 1;
     uint16_t du_mask = (1 << du_bits) - 1;
+    (void)ru_mask; // Only reported (RU ID bits use a separate mask register)
 
     // Program the DU/BS/CC masks & shifts
     WRITE_REG(DEFM_CID_CC_SHIFT, cc_shift);
@@ -574,13 +964,14 @@ int xorif_set_ru_ports(uint16_t ru_bits,
                        uint16_t ssb_val)
 {
     TRACE("xorif_set_ru_ports(%d, %d, %d, %d, %d, %d)\n", ru_bits, ss_bits, mask, user_val, prach_val, ssb_val);
+    SPAN_SCOPE(__func__, "ru_ports", NULL, 0);
 
     if (ss_bits > ru_bits)
     {
         PERROR("Invalid RU port assignment\n");
         return XORIF_INVALID_EAXC_ID;
     }
-    else if (ss_bits > fhi_caps.ss_id_limit)
+    else if (ss_bits > FHI_CAPS.ss_id_limit)
     {
         PERROR("Invalid RU port assignment\n");
         return XORIF_INVALID_EAXC_ID;
@@ -654,13 +1045,14 @@ int xorif_set_ru_ports_lte(uint16_t ru_bits,
                            uint16_t lte_val)
 {
     TRACE("xorif_set_ru_ports_lte(%d, %d, %d, %d, %d, %d, %d)\n", ru_bits, ss_bits, mask, user_val, prach_val, ssb_val, lte_val);
+    SPAN_SCOPE(__func__, "ru_ports", NULL, 0);
 
     if (ss_bits > ru_bits)
     {
         PERROR("Invalid RU port assignment\n");
         return XORIF_INVALID_EAXC_ID;
     }
-    else if (ss_bits > fhi_caps.ss_id_limit)
+    else if (ss_bits > FHI_CAPS.ss_id_limit)
     {
         PERROR("Invalid RU port assignment\n");
         return XORIF_INVALID_EAXC_ID;
@@ -740,6 +1132,7 @@ int xorif_set_ru_ports_lte(uint16_t ru_bits,
 int xorif_set_ru_ports_table_mode(uint16_t mode, uint16_t sub_mode)
 {
     TRACE("xorif_set_ru_ports_table_mode(%d, %d)\n", mode, sub_mode);
+    SPAN_SCOPE(__func__, "ru_ports", "mode", mode);
 
     if (mode > 3)
     {
@@ -751,7 +1144,7 @@ int xorif_set_ru_ports_table_mode(uint16_t mode, uint16_t sub_mode)
     // due to changes in design, sub-mode variants, etc. We leave it to user
     // to ensure there is sufficient space!
 
-    if (fhi_caps.ru_ports_map_width == 0)
+    if (FHI_CAPS.ru_ports_map_width == 0)
     {
         PERROR("Insufficient RU port table memory for mode\n");
         return XORIF_INVALID_RU_PORT_MAPPING;
@@ -768,12 +1161,13 @@ int xorif_set_ru_ports_table_mode(uint16_t mode, uint16_t sub_mode)
 int xorif_set_ru_ports_table_mode1(void)
 {
     TRACE("xorif_set_ru_ports_table_mode1()\n");
+    SPAN_SCOPE(__func__, "ru_ports", NULL, 0);
 
     // Check that the table has sufficient address space for the mode
     // mode 1: {DIR, RU} so width = 1 + ru_bits
     uint16_t required = 1 + num_ru_bits;
 
-    if ((fhi_caps.ru_ports_map_width == 0) || (required > fhi_caps.ru_ports_map_width))
+    if ((FHI_CAPS.ru_ports_map_width == 0) || (required > FHI_CAPS.ru_ports_map_width))
     {
         PERROR("Insufficient RU port table memory for mode\n");
         return XORIF_INVALID_RU_PORT_MAPPING;
@@ -788,10 +1182,11 @@ int xorif_set_ru_ports_table_mode1(void)
 int xorif_set_ru_ports_table_mode2(uint16_t ss_mask, uint16_t u_mask)
 {
     TRACE("xorif_set_ru_ports_table_mode2(0x%X, 0x%X)\n", ss_mask, u_mask);
+    SPAN_SCOPE(__func__, "ru_ports", NULL, 0);
 
     // Note, table size is not checked with this API (complex due to masking)
 
-    if (fhi_caps.ru_ports_map_width == 0)
+    if (FHI_CAPS.ru_ports_map_width == 0)
     {
         PERROR("Insufficient RU port table memory for mode\n");
         return XORIF_INVALID_RU_PORT_MAPPING;
@@ -809,19 +1204,18 @@ int xorif_set_ru_ports_table_mode2(uint16_t ss_mask, uint16_t u_mask)
 int xorif_clear_ru_ports_table(void)
 {
     TRACE("xorif_clear_ru_ports_table()\n");
+    SPAN_SCOPE(__func__, "ru_ports", NULL, 0);
 
     // Note, no need to call this from reset
 
     // Reset RU port mapping table to UNKNOWN_STREAM_TYPE (i.e. not-used)
-    if (fhi_caps.ru_ports_map_width > 0)
+    if (FHI_CAPS.ru_ports_map_width > 0)
     {
-        uint16_t size = 1 << fhi_caps.ru_ports_map_width;
+        uint16_t size = 1 << FHI_CAPS.ru_ports_map_width;
         for (int a = 0; a < size; ++a)
         {
-            // Value: <write strobe> | <ccid> | <port> | <type> | <address>
             // Set to "all ones" to align with SystemVerilog test-bench
-            uint32_t value = (0xFFFFF800) | (a & 0x7FF);
-            WRITE_REG_RAW(DEFM_CID_MAP_WR_STROBE_ADDR, value);
+            write_ru_ports_entry(a, 0x7FFFF800);
         }
     }
 
@@ -834,20 +1228,21 @@ int xorif_set_ru_ports_table(uint16_t address,
                              uint16_t number)
 {
     TRACE("xorif_set_ru_ports_table(%d, %d, %d, %d)\n", address, port, type, number);
+    SPAN_SCOPE(__func__, "ru_ports", "address", address);
 
-    if (fhi_caps.ru_ports_map_width > 0)
+    if (FHI_CAPS.ru_ports_map_width > 0)
     {
-        uint16_t size = 1 << fhi_caps.ru_ports_map_width;
+        uint16_t size = 1 << FHI_CAPS.ru_ports_map_width;
         for (int i = 0; i < number; ++i)
         {
-            // Value: <write strobe> | <port> | <type> | <address>
+            // Entry: <port> | <type>
             uint16_t a = address + i;
             uint16_t p = port + i;
-            uint32_t value = (1U << 31) | ((p & 0x1F) << 18) | ((type & 0x7) << 12) | (a & 0x7FF);
+            uint32_t entry = ((p & 0x1F) << 18) | ((type & 0x7) << 12);
 
             if (a < size)
             {
-                WRITE_REG_RAW(DEFM_CID_MAP_WR_STROBE_ADDR, value);
+                write_ru_ports_entry(a, entry);
             }
             else
             {
@@ -869,21 +1264,21 @@ int xorif_set_ru_ports_table_vcc(uint16_t address,
                                  uint16_t number)
 {
     TRACE("xorif_set_ru_ports_table_vcc(%d, %d, %d, %d, %d)\n", address, port, type, ccid, number);
+    SPAN_SCOPE(__func__, "ru_ports", "address", address);
 
-    if (fhi_caps.ru_ports_map_width > 0)
+    if (FHI_CAPS.ru_ports_map_width > 0)
     {
-        uint16_t size = 1 << fhi_caps.ru_ports_map_width;
+        uint16_t size = 1 << FHI_CAPS.ru_ports_map_width;
         for (int i = 0; i < number; ++i)
         {
-            // Value: <write strobe> | <ccid> | <port> | <type> | <address>
+            // Entry: <ccid> | <port> | <type>
             uint16_t a = address + i;
             uint16_t p = port + i;
-            uint32_t value = (1U << 31) | ((ccid & 0x7) << 24) | ((p & 0x1F) << 18) |
-                             ((type & 0x7) << 12) | (a & 0x7FF);
+            uint32_t entry = ((ccid & 0xF) << 24) | ((p & 0x1F) << 18) | ((type & 0x7) << 12);
 
             if (a < size)
             {
-                WRITE_REG_RAW(DEFM_CID_MAP_WR_STROBE_ADDR, value);
+                write_ru_ports_entry(a, entry);
             }
             else
             {
@@ -898,6 +1293,276 @@ int xorif_set_ru_ports_table_vcc(uint16_t address,
     return XORIF_INVALID_RU_PORT_MAPPING;
 }
 
+int xorif_set_ru_ports_table_bulk(uint16_t address,
+                                  uint16_t number,
+                                  const struct xorif_ru_port_map *map)
+{
+    TRACE("xorif_set_ru_ports_table_bulk(%d, %d, ...)\n", address, number);
+    SPAN_SCOPE(__func__, "ru_ports", "number", number);
+
+    if (!map)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+
+    if (FHI_CAPS.ru_ports_map_width == 0)
+    {
+        PERROR("Insufficient RU port table memory\n");
+        return XORIF_INVALID_RU_PORT_MAPPING;
+    }
+
+    // Check the whole range before writing anything
+    uint16_t size = 1 << FHI_CAPS.ru_ports_map_width;
+    if ((uint32_t)address + number > size)
+    {
+        PERROR("Invalid RU port table address\n");
+        return XORIF_INVALID_RU_PORT_MAPPING;
+    }
+
+    int count = 0;
+    for (int i = 0; i < number; ++i)
+    {
+        uint32_t entry = ((map[i].ccid & 0xF) << 24) | ((map[i].port & 0x1F) << 18) | ((map[i].type & 0x7) << 12);
+        count += write_ru_ports_entry(address + i, entry);
+    }
+    INFO("RU port table: %d of %d entries written\n", count, number);
+
+    return XORIF_SUCCESS;
+}
+
+int xorif_verify_ru_ports_table(uint16_t *num_errors)
+{
+    TRACE("xorif_verify_ru_ports_table(...)\n");
+    SPAN_SCOPE(__func__, "ru_ports", NULL, 0);
+
+    if (FHI_CAPS.ru_ports_map_width == 0)
+    {
+        PERROR("Insufficient RU port table memory\n");
+        return XORIF_INVALID_RU_PORT_MAPPING;
+    }
+
+    // Read back every entry that has been written, and compare with the shadow
+    uint16_t size = 1 << FHI_CAPS.ru_ports_map_width;
+    uint16_t errors = 0;
+    for (int a = 0; a < size; ++a)
+    {
+        if (ru_ports_shadow[a] == RU_PORTS_ENTRY_UNKNOWN)
+        {
+            continue;
+        }
+
+        WRITE_REG_RAW(DEFM_CID_MAP_RD_STROBE_ADDR, (1U << 31) | (a & 0x7FF));
+        uint32_t entry = READ_REG_RAW(DEFM_CID_MAP_RD_STROBE_ADDR) & RU_PORTS_ENTRY_MASK;
+
+        if (entry != ru_ports_shadow[a])
+        {
+            PERROR("RU port table mismatch at address %d (expected 0x%08X, read 0x%08X)\n",
+                   a, ru_ports_shadow[a], entry);
+
+            // Forget the entry, so that it gets re-written next time
+            ru_ports_shadow[a] = RU_PORTS_ENTRY_UNKNOWN;
+            ++errors;
+        }
+    }
+
+    if (num_errors)
+    {
+        *num_errors = errors;
+    }
+
+    return errors ? XORIF_INVALID_RU_PORT_MAPPING : XORIF_SUCCESS;
+}
+
+int xorif_compile_eaxc_layout(const struct xorif_eaxc_spec *spec,
+                              struct xorif_eaxc_layout *layout,
+                              struct xorif_ru_port_map *table,
+                              uint16_t table_len)
+{
+    TRACE("xorif_compile_eaxc_layout(...)\n");
+
+    if (!spec || !layout)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+
+    if (!spec->num_du || !spec->num_bs || !spec->num_cc || !spec->num_user)
+    {
+        PERROR("At least 1 DU, BS, CC and user stream is required\n");
+        return XORIF_INVALID_CONFIG;
+    }
+
+    if (spec->num_cc > xorif_fhi_get_max_cc())
+    {
+        PERROR("%d component carriers requested, device supports %d\n", spec->num_cc, xorif_fhi_get_max_cc());
+        return XORIF_INVALID_CC;
+    }
+
+    // Smallest fields that hold the required numbers
+    uint16_t du_bits = bits_for_count(spec->num_du);
+    uint16_t bs_bits = bits_for_count(spec->num_bs);
+    uint16_t cc_bits = bits_for_count(spec->num_cc);
+
+    uint16_t max_ss = spec->num_user;
+    max_ss = spec->num_prach > max_ss ? spec->num_prach : max_ss;
+    max_ss = spec->num_ssb > max_ss ? spec->num_ssb : max_ss;
+    uint16_t ss_bits = bits_for_count(max_ss);
+
+    // Stream type field: user, plus optional PRACH and SSB
+    uint16_t num_types = 1 + (spec->num_prach ? 1 : 0) + (spec->num_ssb ? 1 : 0);
+    uint16_t type_bits = bits_for_count(num_types);
+    uint16_t ru_bits = ss_bits + type_bits;
+
+    if ((ss_bits > FHI_CAPS.ss_id_limit) || (max_ss > 32))
+    {
+        PERROR("%d spatial streams requested, device supports %d\n", max_ss,
+               (1 << FHI_CAPS.ss_id_limit) < 32 ? (1 << FHI_CAPS.ss_id_limit) : 32);
+        return XORIF_INVALID_SS;
+    }
+
+    // The streams map to the UL (framer) and DL (de-framer) ports: user in both, PRACH in UL, SSB in DL
+    if ((spec->num_user > FHI_CAPS.no_framer_ss) || (spec->num_user > FHI_CAPS.no_deframer_ss))
+    {
+        PERROR("%d user streams requested, device supports %d (UL) and %d (DL)\n", spec->num_user,
+               FHI_CAPS.no_framer_ss, FHI_CAPS.no_deframer_ss);
+        return XORIF_INVALID_SS;
+    }
+    if (spec->num_prach > FHI_CAPS.no_framer_ss)
+    {
+        PERROR("%d PRACH streams requested, device supports %d (UL)\n", spec->num_prach, FHI_CAPS.no_framer_ss);
+        return XORIF_INVALID_SS;
+    }
+    if (spec->num_ssb > FHI_CAPS.no_deframer_ss)
+    {
+        PERROR("%d SSB streams requested, device supports %d (DL)\n", spec->num_ssb, FHI_CAPS.no_deframer_ss);
+        return XORIF_INVALID_SS;
+    }
+
+    if (du_bits > FHI_CAPS.du_id_limit)
+    {
+        PERROR("DU field needs %d bits, device supports %d\n", du_bits, FHI_CAPS.du_id_limit);
+        return XORIF_INVALID_EAXC_ID;
+    }
+    if (bs_bits > FHI_CAPS.bs_id_limit)
+    {
+        PERROR("BS field needs %d bits, device supports %d\n", bs_bits, FHI_CAPS.bs_id_limit);
+        return XORIF_INVALID_EAXC_ID;
+    }
+    if (cc_bits > FHI_CAPS.cc_id_limit)
+    {
+        PERROR("CC field needs %d bits, device supports %d\n", cc_bits, FHI_CAPS.cc_id_limit);
+        return XORIF_INVALID_EAXC_ID;
+    }
+    if (ru_bits > FHI_CAPS.ru_id_limit)
+    {
+        PERROR("RU field needs %d bits (%d stream type + %d spatial stream), device supports %d\n",
+               ru_bits, type_bits, ss_bits, FHI_CAPS.ru_id_limit);
+        return XORIF_INVALID_EAXC_ID;
+    }
+    if (du_bits + bs_bits + cc_bits + ru_bits > 16)
+    {
+        PERROR("Layout needs %d bits (DU %d, BS %d, CC %d, RU %d), eAxC ID has 16\n",
+               du_bits + bs_bits + cc_bits + ru_bits, du_bits, bs_bits, cc_bits, ru_bits);
+        return XORIF_INVALID_EAXC_ID;
+    }
+
+    // Distribute the remaining bits (DU, then BS, then CC, then RU)
+    uint16_t spare = 16 - (du_bits + bs_bits + cc_bits + ru_bits);
+    uint16_t *fields[] = {&du_bits, &bs_bits, &cc_bits, &ru_bits};
+    uint16_t limits[] = {FHI_CAPS.du_id_limit, FHI_CAPS.bs_id_limit, FHI_CAPS.cc_id_limit, FHI_CAPS.ru_id_limit};
+    for (int i = 0; i < 4 && spare > 0; ++i)
+    {
+        uint16_t n = limits[i] - *fields[i];
+        n = n < spare ? n : spare;
+        *fields[i] += n;
+        spare -= n;
+    }
+    if (spare)
+    {
+        PERROR("Device ID limits can't fill the 16-bit eAxC ID (%d bits left over)\n", spare);
+        return XORIF_INVALID_EAXC_ID;
+    }
+
+    // Mask-based RU port mapping
+    uint16_t value = 0;
+    layout->du_bits = du_bits;
+    layout->bs_bits = bs_bits;
+    layout->cc_bits = cc_bits;
+    layout->ru_bits = ru_bits;
+    layout->ss_bits = ss_bits;
+    layout->mask = ((1 << type_bits) - 1) << ss_bits;
+    layout->user_val = value++ << ss_bits;
+    layout->prach_val = spec->num_prach ? (value++ << ss_bits) : 0xFFFF;
+    layout->ssb_val = spec->num_ssb ? (value++ << ss_bits) : 0xFFFF;
+
+    // Table-based RU port mapping (mode 1: <direction> | <RU ID>, uplink first)
+    layout->table_size = 0;
+    if ((FHI_CAPS.ru_ports_map_width == 0) || (1 + ru_bits > FHI_CAPS.ru_ports_map_width))
+    {
+        INFO("RU ports table is too small for the layout (needs %d address bits)\n", 1 + ru_bits);
+        return XORIF_SUCCESS;
+    }
+    layout->table_size = 2 << ru_bits;
+
+    if (table)
+    {
+        if (table_len < layout->table_size)
+        {
+            PERROR("RU ports table storage too small (needs %d entries)\n", layout->table_size);
+            return XORIF_INVALID_RU_PORT_MAPPING;
+        }
+
+        for (int a = 0; a < layout->table_size; ++a)
+        {
+            table[a].port = 0x1F;
+            table[a].type = 0x7;
+            table[a].ccid = 0xF;
+        }
+
+        uint16_t dl = 1 << ru_bits;
+        for (int i = 0; i < spec->num_user; ++i)
+        {
+            table[layout->user_val + i] = (struct xorif_ru_port_map){i, 1, 0};
+            table[dl + layout->user_val + i] = (struct xorif_ru_port_map){i, 0, 0};
+        }
+        for (int i = 0; i < spec->num_prach; ++i)
+        {
+            table[layout->prach_val + i] = (struct xorif_ru_port_map){i, 3, 0};
+        }
+        for (int i = 0; i < spec->num_ssb; ++i)
+        {
+            table[dl + layout->ssb_val + i] = (struct xorif_ru_port_map){i, 2, 0};
+        }
+    }
+
+    INFO("eAxC layout: DU %d, BS %d, CC %d, RU %d (SS %d), mask 0x%X\n",
+         du_bits, bs_bits, cc_bits, ru_bits, ss_bits, layout->mask);
+
+    return XORIF_SUCCESS;
+}
+
+int xorif_apply_eaxc_layout(const struct xorif_eaxc_layout *layout)
+{
+    TRACE("xorif_apply_eaxc_layout(...)\n");
+    SPAN_SCOPE(__func__, "ru_ports", NULL, 0);
+
+    if (!layout)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+
+    int result = xorif_set_fhi_eaxc_id(layout->du_bits, layout->bs_bits, layout->cc_bits, layout->ru_bits);
+    if (result != XORIF_SUCCESS)
+    {
+        return result;
+    }
+
+    return xorif_set_ru_ports(layout->ru_bits, layout->ss_bits, layout->mask,
+                              layout->user_val, layout->prach_val, layout->ssb_val);
+}
+
 int xorif_get_fhi_cc_alloc(uint16_t cc, struct xorif_cc_alloc *ptr)
 {
     TRACE("xorif_get_fhi_cc_alloc(%d, ...)\n", cc);
@@ -933,12 +1598,139 @@ int xorif_get_fhi_cc_alloc(uint16_t cc, struct xorif_cc_alloc *ptr)
     return XORIF_SUCCESS;
 }
 
+int xorif_get_latency_budget(uint16_t cc, const struct xorif_transport_delay *transport, struct xorif_latency_budget *ptr)
+{
+    TRACE("xorif_get_latency_budget(%d, ...)\n", cc);
+
+    if (cc >= MAX_NUM_CC || cc >= xorif_fhi_get_max_cc())
+    {
+        PERROR("Invalid CC value\n");
+        return XORIF_INVALID_CC;
+    }
+    else if (!transport || !ptr)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+    else if ((transport->t12_min < 0) || (transport->t12_min > transport->t12_max) ||
+             (transport->t34_min < 0) || (transport->t34_min > transport->t34_max) ||
+             (transport->t1a_max_up < 0) || (transport->ta4_max < 0))
+    {
+        PERROR("Invalid transport delay\n");
+        return XORIF_INVALID_CONFIG;
+    }
+
+    const struct xorif_cc_config *cfg = &cc_config[cc];
+    double decap = fhi_sys_const.FH_DECAP_DLY;
+
+    memset(ptr, 0, sizeof(struct xorif_latency_budget));
+    ptr->sym_period = sym_period_table[cfg->numerology];
+
+    // O-RU windows (as used to program the "de-framer" and "framer")
+    ptr->t2a_min_up = decap;
+    ptr->t2a_max_up = decap + cfg->delay_comp_up;
+    ptr->t2a_min_cp_dl = cfg->advance_dl + decap;
+    ptr->t2a_max_cp_dl = ptr->t2a_min_cp_dl + cfg->delay_comp_cp_dl;
+    ptr->t2a_min_cp_ul = cfg->advance_ul;
+    ptr->t2a_max_cp_ul = cfg->advance_ul + cfg->delay_comp_cp_ul;
+    ptr->ta3_min = cfg->ul_radio_ch_dly;
+    ptr->ta3_max = cfg->ul_radio_ch_dly + ptr->sym_period;
+
+    // O-DU windows (the transport delay variation narrows the windows)
+    ptr->t1a_min_up = ptr->t2a_min_up + transport->t12_max;
+    ptr->t1a_max_up = ptr->t2a_max_up + transport->t12_min;
+    ptr->t1a_min_cp_dl = ptr->t2a_min_cp_dl + transport->t12_max;
+    ptr->t1a_max_cp_dl = ptr->t2a_max_cp_dl + transport->t12_min;
+    ptr->t1a_min_cp_ul = ptr->t2a_min_cp_ul + transport->t12_max;
+    ptr->t1a_max_cp_ul = ptr->t2a_max_cp_ul + transport->t12_min;
+    ptr->ta4_min = ptr->ta3_min + transport->t34_min;
+    ptr->ta4_max = ptr->ta3_max + transport->t34_max;
+
+    // Downlink stages
+    ptr->dl_transport = transport->t12_max;
+    ptr->dl_deskew = cfg->delay_comp_up;
+    ptr->dl_decap = decap;
+    ptr->dl_total = ptr->dl_transport + ptr->dl_deskew + ptr->dl_decap;
+    ptr->dl_ctrl_advance = cfg->advance_dl;
+    ptr->dl_ctrl_deskew = cfg->delay_comp_cp_dl;
+    ptr->dl_ctrl_total = ptr->dl_transport + ptr->dl_ctrl_deskew + ptr->dl_ctrl_advance + ptr->dl_decap;
+
+    // Uplink stages
+    ptr->ul_radio = cfg->ul_radio_ch_dly;
+    ptr->ul_framing = ptr->sym_period;
+    ptr->ul_transport = transport->t34_max;
+    ptr->ul_total = ptr->ul_radio + ptr->ul_framing + ptr->ul_transport;
+    ptr->ul_ctrl_advance = cfg->advance_ul;
+    ptr->ul_ctrl_deskew = cfg->delay_comp_cp_ul;
+
+    // UL beam-id forward time (limited as per xorif_fhi_configure_time_advance_offsets)
+    double ul_offset = cfg->advance_ul + cfg->ul_radio_ch_dly;
+    if (cfg->ul_bid_forward > ul_offset)
+    {
+        ptr->ul_bid_forward = ul_offset;
+        ptr->violations |= LATENCY_UL_BID_FORWARD;
+    }
+    else if (cfg->ul_bid_forward < ptr->sym_period)
+    {
+        ptr->ul_bid_forward = ptr->sym_period;
+        ptr->violations |= LATENCY_UL_BID_FORWARD;
+    }
+    else
+    {
+        ptr->ul_bid_forward = cfg->ul_bid_forward;
+    }
+
+    // Buffer depths (as per configure_cc)
+    ptr->ul_ctrl_symbols = calc_sym_num(cfg->numerology, cfg->extended_cp, cfg->delay_comp_cp_ul + cfg->advance_ul + cfg->ul_radio_ch_dly);
+    ptr->dl_ctrl_symbols = calc_sym_num(cfg->numerology, cfg->extended_cp, cfg->delay_comp_cp_dl + cfg->advance_dl + decap);
+    ptr->dl_data_symbols = calc_sym_num(cfg->numerology, cfg->extended_cp, cfg->delay_comp_up + decap);
+    ptr->max_ctrl_symbols = FHI_CAPS.max_ctrl_symbols;
+    ptr->max_data_symbols = FHI_CAPS.max_data_symbols;
+
+    // Check windows
+    if (ptr->t1a_min_up > ptr->t1a_max_up)
+    {
+        ptr->violations |= LATENCY_T1A_UP;
+    }
+    if (ptr->t1a_min_cp_dl > ptr->t1a_max_cp_dl)
+    {
+        ptr->violations |= LATENCY_T1A_CP_DL;
+    }
+    if (ptr->t1a_min_cp_ul > ptr->t1a_max_cp_ul)
+    {
+        ptr->violations |= LATENCY_T1A_CP_UL;
+    }
+    if ((transport->t1a_max_up > 0) && (ptr->t1a_min_up > transport->t1a_max_up))
+    {
+        ptr->violations |= LATENCY_T1A_DU_LIMIT;
+    }
+    if (ptr->dl_data_symbols > ptr->max_data_symbols)
+    {
+        ptr->violations |= LATENCY_T2A_DATA_BUFFER;
+    }
+    if ((ptr->dl_ctrl_symbols > ptr->max_ctrl_symbols) || (ptr->ul_ctrl_symbols > ptr->max_ctrl_symbols))
+    {
+        ptr->violations |= LATENCY_T2A_CTRL_BUFFER;
+    }
+    if ((transport->ta4_max > 0) && (ptr->ta4_max > transport->ta4_max))
+    {
+        ptr->violations |= LATENCY_TA3_DU_LIMIT;
+    }
+
+    if (ptr->violations)
+    {
+        INFO("Latency budget for CC %d has violations (0x%X)\n", cc, ptr->violations);
+    }
+
+    return XORIF_SUCCESS;
+}
+
 int xorif_enable_fhi_interrupts(uint32_t mask)
 {
     TRACE("xorif_enable_fhi_interrupts(0x%X)\n", mask);
 
-    // Setup interrupts (enable / disable according to mask value)
-    WRITE_REG_RAW(FHI_INTR_ENABLE_ADDR, mask);
+    // Setup interrupts (enable / disable according to mask value, less any alarms masked by storm detection)
+    xorif_alarm_storm_enable(mask);
 
     // Finally enable the master interrupt
     WRITE_REG(CFG_MASTER_INT_ENABLE, 1);
@@ -976,86 +1768,114 @@ int xorif_set_symbol_strobe_source(uint16_t source)
 // Non-API functions...
 
 #ifdef ENABLE_INTERRUPTS
-int fhi_irq_handler(int id, void *data)
+/**
+ * @brief Handle the FHI alarms (called from the interrupt handler).
+ * @param[in] status Alarm status bits (non-zero)
+ * @param[in] timestamp Time of the interrupt (ns, monotonic clock)
+ */
+static void fhi_alarm_handler(uint32_t status, uint64_t timestamp)
 {
-    struct xorif_device_info *device = (struct xorif_device_info *)data;
+    // Apply the storm detection (masks and coalesces repeating alarms)
+    uint32_t raw = status;
+    status = xorif_alarm_storm(status, timestamp);
 
-    if (device)
+    // Apply the alarm policy (logs the alarms, and selects the action)
+    uint16_t action;
+    uint16_t cc_mask;
+    uint32_t recorded = xorif_alarm_policy(status, timestamp, &action, &cc_mask);
+
+    // Record the alarms in the flight recorder (which may trigger it)
+    xorif_record_alarm(raw, status, action, cc_mask, timestamp);
+
+    if (recorded)
     {
-        // Check interrupt status
-        uint32_t status = READ_REG_RAW(FHI_INTR_STATUS_ADDR) & FHI_INTR_MASK;
-        INFO("fhi_irq_handler() status = 0x%X\n", status);
+        // Record the alarm status, count and queue the alarm event
+        fhi_alarm_status |= recorded;
+        xorif_alarm_event(recorded, timestamp);
+    }
 
-        if (status)
-        {
-            // Record the alarm status
-            fhi_alarm_status |= status;
+    switch (action)
+    {
+    case ALARM_ACTION_DISABLE_CC:
+        // Disable the component carriers (without de-allocation)
+        WRITE_REG(ORAN_CC_ENABLE, READ_REG(ORAN_CC_ENABLE) & ~cc_mask);
+        xorif_stall_cc_change();
+        break;
 
-            // Default interrupt handling...
+    case ALARM_ACTION_RESTART_DEFRAMER:
+        // Restart the de-framer only
+        WRITE_REG(DEFM_RESTART, 1);
+        xorif_stats_restart_async();
+        WRITE_REG(DEFM_RESTART, 0);
+        break;
 
-            if (status & CFG_DEFM_INT_INFIFO_OF_MASK)
-            {
-                INFO("FHI IRQ: CFG_DEFM_INT_INFIFO_OF\n");
-            }
-            if (status & CFG_DEFM_INT_INFIFO_UF_MASK)
-            {
-                INFO("FHI IRQ: CFG_DEFM_INT_INFIFO_UF\n");
-            }
-            if (status & CFG_DEFM_INT_ETH_PIPE_C_BUF_OF_MASK)
-            {
-                INFO("FHI IRQ: CFG_DEFM_INT_ETH_PIPE_C_BUF_OF\n");
-            }
-            if (status & CFG_DEFM_INT_ETH_PIPE_TABLE_OF_MASK)
-            {
-                INFO("FHI IRQ: CFG_DEFM_INT_ETH_PIPE_TABLE_OF\n");
-            }
-            if (status & CFG_FRAM_INT_OUTFIFO_OF_MASK)
-            {
-                INFO("FHI IRQ: CFG_FRAM_INT_OUTFIFO_OF\n");
-            }
-            if (status & CFG_FRAM_INT_OUTFIFO_UF_MASK)
-            {
-                INFO("FHI IRQ: CFG_FRAM_INT_OUTFIFO_UF\n");
-            }
-            if (status & CFG_FRAM_INT_PRACH_SECTION_OVERFLOW_MASK)
-            {
-                INFO("FHI IRQ: CFG_FRAM_INT_PRACH_SECTION_OVERFLOW\n");
-            }
-            if (status & CFG_FRAM_INT_PRACH_SECTION_NOTFOUND_MASK)
-            {
-                INFO("FHI IRQ: CFG_FRAM_INT_PRACH_SECTION_NOTFOUND\n");
-            }
-            if (status & CFG_FRAM_INT_ENA_SECTION_OF_MASK)
-            {
-                INFO("FHI IRQ: CFG_FRAM_INT_ENA_SECTION_OF\n");
-            }
+    case ALARM_ACTION_RESET:
+        // Reset data-pipe (framer & de-framer)
+        WRITE_REG(FRAM_DISABLE, 1);
+        WRITE_REG(DEFM_RESTART, 1);
+        xorif_stats_restart_async();
+        WRITE_REG(FRAM_DISABLE, 0);
+        WRITE_REG(DEFM_RESTART, 0);
+        break;
 
-            // All interrupts are serious error conditions
-            // Reset data-pipe (framer & de-framer)
-            WRITE_REG(FRAM_DISABLE, 1);
-            WRITE_REG(DEFM_RESTART, 1);
-            WRITE_REG(FRAM_DISABLE, 0);
-            WRITE_REG(DEFM_RESTART, 0);
+    default:
+        break;
+    }
 
-            // Clear interrupts by writing to the "master interrupt"
-            WRITE_REG(CFG_MASTER_INT_ENABLE, 0);
-            WRITE_REG(CFG_MASTER_INT_ENABLE, 1);
-        }
+    // Clear interrupts by writing to the "master interrupt"
+    WRITE_REG(CFG_MASTER_INT_ENABLE, 0);
+    WRITE_REG(CFG_MASTER_INT_ENABLE, 1);
+
+    if (fhi_callback && status)
+    {
+        // Call registered call-back function (unless all the alarms were coalesced)
+        (*fhi_callback)(status);
+    }
+}
+
+int fhi_irq_handler(int id, void *data)
+{
+    struct xorif_device_info *device = (struct xorif_device_info *)data;
+
+    if (device)
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        uint64_t entry = (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
 
+        // FHI and OCP interrupts are tied together, so read the pending sources (once)
+        uint16_t sources = 0;
+        uint32_t status = READ_REG_RAW(FHI_INTR_STATUS_ADDR) & FHI_INTR_MASK;
+        IRQ_LOG(IRQ_LOG_FHI_STATUS, 0, status, entry);
+        sources |= status ? IRQ_SOURCE_FHI : 0;
 #ifdef INTEGRATED_OCP
-        if (ocp_callback)
+        // We only access instance 0
+        ocp_status_t status_func = ocp_status;
+        ocp_callback_t callback_func = ocp_callback;
+        uint32_t ocp_events = (status_func && callback_func) ? status_func(0) : 0;
+        if (ocp_events)
         {
-            // FHI and OCP interrupts are tied together, we don't know which
-            // We only access instance 0
-            ocp_callback(0);
+            IRQ_LOG(IRQ_LOG_OCP_STATUS, 0, ocp_events, entry);
+            sources |= IRQ_SOURCE_OCP;
         }
 #endif
 
-        if (fhi_callback)
+        // Only run the handlers for the pending sources
+        if (sources & IRQ_SOURCE_FHI)
+        {
+            fhi_alarm_handler(status, entry);
+        }
+#ifdef INTEGRATED_OCP
+        if (sources & IRQ_SOURCE_OCP)
         {
-            // Call registered call-back function
-            (*fhi_callback)(status);
+            callback_func(0, ocp_events);
         }
+#endif
+
+        // Wake the alarm thread for any deferred log messages, and measure the latency
+        xorif_irq_log_notify();
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        xorif_irq_stats_update(sources, entry, (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec);
 
         return METAL_IRQ_HANDLED;
     }
@@ -1064,16 +1884,29 @@ int fhi_irq_handler(int id, void *data)
 }
 #endif
 
-void xorif_fhi_init_device(void)
+int xorif_fhi_init_device(void)
 {
+    SPAN_SCOPE(__func__, "init", NULL, 0);
+
+    // Clear the expected register values (for the register scrubber)
+    xorif_scrub_reset();
+
 #ifdef NO_HW
     // Initialize fake register bank
+    SPAN_PHASE("init_fake_reg_bank", "init");
     init_fake_reg_bank();
 #endif
 
     // Set-up the FHI capabilities
+    SPAN_PHASE("read_capabilities", "init");
     memset(&fhi_caps, 0, sizeof(fhi_caps));
     fhi_caps.max_cc = READ_REG(CFG_CONFIG_XRAN_MAX_CC);
+    if (fhi_caps.max_cc > MAX_NUM_CC)
+    {
+        // The CC enable / reload registers are 16-bit masks
+        PERROR("Device supports %d component carriers, limiting to %d\n", fhi_caps.max_cc, MAX_NUM_CC);
+        fhi_caps.max_cc = MAX_NUM_CC;
+    }
     fhi_caps.num_eth_ports = READ_REG(CFG_CONFIG_NO_OF_ETH_PORTS);
     fhi_caps.numerologies = 0x1F; // bit-map: u0 - u4
     fhi_caps.extended_cp = 0;
@@ -1155,7 +1988,7 @@ void xorif_fhi_init_device(void)
     fhi_caps.extra_flags = flags;
 
     // Set up any useful defaults, etc.
-    XRAN_TIMER_CLK = fhi_caps.timer_clk_ps; //READ_REG(CFG_CONFIG_XRAN_TIMER_CLK_PS);
+    XRAN_TIMER_CLK = FHI_CAPS.timer_clk_ps; //READ_REG(CFG_CONFIG_XRAN_TIMER_CLK_PS);
 
     // Additional properties extracted from device node
 #ifndef NO_HW
@@ -1171,23 +2004,54 @@ void xorif_fhi_init_device(void)
     }
 #endif
 
+#ifdef XORIF_PROFILE
+    // The specialized library is only valid for the device it was built for
+    if (memcmp(&fhi_caps, &xorif_profile_caps, sizeof(fhi_caps)) != 0)
+    {
+        PERROR("Device capabilities don't match the hardware profile\n");
+        return XORIF_INVALID_CONFIG;
+    }
+#endif
+
+    // The RU port mapping table shadow (and the 11-bit table address) limit the table size
+    if ((1U << FHI_CAPS.ru_ports_map_width) > RU_PORTS_TABLE_MAX_SIZE)
+    {
+        PERROR("RU port table size exceeds maximum (%d)\n", RU_PORTS_TABLE_MAX_SIZE);
+        return XORIF_INVALID_CONFIG;
+    }
+
     // Initialize memory allocation system
+    SPAN_PHASE("initialize_memory", "init");
     initialize_memory();
 
+    // Contents of the RU port mapping table are unknown
+    memset(ru_ports_shadow, 0xFF, sizeof(ru_ports_shadow));
+
+    // Contents of the multi-O-DU tables are unknown
+    memset(modu_shadow_valid, 0, sizeof(modu_shadow_valid));
+
+    // All component carriers are planned on Ethernet port 0 by default
+    memset(planned_eth_port, 0, sizeof(planned_eth_port));
+
     // Clear alarms and counters
+    SPAN_PHASE("clear_alarms_and_counters", "init");
     xorif_clear_fhi_alarms();
     xorif_clear_fhi_stats();
 
 #ifdef ENABLE_INTERRUPTS
     // Setup interrupts *** all disabled by default ***
+    SPAN_PHASE("setup_interrupts", "init");
     // Use xorif_enable_fhi_interrupts() to enable
     WRITE_REG_RAW(FHI_INTR_ENABLE_ADDR, 0);
 
     // Finally enable the master interrupt
     WRITE_REG(CFG_MASTER_INT_ENABLE, 1);
 #endif
+
+    return XORIF_SUCCESS;
 }
 
+#ifndef XORIF_PROFILE
 int xorif_fhi_get_max_cc(void)
 {
     return fhi_caps.max_cc; //READ_REG(CFG_CONFIG_XRAN_MAX_CC);
@@ -1197,6 +2061,7 @@ int xorif_fhi_get_num_eth_ports(void)
 {
     return fhi_caps.num_eth_ports; //READ_REG(CFG_CONFIG_NO_OF_ETH_PORTS);
 }
+#endif
 
 int xorif_fhi_cc_reload(uint16_t cc)
 {
@@ -1209,6 +2074,7 @@ int xorif_fhi_cc_enable(uint16_t cc)
     uint32_t val = READ_REG(ORAN_CC_ENABLE);
     val |= (1 << cc);
     WRITE_REG(ORAN_CC_ENABLE, val);
+    xorif_stall_cc_change();
     return XORIF_SUCCESS;
 }
 
@@ -1218,6 +2084,7 @@ int xorif_fhi_cc_disable(uint16_t cc)
     uint32_t val = READ_REG(ORAN_CC_ENABLE);
     val &= ~(1 << cc);
     WRITE_REG(ORAN_CC_ENABLE, val);
+    xorif_stall_cc_change();
 
     // Deallocate any memory associated with this component carrier
     deallocate_memory(cc);
@@ -1225,9 +2092,9 @@ int xorif_fhi_cc_disable(uint16_t cc)
     return XORIF_SUCCESS;
 }
 
-uint8_t xorif_fhi_get_enabled_mask(void)
+uint16_t xorif_fhi_get_enabled_mask(void)
 {
-    return (uint8_t)READ_REG(ORAN_CC_ENABLE);
+    return (uint16_t)READ_REG(ORAN_CC_ENABLE);
 }
 
 int xorif_fhi_init_cc_symbol_pointers(
@@ -1419,7 +2286,7 @@ int xorif_set_cc_dl_iq_compression_per_ss(uint16_t ss,
         PERROR("IQ compression method/width not supported (DL)\n");
         return XORIF_COMP_MODE_NOT_SUPPORTED;
     }
-    else if ((ss + number) > fhi_caps.no_deframer_ss)
+    else if ((ss + number) > FHI_CAPS.no_deframer_ss)
     {
         PERROR("Invalid spatial stream value\n");
         return XORIF_INVALID_SS;
@@ -1522,17 +2389,38 @@ int xorif_fhi_configure_time_advance_offsets_ssb(uint16_t cc,
 
 int xorif_fhi_configure_cc(uint16_t cc)
 {
+    return configure_cc(cc, 0);
+}
+
+int xorif_fhi_configure_cc_hot_add(uint16_t cc)
+{
+    return configure_cc(cc, 1);
+}
+
+/**
+ * @brief Configure the specified component carrier.
+ * @param[in] cc Component carrier to configure
+ * @param[in] hot_add Flag to place the carrier without disturbing live carriers
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ */
+static int configure_cc(uint16_t cc, int hot_add)
+{
+    SPAN_SCOPE(hot_add ? "xorif_configure_cc_hot_add" : "xorif_configure_cc", "cc", "cc", cc);
+
     // Set up pointer to configuration data
     const struct xorif_cc_config *ptr = &cc_config[cc];
 
     // Calculate required number of symbols
+    SPAN_PHASE("calculate", "cc");
     uint16_t ul_ctrl_sym_num = calc_sym_num(ptr->numerology, ptr->extended_cp, ptr->delay_comp_cp_ul + ptr->advance_ul + ptr->ul_radio_ch_dly);
     uint16_t dl_ctrl_sym_num = calc_sym_num(ptr->numerology, ptr->extended_cp, ptr->delay_comp_cp_dl + ptr->advance_dl + fhi_sys_const.FH_DECAP_DLY);
     uint16_t dl_data_sym_num = calc_sym_num(ptr->numerology, ptr->extended_cp, ptr->delay_comp_up + fhi_sys_const.FH_DECAP_DLY);
     uint16_t ssb_ctrl_sym_num = 0;
     uint16_t ssb_data_sym_num = 0;
 
-    if (ptr->num_rbs_ssb)
+    if (HAS_SSB && ptr->num_rbs_ssb)
     {
         ssb_ctrl_sym_num = calc_sym_num(ptr->numerology_ssb, ptr->extended_cp_ssb, ptr->delay_comp_cp_dl + ptr->advance_dl + fhi_sys_const.FH_DECAP_DLY);
         ssb_data_sym_num = calc_sym_num(ptr->numerology_ssb, ptr->extended_cp_ssb, ptr->delay_comp_up + fhi_sys_const.FH_DECAP_DLY);
@@ -1550,17 +2438,17 @@ int xorif_fhi_configure_cc(uint16_t cc)
 #endif
 
     // Check number ctrl symbols
-    if ((ul_ctrl_sym_num > fhi_caps.max_ctrl_symbols) ||
-        (dl_ctrl_sym_num > fhi_caps.max_ctrl_symbols) ||
-        (ssb_ctrl_sym_num > fhi_caps.max_ctrl_symbols))
+    if ((ul_ctrl_sym_num > FHI_CAPS.max_ctrl_symbols) ||
+        (dl_ctrl_sym_num > FHI_CAPS.max_ctrl_symbols) ||
+        (ssb_ctrl_sym_num > FHI_CAPS.max_ctrl_symbols))
     {
         PERROR("Configuration exceeds max control symbols\n");
         return XORIF_MAX_CTRL_SYM_EXCEEDED;
     }
 
     // Check number data symbols
-    if ((dl_data_sym_num > fhi_caps.max_data_symbols) ||
-        (ssb_data_sym_num > fhi_caps.max_data_symbols))
+    if ((dl_data_sym_num > FHI_CAPS.max_data_symbols) ||
+        (ssb_data_sym_num > FHI_CAPS.max_data_symbols))
     {
         PERROR("Configuration exceeds max data symbols\n");
         return XORIF_MAX_DATA_SYM_EXCEEDED;
@@ -1576,7 +2464,7 @@ int xorif_fhi_configure_cc(uint16_t cc)
 
     // Calculate SSB data buffer size (per symbol)
     uint16_t ssb_data_buff_size = 0;
-    if (ptr->num_rbs_ssb)
+    if (HAS_SSB && ptr->num_rbs_ssb)
     {
         ssb_data_buff_size = calc_data_buff_size(ptr->num_rbs_ssb,
                                                  ptr->iq_comp_meth_ssb,
@@ -1602,75 +2490,139 @@ int xorif_fhi_configure_cc(uint16_t cc)
         num_sections = ptr->num_rbs;
     }
 
-    // Deallocate any memory associated with this component carrier
-    deallocate_memory(cc);
-
-    // Get new memory allocations
-    int ul_ctrl_offset = alloc_block(ul_ctrl_memory, (ul_ctrl_sym_num * ptr->num_ctrl_per_sym_ul), cc);
-    int ul_ctrl_base_offset = alloc_block(ul_ctrl_base_memory, num_sections, cc);
-    int dl_ctrl_offset = alloc_block(dl_ctrl_memory, (dl_ctrl_sym_num * ptr->num_ctrl_per_sym_dl), cc);
-    int dl_data_ptrs_offset = alloc_block(dl_data_ptrs_memory, dl_data_sym_num, cc);
-    int dl_data_buff_offset = alloc_block(dl_data_buff_memory, (dl_data_sym_num * dl_data_buff_size), cc);
-    int ssb_ctrl_offset = alloc_block(ssb_ctrl_memory, (ssb_ctrl_sym_num * ptr->num_ctrl_per_sym_ssb), cc);
-    int ssb_data_ptrs_offset = alloc_block(ssb_data_ptrs_memory, ssb_data_sym_num, cc);
-    int ssb_data_buff_offset = alloc_block(ssb_data_buff_memory, (ssb_data_sym_num * ssb_data_buff_size), cc);
+    // Memory allocation offsets
+    SPAN_PHASE("allocate_memory", "cc");
+    int ul_ctrl_offset;
+    int ul_ctrl_base_offset;
+    int dl_ctrl_offset;
+    int dl_data_ptrs_offset;
+    int dl_data_buff_offset;
+    int ssb_ctrl_offset;
+    int ssb_data_ptrs_offset;
+    int ssb_data_buff_offset;
 
-    // Check for memory allocation errors...
-    int error = 0;
-    if (ul_ctrl_offset == -1)
+    if (hot_add)
     {
-        PERROR("Configuration exceeds available buffer space (uplink ctrl section memory)\n");
-        error = 1;
-    }
+        // Hot-add places this carrier in the free space around the live carriers,
+        // so a carrier that is itself live can't be hot-added
+        if (xorif_fhi_get_enabled_mask() & (1 << cc))
+        {
+            PERROR("Hot-add requires a disabled component carrier (CC %d is enabled)\n", cc);
+            return XORIF_INVALID_CC;
+        }
 
-    if (ul_ctrl_base_offset == -1)
-    {
-        PERROR("Configuration exceeds available subcarriers (uplink ctrl base)\n");
-        error = 1;
-    }
+        void *pools[] = {ul_ctrl_memory, ul_ctrl_base_memory, dl_ctrl_memory, dl_data_ptrs_memory,
+                         dl_data_buff_memory, ssb_ctrl_memory, ssb_data_ptrs_memory, ssb_data_buff_memory};
+        const char *pool_names[] = {"uplink ctrl section memory", "uplink ctrl base", "downlink ctrl section memory",
+                                    "downlink data pointers", "downlink data buffer", "SSB ctrl section memory",
+                                    "SSB data pointers", "SSB data buffer"};
+        (void)pool_names; // Only used for error messages
+        const uint16_t sizes[] = {ul_ctrl_sym_num * ptr->num_ctrl_per_sym_ul, num_sections,
+                                  dl_ctrl_sym_num * ptr->num_ctrl_per_sym_dl, dl_data_sym_num,
+                                  dl_data_sym_num * dl_data_buff_size, ssb_ctrl_sym_num * ptr->num_ctrl_per_sym_ssb,
+                                  ssb_data_sym_num, ssb_data_sym_num * ssb_data_buff_size};
+        int *offsets[] = {&ul_ctrl_offset, &ul_ctrl_base_offset, &dl_ctrl_offset, &dl_data_ptrs_offset,
+                          &dl_data_buff_offset, &ssb_ctrl_offset, &ssb_data_ptrs_offset, &ssb_data_buff_offset};
+
+        // Check that every memory has room before anything is released, allocated or programmed
+        // (the memory held by this disabled carrier counts as free, since it's replaced)
+        for (int i = 0; i < 8; ++i)
+        {
+            if (find_free_block(pools[i], sizes[i], cc) == -1)
+            {
+                PERROR("Hot-add of CC %d exceeds available buffer space (%s: requires %u, largest free block %u)\n",
+                       cc, pool_names[i], sizes[i], get_largest_free_block(pools[i], cc));
+                return XORIF_BUFFER_SPACE_EXCEEDED;
+            }
+        }
 
-    if (dl_ctrl_offset == -1)
-    {
-        PERROR("Configuration exceeds available buffer space (downlink ctrl section memory)\n");
-        error = 1;
-    }
+        // It fits, so release the carrier's existing memory
+        deallocate_memory(cc);
 
-    if (ssb_ctrl_offset  == -1)
-    {
-        PERROR("Configuration exceeds available buffer space (SSB ctrl section memory)\n");
-        error = 1;
+        // Place each block in the smallest free region that fits (existing blocks don't move)
+        for (int i = 0; i < 8; ++i)
+        {
+            *offsets[i] = alloc_block_best_fit(pools[i], sizes[i], cc);
+            if (*offsets[i] == -1)
+            {
+                PERROR("Hot-add of CC %d failed to allocate %s\n", cc, pool_names[i]);
+                deallocate_memory(cc);
+                return XORIF_MEMORY_ALLOCATION_FAIL;
+            }
+        }
     }
-
-    if (dl_data_ptrs_offset == -1)
+    else
     {
-        PERROR("Configuration exceeds allocated buffer space (downlink data pointers)\n");
-        error = 1;
-    }
+        // Deallocate any memory associated with this component carrier
+        deallocate_memory(cc);
 
-    if (dl_data_buff_offset == -1)
-    {
-        PERROR("Configuration exceeds allocated buffer space (downlink data buffer)\n");
-        error = 1;
-    }
+        // Get new memory allocations
+        ul_ctrl_offset = alloc_block(ul_ctrl_memory, (ul_ctrl_sym_num * ptr->num_ctrl_per_sym_ul), cc);
+        ul_ctrl_base_offset = alloc_block(ul_ctrl_base_memory, num_sections, cc);
+        dl_ctrl_offset = alloc_block(dl_ctrl_memory, (dl_ctrl_sym_num * ptr->num_ctrl_per_sym_dl), cc);
+        dl_data_ptrs_offset = alloc_block(dl_data_ptrs_memory, dl_data_sym_num, cc);
+        dl_data_buff_offset = alloc_block(dl_data_buff_memory, (dl_data_sym_num * dl_data_buff_size), cc);
+        ssb_ctrl_offset = alloc_block(ssb_ctrl_memory, (ssb_ctrl_sym_num * ptr->num_ctrl_per_sym_ssb), cc);
+        ssb_data_ptrs_offset = alloc_block(ssb_data_ptrs_memory, ssb_data_sym_num, cc);
+        ssb_data_buff_offset = alloc_block(ssb_data_buff_memory, (ssb_data_sym_num * ssb_data_buff_size), cc);
+
+        // Check for memory allocation errors...
+        int error = 0;
+        if (ul_ctrl_offset == -1)
+        {
+            PERROR("Configuration exceeds available buffer space (uplink ctrl section memory)\n");
+            error = 1;
+        }
 
-    if (ssb_data_ptrs_offset == -1)
-    {
-        PERROR("Configuration exceeds allocated buffer space (SSB data pointers)\n");
-        error = 1;
-    }
+        if (ul_ctrl_base_offset == -1)
+        {
+            PERROR("Configuration exceeds available subcarriers (uplink ctrl base)\n");
+            error = 1;
+        }
 
-    if (ssb_data_buff_offset == -1)
-    {
-        PERROR("Configuration exceeds allocated buffer space (SSB data buffer)\n");
-        error = 1;
-    }
+        if (dl_ctrl_offset == -1)
+        {
+            PERROR("Configuration exceeds available buffer space (downlink ctrl section memory)\n");
+            error = 1;
+        }
 
-    if (error)
-    {
-        // Deallocate any memory associated with this component carrier
-        deallocate_memory(cc);
+        if (ssb_ctrl_offset  == -1)
+        {
+            PERROR("Configuration exceeds available buffer space (SSB ctrl section memory)\n");
+            error = 1;
+        }
+
+        if (dl_data_ptrs_offset == -1)
+        {
+            PERROR("Configuration exceeds allocated buffer space (downlink data pointers)\n");
+            error = 1;
+        }
+
+        if (dl_data_buff_offset == -1)
+        {
+            PERROR("Configuration exceeds allocated buffer space (downlink data buffer)\n");
+            error = 1;
+        }
+
+        if (ssb_data_ptrs_offset == -1)
+        {
+            PERROR("Configuration exceeds allocated buffer space (SSB data pointers)\n");
+            error = 1;
+        }
+
+        if (ssb_data_buff_offset == -1)
+        {
+            PERROR("Configuration exceeds allocated buffer space (SSB data buffer)\n");
+            error = 1;
+        }
+
+        if (error)
+        {
+            // Deallocate any memory associated with this component carrier
+            deallocate_memory(cc);
 
-        return XORIF_BUFFER_SPACE_EXCEEDED;
+            return XORIF_BUFFER_SPACE_EXCEEDED;
+        }
     }
 
     // Everything fits!
@@ -1700,6 +2652,7 @@ int xorif_fhi_configure_cc(uint16_t cc)
     // Program the h/w...
 
     // DL / UL
+    SPAN_PHASE("program_dl_ul", "cc");
     xorif_fhi_init_cc_rbs(cc, ptr->num_rbs, ptr->numerology, ptr->extended_cp);
     xorif_fhi_init_cc_symbol_pointers(cc, dl_data_sym_num, dl_data_ptrs_offset, dl_ctrl_sym_num, ul_ctrl_sym_num);
     xorif_fhi_set_cc_dl_iq_compression(cc, ptr->iq_comp_width_dl, ptr->iq_comp_meth_dl, ptr->iq_comp_mplane_dl);
@@ -1710,7 +2663,9 @@ int xorif_fhi_configure_cc(uint16_t cc)
     xorif_fhi_init_cc_ctrl_constants(cc, dl_ctrl_sym_num, ptr->num_ctrl_per_sym_dl, ul_ctrl_sym_num, ptr->num_ctrl_per_sym_ul);
     xorif_fhi_configure_time_advance_offsets(cc, ptr->numerology, ptr->extended_cp, ptr->advance_ul, ptr->advance_dl, ptr->ul_bid_forward);
 
+#if HAS_SSB
     // SSB
+    SPAN_PHASE("program_ssb", "cc");
     xorif_fhi_init_cc_rbs_ssb(cc, ptr->num_rbs_ssb, ptr->numerology_ssb, ptr->extended_cp_ssb);
     xorif_fhi_init_cc_symbol_pointers_ssb(cc, ssb_data_sym_num, ssb_data_ptrs_offset, ssb_ctrl_sym_num);
     xorif_fhi_set_cc_iq_compression_ssb(cc, ptr->iq_comp_width_ssb, ptr->iq_comp_meth_ssb, ptr->iq_comp_mplane_ssb);
@@ -1718,12 +2673,18 @@ int xorif_fhi_configure_cc(uint16_t cc)
     xorif_fhi_init_cc_dl_data_offsets_ssb(cc, ssb_data_sym_num, ssb_data_ptrs_offset, ssb_data_buff_offset, ssb_data_buff_size);
     xorif_fhi_init_cc_ctrl_constants_ssb(cc, ssb_ctrl_sym_num, ptr->num_ctrl_per_sym_ssb);
     xorif_fhi_configure_time_advance_offsets_ssb(cc, ptr->numerology_ssb, ptr->extended_cp_ssb, ptr->advance_dl);
+#endif
 
+#if HAS_PRACH
     // PRACH
+    SPAN_PHASE("program_prach", "cc");
     xorif_fhi_set_cc_iq_compression_prach(cc, ptr->iq_comp_width_prach, ptr->iq_comp_meth_prach, ptr->iq_comp_mplane_prach);
+#endif
 
     // Perform "reload" on the component carrier
+    SPAN_PHASE("reload", "cc");
     xorif_fhi_cc_reload(cc);
+    xorif_stall_cc_change();
 
 #ifdef AUTO_ENABLE
     // Enable component carrier
@@ -1815,20 +2776,96 @@ static uint16_t calc_data_buff_size(uint16_t num_rbs,
     return size;
 }
 
+/**
+ * @brief Write an entry in the RU port mapping table (if different from the shadow).
+ * @param[in] address Table address
+ * @param[in] entry Entry value (<ccid> | <port> | <type> fields, no strobe or address)
+ * @returns
+ *      - 1 if the entry was written
+ *      - 0 if the entry was unchanged
+ */
+static int write_ru_ports_entry(uint16_t address, uint32_t entry)
+{
+    if (ru_ports_shadow[address] == (entry & RU_PORTS_ENTRY_MASK))
+    {
+        return 0;
+    }
+
+    // Value: <write strobe> | <ccid> | <port> | <type> | <address>
+    WRITE_REG_RAW(DEFM_CID_MAP_WR_STROBE_ADDR, (1U << 31) | entry | (address & 0x7FF));
+    ru_ports_shadow[address] = entry & RU_PORTS_ENTRY_MASK;
+#ifdef EXTRA_DEBUG
+    ++ru_ports_table_writes;
+#endif
+    return 1;
+}
+
+/**
+ * @brief Pack a multi-O-DU table entry (as held in the shadow).
+ * @param[in] ptr Pointer to the table entry
+ * @returns
+ *      - <MAC address 47:0> << 16 | <PCP> << 13 | <DEI> << 12 | <ID>
+ */
+static uint64_t pack_modu_entry(const struct xorif_modu_entry *ptr)
+{
+    uint64_t entry = 0;
+    for (int i = 0; i < 6; ++i)
+    {
+        entry = (entry << 8) | ptr->address[i];
+    }
+    return (entry << 16) | ((ptr->pcp & 0x7) << 13) | ((ptr->dei & 0x1) << 12) | (ptr->id & 0xFFF);
+}
+
+/**
+ * @brief Write an entry in a port's multi-O-DU table (if different from the shadow).
+ * @param[in] port Ethernet port
+ * @param[in] du O-DU port address
+ * @param[in] entry Packed entry (see pack_modu_entry)
+ * @returns
+ *      - 1 if the entry was written
+ *      - 0 if the entry was unchanged
+ */
+static int write_modu_entry(int port, uint16_t du, uint64_t entry)
+{
+    int shadowed = (port < MAX_NUM_ETH_PORTS);
+    if (shadowed && (modu_shadow_valid[port] & (1 << du)) && (modu_shadow[port][du] == entry))
+    {
+        return 0;
+    }
+
+    // MAC address and VLAN tag (the ID / DEI / PCP fields share one register)
+    WRITE_REG_OFFSET(ETH_DU_TABLE_WR_DEST_ADDR_47_32, port * 0x100, (entry >> 48) & 0xFFFF);
+    WRITE_REG_OFFSET(ETH_DU_TABLE_WR_DEST_ADDR_31_0, port * 0x100, (entry >> 16) & 0xFFFFFFFF);
+    WRITE_REG_RAW_ALT("ETH_DU_TABLE_WR_VLAN_ADDR", ETH_DU_TABLE_WR_VLAN_ID_ADDR + (port * 0x100), entry & 0xFFFF);
+
+    // Value: <write strobe> | <DU port address> (the strobe auto-clears)
+    WRITE_REG_RAW_ALT("ETH_DU_TABLE_WR_STROBE_ADDR", ETH_DU_TABLE_WR_STROBE_ADDR + (port * 0x100), (1U << 31) | du);
+
+    if (shadowed)
+    {
+        modu_shadow[port][du] = entry;
+        modu_shadow_valid[port] |= (1 << du);
+    }
+#ifdef EXTRA_DEBUG
+    ++modu_table_writes;
+#endif
+    return 1;
+}
+
 /**
  * @brief Initialize memory allocation system.
 */
 static void initialize_memory(void)
 {
     // Reset the memory allocation pointers
-    init_memory_allocator(&ul_ctrl_memory, 0, 1024 * fhi_caps.max_ul_ctrl_1kwords);
-    init_memory_allocator(&ul_ctrl_base_memory, 0, fhi_caps.max_subcarriers / RE_PER_RB);
-    init_memory_allocator(&dl_ctrl_memory, 0, 1024 * fhi_caps.max_dl_ctrl_1kwords);
-    init_memory_allocator(&dl_data_ptrs_memory, 0, fhi_caps.max_data_symbols);
-    init_memory_allocator(&dl_data_buff_memory, 0, 1024 * fhi_caps.max_dl_data_1kwords);
-    init_memory_allocator(&ssb_ctrl_memory, 0, 512 * fhi_caps.max_ssb_ctrl_512words);
-    init_memory_allocator(&ssb_data_ptrs_memory, 0, fhi_caps.max_data_symbols);
-    init_memory_allocator(&ssb_data_buff_memory, 0, 512 * fhi_caps.max_ssb_data_512words);
+    init_memory_allocator(&ul_ctrl_memory, 0, 1024 * FHI_CAPS.max_ul_ctrl_1kwords);
+    init_memory_allocator(&ul_ctrl_base_memory, 0, FHI_CAPS.max_subcarriers / RE_PER_RB);
+    init_memory_allocator(&dl_ctrl_memory, 0, 1024 * FHI_CAPS.max_dl_ctrl_1kwords);
+    init_memory_allocator(&dl_data_ptrs_memory, 0, FHI_CAPS.max_data_symbols);
+    init_memory_allocator(&dl_data_buff_memory, 0, 1024 * FHI_CAPS.max_dl_data_1kwords);
+    init_memory_allocator(&ssb_ctrl_memory, 0, 512 * FHI_CAPS.max_ssb_ctrl_512words);
+    init_memory_allocator(&ssb_data_ptrs_memory, 0, FHI_CAPS.max_data_symbols);
+    init_memory_allocator(&ssb_data_buff_memory, 0, 512 * FHI_CAPS.max_ssb_data_512words);
 }
 
 /**
@@ -1868,7 +2905,7 @@ static void init_fake_reg_bank(void)
     WRITE_REG(CFG_CONFIG_NO_OF_FRAM_ANTS, 8);
     WRITE_REG(CFG_CONFIG_NO_OF_DEFM_ANTS, 20);
     WRITE_REG(CFG_CONFIG_NO_OF_ETH_PORTS, 4);
-    WRITE_REG(CFG_CONFIG_XRAN_MAX_CC, 8);
+    WRITE_REG(CFG_CONFIG_XRAN_MAX_CC, fake_max_cc);
     WRITE_REG(CFG_CONFIG_XRAN_MAX_DL_SYMBOLS, 16);
     WRITE_REG(CFG_CONFIG_XRAN_FRAM_ETH_PKT_MAX, 9000);
     WRITE_REG(CFG_CONFIG_XRAN_DEFM_ETH_PKT_MAX, 9000);
@@ -1934,13 +2971,130 @@ int xorif_test_error_injections(uint32_t status)
     return XORIF_NOT_SUPPORTED;
 #endif
 }
+
+/**
+ * @brief Set the number of component carriers in the fake register bank.
+ * @param num_cc Number of component carriers (1 to MAX_NUM_CC)
+ * @return
+ *      - XORIF_SUCCESS
+ *      - XORIF_INVALID_CC
+ *      - XORIF_NOT_SUPPORTED
+ * @note
+ * This function is for testing only, and is not exposed in the
+ * API header file. Takes effect at the next xorif_init().
+ */
+int xorif_test_set_fake_max_cc(uint16_t num_cc)
+{
+#ifdef NO_HW
+    if (num_cc == 0 || num_cc > MAX_NUM_CC)
+    {
+        return XORIF_INVALID_CC;
+    }
+    fake_max_cc = num_cc;
+    return XORIF_SUCCESS;
+#else
+    return XORIF_NOT_SUPPORTED;
+#endif
+}
+
+/**
+ * @brief Count the registers of a component carrier written since the last reset.
+ * @param cc Component carrier
+ * @return
+ *      - Number of register words written (per-CC registers and the CC's
+ *        DL / SSB data unroll offset entries)
+ *      - XORIF_NOT_SUPPORTED
+ * @note
+ * This function is for testing only, and is not exposed in the
+ * API header file. Pass a negative value for cc to reset the record.
+ */
+int xorif_test_cc_reg_writes(int cc)
+{
+#ifdef NO_HW
+    if (cc < 0)
+    {
+        xorif_test_reset_reg_writes();
+        return 0;
+    }
+
+    int count = 0;
+
+    // Per-CC register blocks (DL/UL and SSB)
+    for (uint32_t a = 0; a < 0x70; a += 4)
+    {
+        count += xorif_test_reg_written(ORAN_CC_NUMRBS_ADDR + cc * 0x70 + a);
+        count += xorif_test_reg_written(ORAN_CC_SSB_NUMRBS_ADDR + cc * 0x70 + a);
+    }
+
+    // Unroll offset entries, indexed by the CC's allocated data pointers
+    uint16_t offset, size;
+    if (get_alloc_block(dl_data_ptrs_memory, cc, &offset, &size))
+    {
+        for (uint16_t i = offset; i < offset + size; ++i)
+        {
+            count += xorif_test_reg_written(ORAN_CC_DL_DATA_UNROLL_OFFSET_ADDR + i * 4);
+        }
+    }
+    if (get_alloc_block(ssb_data_ptrs_memory, cc, &offset, &size))
+    {
+        for (uint16_t i = offset; i < offset + size; ++i)
+        {
+            count += xorif_test_reg_written(ORAN_CC_SSB_DATA_UNROLL_OFFSET_ADDR + i * 4);
+        }
+    }
+
+    return count;
+#else
+    return XORIF_NOT_SUPPORTED;
+#endif
+}
+
+/**
+ * @brief Count the RU port mapping table entries written since the last reset.
+ * @param reset Reset the count (after reading) if non-zero
+ * @return
+ *      - Number of table entries written
+ * @note
+ * This function is for testing only, and is not exposed in the
+ * API header file.
+ */
+int xorif_test_ru_ports_table_writes(int reset)
+{
+    int count = ru_ports_table_writes;
+    if (reset)
+    {
+        ru_ports_table_writes = 0;
+    }
+    return count;
+}
+
+/**
+ * @brief Count the multi-O-DU table entries written since the last reset.
+ * @param reset Reset the count (after reading) if non-zero
+ * @return
+ *      - Number of table entries written
+ * @note
+ * This function is for testing only, and is not exposed in the
+ * API header file.
+ */
+int xorif_test_modu_table_writes(int reset)
+{
+    int count = modu_table_writes;
+    if (reset)
+    {
+        modu_table_writes = 0;
+    }
+    return count;
+}
 #endif // EXTRA_DEBUG
 
 int xorif_monitor_clear(void)
 {
     TRACE("xorif_monitor_clear()\n");
 
+    xorif_monitor_lock();
     WRITE_REG(CFG_MONITOR_CLEAR, 1);
+    xorif_monitor_unlock();
 
     return XORIF_SUCCESS;
 }
@@ -1949,7 +3103,9 @@ int xorif_monitor_select(uint8_t stream)
 {
     TRACE("xorif_monitor_select(%d)\n", stream);
 
+    xorif_monitor_lock();
     WRITE_REG(CFG_MONITOR_SELECT_CNT, stream);
+    xorif_monitor_unlock();
 
     return XORIF_SUCCESS;
 }
@@ -1958,7 +3114,9 @@ int xorif_monitor_snapshot(void)
 {
     TRACE("xorif_monitor_snapshot()\n");
 
+    xorif_monitor_lock();
     WRITE_REG(CFG_MONITOR_SNAPSHOT, 1);
+    xorif_monitor_unlock();
 
     return XORIF_SUCCESS;
 }
@@ -1967,10 +3125,12 @@ int xorif_monitor_read(uint8_t counter, uint64_t *value)
 {
     TRACE("xorif_monitor_read(%d)\n", counter);
 
+    xorif_monitor_lock();
     WRITE_REG(CFG_MONITOR_SELECT_READ, counter);
     WRITE_REG(CFG_MONITOR_SAMPLE, 1);
     uint64_t temp = (uint64_t)READ_REG(CFG_MONITOR_READ_31__0) |
                     (uint64_t)READ_REG(CFG_MONITOR_READ_63_32) << 32;
+    xorif_monitor_unlock();
     *value = temp;
 
     return XORIF_SUCCESS;
@@ -2010,9 +3170,10 @@ int xorif_stall_monitor_read(struct xorif_stall_monitor *ptr)
 }
 
 #ifdef INTEGRATED_OCP
-void xorif_register_ocp(ocp_callback_t callback)
+void xorif_register_ocp(ocp_status_t status, ocp_callback_t callback)
 {
     TRACE("xorif_register_ocp(...)\n");
+    ocp_status = status;
     ocp_callback = callback;
 }
 
@@ -2020,6 +3181,7 @@ void xorif_deregister_ocp(void)
 {
     TRACE("xorif_deregister_ocp()\n");
     ocp_callback = NULL;
+    ocp_status = NULL;
 }
 #endif
 
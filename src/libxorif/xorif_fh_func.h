@@ -37,9 +37,17 @@
 
 /**
  * @brief Perform default initialization of the device.
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - XORIF_INVALID_CONFIG if the device doesn't match the hardware profile
  */
-void xorif_fhi_init_device(void);
+int xorif_fhi_init_device(void);
 
+#ifdef XORIF_PROFILE
+// Constant for a hardware profile build (but 0 until the device has been checked, and after xorif_finish)
+static inline int xorif_fhi_get_max_cc(void) { return fhi_caps.max_cc ? FHI_CAPS.max_cc : 0; }
+static inline int xorif_fhi_get_num_eth_ports(void) { return fhi_caps.num_eth_ports ? FHI_CAPS.num_eth_ports : 0; }
+#else
 /**
  * @brief Returns the number of supported component carriers.
  * @returns
@@ -53,6 +61,7 @@ int xorif_fhi_get_max_cc(void);
  *      - The number of Ethernet ports
  */
 int xorif_fhi_get_num_eth_ports(void);
+#endif
 
 /**
  * @brief Re-load / re-configure the component carrier configuration.
@@ -83,7 +92,7 @@ int xorif_fhi_cc_disable(uint16_t cc);
  * @returns
  *      - Bit-map of enabled component carriers
  */
-uint8_t xorif_fhi_get_enabled_mask(void);
+uint16_t xorif_fhi_get_enabled_mask(void);
 
 /**
  * @brief Set the "enabled" component carrier bit-map mask.
@@ -312,6 +321,18 @@ int xorif_fhi_init_cc_ctrl_constants_ssb(uint16_t cc,
  */
 int xorif_fhi_configure_cc(uint16_t cc);
 
+/**
+ * @brief Configure the specified component carrier without disturbing live carriers.
+ * @param[in] cc Component carrier to configure
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ * @note
+ * Memory already allocated to other component carriers is left in place,
+ * and no registers belonging to other component carriers are written.
+ */
+int xorif_fhi_configure_cc_hot_add(uint16_t cc);
+
 /**
  * @brief Compute timing advance for the specified component carrier.
  * @param[in] cc Component carrier to configure
@@ -356,6 +377,9 @@ int xorif_fhi_configure_time_advance_offsets_ssb(uint16_t cc,
  *      - METAL_IRQ_NOT_HANDLED if the interrupt source was not handled
  * @note
  * The libmetal framework calls this handler.
+ * The FHI and (integrated) OCP share the interrupt. The pending sources are
+ * read once, and only the handlers for those pending are run. Log messages
+ * are deferred to the alarm thread, and no locks are taken.
  */
 int fhi_irq_handler(int id, void *data);
 #endif
@@ -0,0 +1,758 @@
+/*
+ * Copyright 2020 - 2023 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file xorif_recorder.c
+ * @author Steven Dickinson
+ * @brief Source file for libxorif flight recorder functions.
+ * @addtogroup libxorif
+ * @{
+ */
+
+#include <pthread.h>
+#include <time.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include "xorif_common.h"
+#include "xorif_registers.h"
+#include "xorif_stats.h"
+#include "xorif_recorder.h"
+
+#if HAS_RECORDER
+
+// Flight recorder record (as held, see struct xorif_recorder_record for the dump)
+// Note, only the data words used by the record type are written, and the
+// name isn't copied (the names are static strings, e.g. __func__)
+struct record
+{
+    uint64_t timestamp;                 // Time of the record (ns, monotonic clock)
+    uint32_t seq;                       // Sequence number (0 = in-progress)
+    uint16_t type;                      // Record type
+    uint16_t arg;                       // Type-specific argument
+    uint32_t data[RECORDER_DATA_WORDS]; // Type-specific data
+    const char *name;                   // Function / register name (or NULL)
+};
+
+// Flight recorder records (lock-free, multiple producers)
+// Each producer claims a sequence number, then writes the record, and the
+// sequence number last (so that records in-progress can be detected)
+static struct
+{
+    uint32_t head;         // Sequence number of the latest record claimed
+    int frozen;            // Recording is frozen
+    int armed;             // Triggers (or post-trigger records) are configured, so register writes are recorded
+    int32_t remaining;     // Records to capture before freezing (> 0 after a trigger)
+    uint32_t triggers;     // Enabled triggers
+    uint32_t alarm_mask;   // Alarms that fire the alarm trigger
+    uint32_t post_records; // Records to capture after a trigger
+    uint32_t trigger;      // Trigger that fired (0 = none)
+    uint32_t trigger_seq;  // Sequence number of the trigger record
+    uint64_t trigger_time; // Time of the trigger (ns)
+    uint64_t deadline;     // Time to freeze if the post-trigger records aren't captured (ns, 0 = none)
+    int dump;              // Automatic dump pending
+    struct record records[RECORDER_SIZE];
+} ring;
+
+// Flight recorder thread (samples the counters and dumps the records when frozen)
+// Note, the producers (including the interrupt handler) never take the lock;
+// they wake the thread through the event file descriptor
+static struct
+{
+    pthread_mutex_t lock;  // Protects everything below (except the file descriptor)
+    int fd;                // Event file descriptor to wake the recorder thread (-1 until the first start, then kept open)
+    pthread_t thread;      // Recorder thread
+    int running;           // Recorder thread is running
+    int stop;              // Request to stop the recorder thread
+    uint32_t sample_ms;    // Counter sampling period (0 = off)
+    char dump_file[256];   // Automatic dump file (empty = no automatic dump)
+    uint32_t dumps;        // Automatic dumps written
+    int32_t dump_result;   // Result of the latest automatic dump
+} control = {.lock = PTHREAD_MUTEX_INITIALIZER, .fd = -1};
+
+// Serializes the dumps
+static pthread_mutex_t dump_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Local function prototypes...
+
+static uint64_t time_ns(void);
+static uint64_t stamp_ns(void);
+static struct record *claim(uint16_t type, uint64_t timestamp, uint32_t *seq);
+static void commit(struct record *rec, uint32_t seq);
+static int data_words(uint16_t type);
+static void freeze(void);
+static void wake_thread(void);
+static int start_thread(void);
+static int dump(const char *file);
+static void *recorder_thread(void *arg);
+
+// API functions...
+
+int xorif_set_recorder_trigger(uint32_t triggers, uint32_t alarm_mask, uint16_t post_records, const char *dump_file)
+{
+    TRACE("xorif_set_recorder_trigger(0x%X, 0x%X, %d, %s)\n", triggers, alarm_mask, post_records, dump_file ? dump_file : "NULL");
+
+    if (triggers & ~(RECORDER_TRIGGER_ALARM | RECORDER_TRIGGER_STALL | RECORDER_TRIGGER_ERROR | RECORDER_TRIGGER_MANUAL))
+    {
+        PERROR("Invalid flight recorder triggers\n");
+        return XORIF_INVALID_CONFIG;
+    }
+    else if (dump_file && (strlen(dump_file) >= sizeof(control.dump_file)))
+    {
+        PERROR("Flight recorder dump file name too long\n");
+        return XORIF_INVALID_CONFIG;
+    }
+
+    int result = XORIF_SUCCESS;
+    pthread_mutex_lock(&control.lock);
+    __atomic_store_n(&ring.alarm_mask, alarm_mask, __ATOMIC_RELAXED);
+    __atomic_store_n(&ring.post_records, post_records, __ATOMIC_RELAXED);
+    __atomic_store_n(&ring.triggers, triggers, __ATOMIC_RELEASE);
+    __atomic_store_n(&ring.armed, (triggers || post_records), __ATOMIC_RELAXED);
+    strcpy(control.dump_file, dump_file ? dump_file : "");
+    if (control.dump_file[0] || post_records)
+    {
+        result = start_thread();
+    }
+    pthread_mutex_unlock(&control.lock);
+
+    return result;
+}
+
+int xorif_set_recorder_sampling(uint32_t period_ms)
+{
+    TRACE("xorif_set_recorder_sampling(%d)\n", period_ms);
+
+    int result = XORIF_SUCCESS;
+    pthread_mutex_lock(&control.lock);
+    control.sample_ms = period_ms;
+    if (period_ms || control.running)
+    {
+        result = start_thread();
+    }
+    pthread_mutex_unlock(&control.lock);
+
+    return result;
+}
+
+int xorif_trigger_recorder(void)
+{
+    TRACE("xorif_trigger_recorder()\n");
+    xorif_recorder_trigger(RECORDER_TRIGGER_MANUAL, 0, NULL);
+    return XORIF_SUCCESS;
+}
+
+int xorif_rearm_recorder(void)
+{
+    TRACE("xorif_rearm_recorder()\n");
+
+    pthread_mutex_lock(&control.lock);
+    __atomic_store_n(&ring.dump, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&ring.deadline, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&ring.remaining, 0, __ATOMIC_RELAXED);
+    ring.trigger_seq = 0;
+    ring.trigger_time = 0;
+    __atomic_store_n(&ring.trigger, 0, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&ring.frozen, 0, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&control.lock);
+
+    return XORIF_SUCCESS;
+}
+
+int xorif_dump_recorder(const char *dump_file)
+{
+    TRACE("xorif_dump_recorder(%s)\n", dump_file ? dump_file : "NULL");
+
+    if (!dump_file)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+
+    return dump(dump_file);
+}
+
+int xorif_get_recorder_status(struct xorif_recorder_status *ptr)
+{
+    TRACE("xorif_get_recorder_status(...)\n");
+
+    if (!ptr)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+
+    pthread_mutex_lock(&control.lock);
+    ptr->frozen = __atomic_load_n(&ring.frozen, __ATOMIC_ACQUIRE);
+    ptr->triggers = ring.triggers;
+    ptr->alarm_mask = ring.alarm_mask;
+    ptr->post_records = ring.post_records;
+    ptr->sample_ms = control.sample_ms;
+    ptr->trigger = __atomic_load_n(&ring.trigger, __ATOMIC_ACQUIRE);
+    ptr->trigger_seq = ring.trigger_seq;
+    ptr->trigger_time = ring.trigger_time;
+    ptr->records = __atomic_load_n(&ring.head, __ATOMIC_RELAXED);
+    ptr->dumps = control.dumps;
+    ptr->dump_result = control.dump_result;
+    pthread_mutex_unlock(&control.lock);
+
+    return XORIF_SUCCESS;
+}
+
+// Internal functions...
+
+void xorif_record_api(const char *name)
+{
+    uint32_t seq;
+    struct record *rec = claim(RECORD_API, 0, &seq);
+    if (rec)
+    {
+        rec->name = name;
+        commit(rec, seq);
+    }
+}
+
+void xorif_record_error(const char *name)
+{
+    uint32_t seq;
+    struct record *rec = claim(RECORD_ERROR, 0, &seq);
+    if (rec)
+    {
+        rec->name = name;
+        commit(rec, seq);
+    }
+    xorif_recorder_trigger(RECORDER_TRIGGER_ERROR, 0, name);
+}
+
+void xorif_record_reg_write(const char *name, uint32_t addr, uint32_t mask, uint8_t shift, uint32_t value)
+{
+    // Only while armed (there are many register writes)
+    if (!__atomic_load_n(&ring.armed, __ATOMIC_RELAXED))
+    {
+        return;
+    }
+
+    uint32_t seq;
+    struct record *rec = claim(RECORD_REG_WRITE, 0, &seq);
+    if (rec)
+    {
+        rec->data[0] = addr;
+        rec->data[1] = mask;
+        rec->data[2] = shift;
+        rec->data[3] = value;
+        rec->name = name;
+        commit(rec, seq);
+    }
+}
+
+void xorif_record_alarm(uint32_t status, uint32_t handled, uint16_t action, uint16_t cc_mask, uint64_t timestamp)
+{
+    uint32_t seq;
+    struct record *rec = claim(RECORD_ALARM, timestamp, &seq);
+    if (rec)
+    {
+        rec->data[0] = status;
+        rec->data[1] = handled;
+        rec->data[2] = action;
+        rec->data[3] = cc_mask;
+        commit(rec, seq);
+    }
+
+    if (status & __atomic_load_n(&ring.alarm_mask, __ATOMIC_RELAXED))
+    {
+        xorif_recorder_trigger(RECORDER_TRIGGER_ALARM, status, NULL);
+    }
+}
+
+void xorif_record_stats(int port, const struct xorif_fhi_eth_stats *ptr, uint64_t timestamp)
+{
+    uint32_t seq;
+    struct record *rec = claim(RECORD_STATS, timestamp, &seq);
+    if (rec)
+    {
+        rec->arg = port;
+        rec->data[0] = ptr->total_rx_good_pkt_cnt;
+        rec->data[1] = ptr->total_rx_bad_pkt_cnt;
+        rec->data[2] = ptr->total_rx_bad_fcs_cnt;
+        rec->data[3] = ptr->oran_rx_early;
+        rec->data[4] = ptr->oran_rx_late;
+        rec->data[5] = ptr->oran_rx_corrupt;
+        rec->data[6] = ptr->oran_rx_error_drop;
+        rec->data[7] = ptr->oran_tx_total;
+        commit(rec, seq);
+    }
+}
+
+void xorif_record_stall(uint64_t flags, uint64_t onsets, uint64_t timestamp)
+{
+    uint32_t seq;
+    struct record *rec = claim(RECORD_STALL, timestamp, &seq);
+    if (rec)
+    {
+        rec->data[0] = flags;
+        rec->data[1] = flags >> 32;
+        rec->data[2] = onsets;
+        rec->data[3] = onsets >> 32;
+        commit(rec, seq);
+    }
+}
+
+void xorif_recorder_trigger(uint32_t trigger, uint32_t detail, const char *name)
+{
+    // Only the first (enabled) trigger fires
+    uint32_t none = 0;
+    uint32_t enabled = __atomic_load_n(&ring.triggers, __ATOMIC_ACQUIRE) | RECORDER_TRIGGER_MANUAL;
+    if (!(trigger & enabled) ||
+        !__atomic_compare_exchange_n(&ring.trigger, &none, trigger, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+    {
+        return;
+    }
+
+    uint64_t now = time_ns();
+    uint32_t seq = 0;
+    struct record *rec = claim(RECORD_TRIGGER, now, &seq);
+    if (rec)
+    {
+        rec->arg = trigger;
+        rec->data[0] = detail;
+        rec->name = name;
+        commit(rec, seq);
+    }
+    ring.trigger_seq = seq;
+    ring.trigger_time = now;
+
+    // Capture the records after the trigger (if any), then freeze
+    // Note, this is lock-free (it's called from the interrupt handler)
+    int32_t post = __atomic_load_n(&ring.post_records, __ATOMIC_RELAXED);
+    if (post > 0)
+    {
+        // Don't wait for ever (e.g. if everything has stopped)
+        __atomic_store_n(&ring.deadline, now + RECORDER_POST_TIMEOUT * 1000000ULL, __ATOMIC_RELEASE);
+        __atomic_store_n(&ring.remaining, post, __ATOMIC_RELEASE);
+        wake_thread();
+    }
+    else
+    {
+        freeze();
+    }
+}
+
+void xorif_recorder_finish(void)
+{
+    pthread_mutex_lock(&control.lock);
+    int running = control.running;
+    pthread_mutex_unlock(&control.lock);
+
+    if (running)
+    {
+        __atomic_store_n(&control.stop, 1, __ATOMIC_RELEASE);
+        wake_thread();
+        pthread_join(control.thread, NULL);
+    }
+
+    // Note, the records (and the frozen state) are kept
+    pthread_mutex_lock(&control.lock);
+    control.running = 0;
+    control.sample_ms = 0;
+    control.dump_file[0] = '\0';
+    __atomic_store_n(&ring.dump, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&ring.deadline, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&ring.triggers, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&ring.armed, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&ring.alarm_mask, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&ring.post_records, 0, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&control.lock);
+}
+
+// Local functions...
+
+/**
+ * @brief Read the monotonic clock.
+ * @returns
+ *      - Time in nanoseconds
+ */
+static uint64_t time_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * @brief Read the coarse monotonic clock (for the records of API calls, errors and register writes).
+ * @returns
+ *      - Time in nanoseconds
+ * @note
+ * This is much cheaper than #time_ns, but only has the resolution of the
+ * kernel tick. The records are ordered by their sequence numbers.
+ */
+static uint64_t stamp_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * @brief Claim the next record (unless the recorder is frozen).
+ * @param[in] type Record type (see enum #xorif_recorder_type)
+ * @param[in] timestamp Time of the record (ns, monotonic clock, 0 = now, see #stamp_ns)
+ * @param[out] seq Pointer to write-back the sequence number (for #commit)
+ * @returns
+ *      - Pointer to the record (the caller writes the data words used by the type)
+ *      - NULL if the recorder is frozen
+ */
+static struct record *claim(uint16_t type, uint64_t timestamp, uint32_t *seq)
+{
+    if (__atomic_load_n(&ring.frozen, __ATOMIC_ACQUIRE))
+    {
+        return NULL;
+    }
+
+    *seq = __atomic_add_fetch(&ring.head, 1, __ATOMIC_RELAXED);
+    struct record *rec = &ring.records[(*seq - 1) & (RECORDER_SIZE - 1)];
+
+    // Mark the record in-progress (before over-writing it)
+    __atomic_store_n(&rec->seq, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    rec->timestamp = timestamp ? timestamp : stamp_ns();
+    rec->type = type;
+    rec->arg = 0;
+    rec->name = NULL;
+    return rec;
+}
+
+/**
+ * @brief Complete a record (and freeze the recorder after the post-trigger records).
+ * @param[in] rec Pointer to the record
+ * @param[in] seq Sequence number (from #claim)
+ */
+static void commit(struct record *rec, uint32_t seq)
+{
+    __atomic_store_n(&rec->seq, seq, __ATOMIC_RELEASE);
+
+    if ((__atomic_load_n(&ring.remaining, __ATOMIC_ACQUIRE) > 0) &&
+        (__atomic_sub_fetch(&ring.remaining, 1, __ATOMIC_ACQ_REL) == 0))
+    {
+        freeze();
+    }
+}
+
+/**
+ * @brief Get the number of data words written by a record type.
+ * @param[in] type Record type (see enum #xorif_recorder_type)
+ * @returns
+ *      - Number of data words (the rest are stale, and dumped as 0)
+ */
+static int data_words(uint16_t type)
+{
+    switch (type)
+    {
+    case RECORD_REG_WRITE:
+    case RECORD_ALARM:
+    case RECORD_STALL:
+        return 4;
+    case RECORD_STATS:
+        return 8;
+    case RECORD_TRIGGER:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief Freeze the recorder, and wake the recorder thread to dump it (lock-free).
+ * @note
+ * The thread only dumps the records if a dump file is configured.
+ */
+static void freeze(void)
+{
+    __atomic_store_n(&ring.deadline, 0, __ATOMIC_RELAXED);
+    if (!__atomic_exchange_n(&ring.frozen, 1, __ATOMIC_ACQ_REL))
+    {
+        __atomic_store_n(&ring.dump, 1, __ATOMIC_RELEASE);
+        wake_thread();
+    }
+}
+
+/**
+ * @brief Wake the recorder thread (lock-free, for the interrupt handler).
+ * @note
+ * The event file descriptor is kept open once created, so the interrupt
+ * handler never writes to a closed descriptor.
+ */
+static void wake_thread(void)
+{
+    int efd = __atomic_load_n(&control.fd, __ATOMIC_ACQUIRE);
+    if (efd >= 0)
+    {
+        uint64_t one = 1;
+        ssize_t rc = write(efd, &one, sizeof(one));
+        (void)rc;
+    }
+}
+
+/**
+ * @brief Start the recorder thread if it's not running, otherwise wake it (called with the lock held).
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - XORIF_FAILURE on error
+ */
+static int start_thread(void)
+{
+    if (control.running)
+    {
+        wake_thread();
+        return XORIF_SUCCESS;
+    }
+
+    if (control.fd < 0)
+    {
+        int efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (efd < 0)
+        {
+            PERROR("Failed to create flight recorder thread file descriptor\n");
+            return XORIF_FAILURE;
+        }
+        __atomic_store_n(&control.fd, efd, __ATOMIC_RELEASE);
+    }
+
+    // Don't dump a freeze from before the thread started
+    __atomic_store_n(&ring.dump, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&control.stop, 0, __ATOMIC_RELAXED);
+    control.running = (pthread_create(&control.thread, NULL, recorder_thread, NULL) == 0);
+    if (!control.running)
+    {
+        PERROR("Failed to start flight recorder thread\n");
+        return XORIF_FAILURE;
+    }
+    return XORIF_SUCCESS;
+}
+
+/**
+ * @brief Dump the records to a file (oldest first).
+ * @param[in] file File name
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ */
+static int dump(const char *file)
+{
+    struct xorif_recorder_record *records = calloc(RECORDER_SIZE, sizeof(struct xorif_recorder_record));
+    if (!records)
+    {
+        PERROR("Failed to allocate flight recorder dump memory\n");
+        return XORIF_MEMORY_ALLOCATION_FAIL;
+    }
+
+    struct xorif_recorder_header header;
+    memset(&header, 0, sizeof(header));
+    header.magic = RECORDER_MAGIC;
+    header.version = RECORDER_VERSION;
+    header.record_size = sizeof(struct xorif_recorder_record);
+    header.sw_version = SW_MAJ_VER << 24 | SW_MIN_VER << 16 | SW_REVISION;
+    if (xorif_state)
+    {
+        header.hw_version = READ_REG(CFG_MAJOR_REVISION) << 24 | READ_REG(CFG_MINOR_REVISION) << 16 | READ_REG(CFG_VERSION_REVISION);
+        header.hw_internal_rev = READ_REG(CFG_INTERNAL_REVISION);
+    }
+
+    pthread_mutex_lock(&dump_lock);
+
+    // Copy the records held, skipping any in-progress (or over-written during the copy)
+    uint32_t head = __atomic_load_n(&ring.head, __ATOMIC_ACQUIRE);
+    uint32_t first = (head > RECORDER_SIZE) ? head - RECORDER_SIZE + 1 : 1;
+    uint32_t num = 0;
+    for (uint32_t seq = first; seq - first < head - first + 1; ++seq)
+    {
+        const struct record *rec = &ring.records[(seq - 1) & (RECORDER_SIZE - 1)];
+        if (__atomic_load_n(&rec->seq, __ATOMIC_ACQUIRE) == seq)
+        {
+            struct record copy;
+            memcpy(&copy, rec, sizeof(copy));
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(&rec->seq, __ATOMIC_RELAXED) == seq)
+            {
+                // Convert to the dump format (resolving the name)
+                struct xorif_recorder_record *out = &records[num++];
+                out->timestamp = copy.timestamp;
+                out->seq = seq;
+                out->type = copy.type;
+                out->arg = copy.arg;
+                memcpy(out->data, copy.data, data_words(copy.type) * sizeof(uint32_t));
+                if (copy.name)
+                {
+                    strncpy(out->name, copy.name, RECORDER_NAME_LEN - 1);
+                }
+            }
+        }
+    }
+    header.num_records = num;
+    header.lost = head - num;
+    header.trigger = __atomic_load_n(&ring.trigger, __ATOMIC_ACQUIRE);
+    header.trigger_seq = header.trigger ? ring.trigger_seq : 0;
+    header.mono_time = time_ns();
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    header.real_time = (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+
+    pthread_mutex_unlock(&dump_lock);
+
+    int result = XORIF_SUCCESS;
+    FILE *fp = fopen(file, "wb");
+    if (!fp)
+    {
+        PERROR("Can't open flight recorder dump file '%s'\n", file);
+        result = XORIF_INVALID_CONFIG;
+    }
+    else
+    {
+        size_t written = fwrite(&header, sizeof(header), 1, fp);
+        written += num ? fwrite(records, sizeof(struct xorif_recorder_record), num, fp) : 0;
+        if ((fclose(fp) != 0) || (written != num + 1))
+        {
+            PERROR("Failed to write flight recorder dump file '%s'\n", file);
+            result = XORIF_FAILURE;
+        }
+        else
+        {
+            INFO("Flight recorder dumped to '%s' (%u records)\n", file, num);
+        }
+    }
+
+    free(records);
+    return result;
+}
+
+/**
+ * @brief Flight recorder thread (dumps the records when frozen, freezes the
+ * recorder at the post-trigger deadline, and samples the counters).
+ * @param[in] arg Not used
+ * @returns
+ *      - NULL
+ */
+static void *recorder_thread(void *arg)
+{
+    struct pollfd pfd = {.fd = control.fd, .events = POLLIN};
+    uint64_t next = 0; // Next sample time (ns, 0 = not sampling)
+
+    while (!__atomic_load_n(&control.stop, __ATOMIC_ACQUIRE))
+    {
+        char file[sizeof(control.dump_file)];
+        pthread_mutex_lock(&control.lock);
+        uint64_t period = control.sample_ms * 1000000ULL;
+        strcpy(file, control.dump_file);
+        pthread_mutex_unlock(&control.lock);
+
+        uint64_t now = time_ns();
+        uint64_t deadline = __atomic_load_n(&ring.deadline, __ATOMIC_ACQUIRE);
+        next = period ? (next ? next : now) : 0;
+
+        if (__atomic_exchange_n(&ring.dump, 0, __ATOMIC_ACQ_REL))
+        {
+            // Dump the records (without blocking the producers)
+            if (file[0])
+            {
+                int result = dump(file);
+                pthread_mutex_lock(&control.lock);
+                ++control.dumps;
+                control.dump_result = result;
+                pthread_mutex_unlock(&control.lock);
+            }
+        }
+        else if (deadline && (now >= deadline))
+        {
+            // The post-trigger records weren't captured in time, so freeze now
+            __atomic_compare_exchange_n(&ring.deadline, &deadline, 0, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+            if (__atomic_exchange_n(&ring.remaining, 0, __ATOMIC_ACQ_REL) > 0)
+            {
+                freeze();
+            }
+        }
+        else if (next && (now >= next))
+        {
+            // Take a sample, and set the next sample time (re-aligned if late)
+            next = (now - next < period) ? next + period : now + period;
+            xorif_stats_record_sample();
+        }
+        else
+        {
+            // Wait for the next sample time or the deadline (or a dump, new period, or a request to stop)
+            uint64_t wake = (next && (!deadline || (next < deadline))) ? next : deadline;
+            int timeout_ms = wake ? (int)((wake - now + 999999) / 1000000) : -1;
+            if (poll(&pfd, 1, timeout_ms) > 0)
+            {
+                uint64_t temp;
+                ssize_t rc = read(pfd.fd, &temp, sizeof(temp));
+                (void)rc;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+#else
+
+// The flight recorder is compiled out (see HAS_RECORDER)
+
+int xorif_set_recorder_trigger(uint32_t triggers, uint32_t alarm_mask, uint16_t post_records, const char *dump_file)
+{
+    TRACE("xorif_set_recorder_trigger(0x%X, 0x%X, %d, %s)\n", triggers, alarm_mask, post_records, dump_file ? dump_file : "NULL");
+    PERROR("Flight recorder not supported\n");
+    return XORIF_NOT_SUPPORTED;
+}
+
+int xorif_set_recorder_sampling(uint32_t period_ms)
+{
+    TRACE("xorif_set_recorder_sampling(%d)\n", period_ms);
+    PERROR("Flight recorder not supported\n");
+    return XORIF_NOT_SUPPORTED;
+}
+
+int xorif_trigger_recorder(void)
+{
+    TRACE("xorif_trigger_recorder()\n");
+    PERROR("Flight recorder not supported\n");
+    return XORIF_NOT_SUPPORTED;
+}
+
+int xorif_rearm_recorder(void)
+{
+    TRACE("xorif_rearm_recorder()\n");
+    PERROR("Flight recorder not supported\n");
+    return XORIF_NOT_SUPPORTED;
+}
+
+int xorif_dump_recorder(const char *dump_file)
+{
+    TRACE("xorif_dump_recorder(%s)\n", dump_file ? dump_file : "NULL");
+    PERROR("Flight recorder not supported\n");
+    return XORIF_NOT_SUPPORTED;
+}
+
+int xorif_get_recorder_status(struct xorif_recorder_status *ptr)
+{
+    TRACE("xorif_get_recorder_status(...)\n");
+    PERROR("Flight recorder not supported\n");
+    return XORIF_NOT_SUPPORTED;
+}
+
+#endif // HAS_RECORDER
+
+/** @} */
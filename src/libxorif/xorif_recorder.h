@@ -0,0 +1,120 @@
+/*
+ * Copyright 2020 - 2023 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file xorif_recorder.h
+ * @author Steven Dickinson
+ * @brief Header file for libxorif flight recorder functions/definitions.
+ * @addtogroup libxorif
+ * @{
+ */
+
+#ifndef XORIF_RECORDER_H
+#define XORIF_RECORDER_H
+
+#include <inttypes.h>
+#include "xorif_api.h"
+
+/*******************************************/
+/*** Constants / macros / structs / etc. ***/
+/*******************************************/
+
+#define RECORDER_POST_TIMEOUT 1000 /**< Maximum time to capture the post-trigger records before freezing (ms) */
+
+/***************************/
+/*** Function prototypes ***/
+/***************************/
+
+#if HAS_RECORDER
+
+/**
+ * @brief Record an API call (see the TRACE macro).
+ * @param[in] name Function name (static string, it isn't copied)
+ */
+void xorif_record_api(const char *name);
+
+/**
+ * @brief Record an error, and fire the error trigger (see the PERROR macro).
+ * @param[in] name Function name (static string, it isn't copied)
+ */
+void xorif_record_error(const char *name);
+
+/**
+ * @brief Record a register write (only while the recorder is armed, see #xorif_set_recorder_trigger).
+ * @param[in] name Register name (static string, it isn't copied)
+ * @param[in] addr Register address offset
+ * @param[in] mask Register field mask
+ * @param[in] shift Register field shift
+ * @param[in] value Value written (to the field)
+ */
+void xorif_record_reg_write(const char *name, uint32_t addr, uint32_t mask, uint8_t shift, uint32_t value);
+
+/**
+ * @brief Record an alarm interrupt, and fire the alarm trigger (called from the interrupt handler).
+ * @param[in] status Alarm status bits (see enum #xorif_fhi_alarms)
+ * @param[in] handled Alarm status bits handled (i.e. not coalesced by storm detection)
+ * @param[in] action Action taken (see enum #xorif_alarm_action)
+ * @param[in] cc_mask Component carriers disabled
+ * @param[in] timestamp Time of the interrupt (ns, monotonic clock)
+ */
+void xorif_record_alarm(uint32_t status, uint32_t handled, uint16_t action, uint16_t cc_mask, uint64_t timestamp);
+
+/**
+ * @brief Record a counter sample for an Ethernet port.
+ * @param[in] port Ethernet port
+ * @param[in] ptr Pointer to statistics data structure
+ * @param[in] timestamp Time of the sample (ns, monotonic clock)
+ */
+void xorif_record_stats(int port, const struct xorif_fhi_eth_stats *ptr, uint64_t timestamp);
+
+/**
+ * @brief Record a change of the stall flags (called by the stall sampler).
+ * @param[in] flags Stall flags (see #xorif_stall_monitor_read)
+ * @param[in] onsets Stall flags that have gone high
+ * @param[in] timestamp Time of the sample (ns, monotonic clock)
+ */
+void xorif_record_stall(uint64_t flags, uint64_t onsets, uint64_t timestamp);
+
+/**
+ * @brief Fire a flight recorder trigger (if it's enabled, and no trigger has fired yet).
+ * @param[in] trigger Trigger (see enum #xorif_recorder_trigger)
+ * @param[in] detail Trigger detail (e.g. alarm status)
+ * @param[in] name Function name (static string, or NULL)
+ */
+void xorif_recorder_trigger(uint32_t trigger, uint32_t detail, const char *name);
+
+/**
+ * @brief Stop the flight recorder thread, and reset the configuration (called by #xorif_finish).
+ * @note
+ * The records are kept (and recording continues).
+ */
+void xorif_recorder_finish(void);
+
+#else
+// The flight recorder is compiled out, so recording costs nothing
+static inline void xorif_record_api(const char *name) {}
+static inline void xorif_record_error(const char *name) {}
+static inline void xorif_record_reg_write(const char *name, uint32_t addr, uint32_t mask, uint8_t shift, uint32_t value) {}
+static inline void xorif_record_alarm(uint32_t status, uint32_t handled, uint16_t action, uint16_t cc_mask, uint64_t timestamp) {}
+static inline void xorif_record_stats(int port, const struct xorif_fhi_eth_stats *ptr, uint64_t timestamp) {}
+static inline void xorif_record_stall(uint64_t flags, uint64_t onsets, uint64_t timestamp) {}
+static inline void xorif_recorder_trigger(uint32_t trigger, uint32_t detail, const char *name) {}
+static inline void xorif_recorder_finish(void) {}
+#endif
+
+#endif /* XORIF_RECORDER_H */
+
+/** @} */
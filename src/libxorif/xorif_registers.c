@@ -26,6 +26,7 @@
 #include "xorif_fh_func.h"
 #include "xorif_utils.h"
 #include "xorif_registers.h"
+#include "xorif_scrubber.h"
 
 // The following const structure defines the register map for the Front Haul Interface
 // Note, this array is sorted for more efficient access
@@ -342,6 +343,23 @@ static const reg_info_t reg_map[] = {
 // Fake base address for debug "devmem"
 #define FAKE_BASE_ADDR 0xA0000000
 
+#if defined(NO_HW) && defined(EXTRA_DEBUG)
+// Bit-map of register words written since the last xorif_test_reset_reg_writes() (for test)
+static uint32_t reg_write_map[0x10000 / 4 / 32];
+#endif
+
+// Set during the direct register access writes (xorif_write_fhi_reg...), which
+// aren't part of the configuration, so they're not expected by the register scrubber
+static __thread int direct_write;
+
+#ifdef NO_HW
+// Fake RU port mapping table (accessed via the DEFM_CID_MAP_WR / RD registers)
+static uint32_t fake_cid_map[2048];
+
+// Fake multi-O-DU tables (accessed via the per-port ETH_DU_TABLE_WR / RD registers)
+static uint32_t fake_du_table[MAX_NUM_ETH_PORTS][ETH_DU_TABLE_WR_TABLE_ADDR_MASK + 1][3];
+#endif
+
 /****************************/
 /*** Function definitions ***/
 /****************************/
@@ -365,7 +383,7 @@ uint32_t xorif_read_reg_internal(void *io,
 #endif
     x = (x & mask) >> shift;
 
-    TRACE("READ_REG: %s (0x%04X)[%d:%d] => 0x%X (%u)\n", name, addr, shift + width - 1, shift, x, x);
+    TRACE_REG("READ_REG: %s (0x%04X)[%d:%d] => 0x%X (%u)\n", name, addr, shift + width - 1, shift, x, x);
 
 #ifdef EXTRA_DEBUG
     if (xorif_trace == 3)
@@ -391,25 +409,80 @@ void xorif_write_reg_internal(void *io,
 {
     ASSERT_V(io);
 
-    uint32_t x;
+    xorif_scrub_write_begin();
+    uint32_t x = 0;
+    if (mask != 0xFFFFFFFF)
+    {
+        // Read-modify-write needed (not required for whole register writes)
 #ifdef NO_HW
-    // Read from fake register
-    x = ((uint32_t *)io)[addr / 4];
+        // Read from fake register
+        x = ((uint32_t *)io)[addr / 4];
 #else
-    // Read with libmetal
-    x = metal_io_read32((struct metal_io_region *)io, addr);
+        // Read with libmetal
+        x = metal_io_read32((struct metal_io_region *)io, addr);
 #endif
+    }
     // Modify register field
     x = (x & ~mask) | ((value << shift) & mask);
 #ifdef NO_HW
     // Write to fake register
     ((uint32_t *)io)[addr / 4] = x;
+
+    // Emulate the RU port mapping table write / read strobes
+    if ((addr == DEFM_CID_MAP_WR_STROBE_ADDR) && (x & DEFM_CID_MAP_WR_STROBE_MASK))
+    {
+        fake_cid_map[x & DEFM_CID_MAP_WR_TABLE_ADDR_MASK] = x & ~(DEFM_CID_MAP_WR_STROBE_MASK | DEFM_CID_MAP_WR_TABLE_ADDR_MASK);
+    }
+    else if ((addr == DEFM_CID_MAP_RD_STROBE_ADDR) && (x & DEFM_CID_MAP_RD_STROBE_MASK))
+    {
+        ((uint32_t *)io)[addr / 4] = fake_cid_map[x & DEFM_CID_MAP_RD_TABLE_ADDR_MASK] | (x & DEFM_CID_MAP_RD_TABLE_ADDR_MASK);
+    }
+
+    // Emulate the multi-O-DU table write / read strobes (which auto-clear)
+    uint32_t port = (addr - ETH_DU_TABLE_WR_STROBE_ADDR) / 0x100;
+    if ((addr >= ETH_DU_TABLE_WR_STROBE_ADDR) && ((addr & 0xFF) == (ETH_DU_TABLE_WR_STROBE_ADDR & 0xFF)) &&
+        (port < MAX_NUM_ETH_PORTS) && (x & ETH_DU_TABLE_WR_STROBE_MASK))
+    {
+        uint32_t *entry = fake_du_table[port][x & ETH_DU_TABLE_WR_TABLE_ADDR_MASK];
+        entry[0] = ((uint32_t *)io)[(ETH_DU_TABLE_WR_DEST_ADDR_31_0_ADDR + port * 0x100) / 4];
+        entry[1] = ((uint32_t *)io)[(ETH_DU_TABLE_WR_DEST_ADDR_47_32_ADDR + port * 0x100) / 4];
+        entry[2] = ((uint32_t *)io)[(ETH_DU_TABLE_WR_VLAN_ID_ADDR + port * 0x100) / 4];
+        ((uint32_t *)io)[addr / 4] = x & ~ETH_DU_TABLE_WR_STROBE_MASK;
+    }
+    port = (addr - ETH_DU_TABLE_RD_STROBE_ADDR) / 0x100;
+    if ((addr >= ETH_DU_TABLE_RD_STROBE_ADDR) && ((addr & 0xFF) == (ETH_DU_TABLE_RD_STROBE_ADDR & 0xFF)) &&
+        (port < MAX_NUM_ETH_PORTS) && (x & ETH_DU_TABLE_RD_STROBE_MASK))
+    {
+        uint32_t *entry = fake_du_table[port][x & ETH_DU_TABLE_RD_TABLE_ADDR_MASK];
+        ((uint32_t *)io)[(ETH_DU_TABLE_RD_DEST_ADDR_31_0_ADDR + port * 0x100) / 4] = entry[0];
+        ((uint32_t *)io)[(ETH_DU_TABLE_RD_DEST_ADDR_47_32_ADDR + port * 0x100) / 4] = entry[1];
+        ((uint32_t *)io)[(ETH_DU_TABLE_RD_VLAN_ID_ADDR + port * 0x100) / 4] = entry[2];
+        ((uint32_t *)io)[addr / 4] = x & ~ETH_DU_TABLE_RD_STROBE_MASK;
+    }
+
+    // Emulate the data-pipe restart, which restarts the statistics counters
+    if ((addr == DEFM_RESTART_ADDR) && (x & DEFM_RESTART_MASK))
+    {
+        for (port = 0; port < MAX_NUM_ETH_PORTS; ++port)
+        {
+            for (uint32_t a = STATS_ETH_STATS_TOTAL_RX_GOOD_PKT_CNT_L_ADDR; a <= STATS_ORAN_TX_TOTAL_C_H_ADDR; a += 4)
+            {
+                ((uint32_t *)io)[(a + port * 0x100) / 4] = 0;
+            }
+        }
+    }
+#ifdef EXTRA_DEBUG
+    reg_write_map[addr / 128] |= 1U << ((addr / 4) % 32);
+#endif
 #else
     // Write with libmetal
     metal_io_write32((struct metal_io_region *)io, addr, x);
 #endif
 
-    TRACE("WRITE_REG: %s (0x%04X)[%d:%d] <= 0x%X (%u)\n", name, addr, shift + width - 1, shift, value, value);
+    xorif_scrub_write_end(addr, direct_write ? 0 : mask, x);
+    xorif_record_reg_write(name, addr, mask, shift, value);
+    xorif_span_reg_write();
+    TRACE_REG("WRITE_REG: %s (0x%04X)[%d:%d] <= 0x%X (%u)\n", name, addr, shift + width - 1, shift, value, value);
 
 #ifdef EXTRA_DEBUG
     if (xorif_trace == 3)
@@ -465,6 +538,11 @@ const reg_info_t *xorif_find_register(const char *name)
     }
 }
 
+const reg_info_t *xorif_get_register_map(void)
+{
+    return reg_map;
+}
+
 int xorif_read_fhi_reg(const char *name, uint32_t *value)
 {
     TRACE("xorif_read_reg(%s, ...)\n", name);
@@ -528,13 +606,15 @@ int xorif_write_fhi_reg(const char *name, uint32_t value)
     }
     else
     {
+        direct_write = 1;
         xorif_write_reg_internal(DEV,
-                                 name,
+                                 reg->name,
                                  reg->addr,
                                  reg->mask,
                                  reg->shift,
                                  reg->width,
                                  value);
+        direct_write = 0;
         return XORIF_SUCCESS;
     }
 }
@@ -554,15 +634,34 @@ int xorif_write_fhi_reg_offset(const char *name,
     }
     else
     {
+        direct_write = 1;
         xorif_write_reg_internal(DEV,
-                                 name,
+                                 reg->name,
                                  (reg->addr + offset),
                                  reg->mask,
                                  reg->shift,
                                  reg->width,
                                  value);
+        direct_write = 0;
         return XORIF_SUCCESS;
     }
 }
 
+#if defined(NO_HW) && defined(EXTRA_DEBUG)
+void xorif_test_reset_reg_writes(void)
+{
+    memset(reg_write_map, 0, sizeof(reg_write_map));
+}
+
+int xorif_test_reg_written(uint32_t addr)
+{
+    return (reg_write_map[(addr & 0xFFFF) / 128] >> (((addr & 0xFFFF) / 4) % 32)) & 1;
+}
+
+void xorif_test_set_fake_ru_port(uint16_t address, uint32_t value)
+{
+    fake_cid_map[address & DEFM_CID_MAP_WR_TABLE_ADDR_MASK] = value;
+}
+#endif
+
 /** @} */
@@ -134,6 +134,43 @@ void xorif_write_reg_internal(void *io,
  */
 const reg_info_t *xorif_find_register(const char *name);
 
+/**
+ * @brief Get the register-map (e.g. to find the fields of a register by address).
+ * @returns
+ *      - Pointer to the first register field info (the last entry has a NULL name)
+ */
+const reg_info_t *xorif_get_register_map(void);
+
+#if defined(NO_HW) && defined(EXTRA_DEBUG)
+/**
+ * @brief Reset the record of written registers.
+ * @note
+ * For test only. Every register write to the fake register bank is recorded,
+ * so that tests can check which registers an operation touched.
+ */
+void xorif_test_reset_reg_writes(void);
+
+/**
+ * @brief Check if a register has been written (since the last reset).
+ * @param[in] addr Register address offset
+ * @returns
+ *      - 0 = not written
+ *      - 1 = written
+ * @note
+ * For test only.
+ */
+int xorif_test_reg_written(uint32_t addr);
+
+/**
+ * @brief Overwrite an entry in the fake RU port mapping table.
+ * @param[in] address Table address
+ * @param[in] value Entry value (<ccid> | <port> | <type> fields)
+ * @note
+ * For test only. Used to emulate a corrupted table entry.
+ */
+void xorif_test_set_fake_ru_port(uint16_t address, uint32_t value);
+#endif
+
 #endif /* XORIF_REGISTERS_H */
 
 /** @} */
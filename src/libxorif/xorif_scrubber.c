@@ -0,0 +1,610 @@
+/*
+ * Copyright 2020 - 2023 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file xorif_scrubber.c
+ * @author Steven Dickinson
+ * @brief Source file for libxorif register scrubber functions.
+ * @addtogroup libxorif
+ * @{
+ */
+
+#define _GNU_SOURCE // For SCHED_IDLE
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include "xorif_common.h"
+#include "xorif_registers.h"
+#include "xorif_scrubber.h"
+
+// Size of the register address space covered by the expected values
+#define SCRUB_ADDR_SPACE 0x10000
+
+// Register ranges checked by the scrubber (configuration registers only)
+// Note, strobes (e.g. DEFM_RESTART, DEFM_SNAP_SHOT, ORAN_CC_RELOAD), the RU port
+// mapping and multi-O-DU table access registers, and the status / statistics
+// registers are excluded, since they don't hold the value written
+static const struct
+{
+    uint32_t addr;   // Start address (first instance)
+    uint32_t size;   // Size of each instance (bytes)
+    uint32_t stride; // Address step between instances (bytes)
+    uint16_t count;  // Number of instances (1 = not repeated)
+} scrub_ranges[] = {
+    {CFG_MASTER_INT_ENABLE_ADDR, 0x8, 0, 1},
+    {FRAM_DISABLE_ADDR, FRAM_CID_SEQTABLE_MODE_ADDR + 4 - FRAM_DISABLE_ADDR, 0, 1},
+    {FRAM_PROTOCOL_DEFINITION_ADDR, 0x4, 0, 1},
+    {DEFM_ERR_PACKET_FILTER_ADDR, DEFM_USE_ONE_SYMBOL_STROBE_ADDR + 8 - DEFM_ERR_PACKET_FILTER_ADDR, 0, 1},
+    {DEFM_CTRL_ENA_CRUPT_EAXE_CNT_ADDR, DEFM_CID_LTE_VALUE_ADDR + 4 - DEFM_CTRL_ENA_CRUPT_EAXE_CNT_ADDR, 0, 1},
+    {DEFM_USER_DATA_FILTER_ADDR, 0x80, 0x100, MAX_NUM_ETH_PORTS},
+    {DEFM_CID_MAP_MODE_ADDR, 0x4, 0, 1},
+    {ORAN_SETUP_SF_ADDR, ORAN_SETUP_SY_ADDR + 4 - ORAN_SETUP_SF_ADDR, 0, 1},
+    {ORAN_CC_SSB_NUMRBS_ADDR, 0x70, 0x70, MAX_NUM_CC},
+    {ORAN_CC_SSB_DATA_UNROLL_OFFSET_ADDR, 0x4, 0x4, 512},
+    {ETH_DEST_ADDR_31_0_ADDR, ETH_DU_TABLE_WR_DEST_ADDR_31_0_ADDR - ETH_DEST_ADDR_31_0_ADDR, 0x100, MAX_NUM_ETH_PORTS},
+    {ORAN_CC_ENABLE_ADDR, 0x4, 0, 1},
+    {ORAN_CC_NUMRBS_ADDR, 0x70, 0x70, MAX_NUM_CC},
+    {ORAN_CC_DL_DATA_UNROLL_OFFSET_ADDR, 0x4, 0x4, 512},
+};
+
+#define NUM_SCRUB_RANGES (sizeof(scrub_ranges) / sizeof(scrub_ranges[0]))
+
+// Expected register values, i.e. the bits last written by the library
+// Updated by every register write, from any thread (see xorif_scrub_write_end)
+static struct
+{
+    uint32_t value[SCRUB_ADDR_SPACE / 4]; // Expected value of each register word
+    uint32_t mask[SCRUB_ADDR_SPACE / 4];  // Bits of each register word written by the library
+    uint32_t generation;                  // Incremented after each write
+    uint32_t busy;                        // Number of writes in progress
+} shadow;
+
+// Register scrubber
+static struct
+{
+    pthread_mutex_t lock;                            // Protects everything below
+    pthread_cond_t wake;                             // Used to stop the scrubber thread promptly
+    pthread_t thread;                                // Scrubber thread
+    int running;                                     // Scrubber is running
+    int stop;                                        // Request to stop the scrubber thread
+    uint32_t budget;                                 // Bandwidth budget (register reads per second)
+    uint16_t mode;                                   // Scrubber mode (see enum xorif_scrub_mode)
+    uint64_t passes;                                 // Number of complete passes
+    uint64_t reads;                                  // Number of register reads
+    uint32_t mismatches;                             // Number of register field mismatches
+    uint32_t restored;                               // Number of register field mismatches restored
+    uint32_t retries;                                // Number of range checks repeated
+    uint32_t log_next;                               // Total mismatches logged (next log index, modulo the size)
+    struct xorif_scrub_mismatch log[SCRUB_LOG_SIZE]; // Latest mismatches
+} scrubber = {.lock = PTHREAD_MUTEX_INITIALIZER};
+
+// Serializes the register checks (scrubber thread and xorif_scrub_registers)
+// The thread's position in the register ranges is protected by this lock
+static pthread_mutex_t scan_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint16_t scan_range; // Current range
+static uint16_t scan_index; // Current instance of the range
+
+// Local function prototypes...
+
+static void *scrubber_thread(void *arg);
+static uint32_t scrub_block(uint32_t max_reads, uint16_t mode, uint32_t *mismatches, int *end_of_pass);
+static uint32_t scrub_instance(uint16_t range, uint16_t index, uint16_t mode, uint32_t *mismatches);
+static uint32_t report_mismatch(uint16_t range, uint16_t index, uint32_t addr, uint32_t expected,
+                                uint32_t actual, uint32_t mask, uint16_t mode);
+static uint32_t read_word(uint32_t addr);
+static uint64_t time_ns(void);
+
+// API functions...
+
+int xorif_start_scrubber(uint32_t budget, uint16_t mode)
+{
+    TRACE("xorif_start_scrubber(%u, %d)\n", budget, mode);
+
+    if (!xorif_state)
+    {
+        PERROR("Library not initialized\n");
+        return XORIF_FAILURE;
+    }
+    else if (budget > SCRUB_MAX_BUDGET)
+    {
+        PERROR("Scrubber budget exceeds maximum (%u)\n", SCRUB_MAX_BUDGET);
+        return XORIF_INVALID_CONFIG;
+    }
+    else if (mode > SCRUB_RESTORE)
+    {
+        PERROR("Invalid scrubber mode\n");
+        return XORIF_INVALID_CONFIG;
+    }
+
+    // Re-start with the new settings
+    xorif_stop_scrubber();
+
+    pthread_mutex_lock(&scrubber.lock);
+    scrubber.budget = budget ? budget : SCRUB_DEFAULT_BUDGET;
+    scrubber.mode = mode;
+    scrubber.stop = 0;
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&scrubber.wake, &attr);
+    pthread_condattr_destroy(&attr);
+
+    int result = pthread_create(&scrubber.thread, NULL, scrubber_thread, NULL);
+    scrubber.running = (result == 0);
+    pthread_mutex_unlock(&scrubber.lock);
+
+    if (result != 0)
+    {
+        PERROR("Failed to start scrubber thread\n");
+        xorif_stop_scrubber();
+        return XORIF_FAILURE;
+    }
+
+    INFO("Register scrubber started (%u reads/s, mode %d)\n", scrubber.budget, mode);
+    return XORIF_SUCCESS;
+}
+
+int xorif_stop_scrubber(void)
+{
+    TRACE("xorif_stop_scrubber()\n");
+
+    pthread_mutex_lock(&scrubber.lock);
+    int running = scrubber.running;
+    scrubber.stop = 1;
+    if (running)
+    {
+        pthread_cond_signal(&scrubber.wake);
+    }
+    pthread_mutex_unlock(&scrubber.lock);
+
+    if (running)
+    {
+        pthread_join(scrubber.thread, NULL);
+        pthread_cond_destroy(&scrubber.wake);
+    }
+
+    // Note, the results are kept
+    pthread_mutex_lock(&scrubber.lock);
+    scrubber.running = 0;
+    pthread_mutex_unlock(&scrubber.lock);
+
+    return XORIF_SUCCESS;
+}
+
+int xorif_scrub_registers(uint16_t mode, uint32_t *mismatches)
+{
+    TRACE("xorif_scrub_registers(%d, ...)\n", mode);
+
+    if (!xorif_state)
+    {
+        PERROR("Library not initialized\n");
+        return XORIF_FAILURE;
+    }
+    else if (mode > SCRUB_RESTORE)
+    {
+        PERROR("Invalid scrubber mode\n");
+        return XORIF_INVALID_CONFIG;
+    }
+
+    uint32_t found = 0;
+    uint32_t reads = 0;
+    pthread_mutex_lock(&scan_lock);
+    for (uint16_t range = 0; range < NUM_SCRUB_RANGES; ++range)
+    {
+        for (uint16_t index = 0; index < scrub_ranges[range].count; ++index)
+        {
+            reads += scrub_instance(range, index, mode, &found);
+        }
+    }
+    pthread_mutex_unlock(&scan_lock);
+
+    pthread_mutex_lock(&scrubber.lock);
+    scrubber.passes += 1;
+    scrubber.reads += reads;
+    pthread_mutex_unlock(&scrubber.lock);
+
+    if (mismatches)
+    {
+        *mismatches = found;
+    }
+
+    INFO("Register scrub: %u reads, %u mismatches\n", reads, found);
+    return XORIF_SUCCESS;
+}
+
+int xorif_get_scrubber_status(struct xorif_scrubber_status *ptr)
+{
+    TRACE("xorif_get_scrubber_status(...)\n");
+
+    if (!ptr)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+
+    // Count the register words that are currently checked
+    uint32_t registers = 0;
+    for (uint16_t range = 0; range < NUM_SCRUB_RANGES; ++range)
+    {
+        for (uint16_t index = 0; index < scrub_ranges[range].count; ++index)
+        {
+            uint32_t base = scrub_ranges[range].addr + index * scrub_ranges[range].stride;
+            for (uint32_t addr = base; addr < base + scrub_ranges[range].size; addr += 4)
+            {
+                registers += (__atomic_load_n(&shadow.mask[addr / 4], __ATOMIC_RELAXED) != 0);
+            }
+        }
+    }
+
+    pthread_mutex_lock(&scrubber.lock);
+    ptr->running = scrubber.running;
+    ptr->budget = scrubber.budget;
+    ptr->mode = scrubber.mode;
+    ptr->registers = registers;
+    ptr->passes = scrubber.passes;
+    ptr->reads = scrubber.reads;
+    ptr->mismatches = scrubber.mismatches;
+    ptr->restored = scrubber.restored;
+    ptr->retries = scrubber.retries;
+    pthread_mutex_unlock(&scrubber.lock);
+
+    return XORIF_SUCCESS;
+}
+
+int xorif_get_scrubber_log(uint16_t max, struct xorif_scrub_mismatch *list, uint16_t *num)
+{
+    TRACE("xorif_get_scrubber_log(%d, ...)\n", max);
+
+    if (!list || !num)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+
+    pthread_mutex_lock(&scrubber.lock);
+    uint32_t held = (scrubber.log_next < SCRUB_LOG_SIZE) ? scrubber.log_next : SCRUB_LOG_SIZE;
+    uint32_t count = (held < max) ? held : max;
+    uint32_t first = scrubber.log_next - count;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        list[i] = scrubber.log[(first + i) % SCRUB_LOG_SIZE];
+    }
+    pthread_mutex_unlock(&scrubber.lock);
+
+    *num = count;
+    return XORIF_SUCCESS;
+}
+
+int xorif_clear_scrubber_stats(void)
+{
+    TRACE("xorif_clear_scrubber_stats()\n");
+
+    pthread_mutex_lock(&scrubber.lock);
+    scrubber.passes = 0;
+    scrubber.reads = 0;
+    scrubber.mismatches = 0;
+    scrubber.restored = 0;
+    scrubber.retries = 0;
+    scrubber.log_next = 0;
+    memset(scrubber.log, 0, sizeof(scrubber.log));
+    pthread_mutex_unlock(&scrubber.lock);
+
+    return XORIF_SUCCESS;
+}
+
+// Internal functions...
+
+void xorif_scrub_reset(void)
+{
+    pthread_mutex_lock(&scan_lock);
+    memset(shadow.value, 0, sizeof(shadow.value));
+    memset(shadow.mask, 0, sizeof(shadow.mask));
+    __atomic_add_fetch(&shadow.generation, 1, __ATOMIC_SEQ_CST);
+    scan_range = 0;
+    scan_index = 0;
+    pthread_mutex_unlock(&scan_lock);
+}
+
+void xorif_scrub_write_begin(void)
+{
+    __atomic_add_fetch(&shadow.busy, 1, __ATOMIC_SEQ_CST);
+}
+
+void xorif_scrub_write_end(uint32_t addr, uint32_t mask, uint32_t value)
+{
+    if (addr < SCRUB_ADDR_SPACE)
+    {
+        uint32_t word = addr / 4;
+
+        // Merge the field (other threads may be writing other fields of the same word)
+        uint32_t expected = __atomic_load_n(&shadow.value[word], __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&shadow.value[word], &expected, (expected & ~mask) | (value & mask),
+                                            1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        {
+            // Re-try with the updated value
+        }
+        __atomic_or_fetch(&shadow.mask[word], mask, __ATOMIC_RELAXED);
+    }
+    __atomic_add_fetch(&shadow.generation, 1, __ATOMIC_SEQ_CST);
+    __atomic_sub_fetch(&shadow.busy, 1, __ATOMIC_SEQ_CST);
+}
+
+// Local functions...
+
+/**
+ * @brief Scrubber thread (checks the register ranges continuously, within the budget).
+ * @param[in] arg Not used
+ * @returns
+ *      - NULL
+ */
+static void *scrubber_thread(void *arg)
+{
+    // Run at the lowest priority (not fatal if it can't be set)
+    struct sched_param param = {.sched_priority = 0};
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+
+    pthread_mutex_lock(&scrubber.lock);
+    while (!scrubber.stop)
+    {
+        uint16_t mode = scrubber.mode;
+        uint32_t budget = scrubber.budget;
+        pthread_mutex_unlock(&scrubber.lock);
+
+        // Check the next block of registers
+        uint32_t mismatches = 0;
+        int end_of_pass = 0;
+        pthread_mutex_lock(&scan_lock);
+        uint32_t reads = scrub_block(SCRUB_BLOCK_READS, mode, &mismatches, &end_of_pass);
+        pthread_mutex_unlock(&scan_lock);
+
+        pthread_mutex_lock(&scrubber.lock);
+        scrubber.reads += reads;
+        scrubber.passes += end_of_pass;
+
+        // Pace the reads to the budget (without catching up after a delay)
+        uint64_t pause_ns = reads ? (uint64_t)reads * 1000000000ULL / budget : SCRUB_IDLE_MS * 1000000ULL;
+        uint64_t now = time_ns();
+        uint64_t deadline = (uint64_t)next.tv_sec * 1000000000ULL + next.tv_nsec + pause_ns;
+        deadline = (deadline < now) ? now : deadline;
+        next.tv_sec = deadline / 1000000000ULL;
+        next.tv_nsec = deadline % 1000000000ULL;
+
+        int rc = 0;
+        while (!scrubber.stop && (rc != ETIMEDOUT))
+        {
+            rc = pthread_cond_timedwait(&scrubber.wake, &scrubber.lock, &next);
+        }
+    }
+    pthread_mutex_unlock(&scrubber.lock);
+
+    return NULL;
+}
+
+/**
+ * @brief Check the next block of register range instances (for the scrubber thread).
+ * @param[in] max_reads Register reads before stopping (the current instance is completed)
+ * @param[in] mode Scrubber mode
+ * @param[out] mismatches Pointer to mismatch count (incremented)
+ * @param[out] end_of_pass Pointer to write-back whether a pass completed
+ * @returns
+ *      - Number of register reads made
+ * @note
+ * The caller must hold the scan lock.
+ */
+static uint32_t scrub_block(uint32_t max_reads, uint16_t mode, uint32_t *mismatches, int *end_of_pass)
+{
+    uint32_t reads = 0;
+    *end_of_pass = 0;
+    while (reads < max_reads)
+    {
+        reads += scrub_instance(scan_range, scan_index, mode, mismatches);
+
+        if (++scan_index >= scrub_ranges[scan_range].count)
+        {
+            scan_index = 0;
+            if (++scan_range >= NUM_SCRUB_RANGES)
+            {
+                scan_range = 0;
+                *end_of_pass = 1;
+                break;
+            }
+        }
+    }
+    return reads;
+}
+
+/**
+ * @brief Check an instance of a register range.
+ * @param[in] range Register range
+ * @param[in] index Instance of the range
+ * @param[in] mode Scrubber mode
+ * @param[out] mismatches Pointer to mismatch count (incremented)
+ * @returns
+ *      - Number of register reads made
+ * @note
+ * The checksum of the bits written by the library is compared with the
+ * checksum of the expected values, and only a mismatch is compared word by
+ * word. The check is repeated if the library writes a register meanwhile.
+ */
+static uint32_t scrub_instance(uint16_t range, uint16_t index, uint16_t mode, uint32_t *mismatches)
+{
+    uint32_t base = scrub_ranges[range].addr + index * scrub_ranges[range].stride;
+    uint32_t words = scrub_ranges[range].size / 4;
+    uint32_t actual[words];
+    uint32_t expected[words];
+    uint32_t mask[words];
+    uint32_t reads = 0;
+
+    for (int attempt = 0; attempt < SCRUB_ATTEMPTS; ++attempt)
+    {
+        uint32_t generation = __atomic_load_n(&shadow.generation, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&shadow.busy, __ATOMIC_SEQ_CST))
+        {
+            continue;
+        }
+
+        // Checksums (FNV-1a) of the bits written by the library
+        uint32_t sum_actual = 2166136261U;
+        uint32_t sum_expected = 2166136261U;
+        for (uint32_t i = 0; i < words; ++i)
+        {
+            mask[i] = __atomic_load_n(&shadow.mask[base / 4 + i], __ATOMIC_RELAXED);
+            if (mask[i] == 0)
+            {
+                continue;
+            }
+            expected[i] = __atomic_load_n(&shadow.value[base / 4 + i], __ATOMIC_RELAXED) & mask[i];
+            actual[i] = read_word(base + i * 4) & mask[i];
+            ++reads;
+            sum_actual = (sum_actual ^ actual[i]) * 16777619U;
+            sum_expected = (sum_expected ^ expected[i]) * 16777619U;
+        }
+
+        if ((__atomic_load_n(&shadow.busy, __ATOMIC_SEQ_CST) != 0) ||
+            (__atomic_load_n(&shadow.generation, __ATOMIC_SEQ_CST) != generation))
+        {
+            // The library wrote a register during the check
+            pthread_mutex_lock(&scrubber.lock);
+            scrubber.retries += 1;
+            pthread_mutex_unlock(&scrubber.lock);
+            continue;
+        }
+
+        if (sum_actual != sum_expected)
+        {
+            for (uint32_t i = 0; i < words; ++i)
+            {
+                if (mask[i] && (actual[i] != expected[i]))
+                {
+                    *mismatches += report_mismatch(range, index, base + i * 4, expected[i], actual[i], mask[i], mode);
+                }
+            }
+        }
+        break;
+    }
+
+    return reads;
+}
+
+/**
+ * @brief Report (and optionally restore) a corrupted register word.
+ * @param[in] range Register range
+ * @param[in] index Instance of the range
+ * @param[in] addr Register address offset
+ * @param[in] expected Expected value (bits written by the library)
+ * @param[in] actual Actual value (bits written by the library)
+ * @param[in] mask Bits written by the library
+ * @param[in] mode Scrubber mode
+ * @returns
+ *      - Number of register field mismatches
+ * @note
+ * Each corrupted field is reported with its name from the register map. The
+ * fields of repeated ranges are named for the first instance in the register
+ * map, so the instance is added to the name.
+ */
+static uint32_t report_mismatch(uint16_t range, uint16_t index, uint32_t addr, uint32_t expected,
+                                uint32_t actual, uint32_t mask, uint16_t mode)
+{
+    uint32_t canonical = addr - index * scrub_ranges[range].stride;
+    uint32_t remaining = (expected ^ actual) & mask;
+    int restored = 0;
+
+    if (mode == SCRUB_RESTORE)
+    {
+        // Restore the bits written by the library (read-modify-write)
+        xorif_write_reg_internal(DEV, "SCRUB_RESTORE", addr, mask, 0, 32, expected);
+        restored = 1;
+    }
+
+    struct xorif_scrub_mismatch entry;
+    entry.timestamp = time_ns();
+    entry.addr = addr;
+    entry.restored = restored;
+
+    uint32_t count = 0;
+    const reg_info_t *reg = xorif_get_register_map();
+    while (remaining)
+    {
+        // Find the next corrupted field (or report the remaining bits, if they're not in the register map)
+        while (reg->name && ((reg->addr != canonical) || !(reg->mask & remaining)))
+        {
+            ++reg;
+        }
+        entry.mask = reg->name ? (reg->mask & mask) : remaining;
+        entry.expected = expected & entry.mask;
+        entry.actual = actual & entry.mask;
+        if (!reg->name)
+        {
+            snprintf(entry.name, SCRUB_NAME_LEN, "0x%04X", canonical);
+        }
+        else if (scrub_ranges[range].count > 1)
+        {
+            snprintf(entry.name, SCRUB_NAME_LEN, "%s[%u]", reg->name, index);
+        }
+        else
+        {
+            snprintf(entry.name, SCRUB_NAME_LEN, "%s", reg->name);
+        }
+        remaining &= ~entry.mask;
+        ++count;
+
+        PERROR("Register corrupted: %s (0x%04X) expected 0x%X, actual 0x%X%s\n", entry.name, addr,
+               entry.expected, entry.actual, restored ? " (restored)" : "");
+
+        pthread_mutex_lock(&scrubber.lock);
+        scrubber.log[scrubber.log_next % SCRUB_LOG_SIZE] = entry;
+        scrubber.log_next += 1;
+        scrubber.mismatches += 1;
+        scrubber.restored += restored;
+        pthread_mutex_unlock(&scrubber.lock);
+    }
+
+    return count;
+}
+
+/**
+ * @brief Read a register word (without tracing, unlike READ_REG).
+ * @param[in] addr Register address offset
+ * @returns
+ *      - Value read
+ */
+static uint32_t read_word(uint32_t addr)
+{
+#ifdef NO_HW
+    return fake_reg_bank[addr / 4];
+#else
+    return metal_io_read32(fh_device.io, addr);
+#endif
+}
+
+/**
+ * @brief Read the monotonic clock.
+ * @returns
+ *      - Time in nanoseconds
+ */
+static uint64_t time_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/** @} */
@@ -0,0 +1,64 @@
+/*
+ * Copyright 2020 - 2023 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file xorif_scrubber.h
+ * @author Steven Dickinson
+ * @brief Header file for libxorif register scrubber functions/definitions.
+ * @addtogroup libxorif
+ * @{
+ */
+
+#ifndef XORIF_SCRUBBER_H
+#define XORIF_SCRUBBER_H
+
+#include <inttypes.h>
+
+/*******************************************/
+/*** Constants / macros / structs / etc. ***/
+/*******************************************/
+
+#define SCRUB_BLOCK_READS 16 /**< Register reads made by the scrubber thread between pauses */
+#define SCRUB_IDLE_MS 100    /**< Scrubber thread pause when there are no registers to check (ms) */
+#define SCRUB_ATTEMPTS 3     /**< Attempts to check a register range that's being written */
+
+/***************************/
+/*** Function prototypes ***/
+/***************************/
+
+/**
+ * @brief Clear the expected register values (called when the device is initialized).
+ */
+void xorif_scrub_reset(void);
+
+/**
+ * @brief Note the start of a register write (called before the write).
+ * @note
+ * A check of a register range that overlaps a write is repeated.
+ */
+void xorif_scrub_write_begin(void);
+
+/**
+ * @brief Update the expected register value (called after the write).
+ * @param[in] addr Register address offset
+ * @param[in] mask Register field mask (bits written, 0 = not an expected value)
+ * @param[in] value Register value written (whole register)
+ */
+void xorif_scrub_write_end(uint32_t addr, uint32_t mask, uint32_t value);
+
+#endif /* XORIF_SCRUBBER_H */
+
+/** @} */
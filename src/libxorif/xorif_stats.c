@@ -0,0 +1,1896 @@
+/*
+ * Copyright 2020 - 2023 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file xorif_stats.c
+ * @author Steven Dickinson
+ * @brief Source file for libxorif statistics functions (accumulation, collector, consumers, monitor stream, stall sampler and arrival-time histograms).
+ * @addtogroup libxorif
+ * @{
+ */
+
+#include <stddef.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include "xorif_common.h"
+#include "xorif_fh_func.h"
+#include "xorif_registers.h"
+#include "xorif_stats.h"
+#include "xorif_recorder.h"
+
+// Dynamic clock ID for a PTP hardware clock device (c.f. linux/posix-timers.h)
+#define FD_TO_CLOCKID(fd) ((~(clockid_t)(fd) << 3) | 3)
+
+// Statistics fields: 64-bit counters (<L, H> register pairs, accumulated in
+// software) and instantaneous values (rates / offsets)
+struct stats_field
+{
+    uint16_t addr;    // Register address (port 0)
+    uint16_t offset;  // Offset in the statistics structure
+    uint8_t counter;  // 1 = counter, 0 = instantaneous value
+    uint8_t size;     // Field size in bytes
+    uint8_t scale;    // Register scaling (instantaneous values)
+};
+
+#define COUNTER(a, f) {a, offsetof(struct xorif_fhi_eth_stats, f), 1, 8, 1}
+#define VALUE(a, f, s) {a, offsetof(struct xorif_fhi_eth_stats, f), 0, sizeof(((struct xorif_fhi_eth_stats *)0)->f), s}
+
+static const struct stats_field stats_fields[] = {
+    COUNTER(STATS_ETH_STATS_TOTAL_RX_GOOD_PKT_CNT_L_ADDR, total_rx_good_pkt_cnt),
+    COUNTER(STATS_ETH_STATS_TOTAL_RX_BAD_PKT_CNT_L_ADDR, total_rx_bad_pkt_cnt),
+    COUNTER(STATS_ETH_STATS_TOTAL_RX_BAD_FCS_CNT_L_ADDR, total_rx_bad_fcs_cnt),
+    VALUE(STATS_ETH_STATS_TOTAL_RX_BIT_RATE_ADDR, total_rx_bit_rate, 64),
+    VALUE(STATS_ETH_STATS_ORAN_RX_BIT_RATE_ADDR, oran_rx_bit_rate, 64),
+    COUNTER(STATS_ORAN_RX_TOTAL_L_ADDR, oran_rx_total),
+    COUNTER(STATS_ORAN_RX_ON_TIME_L_ADDR, oran_rx_on_time),
+    COUNTER(STATS_ORAN_RX_EARLY_L_ADDR, oran_rx_early),
+    COUNTER(STATS_ORAN_RX_LATE_L_ADDR, oran_rx_late),
+    COUNTER(STATS_ORAN_RX_TOTAL_C_L_ADDR, oran_rx_total_c),
+    COUNTER(STATS_ORAN_RX_ON_TIME_C_L_ADDR, oran_rx_on_time_c),
+    COUNTER(STATS_ORAN_RX_EARLY_C_L_ADDR, oran_rx_early_c),
+    COUNTER(STATS_ORAN_RX_LATE_C_L_ADDR, oran_rx_late_c),
+    COUNTER(STATS_ORAN_RX_CORRUPT_L_ADDR, oran_rx_corrupt),
+    COUNTER(STATS_ORAN_RX_ERROR_DROP_L_ADDR, oran_rx_error_drop),
+    COUNTER(STATS_ORAN_TX_TOTAL_L_ADDR, oran_tx_total),
+    COUNTER(STATS_ORAN_TX_TOTAL_C_L_ADDR, oran_tx_total_c),
+    VALUE(STATS_OFFSET_EARLIEST_U_PKT_ADDR, offset_earliest_u_pkt, 1),
+    VALUE(STATS_OFFSET_EARLIEST_C_PKT_ADDR, offset_earliest_c_pkt, 1),
+};
+#define NUM_STATS_FIELDS (sizeof(stats_fields) / sizeof(stats_fields[0]))
+
+// Software accumulators (and last hardware counter values)
+static struct xorif_fhi_eth_stats stats_acc[MAX_NUM_ETH_PORTS];
+static uint64_t stats_last[MAX_NUM_ETH_PORTS][NUM_STATS_FIELDS];
+
+// Statistics collector state
+static struct
+{
+    pthread_mutex_t lock;              // Protects everything below (and the accumulators)
+    pthread_cond_t wake;               // Used to stop the collector thread promptly
+    pthread_t thread;                  // Collector thread
+    int running;                       // Collector is running
+    int stop;                          // Request to stop the collector thread
+    uint32_t period_ms;                // Sampling period
+    uint16_t depth;                    // Number of samples held
+    uint16_t num_ports;                // Number of ports sampled
+    uint16_t head;                     // Index for the next sample
+    uint16_t count;                    // Number of valid samples
+    clockid_t clock;                   // Clock for the sample timestamps
+    int ptp_fd;                        // PTP clock device (or -1)
+    uint64_t *timestamp;               // Sample timestamps (ns) [depth]
+    uint64_t *mono;                    // Sample monotonic times (ns) [depth]
+    struct xorif_fhi_eth_stats *stats; // Samples [depth][num_ports]
+} collector = {.lock = PTHREAD_MUTEX_INITIALIZER, .ptp_fd = -1};
+
+// Statistics consumers (also protected by the collector lock)
+// Consumers see "totals" (accumulators + counts folded in by clears) which never go backwards
+static struct
+{
+    int in_use;                                         // Handle is allocated
+    uint32_t epoch[MAX_NUM_ETH_PORTS];                  // Reset epoch at the previous read
+    uint64_t time[MAX_NUM_ETH_PORTS];                   // Monotonic time of the previous read (ns)
+    struct xorif_fhi_eth_stats base[MAX_NUM_ETH_PORTS]; // Totals at the previous read
+} consumers[STATS_MAX_CONSUMERS];
+static int num_consumers;
+static uint32_t stats_epoch; // Incremented when the counters are cleared or restarted
+static uint32_t stats_restarts;      // Data-pipe restarts notified (atomic, written by the interrupt handler)
+static uint32_t stats_restarts_seen; // Data-pipe restarts applied to the accumulators
+static struct xorif_fhi_eth_stats stats_folded[MAX_NUM_ETH_PORTS]; // Counts discarded by clears
+
+// "Monitor block" stream state (the lock also serializes bulk monitor reads)
+static struct
+{
+    pthread_mutex_t lock;                   // Protects everything below (and the monitor registers)
+    pthread_cond_t wake;                    // Used to stop the stream thread promptly
+    pthread_t thread;                       // Stream thread
+    int running;                            // Stream is running
+    int stop;                               // Request to stop the stream thread
+    uint32_t period_us;                     // Sampling period
+    uint16_t num;                           // Number of counters
+    uint8_t counters[MONITOR_MAX_COUNTERS]; // Counters to sample
+    uint16_t depth;                         // Number of samples buffered
+    uint16_t head;                          // Index for the next sample
+    uint16_t count;                         // Number of unread samples
+    uint32_t dropped;                       // Samples lost since the previous read
+    struct xorif_monitor_sample *samples;   // Samples [depth]
+} stream = {.lock = PTHREAD_MUTEX_INITIALIZER};
+
+// Spatial streams covered by the "stall-monitor" flags, in bit order (see #xorif_stall_ss_type)
+#define STALL_NUM_SS 48
+static const struct
+{
+    const char *name; // Spatial stream type name
+    uint8_t base;     // First bit in the flags
+    uint8_t num;      // Number of spatial streams
+} stall_types[] = {
+    {"DL", 0, 20},
+    {"UL", 20, 16},
+    {"PRACH", 36, 4},
+    {"SSB", 40, 4},
+    {"UNSOL", 44, 4},
+};
+#define NUM_STALL_TYPES (sizeof(stall_types) / sizeof(stall_types[0]))
+
+// Stall sampler state
+static struct
+{
+    pthread_mutex_t lock;                 // Protects everything below
+    pthread_cond_t wake;                  // Used to stop the sampler thread promptly
+    pthread_t thread;                     // Sampler thread
+    int running;                          // Sampler is running
+    int stop;                             // Request to stop the sampler thread
+    uint32_t period_ms;                   // Sampling period
+    uint32_t window_ms;                   // Sliding window
+    uint32_t threshold;                   // Recovery threshold (0 = disabled)
+    uint16_t action;                      // Recovery action
+    uint16_t depth;                       // Number of samples in the window
+    uint16_t head;                        // Index for the next sample
+    uint16_t count;                       // Number of valid samples in the window
+    uint64_t *onsets;                     // Stall onsets (bitmap) per sample [depth]
+    uint64_t flags;                       // Stall flags at the previous sample
+    uint64_t last;                        // Monotonic time of the previous sample (ns)
+    uint64_t samples;                     // Number of samples
+    uint64_t cc_change;                   // Monotonic time of the last carrier change (ns, 0 = none) (atomic)
+    uint32_t recoveries;                  // Number of recovery actions
+    uint64_t last_recovery;               // Monotonic time of the last recovery action (ns)
+    uint32_t events[STALL_NUM_SS];        // Stall events
+    uint32_t cc_events[STALL_NUM_SS];     // Stall events soon after a carrier change
+    uint32_t window_events[STALL_NUM_SS]; // Stall events in the window
+    uint64_t onset[STALL_NUM_SS];         // Start time of the current stall (ns)
+    uint64_t duration[STALL_NUM_SS];      // Total duration of completed stalls (ns)
+    uint64_t max_duration[STALL_NUM_SS];  // Longest completed stall (ns)
+} stall = {.lock = PTHREAD_MUTEX_INITIALIZER};
+
+// UL arrival-time histogram summary (the bin counts are held separately)
+struct arrival_hist
+{
+    uint64_t samples;   // Number of samples
+    uint64_t underflow; // Samples before the first bin
+    uint64_t overflow;  // Samples after the last bin
+    int64_t sum;        // Sum of the offsets (for the mean)
+    int32_t min;        // Minimum offset
+    int32_t max;        // Maximum offset
+};
+
+// UL arrival-time histograms (one per component carrier and Ethernet port)
+static struct
+{
+    pthread_mutex_t lock;                                    // Protects everything below
+    int32_t origin_ns;                                       // Start of the first bin
+    uint32_t bin_width_ns;                                   // Bin width
+    uint16_t num_bins;                                       // Number of bins
+    uint64_t *bins;                                          // Bin counts [MAX_NUM_CC][MAX_NUM_ETH_PORTS][num_bins] (NULL = not configured)
+    struct arrival_hist hist[MAX_NUM_CC][MAX_NUM_ETH_PORTS]; // Summaries
+    struct xorif_fhi_eth_stats base[MAX_NUM_ETH_PORTS];      // Port totals when cleared
+} arrival = {.lock = PTHREAD_MUTEX_INITIALIZER};
+
+// Local function prototypes...
+static uint64_t get_field(const struct xorif_fhi_eth_stats *ptr, int i);
+static void set_field(struct xorif_fhi_eth_stats *ptr, int i, uint64_t value);
+static void read_stats(uint16_t num_ports, struct xorif_fhi_eth_stats *ptr);
+static uint64_t time_ns(clockid_t clock);
+static void take_sample(void);
+static void *collector_thread(void *arg);
+static uint16_t get_num_ports(void);
+static void fold_stats(void);
+static void apply_restarts(void);
+static void read_totals(uint16_t num_ports, struct xorif_fhi_eth_stats *ptr, uint64_t *mono);
+static int check_counters(uint16_t num, const uint8_t counters[]);
+static void monitor_sample(uint16_t num, const uint8_t counters[], uint64_t values[], uint64_t *timestamp);
+static void *stream_thread(void *arg);
+static void clear_stall(void);
+static int stall_sample(uint32_t *events);
+static void stall_recovery(int i, uint16_t action, uint32_t events, uint32_t window_ms);
+static void *stall_thread(void *arg);
+static int check_arrival(uint16_t cc, int port);
+static void clear_arrival(const struct xorif_fhi_eth_stats *base);
+static void add_arrival(uint16_t cc, int port, uint16_t num, const int32_t offsets[]);
+static int32_t arrival_percentile(uint16_t cc, int port, double percentile);
+
+// API functions...
+
+int xorif_get_fhi_eth_stats_all(uint16_t num_ports, struct xorif_fhi_eth_stats *ptr)
+{
+    TRACE("xorif_get_fhi_eth_stats_all(%d, ...)\n", num_ports);
+
+    if ((num_ports > xorif_fhi_get_num_eth_ports()) || (num_ports > MAX_NUM_ETH_PORTS))
+    {
+        PERROR("Invalid number of Ethernet ports\n");
+        return XORIF_INVALID_ETH_PORT;
+    }
+    else if (!ptr)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+
+    pthread_mutex_lock(&collector.lock);
+    if (collector.running)
+    {
+        // Served from the latest collected sample
+        uint16_t latest = (collector.head + collector.depth - 1) % collector.depth;
+        memcpy(ptr, &collector.stats[latest * collector.num_ports], num_ports * sizeof(struct xorif_fhi_eth_stats));
+    }
+    else
+    {
+        read_stats(num_ports, ptr);
+    }
+    pthread_mutex_unlock(&collector.lock);
+
+    return XORIF_SUCCESS;
+}
+
+int xorif_start_stats_collector(uint32_t period_ms, uint16_t depth, const char *ptp_device)
+{
+    TRACE("xorif_start_stats_collector(%d, %d, %s)\n", period_ms, depth, ptp_device ? ptp_device : "NULL");
+
+    if ((period_ms == 0) || (depth < 2) || (depth > STATS_MAX_DEPTH))
+    {
+        PERROR("Invalid statistics collector period / depth\n");
+        return XORIF_INVALID_CONFIG;
+    }
+
+    // Re-start with the new settings
+    xorif_stop_stats_collector();
+
+    // Timestamp clock (PTP hardware clock or monotonic)
+    clockid_t clock = CLOCK_MONOTONIC;
+    int fd = -1;
+    if (ptp_device)
+    {
+        struct timespec ts;
+        fd = open(ptp_device, O_RDONLY);
+        if ((fd < 0) || (clock_gettime(FD_TO_CLOCKID(fd), &ts) != 0))
+        {
+            PERROR("Can't use PTP clock '%s'\n", ptp_device);
+            if (fd >= 0)
+            {
+                close(fd);
+            }
+            return XORIF_INVALID_CONFIG;
+        }
+        clock = FD_TO_CLOCKID(fd);
+    }
+
+    uint16_t num_ports = xorif_fhi_get_num_eth_ports();
+    num_ports = (num_ports > MAX_NUM_ETH_PORTS) ? MAX_NUM_ETH_PORTS : num_ports;
+
+    uint64_t *timestamp = calloc(depth, sizeof(uint64_t));
+    uint64_t *mono = calloc(depth, sizeof(uint64_t));
+    struct xorif_fhi_eth_stats *stats = calloc(depth * num_ports, sizeof(struct xorif_fhi_eth_stats));
+    if (!timestamp || !mono || !stats)
+    {
+        PERROR("Failed to allocate statistics collector memory\n");
+        free(timestamp);
+        free(mono);
+        free(stats);
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        return XORIF_MEMORY_ALLOCATION_FAIL;
+    }
+
+    pthread_mutex_lock(&collector.lock);
+    collector.period_ms = period_ms;
+    collector.depth = depth;
+    collector.num_ports = num_ports;
+    collector.head = 0;
+    collector.count = 0;
+    collector.clock = clock;
+    collector.ptp_fd = fd;
+    collector.timestamp = timestamp;
+    collector.mono = mono;
+    collector.stats = stats;
+    collector.stop = 0;
+
+    // First sample now, so that there is always one available to readers
+    take_sample();
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&collector.wake, &attr);
+    pthread_condattr_destroy(&attr);
+
+    int result = pthread_create(&collector.thread, NULL, collector_thread, NULL);
+    collector.running = (result == 0);
+    pthread_mutex_unlock(&collector.lock);
+
+    if (result != 0)
+    {
+        PERROR("Failed to start statistics collector thread\n");
+        xorif_stop_stats_collector();
+        return XORIF_FAILURE;
+    }
+
+    INFO("Statistics collector started (%d ms, %d samples)\n", period_ms, depth);
+    return XORIF_SUCCESS;
+}
+
+int xorif_stop_stats_collector(void)
+{
+    TRACE("xorif_stop_stats_collector()\n");
+
+    pthread_mutex_lock(&collector.lock);
+    int running = collector.running;
+    collector.stop = 1;
+    if (running)
+    {
+        pthread_cond_signal(&collector.wake);
+    }
+    pthread_mutex_unlock(&collector.lock);
+
+    if (running)
+    {
+        pthread_join(collector.thread, NULL);
+        pthread_cond_destroy(&collector.wake);
+    }
+
+    pthread_mutex_lock(&collector.lock);
+    collector.running = 0;
+    collector.count = 0;
+    free(collector.timestamp);
+    free(collector.mono);
+    free(collector.stats);
+    collector.timestamp = NULL;
+    collector.mono = NULL;
+    collector.stats = NULL;
+    if (collector.ptp_fd >= 0)
+    {
+        close(collector.ptp_fd);
+        collector.ptp_fd = -1;
+    }
+    pthread_mutex_unlock(&collector.lock);
+
+    return XORIF_SUCCESS;
+}
+
+int xorif_get_stats_sample(int port, uint16_t age, struct xorif_fhi_eth_stats *ptr, uint64_t *timestamp)
+{
+    TRACE("xorif_get_stats_sample(%d, %d, ...)\n", port, age);
+
+    if (!ptr)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+
+    pthread_mutex_lock(&collector.lock);
+    int result = XORIF_SUCCESS;
+    if (!collector.running)
+    {
+        PERROR("Statistics collector is not running\n");
+        result = XORIF_NOT_SUPPORTED;
+    }
+    else if ((port < 0) || (port >= collector.num_ports))
+    {
+        PERROR("Invalid Ethernet port value\n");
+        result = XORIF_INVALID_ETH_PORT;
+    }
+    else if (age >= collector.count)
+    {
+        PERROR("Sample not available\n");
+        result = XORIF_INVALID_CONFIG;
+    }
+    else
+    {
+        uint16_t i = (collector.head + collector.depth - 1 - age) % collector.depth;
+        memcpy(ptr, &collector.stats[i * collector.num_ports + port], sizeof(struct xorif_fhi_eth_stats));
+        if (timestamp)
+        {
+            *timestamp = collector.timestamp[i];
+        }
+    }
+    pthread_mutex_unlock(&collector.lock);
+
+    return result;
+}
+
+int xorif_get_stats_window(int port, uint32_t window_ms, struct xorif_fhi_eth_stats_window *ptr)
+{
+    TRACE("xorif_get_stats_window(%d, %d, ...)\n", port, window_ms);
+
+    if (!ptr)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+
+    pthread_mutex_lock(&collector.lock);
+    if (!collector.running)
+    {
+        pthread_mutex_unlock(&collector.lock);
+        PERROR("Statistics collector is not running\n");
+        return XORIF_NOT_SUPPORTED;
+    }
+    else if ((port < 0) || (port >= collector.num_ports))
+    {
+        pthread_mutex_unlock(&collector.lock);
+        PERROR("Invalid Ethernet port value\n");
+        return XORIF_INVALID_ETH_PORT;
+    }
+
+    memset(ptr, 0, sizeof(struct xorif_fhi_eth_stats_window));
+
+    // Samples within the window (newest first)
+    uint16_t depth = collector.depth;
+    uint16_t newest = (collector.head + depth - 1) % depth;
+    uint16_t n = 1;
+    while ((n < collector.count) &&
+           ((window_ms == 0) ||
+            ((collector.mono[newest] - collector.mono[(newest + depth - n) % depth]) <= window_ms * 1000000ULL)))
+    {
+        ++n;
+    }
+    uint16_t oldest = (newest + depth - (n - 1)) % depth;
+
+    ptr->num_samples = n;
+    ptr->start_time = collector.timestamp[oldest];
+    ptr->end_time = collector.timestamp[newest];
+
+    const struct xorif_fhi_eth_stats *first = &collector.stats[oldest * collector.num_ports + port];
+    const struct xorif_fhi_eth_stats *last = &collector.stats[newest * collector.num_ports + port];
+    double span = (collector.mono[newest] - collector.mono[oldest]) / 1e9;
+
+    for (int f = 0; f < NUM_STATS_FIELDS; ++f)
+    {
+        uint64_t min = UINT64_MAX;
+        uint64_t max = 0;
+        double sum = 0;
+
+        if (stats_fields[f].counter)
+        {
+            // Rate over each interval between consecutive samples
+            for (int k = 1; k < n; ++k)
+            {
+                uint16_t a = (oldest + k - 1) % depth;
+                uint16_t b = (oldest + k) % depth;
+                double dt = (collector.mono[b] - collector.mono[a]) / 1e9;
+                uint64_t delta = get_field(&collector.stats[b * collector.num_ports + port], f) -
+                                 get_field(&collector.stats[a * collector.num_ports + port], f);
+                uint64_t rate = (dt > 0) ? (uint64_t)(delta / dt) : 0;
+                min = (rate < min) ? rate : min;
+                max = (rate > max) ? rate : max;
+            }
+            if (n < 2)
+            {
+                min = 0;
+            }
+            set_field(&ptr->rate, f, (span > 0) ? (uint64_t)((get_field(last, f) - get_field(first, f)) / span) : 0);
+        }
+        else
+        {
+            // Mean, min and max of the sampled values
+            for (int k = 0; k < n; ++k)
+            {
+                uint64_t value = get_field(&collector.stats[((oldest + k) % depth) * collector.num_ports + port], f);
+                min = (value < min) ? value : min;
+                max = (value > max) ? value : max;
+                sum += value;
+            }
+            set_field(&ptr->rate, f, (uint64_t)(sum / n));
+        }
+        set_field(&ptr->min, f, min);
+        set_field(&ptr->max, f, max);
+    }
+    pthread_mutex_unlock(&collector.lock);
+
+    return XORIF_SUCCESS;
+}
+
+int xorif_open_stats_consumer(uint16_t *handle)
+{
+    TRACE("xorif_open_stats_consumer(...)\n");
+
+    if (!handle)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+
+    pthread_mutex_lock(&collector.lock);
+    int result = XORIF_MEMORY_ALLOCATION_FAIL;
+    for (uint16_t h = 0; h < STATS_MAX_CONSUMERS; ++h)
+    {
+        if (!consumers[h].in_use)
+        {
+            // Baseline is the current totals for all ports
+            uint64_t mono;
+            uint16_t num_ports = get_num_ports();
+            read_totals(num_ports, consumers[h].base, &mono);
+            for (int port = 0; port < num_ports; ++port)
+            {
+                consumers[h].epoch[port] = stats_epoch;
+                consumers[h].time[port] = mono;
+            }
+            consumers[h].in_use = 1;
+            ++num_consumers;
+            *handle = h;
+            result = XORIF_SUCCESS;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&collector.lock);
+
+    if (result != XORIF_SUCCESS)
+    {
+        PERROR("No statistics consumer handles available\n");
+    }
+    return result;
+}
+
+int xorif_close_stats_consumer(uint16_t handle)
+{
+    TRACE("xorif_close_stats_consumer(%d)\n", handle);
+
+    pthread_mutex_lock(&collector.lock);
+    int result = XORIF_SUCCESS;
+    if ((handle >= STATS_MAX_CONSUMERS) || !consumers[handle].in_use)
+    {
+        PERROR("Invalid statistics consumer handle\n");
+        result = XORIF_INVALID_CONFIG;
+    }
+    else
+    {
+        consumers[handle].in_use = 0;
+        --num_consumers;
+    }
+    pthread_mutex_unlock(&collector.lock);
+
+    return result;
+}
+
+int xorif_read_stats_consumer(uint16_t handle, int port, struct xorif_fhi_eth_stats_delta *ptr)
+{
+    TRACE("xorif_read_stats_consumer(%d, %d, ...)\n", handle, port);
+
+    if ((port < 0) || (port >= xorif_fhi_get_num_eth_ports()) || (port >= MAX_NUM_ETH_PORTS))
+    {
+        PERROR("Invalid Ethernet port value\n");
+        return XORIF_INVALID_ETH_PORT;
+    }
+    else if (!ptr)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+
+    pthread_mutex_lock(&collector.lock);
+    if ((handle >= STATS_MAX_CONSUMERS) || !consumers[handle].in_use)
+    {
+        pthread_mutex_unlock(&collector.lock);
+        PERROR("Invalid statistics consumer handle\n");
+        return XORIF_INVALID_CONFIG;
+    }
+
+    struct xorif_fhi_eth_stats totals[MAX_NUM_ETH_PORTS];
+    uint64_t mono;
+    read_totals(port + 1, totals, &mono);
+
+    struct xorif_fhi_eth_stats *base = &consumers[handle].base[port];
+    const struct xorif_fhi_eth_stats *now = &totals[port];
+    ptr->epoch = stats_epoch;
+    ptr->resets = stats_epoch - consumers[handle].epoch[port];
+    ptr->interval = mono - consumers[handle].time[port];
+    double interval = ptr->interval / 1e9;
+
+    for (int f = 0; f < NUM_STATS_FIELDS; ++f)
+    {
+        if (stats_fields[f].counter)
+        {
+            uint64_t delta = get_field(now, f) - get_field(base, f);
+            set_field(&ptr->delta, f, delta);
+            set_field(&ptr->rate, f, (interval > 0) ? (uint64_t)(delta / interval) : 0);
+        }
+        else
+        {
+            set_field(&ptr->delta, f, get_field(now, f));
+            set_field(&ptr->rate, f, get_field(now, f));
+        }
+    }
+
+    // New baseline
+    memcpy(base, now, sizeof(struct xorif_fhi_eth_stats));
+    consumers[handle].epoch[port] = stats_epoch;
+    consumers[handle].time[port] = mono;
+    pthread_mutex_unlock(&collector.lock);
+
+    return XORIF_SUCCESS;
+}
+
+int xorif_monitor_read_bulk(uint16_t num, const uint8_t counters[], uint64_t values[], uint64_t *timestamp)
+{
+    TRACE("xorif_monitor_read_bulk(%d, ...)\n", num);
+
+    if (!counters || !values)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+    else if (!check_counters(num, counters))
+    {
+        return XORIF_INVALID_CONFIG;
+    }
+
+    uint64_t t;
+    pthread_mutex_lock(&stream.lock);
+    monitor_sample(num, counters, values, &t);
+    pthread_mutex_unlock(&stream.lock);
+
+    if (timestamp)
+    {
+        *timestamp = t;
+    }
+
+    return XORIF_SUCCESS;
+}
+
+int xorif_start_monitor_stream(uint32_t period_us, uint16_t num, const uint8_t counters[], uint16_t depth)
+{
+    TRACE("xorif_start_monitor_stream(%d, %d, ..., %d)\n", period_us, num, depth);
+
+    if (!counters)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+    else if (!check_counters(num, counters))
+    {
+        return XORIF_INVALID_CONFIG;
+    }
+    else if ((period_us == 0) || (depth < 2) || (depth > STATS_MAX_DEPTH))
+    {
+        PERROR("Invalid monitor stream period / depth\n");
+        return XORIF_INVALID_CONFIG;
+    }
+
+    // Re-start with the new settings
+    xorif_stop_monitor_stream();
+
+    struct xorif_monitor_sample *samples = calloc(depth, sizeof(struct xorif_monitor_sample));
+    if (!samples)
+    {
+        PERROR("Failed to allocate monitor stream memory\n");
+        return XORIF_MEMORY_ALLOCATION_FAIL;
+    }
+
+    pthread_mutex_lock(&stream.lock);
+    stream.period_us = period_us;
+    stream.num = num;
+    memcpy(stream.counters, counters, num);
+    stream.depth = depth;
+    stream.head = 0;
+    stream.count = 0;
+    stream.dropped = 0;
+    stream.samples = samples;
+    stream.stop = 0;
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&stream.wake, &attr);
+    pthread_condattr_destroy(&attr);
+
+    int result = pthread_create(&stream.thread, NULL, stream_thread, NULL);
+    stream.running = (result == 0);
+    pthread_mutex_unlock(&stream.lock);
+
+    if (result != 0)
+    {
+        PERROR("Failed to start monitor stream thread\n");
+        xorif_stop_monitor_stream();
+        return XORIF_FAILURE;
+    }
+
+    INFO("Monitor stream started (%d us, %d counters, %d samples)\n", period_us, num, depth);
+    return XORIF_SUCCESS;
+}
+
+int xorif_stop_monitor_stream(void)
+{
+    TRACE("xorif_stop_monitor_stream()\n");
+
+    pthread_mutex_lock(&stream.lock);
+    int running = stream.running;
+    stream.stop = 1;
+    if (running)
+    {
+        pthread_cond_signal(&stream.wake);
+    }
+    pthread_mutex_unlock(&stream.lock);
+
+    if (running)
+    {
+        pthread_join(stream.thread, NULL);
+        pthread_cond_destroy(&stream.wake);
+    }
+
+    pthread_mutex_lock(&stream.lock);
+    stream.running = 0;
+    stream.count = 0;
+    free(stream.samples);
+    stream.samples = NULL;
+    pthread_mutex_unlock(&stream.lock);
+
+    return XORIF_SUCCESS;
+}
+
+int xorif_read_monitor_stream(uint16_t max, struct xorif_monitor_sample *samples, uint16_t *num, uint32_t *dropped)
+{
+    TRACE("xorif_read_monitor_stream(%d, ...)\n", max);
+
+    if (!samples || !num)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+
+    pthread_mutex_lock(&stream.lock);
+    if (!stream.running)
+    {
+        pthread_mutex_unlock(&stream.lock);
+        PERROR("Monitor stream is not running\n");
+        return XORIF_NOT_SUPPORTED;
+    }
+
+    uint16_t n = (stream.count < max) ? stream.count : max;
+    uint16_t oldest = (stream.head + stream.depth - stream.count) % stream.depth;
+    for (int i = 0; i < n; ++i)
+    {
+        memcpy(&samples[i], &stream.samples[(oldest + i) % stream.depth], sizeof(struct xorif_monitor_sample));
+    }
+    stream.count -= n;
+    *num = n;
+    if (dropped)
+    {
+        *dropped = stream.dropped;
+    }
+    stream.dropped = 0;
+    pthread_mutex_unlock(&stream.lock);
+
+    return XORIF_SUCCESS;
+}
+
+int xorif_start_stall_sampler(uint32_t period_ms, uint32_t window_ms, uint32_t threshold, uint16_t action)
+{
+    TRACE("xorif_start_stall_sampler(%d, %d, %d, %d)\n", period_ms, window_ms, threshold, action);
+
+    if ((period_ms == 0) || (window_ms == 0))
+    {
+        PERROR("Invalid stall sampler period / window\n");
+        return XORIF_INVALID_CONFIG;
+    }
+    else if (action > STALL_ACTION_RESTART_DATAPIPE)
+    {
+        PERROR("Invalid stall sampler recovery action\n");
+        return XORIF_INVALID_CONFIG;
+    }
+
+    // Re-start with the new settings
+    xorif_stop_stall_sampler();
+
+    uint32_t depth = (window_ms + period_ms - 1) / period_ms;
+    depth = (depth > STATS_MAX_DEPTH) ? STATS_MAX_DEPTH : depth;
+    uint64_t *onsets = calloc(depth, sizeof(uint64_t));
+    if (!onsets)
+    {
+        PERROR("Failed to allocate stall sampler memory\n");
+        return XORIF_MEMORY_ALLOCATION_FAIL;
+    }
+
+    pthread_mutex_lock(&stall.lock);
+    stall.period_ms = period_ms;
+    stall.window_ms = window_ms;
+    stall.threshold = threshold;
+    stall.action = action;
+    stall.depth = depth;
+    stall.onsets = onsets;
+    stall.flags = 0;
+    stall.samples = 0;
+    clear_stall();
+    stall.stop = 0;
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&stall.wake, &attr);
+    pthread_condattr_destroy(&attr);
+
+    int result = pthread_create(&stall.thread, NULL, stall_thread, NULL);
+    stall.running = (result == 0);
+    pthread_mutex_unlock(&stall.lock);
+
+    if (result != 0)
+    {
+        PERROR("Failed to start stall sampler thread\n");
+        xorif_stop_stall_sampler();
+        return XORIF_FAILURE;
+    }
+
+    INFO("Stall sampler started (%d ms, %d ms window, threshold %d, action %d)\n", period_ms, window_ms, threshold, action);
+    return XORIF_SUCCESS;
+}
+
+int xorif_stop_stall_sampler(void)
+{
+    TRACE("xorif_stop_stall_sampler()\n");
+
+    pthread_mutex_lock(&stall.lock);
+    int running = stall.running;
+    stall.stop = 1;
+    if (running)
+    {
+        pthread_cond_signal(&stall.wake);
+    }
+    pthread_mutex_unlock(&stall.lock);
+
+    if (running)
+    {
+        pthread_join(stall.thread, NULL);
+        pthread_cond_destroy(&stall.wake);
+    }
+
+    // Note, the results (including the window counts) are kept
+    pthread_mutex_lock(&stall.lock);
+    stall.running = 0;
+    free(stall.onsets);
+    stall.onsets = NULL;
+    pthread_mutex_unlock(&stall.lock);
+
+    return XORIF_SUCCESS;
+}
+
+int xorif_clear_stall_stats(void)
+{
+    TRACE("xorif_clear_stall_stats()\n");
+
+    pthread_mutex_lock(&stall.lock);
+    clear_stall();
+    pthread_mutex_unlock(&stall.lock);
+
+    return XORIF_SUCCESS;
+}
+
+int xorif_get_stall_stats(uint16_t type, uint16_t ss, struct xorif_stall_stats *ptr)
+{
+    TRACE("xorif_get_stall_stats(%d, %d, ...)\n", type, ss);
+
+    if (!ptr)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+    else if (type >= NUM_STALL_TYPES)
+    {
+        PERROR("Invalid spatial stream type\n");
+        return XORIF_INVALID_CONFIG;
+    }
+    else if (ss >= stall_types[type].num)
+    {
+        PERROR("Invalid spatial stream\n");
+        return XORIF_INVALID_SS;
+    }
+
+    int i = stall_types[type].base + ss;
+
+    pthread_mutex_lock(&stall.lock);
+    ptr->events = stall.events[i];
+    ptr->stalled = (stall.flags >> i) & 1;
+    ptr->duration = stall.duration[i];
+    ptr->max_duration = stall.max_duration[i];
+    if (ptr->stalled)
+    {
+        // Include the current stall (up to the latest sample)
+        uint64_t current = stall.last - stall.onset[i];
+        ptr->duration += current;
+        ptr->max_duration = (current > ptr->max_duration) ? current : ptr->max_duration;
+    }
+    ptr->window_events = stall.window_events[i];
+    ptr->cc_events = stall.cc_events[i];
+    ptr->rate = (stall.count > 0) ? stall.window_events[i] * 1000.0 / ((double)stall.count * stall.period_ms) : 0.0;
+    pthread_mutex_unlock(&stall.lock);
+
+    return XORIF_SUCCESS;
+}
+
+int xorif_get_stall_sampler_status(struct xorif_stall_sampler_status *ptr)
+{
+    TRACE("xorif_get_stall_sampler_status(...)\n");
+
+    if (!ptr)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+
+    pthread_mutex_lock(&stall.lock);
+    ptr->running = stall.running;
+    ptr->period_ms = stall.period_ms;
+    ptr->window_ms = stall.window_ms;
+    ptr->threshold = stall.threshold;
+    ptr->action = stall.action;
+    ptr->samples = stall.samples;
+    ptr->events = 0;
+    ptr->window_events = 0;
+    for (int i = 0; i < STALL_NUM_SS; ++i)
+    {
+        ptr->events += stall.events[i];
+        ptr->window_events += stall.window_events[i];
+    }
+    ptr->recoveries = stall.recoveries;
+    ptr->last_recovery = stall.last_recovery;
+    pthread_mutex_unlock(&stall.lock);
+
+    return XORIF_SUCCESS;
+}
+
+int xorif_configure_arrival_histogram(uint32_t bin_width_ns, uint16_t num_bins, int32_t origin_ns)
+{
+    TRACE("xorif_configure_arrival_histogram(%u, %u, %d)\n", bin_width_ns, num_bins, origin_ns);
+
+    if ((bin_width_ns == 0) || (num_bins == 0) || (num_bins > ARRIVAL_HIST_MAX_BINS))
+    {
+        PERROR("Invalid arrival histogram bins\n");
+        return XORIF_INVALID_CONFIG;
+    }
+
+    uint64_t *bins = calloc(MAX_NUM_CC * MAX_NUM_ETH_PORTS * num_bins, sizeof(uint64_t));
+    if (!bins)
+    {
+        PERROR("Memory allocation failed\n");
+        return XORIF_MEMORY_ALLOCATION_FAIL;
+    }
+
+    // Hardware baselines (read first, so that the locks aren't nested)
+    struct xorif_fhi_eth_stats base[MAX_NUM_ETH_PORTS];
+    uint64_t mono;
+    pthread_mutex_lock(&collector.lock);
+    read_totals(get_num_ports(), base, &mono);
+    pthread_mutex_unlock(&collector.lock);
+
+    pthread_mutex_lock(&arrival.lock);
+    free(arrival.bins);
+    arrival.bins = bins;
+    arrival.bin_width_ns = bin_width_ns;
+    arrival.num_bins = num_bins;
+    arrival.origin_ns = origin_ns;
+    clear_arrival(base);
+    pthread_mutex_unlock(&arrival.lock);
+
+    return XORIF_SUCCESS;
+}
+
+int xorif_clear_arrival_histograms(void)
+{
+    TRACE("xorif_clear_arrival_histograms()\n");
+
+    // Hardware baselines (read first, so that the locks aren't nested)
+    struct xorif_fhi_eth_stats base[MAX_NUM_ETH_PORTS];
+    uint64_t mono;
+    pthread_mutex_lock(&collector.lock);
+    read_totals(get_num_ports(), base, &mono);
+    pthread_mutex_unlock(&collector.lock);
+
+    pthread_mutex_lock(&arrival.lock);
+    if (!arrival.bins)
+    {
+        pthread_mutex_unlock(&arrival.lock);
+        PERROR("Arrival histograms are not configured\n");
+        return XORIF_INVALID_CONFIG;
+    }
+    clear_arrival(base);
+    pthread_mutex_unlock(&arrival.lock);
+
+    return XORIF_SUCCESS;
+}
+
+int xorif_add_arrival_samples(uint16_t cc, int port, uint16_t num, const int32_t offsets[])
+{
+    TRACE("xorif_add_arrival_samples(%d, %d, %d, ...)\n", cc, port, num);
+
+    int result = check_arrival(cc, port);
+    if (result != XORIF_SUCCESS)
+    {
+        return result;
+    }
+    else if (num && !offsets)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+
+    pthread_mutex_lock(&arrival.lock);
+    if (!arrival.bins)
+    {
+        pthread_mutex_unlock(&arrival.lock);
+        PERROR("Arrival histograms are not configured\n");
+        return XORIF_INVALID_CONFIG;
+    }
+
+    add_arrival(cc, port, num, offsets);
+    pthread_mutex_unlock(&arrival.lock);
+
+    return XORIF_SUCCESS;
+}
+
+int xorif_get_arrival_histogram(uint16_t cc, int port, struct xorif_arrival_histogram *ptr)
+{
+    TRACE("xorif_get_arrival_histogram(%d, %d, ...)\n", cc, port);
+
+    int result = check_arrival(cc, port);
+    if (result != XORIF_SUCCESS)
+    {
+        return result;
+    }
+    else if (!ptr)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+
+    // Hardware counts for the port (totals never go backwards)
+    struct xorif_fhi_eth_stats totals[MAX_NUM_ETH_PORTS];
+    uint64_t mono;
+    pthread_mutex_lock(&collector.lock);
+    read_totals(port + 1, totals, &mono);
+    pthread_mutex_unlock(&collector.lock);
+
+    pthread_mutex_lock(&arrival.lock);
+    if (!arrival.bins)
+    {
+        pthread_mutex_unlock(&arrival.lock);
+        PERROR("Arrival histograms are not configured\n");
+        return XORIF_INVALID_CONFIG;
+    }
+
+    memset(ptr, 0, sizeof(struct xorif_arrival_histogram));
+    const struct arrival_hist *h = &arrival.hist[cc][port];
+    ptr->origin_ns = arrival.origin_ns;
+    ptr->bin_width_ns = arrival.bin_width_ns;
+    ptr->num_bins = arrival.num_bins;
+    ptr->samples = h->samples;
+    ptr->underflow = h->underflow;
+    ptr->overflow = h->overflow;
+    memcpy(ptr->bins, &arrival.bins[(cc * MAX_NUM_ETH_PORTS + port) * arrival.num_bins], arrival.num_bins * sizeof(uint64_t));
+    if (h->samples)
+    {
+        ptr->min_ns = h->min;
+        ptr->max_ns = h->max;
+        ptr->mean_ns = h->sum / (int64_t)h->samples;
+        ptr->p50_ns = arrival_percentile(cc, port, 50.0);
+        ptr->p90_ns = arrival_percentile(cc, port, 90.0);
+        ptr->p99_ns = arrival_percentile(cc, port, 99.0);
+        ptr->p999_ns = arrival_percentile(cc, port, 99.9);
+    }
+    ptr->hw_early = totals[port].oran_rx_early_c - arrival.base[port].oran_rx_early_c;
+    ptr->hw_on_time = totals[port].oran_rx_on_time_c - arrival.base[port].oran_rx_on_time_c;
+    ptr->hw_late = totals[port].oran_rx_late_c - arrival.base[port].oran_rx_late_c;
+    pthread_mutex_unlock(&arrival.lock);
+
+    return XORIF_SUCCESS;
+}
+
+int xorif_get_arrival_percentile(uint16_t cc, int port, double percentile, int32_t *offset_ns)
+{
+    TRACE("xorif_get_arrival_percentile(%d, %d, %f, ...)\n", cc, port, percentile);
+
+    int result = check_arrival(cc, port);
+    if (result != XORIF_SUCCESS)
+    {
+        return result;
+    }
+    else if (!offset_ns)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+    else if ((percentile < 0.0) || (percentile > 100.0))
+    {
+        PERROR("Invalid percentile\n");
+        return XORIF_INVALID_CONFIG;
+    }
+
+    pthread_mutex_lock(&arrival.lock);
+    if (!arrival.bins || !arrival.hist[cc][port].samples)
+    {
+        pthread_mutex_unlock(&arrival.lock);
+        PERROR("No arrival samples\n");
+        return XORIF_INVALID_CONFIG;
+    }
+    *offset_ns = arrival_percentile(cc, port, percentile);
+    pthread_mutex_unlock(&arrival.lock);
+
+    return XORIF_SUCCESS;
+}
+
+// Internal functions...
+
+void xorif_stall_cc_change(void)
+{
+    // Lock-free, since it's also called from the interrupt handler
+    __atomic_store_n(&stall.cc_change, time_ns(CLOCK_MONOTONIC), __ATOMIC_RELAXED);
+}
+
+void xorif_monitor_lock(void)
+{
+    pthread_mutex_lock(&stream.lock);
+}
+
+void xorif_monitor_unlock(void)
+{
+    pthread_mutex_unlock(&stream.lock);
+}
+
+void xorif_stats_clear(void)
+{
+    pthread_mutex_lock(&collector.lock);
+
+    // Fold the counts so far into the consumers' totals
+    if (num_consumers > 0)
+    {
+        fold_stats();
+        uint16_t num_ports = get_num_ports();
+        for (int port = 0; port < num_ports; ++port)
+        {
+            for (int f = 0; f < NUM_STATS_FIELDS; ++f)
+            {
+                if (stats_fields[f].counter)
+                {
+                    set_field(&stats_folded[port], f, get_field(&stats_folded[port], f) + get_field(&stats_acc[port], f));
+                }
+            }
+        }
+    }
+    apply_restarts();
+    ++stats_epoch;
+
+    // Take snapshot (with reset)
+    WRITE_REG_RAW(DEFM_SNAP_SHOT_ADDR, 0xFFFFFFFF);
+
+    // Clear the software accumulators
+    memset(stats_acc, 0, sizeof(stats_acc));
+    memset(stats_last, 0, sizeof(stats_last));
+
+    // Discard the collected samples (and start again)
+    if (collector.running)
+    {
+        collector.count = 0;
+        take_sample();
+    }
+
+    pthread_mutex_unlock(&collector.lock);
+}
+
+void xorif_stats_restart(void)
+{
+    pthread_mutex_lock(&collector.lock);
+
+    // Accumulate the counts so far (only needed if anyone is watching)
+    if ((num_consumers > 0) || collector.running)
+    {
+        fold_stats();
+    }
+
+    // Hardware counters restart from 0
+    memset(stats_last, 0, sizeof(stats_last));
+    ++stats_epoch;
+
+    pthread_mutex_unlock(&collector.lock);
+}
+
+void xorif_stats_restart_async(void)
+{
+    // Only flag the restart, the accumulators catch up at the next read
+    __atomic_add_fetch(&stats_restarts, 1, __ATOMIC_RELEASE);
+}
+
+void xorif_stats_record_sample(void)
+{
+    pthread_mutex_lock(&collector.lock);
+    if (xorif_state && !collector.running)
+    {
+        // Note, the collector records its own samples
+        uint16_t num_ports = get_num_ports();
+        struct xorif_fhi_eth_stats temp[MAX_NUM_ETH_PORTS];
+        read_stats(num_ports, temp);
+        uint64_t now = time_ns(CLOCK_MONOTONIC);
+        for (int port = 0; port < num_ports; ++port)
+        {
+            xorif_record_stats(port, &temp[port], now);
+        }
+    }
+    pthread_mutex_unlock(&collector.lock);
+}
+
+// Local functions...
+
+/**
+ * @brief Get a statistics field.
+ * @param[in] ptr Pointer to statistics data structure
+ * @param[in] i Index in the statistics fields table
+ * @returns
+ *      - Field value
+ */
+static uint64_t get_field(const struct xorif_fhi_eth_stats *ptr, int i)
+{
+    const uint8_t *p = (const uint8_t *)ptr + stats_fields[i].offset;
+    return (stats_fields[i].size == 8) ? *(const uint64_t *)p : *(const uint16_t *)p;
+}
+
+/**
+ * @brief Set a statistics field.
+ * @param[in,out] ptr Pointer to statistics data structure
+ * @param[in] i Index in the statistics fields table
+ * @param[in] value Field value
+ */
+static void set_field(struct xorif_fhi_eth_stats *ptr, int i, uint64_t value)
+{
+    uint8_t *p = (uint8_t *)ptr + stats_fields[i].offset;
+    if (stats_fields[i].size == 8)
+    {
+        *(uint64_t *)p = value;
+    }
+    else
+    {
+        *(uint16_t *)p = value;
+    }
+}
+
+/**
+ * @brief Read the statistics for all ports from a single snapshot, and accumulate.
+ * @param[in] num_ports Number of Ethernet ports
+ * @param[out] ptr Pointer to array of statistics data structures
+ * @note
+ * Each read adds the difference since the previous read. A counter that has
+ * gone backwards has restarted (e.g. reset), so it's counted from 0.
+ */
+static void read_stats(uint16_t num_ports, struct xorif_fhi_eth_stats *ptr)
+{
+    apply_restarts();
+
+    // Take one snapshot (no reset) for all ports
+    WRITE_REG(DEFM_SNAP_SHOT, 1);
+
+    for (int port = 0; port < num_ports; ++port)
+    {
+        struct xorif_fhi_eth_stats *acc = &stats_acc[port];
+        uint32_t base = port * 0x100;
+
+        for (int i = 0; i < NUM_STATS_FIELDS; ++i)
+        {
+            uint32_t addr = stats_fields[i].addr + base;
+            if (stats_fields[i].counter)
+            {
+                uint64_t value = (uint64_t)READ_REG_RAW_ALT("STATS_COUNTER_L", addr) |
+                                 (uint64_t)READ_REG_RAW_ALT("STATS_COUNTER_H", addr + 4) << 32;
+                uint64_t *last = &stats_last[port][i];
+                uint64_t delta = (value >= *last) ? (value - *last) : value;
+                *last = value;
+                set_field(acc, i, get_field(acc, i) + delta);
+            }
+            else
+            {
+                uint32_t mask = (stats_fields[i].size == 8) ? 0xFFFFFFFF : 0xFFF;
+                set_field(acc, i, (uint64_t)(READ_REG_RAW_ALT("STATS_VALUE", addr) & mask) * stats_fields[i].scale);
+            }
+        }
+
+        memcpy(&ptr[port], acc, sizeof(struct xorif_fhi_eth_stats));
+    }
+}
+
+/**
+ * @brief Read a clock.
+ * @param[in] clock Clock ID
+ * @returns
+ *      - Time in nanoseconds
+ */
+static uint64_t time_ns(clockid_t clock)
+{
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * @brief Take a sample for the statistics collector (called with the lock held).
+ */
+static void take_sample(void)
+{
+    uint16_t i = collector.head;
+    read_stats(collector.num_ports, &collector.stats[i * collector.num_ports]);
+    collector.mono[i] = time_ns(CLOCK_MONOTONIC);
+    collector.timestamp[i] = (collector.clock == CLOCK_MONOTONIC) ? collector.mono[i] : time_ns(collector.clock);
+    for (int port = 0; port < collector.num_ports; ++port)
+    {
+        xorif_record_stats(port, &collector.stats[i * collector.num_ports + port], collector.mono[i]);
+    }
+    collector.head = (i + 1) % collector.depth;
+    if (collector.count < collector.depth)
+    {
+        ++collector.count;
+    }
+}
+
+/**
+ * @brief Statistics collector thread.
+ * @param[in] arg Not used
+ * @returns
+ *      - NULL
+ */
+static void *collector_thread(void *arg)
+{
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+
+    pthread_mutex_lock(&collector.lock);
+    while (!collector.stop)
+    {
+        // Wait until the next sample time (or a request to stop)
+        next.tv_nsec += (collector.period_ms % 1000) * 1000000L;
+        next.tv_sec += collector.period_ms / 1000 + next.tv_nsec / 1000000000L;
+        next.tv_nsec %= 1000000000L;
+        int rc = 0;
+        while (!collector.stop && (rc != ETIMEDOUT))
+        {
+            rc = pthread_cond_timedwait(&collector.wake, &collector.lock, &next);
+        }
+
+        if (!collector.stop)
+        {
+            take_sample();
+        }
+    }
+    pthread_mutex_unlock(&collector.lock);
+
+    return NULL;
+}
+
+/**
+ * @brief Get the number of Ethernet ports with statistics.
+ * @returns
+ *      - Number of ports
+ */
+static uint16_t get_num_ports(void)
+{
+    uint16_t num_ports = xorif_fhi_get_num_eth_ports();
+    return (num_ports > MAX_NUM_ETH_PORTS) ? MAX_NUM_ETH_PORTS : num_ports;
+}
+
+/**
+ * @brief Bring the software accumulators up to date with the hardware (called with the lock held).
+ */
+static void fold_stats(void)
+{
+    struct xorif_fhi_eth_stats temp[MAX_NUM_ETH_PORTS];
+    read_stats(get_num_ports(), temp);
+}
+
+/**
+ * @brief Apply the data-pipe restarts notified since the previous read (called with the lock held).
+ * @note
+ * The hardware counters restarted from 0, so the next read counts them from 0
+ * (the counts between the previous read and the restart are not seen).
+ */
+static void apply_restarts(void)
+{
+    uint32_t restarts = __atomic_load_n(&stats_restarts, __ATOMIC_ACQUIRE);
+    if (restarts != stats_restarts_seen)
+    {
+        memset(stats_last, 0, sizeof(stats_last));
+        stats_epoch += restarts - stats_restarts_seen;
+        stats_restarts_seen = restarts;
+    }
+}
+
+/**
+ * @brief Read the consumer totals (called with the lock held).
+ * @param[in] num_ports Number of Ethernet ports
+ * @param[out] ptr Pointer to array of statistics data structures
+ * @param[out] mono Monotonic time of the values (ns)
+ * @note
+ * The latest collected sample is used if the collector is running.
+ */
+static void read_totals(uint16_t num_ports, struct xorif_fhi_eth_stats *ptr, uint64_t *mono)
+{
+    if (collector.running)
+    {
+        uint16_t latest = (collector.head + collector.depth - 1) % collector.depth;
+        memcpy(ptr, &collector.stats[latest * collector.num_ports], num_ports * sizeof(struct xorif_fhi_eth_stats));
+        *mono = collector.mono[latest];
+    }
+    else
+    {
+        read_stats(num_ports, ptr);
+        *mono = time_ns(CLOCK_MONOTONIC);
+    }
+
+    for (int port = 0; port < num_ports; ++port)
+    {
+        for (int f = 0; f < NUM_STATS_FIELDS; ++f)
+        {
+            if (stats_fields[f].counter)
+            {
+                set_field(&ptr[port], f, get_field(&ptr[port], f) + get_field(&stats_folded[port], f));
+            }
+        }
+    }
+}
+
+/**
+ * @brief Check a list of "monitor block" counters.
+ * @param[in] num Number of counters
+ * @param[in] counters Array of counters
+ * @returns
+ *      - 1 if valid
+ *      - 0 if not valid
+ */
+static int check_counters(uint16_t num, const uint8_t counters[])
+{
+    if ((num == 0) || (num > MONITOR_MAX_COUNTERS))
+    {
+        PERROR("Invalid number of monitor counters\n");
+        return 0;
+    }
+
+    for (int i = 0; i < num; ++i)
+    {
+        if (counters[i] > (CFG_MONITOR_SELECT_READ_MASK >> CFG_MONITOR_SELECT_READ_OFFSET))
+        {
+            PERROR("Invalid monitor counter %d\n", counters[i]);
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Read a list of "monitor block" counters from a single snapshot (called with the stream lock held).
+ * @param[in] num Number of counters
+ * @param[in] counters Array of counters
+ * @param[out] values Array of counter values
+ * @param[out] timestamp Snapshot time (ns)
+ * @note
+ * Whole register writes avoid the read-modify-write cycles, and repeated
+ * counters re-use the value already read.
+ */
+static void monitor_sample(uint16_t num, const uint8_t counters[], uint64_t values[], uint64_t *timestamp)
+{
+    // One snapshot for all counters
+    WRITE_REG_RAW(CFG_MONITOR_SNAPSHOT_ADDR, CFG_MONITOR_SNAPSHOT_MASK);
+    *timestamp = time_ns(CLOCK_MONOTONIC);
+
+    for (int i = 0; i < num; ++i)
+    {
+        int j;
+        for (j = 0; j < i; ++j)
+        {
+            if (counters[j] == counters[i])
+            {
+                break;
+            }
+        }
+
+        if (j < i)
+        {
+            values[i] = values[j];
+        }
+        else
+        {
+            WRITE_REG_RAW(CFG_MONITOR_SELECT_READ_ADDR, counters[i] << CFG_MONITOR_SELECT_READ_OFFSET);
+            WRITE_REG_RAW(CFG_MONITOR_SAMPLE_ADDR, CFG_MONITOR_SAMPLE_MASK);
+            values[i] = (uint64_t)READ_REG_RAW(CFG_MONITOR_READ_31__0_ADDR) |
+                        (uint64_t)READ_REG_RAW(CFG_MONITOR_READ_63_32_ADDR) << 32;
+        }
+    }
+}
+
+/**
+ * @brief "Monitor block" stream thread.
+ * @param[in] arg Not used
+ * @returns
+ *      - NULL
+ */
+static void *stream_thread(void *arg)
+{
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+
+    pthread_mutex_lock(&stream.lock);
+    while (!stream.stop)
+    {
+        // Take sample (the oldest unread sample is lost if the buffer is full)
+        struct xorif_monitor_sample *sample = &stream.samples[stream.head];
+        monitor_sample(stream.num, stream.counters, sample->values, &sample->timestamp);
+        sample->num_counters = stream.num;
+        stream.head = (stream.head + 1) % stream.depth;
+        if (stream.count < stream.depth)
+        {
+            ++stream.count;
+        }
+        else
+        {
+            ++stream.dropped;
+        }
+
+        // Wait until the next sample time (or a request to stop)
+        next.tv_nsec += (stream.period_us % 1000000) * 1000L;
+        next.tv_sec += stream.period_us / 1000000 + next.tv_nsec / 1000000000L;
+        next.tv_nsec %= 1000000000L;
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if ((now.tv_sec > next.tv_sec) || ((now.tv_sec == next.tv_sec) && (now.tv_nsec > next.tv_nsec)))
+        {
+            // Running late, so don't try to catch up
+            next = now;
+        }
+        int rc = 0;
+        while (!stream.stop && (rc != ETIMEDOUT))
+        {
+            rc = pthread_cond_timedwait(&stream.wake, &stream.lock, &next);
+        }
+    }
+    pthread_mutex_unlock(&stream.lock);
+
+    return NULL;
+}
+
+/**
+ * @brief Clear the stall sampler results (called with the lock held).
+ * @note
+ * Current stalls are timed from the previous sample.
+ */
+static void clear_stall(void)
+{
+    stall.head = 0;
+    stall.count = 0;
+    stall.recoveries = 0;
+    stall.last_recovery = 0;
+    memset(stall.events, 0, sizeof(stall.events));
+    memset(stall.cc_events, 0, sizeof(stall.cc_events));
+    memset(stall.window_events, 0, sizeof(stall.window_events));
+    memset(stall.duration, 0, sizeof(stall.duration));
+    memset(stall.max_duration, 0, sizeof(stall.max_duration));
+    for (int i = 0; i < STALL_NUM_SS; ++i)
+    {
+        stall.onset[i] = stall.last;
+    }
+}
+
+/**
+ * @brief Take a sample for the stall sampler (called with the lock held).
+ * @param[out] events Number of stall events in the window (when the threshold is crossed)
+ * @returns
+ *      - Spatial stream (bit) that crossed the recovery threshold
+ *      - -1 if there's no recovery action to perform
+ * @note
+ * Uses one snapshot and two whole register reads (rather than the 7 field
+ * reads of #xorif_stall_monitor_read).
+ * The window is cleared when the threshold is crossed, so the action is not
+ * repeated until the threshold is re-crossed.
+ */
+static int stall_sample(uint32_t *events)
+{
+    WRITE_REG_RAW(FRAM_STALL_SAMPLE_ADDR, FRAM_STALL_SAMPLE_MASK);
+    uint64_t now = time_ns(CLOCK_MONOTONIC);
+    uint32_t r0 = READ_REG_RAW(FRAM_STALL_MONITOR_UL_SS_7_0_ADDR);
+    uint32_t r1 = READ_REG_RAW(FRAM_STALL_MONITOR_UL_SS_15_8_ADDR);
+
+#define STALL_FIELD(r, f) (uint64_t)(((r) & FRAM_STALL_MONITOR_##f##_MASK) >> FRAM_STALL_MONITOR_##f##_OFFSET)
+    uint64_t flags = STALL_FIELD(r0, DL_SS_7_0) |
+                     STALL_FIELD(r1, DL_SS_19_8) << 8 |
+                     STALL_FIELD(r0, UL_SS_7_0) << 20 |
+                     STALL_FIELD(r1, UL_SS_15_8) << 28 |
+                     STALL_FIELD(r0, UL_PRACH_3_0) << 36 |
+                     STALL_FIELD(r0, SSB_3_0) << 40 |
+                     STALL_FIELD(r0, UL_UNSOL_3_0) << 44;
+#undef STALL_FIELD
+
+    uint64_t onsets = flags & ~stall.flags;
+    uint64_t ends = stall.flags & ~flags;
+    uint64_t cc_change = __atomic_load_n(&stall.cc_change, __ATOMIC_RELAXED);
+    int near_cc_change = (cc_change != 0) && (now - cc_change <= stall.window_ms * 1000000ULL);
+
+    // Update the sliding window (dropping the oldest sample when full)
+    if (stall.count == stall.depth)
+    {
+        uint64_t oldest = stall.onsets[stall.head];
+        for (int i = 0; oldest; ++i, oldest >>= 1)
+        {
+            stall.window_events[i] -= oldest & 1;
+        }
+    }
+    else
+    {
+        ++stall.count;
+    }
+    stall.onsets[stall.head] = onsets;
+    stall.head = (stall.head + 1) % stall.depth;
+
+    for (int i = 0; i < STALL_NUM_SS; ++i)
+    {
+        if ((onsets >> i) & 1)
+        {
+            ++stall.events[i];
+            ++stall.window_events[i];
+            stall.cc_events[i] += near_cc_change;
+            stall.onset[i] = now;
+        }
+        else if ((ends >> i) & 1)
+        {
+            uint64_t d = now - stall.onset[i];
+            stall.duration[i] += d;
+            stall.max_duration[i] = (d > stall.max_duration[i]) ? d : stall.max_duration[i];
+        }
+    }
+
+    if (onsets | ends)
+    {
+        xorif_record_stall(flags, onsets, now);
+    }
+    stall.flags = flags;
+    stall.last = now;
+    ++stall.samples;
+
+    // Trigger the recovery action when any spatial stream exceeds the threshold
+    if (stall.threshold && onsets)
+    {
+        for (int i = 0; i < STALL_NUM_SS; ++i)
+        {
+            if (stall.window_events[i] >= stall.threshold)
+            {
+                *events = stall.window_events[i];
+                ++stall.recoveries;
+                stall.last_recovery = stall.last;
+                stall.head = 0;
+                stall.count = 0;
+                memset(stall.window_events, 0, sizeof(stall.window_events));
+                return i;
+            }
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Perform the stall sampler recovery action (called without the lock).
+ * @param[in] i Spatial stream (bit) that crossed the threshold
+ * @param[in] action Recovery action
+ * @param[in] events Number of stall events in the window
+ * @param[in] window_ms Sliding window
+ * @note
+ * The register writes and messages are kept outside the lock, which the
+ * interrupt handler's carrier change notification also uses.
+ */
+static void stall_recovery(int i, uint16_t action, uint32_t events, uint32_t window_ms)
+{
+    int t = NUM_STALL_TYPES - 1;
+    while (i < stall_types[t].base)
+    {
+        --t;
+    }
+    const char *name = stall_types[t].name;
+    int ss = i - stall_types[t].base;
+    (void)name; // Only used for messages
+    (void)ss;
+    (void)events;
+    (void)window_ms;
+
+    xorif_recorder_trigger(RECORDER_TRIGGER_STALL, i, NULL);
+
+    switch (action)
+    {
+    case STALL_ACTION_LOG:
+        PERROR("Stall threshold exceeded (%s spatial stream %d, %d events in %d ms)\n", name, ss, events, window_ms);
+        break;
+
+    case STALL_ACTION_RESTART_FRAMER:
+        INFO("Stall threshold exceeded (%s spatial stream %d), restarting framer\n", name, ss);
+        WRITE_REG(FRAM_DISABLE, 1);
+        WRITE_REG(FRAM_DISABLE, 0);
+        break;
+
+    case STALL_ACTION_RESTART_DATAPIPE:
+        INFO("Stall threshold exceeded (%s spatial stream %d), restarting data-pipe\n", name, ss);
+        WRITE_REG(FRAM_DISABLE, 1);
+        xorif_stats_restart();
+        WRITE_REG(DEFM_RESTART, 1);
+        WRITE_REG(FRAM_DISABLE, 0);
+        WRITE_REG(DEFM_RESTART, 0);
+        break;
+
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Stall sampler thread.
+ * @param[in] arg Not used
+ * @returns
+ *      - NULL
+ */
+static void *stall_thread(void *arg)
+{
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+
+    pthread_mutex_lock(&stall.lock);
+    while (!stall.stop)
+    {
+        // Wait until the next sample time (or a request to stop)
+        next.tv_nsec += (stall.period_ms % 1000) * 1000000L;
+        next.tv_sec += stall.period_ms / 1000 + next.tv_nsec / 1000000000L;
+        next.tv_nsec %= 1000000000L;
+        int rc = 0;
+        while (!stall.stop && (rc != ETIMEDOUT))
+        {
+            rc = pthread_cond_timedwait(&stall.wake, &stall.lock, &next);
+        }
+
+        if (!stall.stop)
+        {
+            uint32_t events;
+            int i = stall_sample(&events);
+            if (i >= 0)
+            {
+                uint16_t action = stall.action;
+                uint32_t window_ms = stall.window_ms;
+                pthread_mutex_unlock(&stall.lock);
+                stall_recovery(i, action, events, window_ms);
+                pthread_mutex_lock(&stall.lock);
+            }
+        }
+    }
+    pthread_mutex_unlock(&stall.lock);
+
+    return NULL;
+}
+
+/**
+ * @brief Check the component carrier and Ethernet port for an arrival-time histogram.
+ * @param[in] cc Component carrier
+ * @param[in] port Ethernet port
+ * @returns
+ *      - XORIF_SUCCESS on success
+ *      - Error code on failure
+ */
+static int check_arrival(uint16_t cc, int port)
+{
+    if (cc >= MAX_NUM_CC || cc >= xorif_fhi_get_max_cc())
+    {
+        PERROR("Invalid CC value\n");
+        return XORIF_INVALID_CC;
+    }
+    else if ((port < 0) || (port >= xorif_fhi_get_num_eth_ports()) || (port >= MAX_NUM_ETH_PORTS))
+    {
+        PERROR("Invalid Ethernet port value\n");
+        return XORIF_INVALID_ETH_PORT;
+    }
+    return XORIF_SUCCESS;
+}
+
+/**
+ * @brief Clear the arrival-time histograms, and set new hardware baselines (called with the lock held).
+ * @param[in] base Port totals (read by the caller before taking the lock)
+ */
+static void clear_arrival(const struct xorif_fhi_eth_stats *base)
+{
+    memset(arrival.bins, 0, MAX_NUM_CC * MAX_NUM_ETH_PORTS * arrival.num_bins * sizeof(uint64_t));
+    memset(arrival.hist, 0, sizeof(arrival.hist));
+    memcpy(arrival.base, base, sizeof(arrival.base));
+}
+
+/**
+ * @brief Add arrival offsets to a histogram (called with the lock held, when configured).
+ * @param[in] cc Component carrier
+ * @param[in] port Ethernet port
+ * @param[in] num Number of samples
+ * @param[in] offsets Array of arrival offsets (ns)
+ */
+static void add_arrival(uint16_t cc, int port, uint16_t num, const int32_t offsets[])
+{
+    uint64_t *bins = &arrival.bins[(cc * MAX_NUM_ETH_PORTS + port) * arrival.num_bins];
+    struct arrival_hist *h = &arrival.hist[cc][port];
+    for (int i = 0; i < num; ++i)
+    {
+        int64_t offset = offsets[i];
+        int64_t bin = offset - arrival.origin_ns;
+        bin = (bin < 0) ? -1 : bin / arrival.bin_width_ns;
+        if (bin < 0)
+        {
+            ++h->underflow;
+        }
+        else if (bin >= arrival.num_bins)
+        {
+            ++h->overflow;
+        }
+        else
+        {
+            ++bins[bin];
+        }
+        h->min = (!h->samples || (offsets[i] < h->min)) ? offsets[i] : h->min;
+        h->max = (!h->samples || (offsets[i] > h->max)) ? offsets[i] : h->max;
+        h->sum += offset;
+        ++h->samples;
+    }
+}
+
+/**
+ * @brief Calculate a percentile of an arrival-time histogram (called with the lock held, with samples).
+ * @param[in] cc Component carrier
+ * @param[in] port Ethernet port
+ * @param[in] percentile Percentile (0 to 100)
+ * @returns
+ *      - Arrival offset (ns), interpolated within the bin
+ */
+static int32_t arrival_percentile(uint16_t cc, int port, double percentile)
+{
+    const uint64_t *bins = &arrival.bins[(cc * MAX_NUM_ETH_PORTS + port) * arrival.num_bins];
+    const struct arrival_hist *h = &arrival.hist[cc][port];
+    double rank = percentile / 100.0 * h->samples;
+    double offset = h->max;
+
+    // Samples outside the bins are only known by the minimum / maximum
+    uint64_t count = h->underflow;
+    if (rank <= count)
+    {
+        return h->min;
+    }
+    for (int i = 0; i < arrival.num_bins; ++i)
+    {
+        if (bins[i] && (count + bins[i] >= rank))
+        {
+            double fraction = (rank - count) / bins[i];
+            offset = arrival.origin_ns + (i + fraction) * arrival.bin_width_ns;
+            break;
+        }
+        count += bins[i];
+    }
+
+    // Limit to the range of the samples
+    offset = (offset < h->min) ? h->min : offset;
+    offset = (offset > h->max) ? h->max : offset;
+    return (int32_t)offset;
+}
+
+/** @} */
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2020 - 2023 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file xorif_stats.h
+ * @author Steven Dickinson
+ * @brief Header file for libxorif statistics functions/definitions.
+ * @addtogroup libxorif
+ * @{
+ */
+
+#ifndef XORIF_STATS_H
+#define XORIF_STATS_H
+
+#include <inttypes.h>
+#include "xorif_api.h"
+
+/*******************************************/
+/*** Constants / macros / structs / etc. ***/
+/*******************************************/
+
+#define STATS_MAX_DEPTH 4096   /**< Maximum number of samples held by the statistics collector */
+#define STATS_MAX_CONSUMERS 16 /**< Maximum number of statistics consumer handles */
+#define MONITOR_MAX_COUNTERS 64 /**< Maximum number of "monitor block" counters per sample */
+
+/***************************/
+/*** Function prototypes ***/
+/***************************/
+
+/**
+ * @brief Clear the statistics counters (hardware and software accumulators).
+ * @note
+ * Any samples held by the statistics collector are discarded, and the reset
+ * epoch is incremented. The counts so far are kept for the consumers.
+ */
+void xorif_stats_clear(void);
+
+/**
+ * @brief Notify the statistics functions that the data-pipe is about to be restarted.
+ * @note
+ * Call before restarting the data-pipe (DEFM_RESTART), which restarts the
+ * hardware counters. The counts so far are accumulated (if the collector is
+ * running or there are consumers) and the reset epoch is incremented.
+ * Not for the interrupt handler (see #xorif_stats_restart_async).
+ */
+void xorif_stats_restart(void);
+
+/**
+ * @brief Notify the statistics functions that the data-pipe has been restarted
+ * (from the interrupt handler).
+ * @note
+ * Call once the data-pipe restart (DEFM_RESTART) is asserted. It's lock-free,
+ * and only flags the restart: the next read (by the collector or a reader)
+ * counts the hardware counters from 0 and increments the reset epoch. The
+ * counts between the previous read and the restart are not seen.
+ */
+void xorif_stats_restart_async(void);
+
+/**
+ * @brief Notify the stall sampler of a carrier change (enable / disable / re-configure).
+ * @note
+ * Used to count stall events that start soon after a carrier change.
+ */
+void xorif_stall_cc_change(void);
+
+/**
+ * @brief Lock the "monitor block" (shared by the single counter reads and the monitor stream).
+ * @note
+ * The select / snapshot / read sequence uses shared registers, so it must not
+ * interleave with the monitor stream thread or a bulk read.
+ */
+void xorif_monitor_lock(void);
+
+/**
+ * @brief Unlock the "monitor block" (see #xorif_monitor_lock).
+ */
+void xorif_monitor_unlock(void);
+
+/**
+ * @brief Record a counter sample for each port in the flight recorder (called by the recorder thread).
+ * @note
+ * Does nothing when the statistics collector is running (it records its own samples).
+ */
+void xorif_stats_record_sample(void);
+
+#endif /* XORIF_STATS_H */
+
+/** @} */
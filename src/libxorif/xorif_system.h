@@ -34,7 +34,8 @@
 
 // System constants
 #define NUM_NUMEROLOGY 5 /**< Number of numerologies */
-#define MAX_NUM_CC 8     /**< Maximum number of component carriers */
+#define MAX_NUM_CC 16    /**< Maximum number of component carriers (16-bit CC enable / reload masks) */
+#define MAX_NUM_ETH_PORTS 8 /**< Maximum number of Ethernet ports with shadowed (per-port) tables */
 #define MAX_NUM_RBS 275  /**< Maximum number of RBs supported per CC */
 #define MIN_NUM_RBS 1    /**< Minimum number of RBs supported per CC */
 #define SSB_NUM_RBS 20   /**< Number of RBs for SSB */
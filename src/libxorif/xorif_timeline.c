@@ -0,0 +1,377 @@
+/*
+ * Copyright 2020 - 2023 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file xorif_timeline.c
+ * @author Steven Dickinson
+ * @brief Source file for libxorif timeline (span instrumentation) functions.
+ * @addtogroup libxorif
+ * @{
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include "xorif_common.h"
+#include "xorif_timeline.h"
+
+// Timeline span (written by the thread that owns it, "end" last)
+struct span
+{
+    const char *name;     // Span name
+    const char *category; // Span category
+    const char *arg_name; // Argument name (NULL = none)
+    int32_t arg;          // Argument value
+    uint32_t tid;         // Thread ID
+    uint32_t writes;      // Register write count at the start (at the end, once finished)
+    uint64_t start;       // Start time (ns, monotonic clock)
+    uint64_t end;         // End time (ns, monotonic clock, 0 = not finished)
+};
+
+// Span handles hold the capture generation (above the index), so the spans
+// still open from an earlier capture are ignored when they end
+#define SPAN_INDEX_BITS 20 // Enough for TIMELINE_MAX_EVENTS - 1
+#define SPAN_INDEX_MASK ((1U << SPAN_INDEX_BITS) - 1)
+#define SPAN_GEN_MASK 0x3FF // Keeps the handles positive
+
+// Timeline (lock-free, multiple producers)
+// Each producer claims the next span, and capture stops when it's full
+// Note, the producers count themselves "busy" whilst they're writing a span,
+// and a restart waits for them before the spans are re-used (or freed)
+static struct
+{
+    int enabled;         // Capturing
+    uint32_t busy;       // Number of producers writing a span
+    uint32_t gen;        // Capture generation
+    uint32_t next;       // Next span to claim (can exceed the capacity, the excess are lost)
+    uint32_t capacity;   // Number of spans allocated
+    uint64_t origin;     // Time the timeline was started (ns)
+    struct span *spans;  // Spans
+} timeline;
+
+// Serializes the API functions
+static pthread_mutex_t timeline_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Register writes made by the calling thread, and its thread ID (0 = not read yet)
+static __thread uint32_t thread_writes;
+static __thread uint32_t thread_id;
+
+// Local function prototypes...
+
+static uint64_t time_ns(void);
+static void write_string(FILE *fp, const char *str);
+static void write_span(FILE *fp, const struct span *ptr, uint64_t end, int pid);
+
+// API functions...
+
+int xorif_start_timeline(uint32_t max_events)
+{
+    TRACE("xorif_start_timeline(%u)\n", max_events);
+
+    if (max_events > TIMELINE_MAX_EVENTS)
+    {
+        PERROR("Timeline size exceeds maximum (%u)\n", TIMELINE_MAX_EVENTS);
+        return XORIF_INVALID_CONFIG;
+    }
+    else if (max_events == 0)
+    {
+        max_events = TIMELINE_DEFAULT_EVENTS;
+    }
+
+    pthread_mutex_lock(&timeline_lock);
+    __atomic_store_n(&timeline.enabled, 0, __ATOMIC_SEQ_CST);
+
+    // Orphan the spans still open (from the last capture), and wait for any
+    // producer that's writing a span
+    __atomic_store_n(&timeline.gen, (timeline.gen + 1) & SPAN_GEN_MASK, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&timeline.busy, __ATOMIC_SEQ_CST))
+    {
+        sched_yield();
+    }
+
+    if (max_events != timeline.capacity)
+    {
+        struct span *spans = malloc(max_events * sizeof(struct span));
+        if (!spans)
+        {
+            pthread_mutex_unlock(&timeline_lock);
+            PERROR("Failed to allocate timeline\n");
+            return XORIF_MEMORY_ALLOCATION_FAIL;
+        }
+        free(timeline.spans);
+        timeline.spans = spans;
+        timeline.capacity = max_events;
+    }
+    memset(timeline.spans, 0, max_events * sizeof(struct span));
+    timeline.origin = time_ns();
+    __atomic_store_n(&timeline.next, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&timeline.enabled, 1, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&timeline_lock);
+
+    return XORIF_SUCCESS;
+}
+
+int xorif_stop_timeline(void)
+{
+    TRACE("xorif_stop_timeline()\n");
+
+    pthread_mutex_lock(&timeline_lock);
+    __atomic_store_n(&timeline.enabled, 0, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&timeline_lock);
+
+    return XORIF_SUCCESS;
+}
+
+int xorif_write_timeline(const char *file)
+{
+    TRACE("xorif_write_timeline(%s)\n", file ? file : "NULL");
+
+    if (!file)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+
+    FILE *fp = fopen(file, "w");
+    if (!fp)
+    {
+        PERROR("Can't open timeline file '%s'\n", file);
+        return XORIF_INVALID_CONFIG;
+    }
+
+    int pid = getpid();
+    uint32_t sw_version = xorif_get_sw_version();
+
+    pthread_mutex_lock(&timeline_lock);
+    uint32_t num = __atomic_load_n(&timeline.next, __ATOMIC_ACQUIRE);
+    uint32_t lost = (num > timeline.capacity) ? num - timeline.capacity : 0;
+    num -= lost;
+
+    fprintf(fp, "{\"displayTimeUnit\":\"ns\",\n");
+    fprintf(fp, "\"otherData\":{\"library\":\"libxorif\",\"sw_version\":\"0x%08X\",\"lost_spans\":%u},\n", sw_version, lost);
+    fprintf(fp, "\"traceEvents\":[\n");
+    fprintf(fp, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"libxorif\"}}", pid, pid);
+    for (uint32_t i = 0; i < num; ++i)
+    {
+        const struct span *ptr = &timeline.spans[i];
+
+        // A span that's been claimed, but not started yet, has no time
+        if (__atomic_load_n(&ptr->start, __ATOMIC_ACQUIRE) == 0)
+        {
+            continue;
+        }
+        fprintf(fp, ",\n");
+        write_span(fp, ptr, __atomic_load_n(&ptr->end, __ATOMIC_ACQUIRE), pid);
+    }
+    fprintf(fp, "\n]}\n");
+    pthread_mutex_unlock(&timeline_lock);
+
+    if (fclose(fp) != 0)
+    {
+        PERROR("Failed to write timeline file '%s'\n", file);
+        return XORIF_FAILURE;
+    }
+
+    INFO("Timeline written to '%s' (%u spans)\n", file, num);
+    return XORIF_SUCCESS;
+}
+
+int xorif_get_timeline_status(struct xorif_timeline_status *ptr)
+{
+    TRACE("xorif_get_timeline_status(...)\n");
+
+    if (!ptr)
+    {
+        PERROR("Null pointer\n");
+        return XORIF_NULL_POINTER;
+    }
+
+    pthread_mutex_lock(&timeline_lock);
+    uint32_t num = __atomic_load_n(&timeline.next, __ATOMIC_ACQUIRE);
+    ptr->enabled = __atomic_load_n(&timeline.enabled, __ATOMIC_ACQUIRE);
+    ptr->capacity = timeline.capacity;
+    ptr->lost = (num > timeline.capacity) ? num - timeline.capacity : 0;
+    ptr->spans = num - ptr->lost;
+    ptr->open = 0;
+    for (uint32_t i = 0; i < ptr->spans; ++i)
+    {
+        if (__atomic_load_n(&timeline.spans[i].end, __ATOMIC_ACQUIRE) == 0)
+        {
+            ++ptr->open;
+        }
+    }
+    pthread_mutex_unlock(&timeline_lock);
+
+    return XORIF_SUCCESS;
+}
+
+// Internal functions...
+
+int xorif_span_begin(const char *name, const char *category, const char *arg_name, int32_t arg)
+{
+    if (!__atomic_load_n(&timeline.enabled, __ATOMIC_ACQUIRE))
+    {
+        return -1;
+    }
+
+    // Check again once busy (the timeline may have been restarted)
+    __atomic_add_fetch(&timeline.busy, 1, __ATOMIC_SEQ_CST);
+    if (!__atomic_load_n(&timeline.enabled, __ATOMIC_SEQ_CST))
+    {
+        __atomic_sub_fetch(&timeline.busy, 1, __ATOMIC_RELEASE);
+        return -1;
+    }
+
+    uint32_t gen = __atomic_load_n(&timeline.gen, __ATOMIC_RELAXED);
+    uint32_t index = __atomic_fetch_add(&timeline.next, 1, __ATOMIC_RELAXED);
+    if (index >= timeline.capacity)
+    {
+        __atomic_sub_fetch(&timeline.busy, 1, __ATOMIC_RELEASE);
+        return -1;
+    }
+
+    if (thread_id == 0)
+    {
+        thread_id = syscall(SYS_gettid);
+    }
+
+    struct span *ptr = &timeline.spans[index];
+    ptr->name = name;
+    ptr->category = category;
+    ptr->arg_name = arg_name;
+    ptr->arg = arg;
+    ptr->tid = thread_id;
+    ptr->writes = thread_writes;
+    __atomic_store_n(&ptr->end, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&ptr->start, time_ns(), __ATOMIC_RELEASE);
+    __atomic_sub_fetch(&timeline.busy, 1, __ATOMIC_RELEASE);
+    return (gen << SPAN_INDEX_BITS) | index;
+}
+
+void xorif_span_end(int span)
+{
+    if (span < 0)
+    {
+        return;
+    }
+
+    // Ignore the span if it's from an earlier capture
+    __atomic_add_fetch(&timeline.busy, 1, __ATOMIC_SEQ_CST);
+    uint32_t index = span & SPAN_INDEX_MASK;
+    if ((((uint32_t)span >> SPAN_INDEX_BITS) == __atomic_load_n(&timeline.gen, __ATOMIC_SEQ_CST)) &&
+        (index < timeline.capacity))
+    {
+        struct span *ptr = &timeline.spans[index];
+        ptr->writes = thread_writes - ptr->writes;
+        __atomic_store_n(&ptr->end, time_ns(), __ATOMIC_RELEASE);
+    }
+    __atomic_sub_fetch(&timeline.busy, 1, __ATOMIC_RELEASE);
+}
+
+int xorif_span_next(int span, const char *name, const char *category)
+{
+    xorif_span_end(span);
+    return name ? xorif_span_begin(name, category, NULL, 0) : -1;
+}
+
+void xorif_span_cleanup(int *span)
+{
+    xorif_span_end(*span);
+}
+
+void xorif_span_reg_write(void)
+{
+    ++thread_writes;
+}
+
+// Local functions...
+
+/**
+ * @brief Read the monotonic clock.
+ * @returns
+ *      - Time in nanoseconds
+ */
+static uint64_t time_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * @brief Write a string as a JSON string (quoted, and escaped).
+ * @param[in] fp File pointer
+ * @param[in] str String
+ */
+static void write_string(FILE *fp, const char *str)
+{
+    fputc('"', fp);
+    for (; *str; ++str)
+    {
+        if ((*str == '"') || (*str == '\\'))
+        {
+            fputc('\\', fp);
+            fputc(*str, fp);
+        }
+        else if ((unsigned char)*str < 0x20)
+        {
+            fprintf(fp, "\\u%04x", (unsigned char)*str);
+        }
+        else
+        {
+            fputc(*str, fp);
+        }
+    }
+    fputc('"', fp);
+}
+
+/**
+ * @brief Write a span as a trace event.
+ * @param[in] fp File pointer
+ * @param[in] ptr Pointer to span
+ * @param[in] end End time (ns, 0 = not finished)
+ * @param[in] pid Process ID
+ * @note
+ * A finished span is a "complete" event (with the number of register writes),
+ * otherwise it's a "begin" event. Times are in microseconds.
+ */
+static void write_span(FILE *fp, const struct span *ptr, uint64_t end, int pid)
+{
+    fprintf(fp, "{\"name\":");
+    write_string(fp, ptr->name);
+    fprintf(fp, ",\"cat\":");
+    write_string(fp, ptr->category);
+    fprintf(fp, ",\"ph\":\"%s\",\"ts\":%.3f", end ? "X" : "B", (ptr->start - timeline.origin) / 1000.0);
+    if (end)
+    {
+        fprintf(fp, ",\"dur\":%.3f", (end - ptr->start) / 1000.0);
+    }
+    fprintf(fp, ",\"pid\":%d,\"tid\":%u,\"args\":{", pid, ptr->tid);
+    if (ptr->arg_name)
+    {
+        write_string(fp, ptr->arg_name);
+        fprintf(fp, ":%d%s", ptr->arg, end ? "," : "");
+    }
+    if (end)
+    {
+        fprintf(fp, "\"reg_writes\":%u", ptr->writes);
+    }
+    fprintf(fp, "}}");
+}
+
+/** @} */
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2020 - 2023 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file xorif_timeline.h
+ * @author Steven Dickinson
+ * @brief Header file for libxorif timeline (span instrumentation) functions/definitions.
+ * @addtogroup libxorif
+ * @{
+ */
+
+#ifndef XORIF_TIMELINE_H
+#define XORIF_TIMELINE_H
+
+#include <inttypes.h>
+
+/*******************************************/
+/*** Constants / macros / structs / etc. ***/
+/*******************************************/
+
+/**
+ * @brief Span covering the rest of the enclosing scope (ended automatically, including early returns).
+ * @param name Span name (static string, e.g. __func__)
+ * @param category Span category (e.g. "init", "cc", "ru_ports", "ocp")
+ * @param arg_name Argument name (or NULL for none)
+ * @param arg Argument value
+ * @note
+ * Only one per scope. It also declares the current phase (see #SPAN_PHASE).
+ */
+#define SPAN_SCOPE(name, category, arg_name, arg)                                                          \
+    int scoped_span __attribute__((cleanup(xorif_span_cleanup), unused)) =                                 \
+            xorif_span_begin(name, category, arg_name, arg),                                               \
+        scoped_phase __attribute__((cleanup(xorif_span_cleanup), unused)) = -1
+
+/**
+ * @brief Begin the next phase within a #SPAN_SCOPE span (ending the current phase).
+ * @param name Phase name (static string)
+ * @param category Phase category (static string)
+ * @note
+ * The last phase ends with #SPAN_PHASE_END, or when the span ends.
+ */
+#define SPAN_PHASE(name, category) scoped_phase = xorif_span_next(scoped_phase, name, category)
+
+/**
+ * @brief End the current phase within a #SPAN_SCOPE span.
+ */
+#define SPAN_PHASE_END() scoped_phase = xorif_span_next(scoped_phase, NULL, NULL)
+
+/***************************/
+/*** Function prototypes ***/
+/***************************/
+
+/**
+ * @brief Begin a span (if the timeline is capturing).
+ * @param[in] name Span name (static string, it isn't copied)
+ * @param[in] category Span category (static string)
+ * @param[in] arg_name Argument name (static string, or NULL for none)
+ * @param[in] arg Argument value
+ * @returns
+ *      - Span handle (or -1 if not captured)
+ */
+int xorif_span_begin(const char *name, const char *category, const char *arg_name, int32_t arg);
+
+/**
+ * @brief End a span.
+ * @param[in] span Span handle (from #xorif_span_begin, -1 or a span from an earlier capture is ignored)
+ */
+void xorif_span_end(int span);
+
+/**
+ * @brief End a span, and begin the next one (e.g. the next phase of an operation).
+ * @param[in] span Span handle (from #xorif_span_begin, -1 is ignored)
+ * @param[in] name Next span name (static string, or NULL for none)
+ * @param[in] category Next span category (static string)
+ * @returns
+ *      - Next span handle (or -1 if not captured)
+ */
+int xorif_span_next(int span, const char *name, const char *category);
+
+/**
+ * @brief End a span when it goes out of scope (see #SPAN_SCOPE).
+ * @param[in] span Pointer to span handle
+ */
+void xorif_span_cleanup(int *span);
+
+/**
+ * @brief Count a register write against the spans of the calling thread.
+ */
+void xorif_span_reg_write(void);
+
+#endif /* XORIF_TIMELINE_H */
+
+/** @} */
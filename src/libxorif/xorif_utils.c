@@ -260,7 +260,7 @@ int check_numerology(uint16_t numerology, uint16_t extended_cp)
         // Extended CP requested for numerology other than 2
         return 0;
     }
-    else if (extended_cp && !fhi_caps.extended_cp)
+    else if (extended_cp && !FHI_CAPS.extended_cp)
     {
         // Extended CP requested when it's not supported
         return 0;
@@ -268,7 +268,7 @@ int check_numerology(uint16_t numerology, uint16_t extended_cp)
     else
     {
         // Check requested numerology against support mask
-        return ((1 << numerology) & fhi_caps.numerologies);
+        return ((1 << numerology) & FHI_CAPS.numerologies);
     }
 }
 
@@ -282,14 +282,14 @@ int check_iq_comp_mode(uint16_t bit_width, enum xorif_iq_comp comp_method, enum
     // Get capabilities based on channel type
     if ((chan == CHAN_DL) || (chan == CHAN_SSB))
     {
-        methods = fhi_caps.iq_de_comp_methods;
-        bfp_widths = fhi_caps.iq_de_comp_bfp_widths;
-        mod_widths = fhi_caps.iq_de_comp_mod_widths;
+        methods = FHI_CAPS.iq_de_comp_methods;
+        bfp_widths = FHI_CAPS.iq_de_comp_bfp_widths;
+        mod_widths = FHI_CAPS.iq_de_comp_mod_widths;
     }
     else if ((chan == CHAN_UL) || (chan == CHAN_PRACH))
     {
-        methods = fhi_caps.iq_comp_methods;
-        bfp_widths = fhi_caps.iq_comp_bfp_widths;
+        methods = FHI_CAPS.iq_comp_methods;
+        bfp_widths = FHI_CAPS.iq_comp_bfp_widths;
     }
     else
     {
@@ -354,6 +354,18 @@ const char *binary_mask_string(uint32_t value, uint32_t mask, uint16_t length)
     return s;
 }
 
+uint16_t bits_for_count(uint32_t n)
+{
+    uint16_t bits = 0;
+
+    while ((1U << bits) < n)
+    {
+        ++bits;
+    }
+
+    return bits;
+}
+
 void *init_memory_allocator(void **ptr, uint16_t offset, uint16_t size)
 {
     block_t *p;
@@ -384,42 +396,133 @@ void *init_memory_allocator(void **ptr, uint16_t offset, uint16_t size)
     return (void *)p;
 }
 
-int alloc_block(void *ptr, uint16_t size, uint16_t tag)
+/**
+ * @brief Claim the start of a free block for the specified tag.
+ * @param[in,out] p Free block (must be at least 'size' long)
+ * @param[in] size Size of required block
+ * @param[in] tag Tag for block
+ * @returns
+ *      - Offset of allocated block
+ *      - -1 if the block can't be split
+ */
+static int claim_block(block_t *p, uint16_t size, uint16_t tag)
 {
-    // Scan list of blocks
+    if (p->size == size)
+    {
+        // Free block is exact size
+        p->tag = tag;
+    }
+    else
+    {
+        // Free block is larger, so split it into 'p' and 'q'
+        // 'p' becomes the used block, and 'q' becomes the free block
+        // with 'q' linked after 'p'
+        block_t *q = calloc(1, sizeof(block_t));
+        if (!q)
+        {
+            // Unable to allocate!
+            return -1;
+        }
+
+        // Adjust 'p' & 'q' accordingly
+        q->offset = p->offset + size;
+        q->size = p->size - size;
+        q->tag = FREE;
+        q->next = p->next;
+        p->size = size;
+        p->tag = tag;
+        p->next = q;
+    }
+    return p->offset;
+}
+
+/**
+ * @brief Find the smallest free block that can hold the required size.
+ * @param[in] ptr Memory allocation pointer
+ * @param[in] size Size of required block
+ * @returns
+ *      - Pointer to the free block
+ *      - NULL if no free block is big enough
+ */
+static block_t *find_best_fit(void *ptr, uint16_t size)
+{
+    block_t *best = NULL;
     block_t *p = (block_t *)ptr;
     while (p != NULL)
     {
-        // Using "first fit" approach
         if ((p->tag == FREE) && (p->size >= size))
         {
-            if (p->size == size)
+            if (!best || (p->size < best->size))
             {
-                // Free block is exact size
-                p->tag = tag;
+                best = p;
             }
-            else
-            {
-                // Free block is larger, so split it into 'p' and 'q'
-                // 'p' becomes the used block, and 'q' becomes the free block
-                // with 'q' linked after 'p'
-                block_t *q = calloc(1, sizeof(block_t));
-                if (!q)
-                {
-                    // Unable to allocate!
-                    return -1;
-                }
+        }
+        p = p->next;
+    }
+    return best;
+}
 
-                // Adjust 'p' & 'q' accordingly
-                q->offset = p->offset + size;
-                q->size = p->size - size;
-                q->tag = FREE;
-                q->next = p->next;
-                p->size = size;
-                p->tag = tag;
-                p->next = q;
-            }
-            return p->offset;
+/**
+ * @brief Find the smallest free region that can hold the required size,
+ * counting the blocks held by the specified tag as free.
+ * @param[in] ptr Memory allocation pointer
+ * @param[in] size Size of required block
+ * @param[in] tag Tag whose blocks would be released
+ * @param[out] largest Size of the largest free region
+ * @returns
+ *      - Offset of the region
+ *      - -1 if no region is big enough
+ * @note
+ * Adjacent free blocks (and blocks held by the tag) form a single region,
+ * as they would after dealloc_block() merges them.
+ */
+static int find_free_region(void *ptr, uint16_t size, uint16_t tag, uint16_t *largest)
+{
+    int best = -1;
+    uint16_t best_size = 0;
+    *largest = 0;
+
+    block_t *p = (block_t *)ptr;
+    while (p != NULL)
+    {
+        if ((p->tag != FREE) && (p->tag != tag))
+        {
+            p = p->next;
+            continue;
+        }
+
+        // Merge the run of free blocks
+        uint16_t offset = p->offset;
+        uint16_t run = 0;
+        while ((p != NULL) && ((p->tag == FREE) || (p->tag == tag)))
+        {
+            run += p->size;
+            p = p->next;
+        }
+
+        if (run > *largest)
+        {
+            *largest = run;
+        }
+        if ((run >= size) && ((best == -1) || (run < best_size)))
+        {
+            best = offset;
+            best_size = run;
+        }
+    }
+    return best;
+}
+
+int alloc_block(void *ptr, uint16_t size, uint16_t tag)
+{
+    // Scan list of blocks
+    block_t *p = (block_t *)ptr;
+    while (p != NULL)
+    {
+        // Using "first fit" approach
+        if ((p->tag == FREE) && (p->size >= size))
+        {
+            return claim_block(p, size, tag);
         }
         p = p->next;
     }
@@ -428,6 +531,25 @@ int alloc_block(void *ptr, uint16_t size, uint16_t tag)
     return -1;
 }
 
+int alloc_block_best_fit(void *ptr, uint16_t size, uint16_t tag)
+{
+    block_t *p = find_best_fit(ptr, size);
+    return p ? claim_block(p, size, tag) : -1;
+}
+
+int find_free_block(void *ptr, uint16_t size, uint16_t tag)
+{
+    uint16_t largest;
+    return find_free_region(ptr, size, tag, &largest);
+}
+
+uint16_t get_largest_free_block(void *ptr, uint16_t tag)
+{
+    uint16_t largest;
+    find_free_region(ptr, 0, tag, &largest);
+    return largest;
+}
+
 void dealloc_block(void *ptr, uint16_t tag)
 {
     block_t *p = (block_t *)ptr;
@@ -31,17 +31,6 @@
 /*** Constants / macros / structs / etc. ***/
 /*******************************************/
 
-/**
- * @brief Enumerated type for channel type.
- */
-enum xorif_chan_type
-{
-    CHAN_UL = 0, /**< Uplink */
-    CHAN_DL,     /**< Downlink */
-    CHAN_SSB,    /**< SSB */
-    CHAN_PRACH,  /**< PRACH */
-};
-
 typedef int (*irq_handler_t)(int id, void *data);
 
 // Macro to perform ceil(x/y)
@@ -153,6 +142,14 @@ const char *binary_string(uint32_t value, uint16_t length);
  */
 const char *binary_mask_string(uint32_t value, uint32_t mask, uint16_t length);
 
+/**
+ * @brief Calculate the number of bits needed to encode a number of values.
+ * @param[in] n Number of values
+ * @returns
+ *      - Number of bits (0 for n <= 1)
+ */
+uint16_t bits_for_count(uint32_t n);
+
 /**
  * @brief Initialize a memory allocation pointer.
  * @param[in] ptr Pointer to memory allocation pointer
@@ -185,6 +182,42 @@ void *init_memory_allocator(void **ptr, uint16_t offset, uint16_t size);
  */
 int alloc_block(void *ptr, uint16_t size, uint16_t tag);
 
+/**
+ * @brief Allocate a memory block from the total allocation (using "best fit").
+ * @param[in,out] ptr Memory allocation pointer
+ * @param[in] size Size of required block
+ * @param[in] tag Tag for block (e.g. a component carrier ID)
+ * @returns
+ *      - Offset of allocated block
+ *      - -1 if a block of the required size can't be allocated
+ * @note
+ * The smallest free block that fits is used, which keeps the larger free
+ * regions available for carriers added later.
+ */
+int alloc_block_best_fit(void *ptr, uint16_t size, uint16_t tag);
+
+/**
+ * @brief Find where alloc_block_best_fit() would place a block, if the blocks
+ * held by the specified tag were deallocated first (nothing is changed).
+ * @param[in] ptr Memory allocation pointer
+ * @param[in] size Size of required block
+ * @param[in] tag Tag whose blocks would be released (e.g. the component carrier being placed)
+ * @returns
+ *      - Offset that would be allocated
+ *      - -1 if a block of the required size can't be allocated
+ */
+int find_free_block(void *ptr, uint16_t size, uint16_t tag);
+
+/**
+ * @brief Get the size of the largest free block, if the blocks held by the
+ * specified tag were deallocated first.
+ * @param[in] ptr Memory allocation pointer
+ * @param[in] tag Tag whose blocks would be released
+ * @returns
+ *      - Size of the largest free block (0 if the memory is full)
+ */
+uint16_t get_largest_free_block(void *ptr, uint16_t tag);
+
 /**
  * @brief Deallocate a memory block (using specified tag value).
  * @param[in] ptr Memory allocation pointer
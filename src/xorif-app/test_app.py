@@ -4,6 +4,9 @@ import logging
 import subprocess
 import os
 import time
+import socket
+import urllib.request
+import pytest
 
 logger = logging.getLogger()
 
@@ -193,6 +196,67 @@ def test_app_golden_configs(app_type, bf, ocp, oprach):
         # Kill server
         proc.kill()
 
+def scrape_unix(path):
+    with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as sock:
+        sock.connect(path)
+        sock.sendall(b"GET /metrics HTTP/1.0\r\n\r\n")
+        data = b""
+        while True:
+            chunk = sock.recv(65536)
+            if not chunk:
+                break
+            data += chunk
+    header, body = data.decode().split("\r\n\r\n", 1)
+    assert header.startswith("HTTP/1.0 200 OK")
+    return body
+
+@pytest.mark.skipif("config.getoption('--app_type') != 0", reason="C xorif-app only")
+def test_app_metrics(app_type, bf, ocp, oprach):
+    # Start server with the metrics exporter on a TCP/IP port
+    proc = subprocess.Popen(["./xorif-app", "-b", "-m", "9101"])
+    time.sleep(5)
+    try:
+        with urllib.request.urlopen("http://127.0.0.1:9101/metrics") as f:
+            assert f.headers["Content-Type"].startswith("application/openmetrics-text")
+            body = f.read().decode()
+        assert "xorif_fhi_up 0\n" in body
+        assert body.endswith("# EOF\n")
+
+        do_command(client[app_type] + "-c init")
+        do_command(client[app_type] + "-c \"configure 0\"")
+        for i in range(10):
+            with urllib.request.urlopen("http://127.0.0.1:9101/metrics") as f:
+                body = f.read().decode()
+        assert "xorif_fhi_up 1\n" in body
+        assert "# TYPE xorif_fhi_oran_rx_total counter\n" in body
+        assert 'xorif_fhi_oran_rx_total_total{port="0"} 0\n' in body
+        assert "# TYPE xorif_fhi_oran_rx_bit_rate gauge\n" in body
+        assert 'xorif_fhi_alarm{alarm="axi_timeout"} 0\n' in body
+        assert 'xorif_fhi_alarm_events_total{alarm="axi_timeout"} 0\n' in body
+        assert 'xorif_fhi_pool_used{pool="ul_ctrl"}' in body
+        assert 'xorif_fhi_pool_size{pool="dl_data_buff"}' in body
+        assert body.endswith("# EOF\n")
+
+        # The command socket is still usable
+        do_command(client[app_type] + "-c \"get fhi_stats 0\"")
+        do_command(client[app_type] + "-c terminate")
+    finally:
+        # Kill server
+        proc.kill()
+
+    # Start server with the metrics exporter on a Unix socket
+    path = "/tmp/xorif-app-metrics.sock"
+    proc = subprocess.Popen(["./xorif-app", "-b", "-i", "-m", path])
+    time.sleep(5)
+    try:
+        body = scrape_unix(path)
+        assert "xorif_fhi_up 1\n" in body
+        assert body.endswith("# EOF\n")
+        do_command(client[app_type] + "-c terminate")
+    finally:
+        # Kill server
+        proc.kill()
+
 if __name__ == "__main__":
     test_app_command_line(app_type=1, bf=False, ocp=True, oprach=False)
     #test_app_example_configs(app_type=1, bf=False, ocp=False, oprach=False)
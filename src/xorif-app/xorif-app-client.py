@@ -39,6 +39,7 @@ EXIT = 2
 logger = logging.getLogger(PROG_SHORT)
 
 handles = {}
+stats_consumer = None
 commands = []
 history = []
 
@@ -328,6 +329,43 @@ def get_cmd(args):
                 print(f"{handle.xorif_get_fhi_alarms()}")
                 return SUCCESS
 
+        # get fhi_alarm_counts
+        if match(args[1], "fhi_alarm_counts"):
+            if len(args) == 2 and "FHI" in handles:
+                handle = handles["FHI"]
+                result, counts = handle.xorif_get_fhi_alarm_counts()
+                if result == SUCCESS:
+                    pprint(counts)
+                return result
+
+        # get fhi_alarm_policy <alarm>
+        if match(args[1], "fhi_alarm_policy"):
+            if len(args) == 3 and "FHI" in handles:
+                handle = handles["FHI"]
+                result, action, cc_mask = handle.xorif_get_fhi_alarm_policy(integer(args[2]))
+                if result == SUCCESS:
+                    print(f"action = {action}")
+                    print(f"cc_mask = {hex(cc_mask)}")
+                return result
+
+        # get fhi_alarm_storm
+        if match(args[1], "fhi_alarm_storm"):
+            if len(args) == 2 and "FHI" in handles:
+                handle = handles["FHI"]
+                result, stats = handle.xorif_get_fhi_alarm_storm_stats()
+                if result == SUCCESS:
+                    pprint(stats)
+                return result
+
+        # get irq_stats
+        if match(args[1], "irq_stats"):
+            if len(args) == 2 and "FHI" in handles:
+                handle = handles["FHI"]
+                result, stats = handle.xorif_get_irq_stats()
+                if result == SUCCESS:
+                    pprint(stats)
+                return result
+
         # get fhi_state
         if match(args[1], "fhi_state"):
             if len(args) == 2 and "FHI" in handles:
@@ -339,7 +377,7 @@ def get_cmd(args):
         if match(args[1], "fhi_enabled"):
             if len(args) == 2 and "FHI" in handles:
                 handle = handles["FHI"]
-                print(f"0x{handle.xorif_get_enabled_cc_mask():02x}")
+                print(f"0x{handle.xorif_get_enabled_cc_mask():04x}")
                 return SUCCESS
 
         # get fhi_cc_config <cc>
@@ -369,6 +407,21 @@ def get_cmd(args):
                     pprint(stats)
                 return result
 
+        # get fhi_stats_delta <port>
+        if match(args[1], "fhi_stats_delta"):
+            if len(args) == 3 and "FHI" in handles:
+                global stats_consumer
+                handle = handles["FHI"]
+                if stats_consumer is None:
+                    result, consumer = handle.xorif_open_stats_consumer()
+                    if result != SUCCESS:
+                        return result
+                    stats_consumer = consumer
+                result, stats = handle.xorif_read_stats_consumer(stats_consumer, integer(args[2]))
+                if result == SUCCESS:
+                    pprint(stats)
+                return result
+
         # get ocp_sw_version
         if match(args[1], "ocp_sw_version"):
             if len(args) == 2 and "OCP" in handles:
@@ -747,6 +800,20 @@ def set_cmd(args):
                 size = integer(args[2])
                 return handle.xorif_set_mtu_size(size)
 
+        # set fhi_alarm_policy <alarms> <action> [<cc_mask>]
+        if match(args[1], "fhi_alarm_policy"):
+            if len(args) in (4, 5) and "FHI" in handles:
+                handle = handles["FHI"]
+                values = [integer(x) for x in args[2:]]
+                return handle.xorif_set_fhi_alarm_policy(*values)
+
+        # set fhi_alarm_storm <threshold> <window_ms> <backoff_ms>
+        if match(args[1], "fhi_alarm_storm"):
+            if len(args) == 5 and "FHI" in handles:
+                handle = handles["FHI"]
+                values = [integer(x) for x in args[2:]]
+                return handle.xorif_set_fhi_alarm_storm(*values)
+
         # set protocol <ECPRI | 1914.3> <VLAN = 0|1> <RAW | IPv4 | IPv6> # sets packet filter
         # set protocol_alt <ECPRI | 1914.3> <VLAN = 0|1> <RAW | IPv4 | IPv6> # doesn't set packet filter
         if match(args[1], "protocol") or match(args[1], "protocol_alt"):
@@ -1024,15 +1091,21 @@ def disable_cmd(args):
 
 def clear_cmd(args):
     if len(args) == 2:
-        # clear (fhi_alarms | fhi_stats | ru_ports_table)
+        # clear (fhi_alarms | fhi_alarm_counts | fhi_stats | irq_stats | ru_ports_table)
         if "FHI" in handles:
             handle = handles["FHI"]
             if match(args[1], "fhi_alarms"):
                 handle.xorif_clear_fhi_alarms()
                 return SUCCESS
+            elif match(args[1], "fhi_alarm_counts"):
+                handle.xorif_clear_fhi_alarm_counts()
+                return SUCCESS
             elif match(args[1], "fhi_stats"):
                 handle.xorif_clear_fhi_stats()
                 return SUCCESS
+            elif match(args[1], "irq_stats"):
+                handle.xorif_clear_irq_stats()
+                return SUCCESS
             elif match(args[1], "ru_ports_table"):
                 handle.xorif_clear_ru_ports_table()
                 return SUCCESS
@@ -1160,10 +1233,56 @@ def monitor_cmd(args):
                         print(value)
                     return result
 
+    # monitor fhi read_bulk <counter> {<counter>}
+    # monitor fhi stream start <period_us> <counter> {<counter>}
+    # monitor fhi stream (read | stop)
+    if len(args) >= 4 and match(args[1], "fhi") and "FHI" in handles:
+        handle = handles["FHI"]
+        if match(args[2], "read_bulk"):
+            result, values, timestamp = handle.xorif_monitor_read_bulk([integer(x) for x in args[3:]])
+            if result == SUCCESS:
+                print(timestamp, values)
+            return result
+        elif match(args[2], "stream"):
+            if match(args[3], "start") and len(args) >= 6:
+                return handle.xorif_start_monitor_stream(integer(args[4]), [integer(x) for x in args[5:]], 1024)
+            elif match(args[3], "stop") and len(args) == 4:
+                return handle.xorif_stop_monitor_stream()
+            elif match(args[3], "read") and len(args) == 4:
+                result, samples, dropped = handle.xorif_read_monitor_stream(1024)
+                if result == SUCCESS:
+                    for sample in samples:
+                        print(sample['timestamp'], sample['values'])
+                    print(f"dropped = {dropped}")
+                return result
+
 def stall_cmd(args):
     # stall snapshot
     # stall read
-    if len(args) == 2:
+    # stall sampler start <period_ms> <window_ms> [<threshold> <action>]
+    # stall sampler (read | clear | stop)
+    if len(args) >= 3 and match(args[1], "sampler"):
+        if "FHI" in handles:
+            handle = handles["FHI"]
+            if match(args[2], "start") and len(args) in (5, 7):
+                values = [int(x, 0) for x in args[3:]]
+                return handle.xorif_start_stall_sampler(*values)
+            elif match(args[2], "stop") and len(args) == 3:
+                return handle.xorif_stop_stall_sampler()
+            elif match(args[2], "clear") and len(args) == 3:
+                return handle.xorif_clear_stall_stats()
+            elif match(args[2], "read") and len(args) == 3:
+                result, status = handle.xorif_get_stall_sampler_status()
+                if result == SUCCESS:
+                    for k, v in status.items():
+                        print(f"{k}: {v}")
+                    for t, (name, num) in enumerate((("dl", 20), ("ul", 16), ("prach", 4), ("ssb", 4), ("unsol", 4))):
+                        for ss in range(num):
+                            result, stats = handle.xorif_get_stall_stats(t, ss)
+                            if result == SUCCESS and (stats['events'] or stats['stalled']):
+                                print(f"{name}_ss[{ss}]: {stats}")
+                return result
+    elif len(args) == 2:
         if "FHI" in handles:
             handle = handles["FHI"]
             if match(args[1], "snapshot"):
@@ -1175,6 +1294,161 @@ def stall_cmd(args):
                         print(f"{k}: {bin(v)}")
                 return result
 
+def arrival_cmd(args):
+    # arrival config <bin_width_ns> <num_bins> [<origin_ns>]
+    # arrival add <cc> <port> <offset_ns> {<offset_ns>}
+    # arrival read <cc> <port>
+    # arrival percentile <cc> <port> <percentile>
+    # arrival clear
+    if len(args) >= 2 and "FHI" in handles:
+        handle = handles["FHI"]
+        if match(args[1], "config") and len(args) in (4, 5):
+            values = [int(x, 0) for x in args[2:]]
+            return handle.xorif_configure_arrival_histogram(*values)
+        elif match(args[1], "add") and len(args) >= 5:
+            offsets = [int(float(x)) for x in args[4:]]
+            return handle.xorif_add_arrival_samples(integer(args[2]), integer(args[3]), offsets)
+        elif match(args[1], "read") and len(args) == 4:
+            result, hist = handle.xorif_get_arrival_histogram(integer(args[2]), integer(args[3]))
+            if result == SUCCESS:
+                bins = hist.pop('bins')
+                for k, v in hist.items():
+                    print(f"{k}: {v}")
+                for i in range(hist['num_bins']):
+                    if bins[i]:
+                        print(f"bin[{hist['origin_ns'] + i * hist['bin_width_ns']}]: {bins[i]}")
+            return result
+        elif match(args[1], "percentile") and len(args) == 5:
+            result, offset = handle.xorif_get_arrival_percentile(integer(args[2]), integer(args[3]), float(args[4]))
+            if result == SUCCESS:
+                print(f"offset_ns = {offset}")
+            return result
+        elif match(args[1], "clear") and len(args) == 2:
+            return handle.xorif_clear_arrival_histograms()
+
+def recorder_cmd(args):
+    # recorder trigger <triggers> <alarm_mask> <post_records> [<dump_file>]
+    # recorder sampling <period_ms>
+    # recorder (fire | rearm | status)
+    # recorder dump <dump_file>
+    if len(args) >= 2 and "FHI" in handles:
+        handle = handles["FHI"]
+        if match(args[1], "trigger") and len(args) in (5, 6):
+            dump_file = args[5] if len(args) == 6 else None
+            return handle.xorif_set_recorder_trigger(integer(args[2]), integer(args[3]), integer(args[4]), dump_file)
+        elif match(args[1], "sampling") and len(args) == 3:
+            return handle.xorif_set_recorder_sampling(integer(args[2]))
+        elif match(args[1], "fire") and len(args) == 2:
+            return handle.xorif_trigger_recorder()
+        elif match(args[1], "rearm") and len(args) == 2:
+            return handle.xorif_rearm_recorder()
+        elif match(args[1], "dump") and len(args) == 3:
+            return handle.xorif_dump_recorder(args[2])
+        elif match(args[1], "status") and len(args) == 2:
+            result, status = handle.xorif_get_recorder_status()
+            if result == SUCCESS:
+                pprint(status)
+            return result
+
+def timeline_cmd(args):
+    # timeline start [<max_events>]
+    # timeline (stop | status)
+    # timeline write <file>
+    if len(args) >= 2 and "FHI" in handles:
+        handle = handles["FHI"]
+        if match(args[1], "start") and len(args) in (2, 3):
+            max_events = integer(args[2]) if len(args) == 3 else 0
+            return handle.xorif_start_timeline(max_events)
+        elif match(args[1], "stop") and len(args) == 2:
+            return handle.xorif_stop_timeline()
+        elif match(args[1], "write") and len(args) == 3:
+            return handle.xorif_write_timeline(args[2])
+        elif match(args[1], "status") and len(args) == 2:
+            result, status = handle.xorif_get_timeline_status()
+            if result == SUCCESS:
+                pprint(status)
+            return result
+
+def scrubber_cmd(args):
+    # scrubber start [<budget> [<mode>]]
+    # scrubber run [<mode>]
+    # scrubber (stop | status | log | clear)
+    if len(args) >= 2 and "FHI" in handles:
+        handle = handles["FHI"]
+        if match(args[1], "start") and len(args) in (2, 3, 4):
+            budget = integer(args[2]) if len(args) >= 3 else 0
+            mode = integer(args[3]) if len(args) == 4 else 0
+            return handle.xorif_start_scrubber(budget, mode)
+        elif match(args[1], "stop") and len(args) == 2:
+            return handle.xorif_stop_scrubber()
+        elif match(args[1], "run") and len(args) in (2, 3):
+            mode = integer(args[2]) if len(args) == 3 else 0
+            result, mismatches = handle.xorif_scrub_registers(mode)
+            if result == SUCCESS:
+                print(f"mismatches = {mismatches}")
+            return result
+        elif match(args[1], "status") and len(args) == 2:
+            result, status = handle.xorif_get_scrubber_status()
+            if result == SUCCESS:
+                pprint(status)
+            return result
+        elif match(args[1], "log") and len(args) == 2:
+            result, log = handle.xorif_get_scrubber_log()
+            if result == SUCCESS:
+                pprint(log)
+            return result
+        elif match(args[1], "clear") and len(args) == 2:
+            return handle.xorif_clear_scrubber_stats()
+
+def latency_cmd(args):
+    # latency <cc> <t12_min> <t12_max> [<t34_min> <t34_max> [<t1a_max_up> <ta4_max>]]
+    if len(args) in (4, 6, 8) and "FHI" in handles:
+        handle = handles["FHI"]
+        cc = integer(args[1])
+        delays = [float(x) for x in args[2:]]
+        if len(delays) == 2:
+            # Same transport delay in both directions
+            delays += delays
+        transport = dict(zip(("t12_min", "t12_max", "t34_min", "t34_max", "t1a_max_up", "ta4_max"), delays))
+        result, budget = handle.xorif_get_latency_budget(cc, transport)
+        if result == SUCCESS:
+            pprint(budget)
+        return result
+
+def bandwidth_cmd(args):
+    # bandwidth (cc <cc> | port <port>) <link_gbps> <mtu> <dl> <ul> [<prach> <prach_rbs> <prach_sym> [<ssb> <ssb_sym>]]
+    if len(args) in (7, 10, 12) and "FHI" in handles:
+        handle = handles["FHI"]
+        num = integer(args[2])
+        names = ("mtu", "dl_streams", "ul_streams", "prach_streams", "prach_rbs", "prach_symbols", "ssb_streams", "ssb_symbols")
+        params = dict(zip(names, [integer(x) for x in args[4:]]))
+        params["link_rate"] = float(args[3])
+        if match(args[1], "cc"):
+            result, bw = handle.xorif_get_cc_bandwidth(num, params)
+        elif match(args[1], "port"):
+            result, bw = handle.xorif_get_port_bandwidth(num, params)
+        else:
+            return
+        if result == SUCCESS:
+            pprint(bw)
+        return result
+
+def comp_advice_cmd(args):
+    # comp_advice <cc> (ul | dl | ssb | prach) <target_evm> [<modulation> <backoff> <power_range> [<num_rbs> <seed>]]
+    chans = {"ul": 0, "dl": 1, "ssb": 2, "prach": 3}
+    if len(args) in (4, 7, 9) and args[2].lower() in chans and "FHI" in handles:
+        handle = handles["FHI"]
+        cc = integer(args[1])
+        params = {"target_evm": float(args[3]), "backoff": 12}
+        if len(args) >= 7:
+            params.update(modulation=integer(args[4]), backoff=float(args[5]), power_range=float(args[6]))
+        if len(args) == 9:
+            params.update(num_rbs=integer(args[7]), seed=integer(args[8]))
+        result, advice = handle.xorif_advise_iq_compression(cc, chans[args[2].lower()], params)
+        if result == SUCCESS:
+            pprint(advice)
+        return result
+
 def activate_cmd(args):
     # activate (ocp | oprach | ...)
     if len(args) == 2:
@@ -1487,8 +1761,14 @@ cmds.append(("help", help_cmd, "Provide command help and syntax"))
 cmds.append(("help", None, "?help [<topic>]"))
 cmds.append(("activate", activate_cmd, "Activate HW, transitioning to operational state"))
 cmds.append(("activate", None, "?activate (ocp | oprach | ...)"))
+cmds.append(("arrival", arrival_cmd, "Use the UL arrival-time histograms"))
+cmds.append(("arrival", None, "?arrival config <bin_width_ns> <num_bins> [<origin_ns>]"))
+cmds.append(("arrival", None, "?arrival add <cc> <port> <offset_ns> {<offset_ns>}"))
+cmds.append(("arrival", None, "?arrival read <cc> <port>"))
+cmds.append(("arrival", None, "?arrival percentile <cc> <port> <percentile>"))
+cmds.append(("arrival", None, "?arrival clear"))
 cmds.append(("clear", clear_cmd, "Clear various status, alarms, etc."))
-cmds.append(("clear", None, "?clear (fhi_alarms | fhi_stats | ru_ports_table)"))
+cmds.append(("clear", None, "?clear (fhi_alarms | fhi_alarm_counts | fhi_stats | irq_stats | ru_ports_table)"))
 cmds.append(("clear", None, "?clear ocp_events"))
 cmds.append(("clear", None, "?clear oprach_events"))
 cmds.append(("configure", configure_cmd, "Program component carrier configuration"))
@@ -1516,6 +1796,9 @@ cmds.append(("finish", None, "?finish (fhi | ocp | ...)"))
 cmds.append(("finish", None, "?finish"))
 cmds.append(("get", get_cmd, "Get various configuration and status data from a device"))
 cmds.append(("get", None, "?get (fhi_alarms | fhi_state | fhi_enabled)"))
+cmds.append(("get", None, "?get fhi_alarm_counts"))
+cmds.append(("get", None, "?get fhi_alarm_policy <alarm>"))
+cmds.append(("get", None, "?get fhi_alarm_storm"))
 cmds.append(("get", None, "?get (fhi_capabilities | fhi_caps)"))
 cmds.append(("get", None, "?get (fhi_sw_version | fhi_hw_version | fhi_hw_internal_rev)"))
 cmds.append(("get", None, "?get (ocp_capabilities | ocp_caps)"))
@@ -1527,6 +1810,7 @@ cmds.append(("get", None, "?get (oprach_sw_version | oprach_hw_version)"))
 cmds.append(("get", None, "?get fhi_cc_alloc <cc>"))
 cmds.append(("get", None, "?get fhi_cc_config <cc>"))
 cmds.append(("get", None, "?get fhi_stats <port>"))
+cmds.append(("get", None, "?get irq_stats"))
 cmds.append(("get", None, "?get ocp_antenna_cfg"))
 cmds.append(("get", None, "?get ocp_cc_cfg <cc>"))
 cmds.append(("get", None, "?get ocp_trigger_cfg"))
@@ -1544,9 +1828,30 @@ cmds.append(("monitor", None, "?monitor (fhi | ocp | ...) clear"))
 cmds.append(("monitor", None, "?monitor (fhi | ocp | ...) read <counter>"))
 cmds.append(("monitor", None, "?monitor (fhi | ...) select <stream>"))
 cmds.append(("monitor", None, "?monitor (fhi | ocp | ...) snapshot"))
+cmds.append(("recorder", recorder_cmd, "Use the flight recorder"))
+cmds.append(("recorder", None, "?recorder trigger <triggers> <alarm_mask> <post_records> [<dump_file>]"))
+cmds.append(("recorder", None, "?recorder sampling <period_ms>"))
+cmds.append(("recorder", None, "?recorder (fire | rearm | status)"))
+cmds.append(("recorder", None, "?recorder dump <dump_file>"))
 cmds.append(("stall", stall_cmd, "Use the stall detection monitor"))
 cmds.append(("stall", None, "?stall snapshot"))
 cmds.append(("stall", None, "?stall read"))
+cmds.append(("stall", None, "?stall sampler start <period_ms> <window_ms> [<threshold> <action>]"))
+cmds.append(("stall", None, "?stall sampler (read | clear | stop)"))
+cmds.append(("timeline", timeline_cmd, "Capture a timeline of library operations"))
+cmds.append(("timeline", None, "?timeline start [<max_events>]"))
+cmds.append(("timeline", None, "?timeline (stop | status)"))
+cmds.append(("timeline", None, "?timeline write <file>"))
+cmds.append(("scrubber", scrubber_cmd, "Check the configuration registers for corruption"))
+cmds.append(("scrubber", None, "?scrubber start [<budget> [<mode>]]"))
+cmds.append(("scrubber", None, "?scrubber run [<mode>]"))
+cmds.append(("scrubber", None, "?scrubber (stop | status | log | clear)"))
+cmds.append(("latency", latency_cmd, "Calculate the latency budget of a component carrier"))
+cmds.append(("latency", None, "?latency <cc> <t12_min> <t12_max> [<t34_min> <t34_max> [<t1a_max_up> <ta4_max>]]"))
+cmds.append(("bandwidth", bandwidth_cmd, "Calculate the U-plane bit rates and packet rates"))
+cmds.append(("bandwidth", None, "?bandwidth (cc <cc> | port <port>) <link_gbps> <mtu> <dl> <ul> [<prach> <prach_rbs> <prach_sym> [<ssb> <ssb_sym>]]"))
+cmds.append(("comp_advice", comp_advice_cmd, "Recommend the narrowest IQ compression that meets a quality target"))
+cmds.append(("comp_advice", None, "?comp_advice <cc> (ul | dl | ssb | prach) <target_evm> [<modulation> <backoff> <power_range> [<num_rbs> <seed>]]"))
 cmds.append(("quit", exit_cmd, None))
 cmds.append(("read_reg", read_reg_cmd, "Read device registers"))
 cmds.append(("read_reg", None, "?read_reg (fhi | ocp | ...) <name>"))
@@ -1567,6 +1872,8 @@ cmds.append(("set", None, "?set dest_mac_addr <port> <address = XX:XX:XX:XX:XX:X
 cmds.append(("set", None, "?set dl_sections_per_sym <cc> <number_of_sections> <number_of_ctrl_words>"))
 cmds.append(("set", None, "?set dl_timing_params <cc> <delay_comp_cp> <delay_comp_up> <advance>"))
 cmds.append(("set", None, "?set eaxc_id <DU_bits> <BS_bits> <CC_bits> <RU_bits>"))
+cmds.append(("set", None, "?set fhi_alarm_policy <alarms> <action = 0..5> [<cc_mask>]"))
+cmds.append(("set", None, "?set fhi_alarm_storm <threshold> <window_ms> <backoff_ms>"))
 cmds.append(("set", None, "?set frames_per_sym <cc> <number_of_frames>"))
 cmds.append(("set", None, "?set frames_per_sym_ssb <cc> <number_of_frames>"))
 cmds.append(("set", None, "?set modu_dest_mac_addr <du> <address = XX:XX:XX:XX:XX:XX> [<id> <dei> <pcp>]"))
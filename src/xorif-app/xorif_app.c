@@ -86,11 +86,12 @@ int main(int argc, char *argv[])
     int do_init = 0;
     int do_version = 0;
     const char *file = "";
+    const char *metrics = NULL;
     int opt;
 
     // Process command line options
     opterr = 0;
-    while ((opt = getopt(argc, argv, "bcf:hin:p:svSBFIV")) != -1)
+    while ((opt = getopt(argc, argv, "bcf:him:n:p:svSBFIV")) != -1)
     {
         switch (opt)
         {
@@ -111,6 +112,9 @@ int main(int argc, char *argv[])
         case 'i':
             do_init = 1;
             break;
+        case 'm':
+            metrics = optarg;
+            break;
         case 'n':
             ip_addr_name = optarg;
             break;
@@ -143,7 +147,7 @@ int main(int argc, char *argv[])
             do_version = 1;
             break;
         case '?':
-            if (optopt == 'e' || optopt == 'f' || optopt == 'n' || optopt == 'p')
+            if (optopt == 'e' || optopt == 'f' || optopt == 'm' || optopt == 'n' || optopt == 'p')
             {
                 fprintf(stderr, "Option '-%c' requires an argument\n", optopt);
             }
@@ -183,6 +187,7 @@ int main(int argc, char *argv[])
 
         printf("\t-b Disable banner on start\n");
         printf("\t-i Auto-initialize (server mode only)\n");
+        printf("\t-m <port | path> Serve OpenMetrics on the specified port or Unix socket (server mode only)\n");
         printf("\t-v Verbose\n");
         printf("\t-V Display version of the application\n");
 
@@ -266,6 +271,7 @@ int main(int argc, char *argv[])
 #ifdef NO_HW
         fprintf(stderr, "No hardware\n");
         (void)do_init; // Prevent warning 'unused-but-set-variable'
+        (void)metrics;
         return FAILURE;
 #else
         remote_target = 0;
@@ -278,6 +284,16 @@ int main(int argc, char *argv[])
         }
         remote_host = 1;
 
+        if (metrics)
+        {
+            // Start metrics exporter (runs alongside the command socket)
+            if (start_metrics(metrics) != SUCCESS)
+            {
+                PERROR("Failed to start metrics exporter\n");
+                return FAILURE;
+            }
+        }
+
 #ifdef TEST_CALLBACK
         // Test register call-backs
         xorif_register_fhi_isr(isr_callback1);
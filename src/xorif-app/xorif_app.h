@@ -33,6 +33,7 @@
 #include <stdarg.h>
 #include <syslog.h>
 #include <unistd.h>
+#include <pthread.h>
 
 // Control codes for coloured text in console
 #define ANSI_COLOR_RED "\x1b[31m"
@@ -123,6 +124,7 @@ extern const char * const app_version_str;
 extern int no_fhi;
 extern int no_bf;
 extern int no_srs;
+extern pthread_rwlock_t library_lock;
 
 /**
  * @brief Entry point for file mode.
@@ -179,6 +181,16 @@ int send_to_target(const char *request, char *response);
  */
 int send_to_host(const char *response);
 
+/**
+ * @brief Start the metrics exporter (server side).
+ * @param[in] endpoint TCP/IP port number or Unix domain socket path
+ * @returns
+ *      - SUCCESS on success
+ *      - Error code on failure
+ * @note The exporter runs in its own thread, serving OpenMetrics text over HTTP.
+ */
+int start_metrics(const char *endpoint);
+
 #endif /* XORIF_APP_H */
 
 /** @} */
\ No newline at end of file
@@ -59,6 +59,8 @@ static int test2(const char *request, char *response);
 static int debug(const char *request, char *response);
 static int init(const char *request, char *response);
 static int finish(const char *request, char *response);
+static int init_libraries(const char *request, char *response);
+static int finish_libraries(const char *request, char *response);
 static int reset(const char *request, char *response);
 static int has(const char *request, char *response);
 static int get(const char *request, char *response);
@@ -74,6 +76,13 @@ static int write_reg_offset(const char *request, char *response);
 static int dump(const char *request, char *response);
 static int monitor(const char *request, char *response);
 static int stall(const char *request, char *response);
+static int arrival(const char *request, char *response);
+static int recorder(const char *request, char *response);
+static int timeline(const char *request, char *response);
+static int scrubber(const char *request, char *response);
+static int latency(const char *request, char *response);
+static int bandwidth(const char *request, char *response);
+static int comp_advice(const char *request, char *response);
 #ifdef EXTRA_DEBUG
 static int test_fhi(const char *request, char *response);
 #endif // EXTRA_DEBUG
@@ -162,7 +171,16 @@ const struct command command_set[] =
     {"get", NULL, "?get fhi_cc_config <cc>"},
     {"get", NULL, "?get fhi_cc_alloc <cc>"},
     {"get", NULL, "?get fhi_stats <port>"},
+    {"get", NULL, "?get fhi_stats_all # one value per port, accumulated counters"},
+    {"get", NULL, "?get fhi_stats_delta <port> # deltas since the previous 'get fhi_stats_delta'"},
     {"get", NULL, "?get (fhi_alarms | fhi_state | fhi_enabled)"},
+    {"get", NULL, "?get fhi_alarm_counts"},
+    {"get", NULL, "?get fhi_alarm_policy <alarm>"},
+    {"get", NULL, "?get fhi_alarm_storm"},
+    {"get", NULL, "?get irq_stats"},
+    {"get", NULL, "?get fhi_eaxc_layout <num_du> <num_bs> <num_cc> <num_user> <num_prach> <num_ssb>"},
+    {"get", NULL, "?get fhi_port_config <port>"},
+    {"get", NULL, "?get fhi_modu_table <port> [<du> <number>]"},
     {"set", set, "Set various configuration data for device"},
     {"set", NULL, "?set num_rbs <cc> <number_of_rbs>"},
     {"set", NULL, "?set numerology <cc> <numerology = 0..4> <extended_cp = 0|1>"},
@@ -187,9 +205,12 @@ const struct command command_set[] =
     {"set", NULL, "?set dest_mac_addr <port> <address = XX:XX:XX:XX:XX:XX>"},
     {"set", NULL, "?set src_mac_addr <port> <address = XX:XX:XX:XX:XX:XX>"},
     {"set", NULL, "?set vlan <port> <id> <dei> <pcp>"},
+    {"set", NULL, "?set cc_planned_eth_port <cc> <port>"},
     {"set", NULL, "?set modu_mode <0 = disabled | 1 = enabled>"},
     {"set", NULL, "?set modu_dest_mac_addr <du> <address = XX:XX:XX:XX:XX:XX> [<id> <dei> <pcp>]"},
     {"set", NULL, "?set mtu_size <size>"},
+    {"set", NULL, "?set fhi_alarm_policy <alarms> <action = 0..5> [<cc_mask>]"},
+    {"set", NULL, "?set fhi_alarm_storm <threshold> <window_ms> <backoff_ms>"},
     {"set", NULL, "?set protocol <ECPRI | 1914.3> <VLAN = 0|1> <RAW | IPv4 | IPv6> # sets packet filter"},
     {"set", NULL, "?set protocol_alt <ECPRI | 1914.3> <VLAN = 0|1> <RAW | IPv4 | IPv6> # doesn't set packet filter"},
     {"set", NULL, "?set packet_filter <port> <filter = (16 x 32b)> <mask = (4 x 16b)>"},
@@ -202,6 +223,7 @@ const struct command command_set[] =
     {"configure", configure, "Program component carrier configuration"},
     {"configure", NULL, "?configure <cc>"},
     {"configure", NULL, "?configure fhi <cc>"},
+    {"configure", NULL, "?configure fhi_hot_add <cc> # keeps other carriers' buffers in place"},
     {"enable", enable, "Enable component carrier"},
     {"enable", NULL, "?enable <cc>"},
     {"enable", NULL, "?enable fhi <cc>"},
@@ -209,7 +231,7 @@ const struct command command_set[] =
     {"disable", NULL, "?disable <cc>"},
     {"disable", NULL, "?disable fhi <cc>"},
     {"clear", clear, "Clear various status, alarms, etc."},
-    {"clear", NULL, "?clear (fhi_alarms | fhi_stats | ru_ports_table)"},
+    {"clear", NULL, "?clear (fhi_alarms | fhi_alarm_counts | fhi_stats | irq_stats | ru_ports_table)"},
     {"read_reg", read_reg, "Read device registers"},
     {"read_reg", NULL, "?read_reg fhi <name>"},
     {"read_reg_offset", read_reg_offset, "Read device registers (with offsets)"},
@@ -225,9 +247,39 @@ const struct command command_set[] =
     {"monitor", NULL, "?monitor fhi select <stream>"},
     {"monitor", NULL, "?monitor fhi snapshot"},
     {"monitor", NULL, "?monitor fhi read <counter>"},
+    {"monitor", NULL, "?monitor fhi read_bulk <counter> {<counter>} # single snapshot"},
+    {"monitor", NULL, "?monitor fhi stream start <period_us> <counter> {<counter>}"},
+    {"monitor", NULL, "?monitor fhi stream (read | stop)"},
     {"stall", stall, "Use the stall detection monitor"},
     {"stall", NULL, "?stall snapshot"},
     {"stall", NULL, "?stall read"},
+    {"stall", NULL, "?stall sampler start <period_ms> <window_ms> [<threshold> <action>]"},
+    {"stall", NULL, "?stall sampler (read | clear | stop)"},
+    {"arrival", arrival, "Use the UL arrival-time histograms"},
+    {"arrival", NULL, "?arrival config <bin_width_ns> <num_bins> [<origin_ns>]"},
+    {"arrival", NULL, "?arrival add <cc> <port> <offset_ns> {<offset_ns>}"},
+    {"arrival", NULL, "?arrival read <cc> <port>"},
+    {"arrival", NULL, "?arrival percentile <cc> <port> <percentile>"},
+    {"arrival", NULL, "?arrival clear"},
+    {"recorder", recorder, "Use the flight recorder"},
+    {"recorder", NULL, "?recorder trigger <triggers> <alarm_mask> <post_records> [<dump_file>]"},
+    {"recorder", NULL, "?recorder sampling <period_ms>"},
+    {"recorder", NULL, "?recorder (fire | rearm | status)"},
+    {"recorder", NULL, "?recorder dump <dump_file>"},
+    {"timeline", timeline, "Capture a timeline of library operations"},
+    {"timeline", NULL, "?timeline start [<max_events>]"},
+    {"timeline", NULL, "?timeline (stop | status)"},
+    {"timeline", NULL, "?timeline write <file>"},
+    {"scrubber", scrubber, "Check the configuration registers for corruption"},
+    {"scrubber", NULL, "?scrubber start [<budget> [<mode>]]"},
+    {"scrubber", NULL, "?scrubber run [<mode>]"},
+    {"scrubber", NULL, "?scrubber (stop | status | log | clear)"},
+    {"latency", latency, "Calculate the latency budget of a component carrier"},
+    {"latency", NULL, "?latency <cc> <t12_min> <t12_max> [<t34_min> <t34_max> [<t1a_max_up> <ta4_max>]]"},
+    {"bandwidth", bandwidth, "Calculate the U-plane bit rates and packet rates"},
+    {"bandwidth", NULL, "?bandwidth (cc <cc> | port <port>) <link_gbps> <mtu> <dl> <ul> [<prach> <prach_rbs> <prach_sym> [<ssb> <ssb_sym>]]"},
+    {"comp_advice", comp_advice, "Recommend the narrowest IQ compression that meets a quality target"},
+    {"comp_advice", NULL, "?comp_advice <cc> (ul | dl | ssb | prach) <target_evm> [<modulation> <backoff> <power_range> [<num_rbs> <seed>]]"},
 #ifdef EXTRA_DEBUG
     {"test_fhi", test_fhi, "?test_fhi ..."},
 #endif // EXTRA_DEBUG
@@ -892,6 +944,23 @@ static int debug(const char *request, char *response)
  *      - Error code if not successful
  */
 static int init(const char *request, char *response)
+{
+    // Hold off the other threads using the libraries (e.g. metrics exporter)
+    pthread_rwlock_wrlock(&library_lock);
+    int result = init_libraries(request, response);
+    pthread_rwlock_unlock(&library_lock);
+    return result;
+}
+
+/**
+ * @brief Perform the "init" command (with the library lock held).
+ * @param[in] request Pointer to request string
+ * @param[in,out] response Pointer to response string
+ * @returns
+ *      - 0 if successful
+ *      - Error code if not successful
+ */
+static int init_libraries(const char *request, char *response)
 {
     if (remote_target)
     {
@@ -1012,6 +1081,23 @@ static int init(const char *request, char *response)
  *      - Error code if not successful
  */
 static int finish(const char *request, char *response)
+{
+    // Hold off the other threads using the libraries (e.g. metrics exporter)
+    pthread_rwlock_wrlock(&library_lock);
+    int result = finish_libraries(request, response);
+    pthread_rwlock_unlock(&library_lock);
+    return result;
+}
+
+/**
+ * @brief Perform the "finish" command (with the library lock held).
+ * @param[in] request Pointer to request string
+ * @param[in,out] response Pointer to response string
+ * @returns
+ *      - 0 if successful
+ *      - Error code if not successful
+ */
+static int finish_libraries(const char *request, char *response)
 {
     if (remote_target)
     {
@@ -1224,6 +1310,25 @@ static int has(const char *request, char *response)
 #endif
 }
 
+#ifndef NO_HW
+// Maximum number of ports reported by "get fhi_stats_all" (one value per port on each line)
+#define MAX_STATS_PORTS 8
+
+// Number of samples buffered by "monitor fhi stream start"
+#define MONITOR_STREAM_DEPTH 1024
+
+// Statistics consumer handle used by "get fhi_stats_delta" (opened on first use)
+static int stats_consumer = -1;
+
+#define PRINT_STATS_ALL(field, fmt)                             \
+    response += sprintf(response, #field " =");                 \
+    for (int i = 0; i < num_ports; ++i)                         \
+    {                                                           \
+        response += sprintf(response, " " fmt, stats[i].field); \
+    }                                                           \
+    response += sprintf(response, "\n");
+#endif
+
 /**
  * @brief "get" command.
  * @param[in] request Pointer to request string
@@ -1324,6 +1429,100 @@ static int get(const char *request, char *response)
                     response += sprintf(response, "result = 0x%X\n", result);
                     return SUCCESS;
                 }
+                else if (match(s, "fhi_alarm_counts") && num_tokens == 2)
+                {
+                    // get fhi_alarm_counts
+                    struct xorif_fhi_alarm_counts counts;
+                    int result = xorif_get_fhi_alarm_counts(&counts);
+                    if (result == XORIF_SUCCESS)
+                    {
+                        response += sprintf(response, "status = 0\n");
+                        response += sprintf(response, "interrupts = %lu\n", counts.interrupts);
+                        for (int i = 0; i < 32; ++i)
+                        {
+                            if (counts.count[i])
+                            {
+                                response += sprintf(response, "count[0x%X] = %u\n", 1U << i, counts.count[i]);
+                            }
+                        }
+                        response += sprintf(response, "cc_disables = %u\n", counts.cc_disables);
+                        response += sprintf(response, "deframer_restarts = %u\n", counts.deframer_restarts);
+                        response += sprintf(response, "resets = %u\n", counts.resets);
+                        response += sprintf(response, "suppressed = %u\n", counts.suppressed);
+                        return SUCCESS;
+                    }
+                    return result;
+                }
+                else if (match(s, "fhi_alarm_policy") && num_tokens == 3)
+                {
+                    // get fhi_alarm_policy <alarm>
+                    unsigned int alarm;
+                    if (parse_integer(2, &alarm))
+                    {
+                        uint16_t action;
+                        uint16_t cc_mask;
+                        int result = xorif_get_fhi_alarm_policy(alarm, &action, &cc_mask);
+                        if (result == XORIF_SUCCESS)
+                        {
+                            response += sprintf(response, "status = 0\n");
+                            response += sprintf(response, "action = %d\n", action);
+                            response += sprintf(response, "cc_mask = 0x%X\n", cc_mask);
+                            return SUCCESS;
+                        }
+                        return result;
+                    }
+                }
+                else if (match(s, "fhi_alarm_storm") && num_tokens == 2)
+                {
+                    // get fhi_alarm_storm
+                    struct xorif_fhi_alarm_storm_stats stats;
+                    int result = xorif_get_fhi_alarm_storm_stats(&stats);
+                    if (result == XORIF_SUCCESS)
+                    {
+                        response += sprintf(response, "status = 0\n");
+                        response += sprintf(response, "masked = 0x%X\n", stats.masked);
+                        for (int i = 0; i < 32; ++i)
+                        {
+                            if (stats.storms[i])
+                            {
+                                response += sprintf(response, "storms[0x%X] = %u\n", 1U << i, stats.storms[i]);
+                                response += sprintf(response, "coalesced[0x%X] = %u\n", 1U << i, stats.coalesced[i]);
+                                response += sprintf(response, "masked_time[0x%X] = %lu\n", 1U << i, stats.masked_time[i]);
+                                response += sprintf(response, "backoff_ms[0x%X] = %u\n", 1U << i, stats.backoff_ms[i]);
+                            }
+                        }
+                        return SUCCESS;
+                    }
+                    return result;
+                }
+                else if (match(s, "irq_stats") && num_tokens == 2)
+                {
+                    // get irq_stats
+                    struct xorif_irq_stats stats;
+                    int result = xorif_get_irq_stats(&stats);
+                    if (result == XORIF_SUCCESS)
+                    {
+                        response += sprintf(response, "status = 0\n");
+                        response += sprintf(response, "interrupts = %lu\n", stats.interrupts);
+                        response += sprintf(response, "fhi = %lu\n", stats.fhi);
+                        response += sprintf(response, "ocp = %lu\n", stats.ocp);
+                        response += sprintf(response, "spurious = %lu\n", stats.spurious);
+                        response += sprintf(response, "min_ns = %u\n", stats.min_ns);
+                        response += sprintf(response, "mean_ns = %lu\n", stats.interrupts ? stats.total_ns / stats.interrupts : 0);
+                        response += sprintf(response, "max_ns = %u\n", stats.max_ns);
+                        response += sprintf(response, "last_ns = %u\n", stats.last_ns);
+                        for (int i = 0; i < IRQ_LATENCY_BINS; ++i)
+                        {
+                            if (stats.histogram[i])
+                            {
+                                response += sprintf(response, "histogram[<%uus] = %u\n", 1U << i, stats.histogram[i]);
+                            }
+                        }
+                        response += sprintf(response, "log_dropped = %u\n", stats.log_dropped);
+                        return SUCCESS;
+                    }
+                    return result;
+                }
                 else if (match(s, "fhi_stats") && num_tokens == 3)
                 {
                     // get fhi_stats <port>
@@ -1358,6 +1557,85 @@ static int get(const char *request, char *response)
                         }
                     }
                 }
+                else if (match(s, "fhi_stats_all") && num_tokens == 2)
+                {
+                    // get fhi_stats_all
+                    struct xorif_fhi_eth_stats stats[MAX_STATS_PORTS];
+                    int num_ports = xorif_get_capabilities()->num_eth_ports;
+                    num_ports = (num_ports > MAX_STATS_PORTS) ? MAX_STATS_PORTS : num_ports;
+                    int result = xorif_get_fhi_eth_stats_all(num_ports, stats);
+                    response += sprintf(response, "status = %d\n", result);
+                    if (result == XORIF_SUCCESS)
+                    {
+                        PRINT_STATS_ALL(total_rx_good_pkt_cnt, "%lu");
+                        PRINT_STATS_ALL(total_rx_bad_pkt_cnt, "%lu");
+                        PRINT_STATS_ALL(total_rx_bad_fcs_cnt, "%lu");
+                        PRINT_STATS_ALL(total_rx_bit_rate, "%lu");
+                        PRINT_STATS_ALL(oran_rx_bit_rate, "%lu");
+                        PRINT_STATS_ALL(oran_rx_total, "%lu");
+                        PRINT_STATS_ALL(oran_rx_on_time, "%lu");
+                        PRINT_STATS_ALL(oran_rx_early, "%lu");
+                        PRINT_STATS_ALL(oran_rx_late, "%lu");
+                        PRINT_STATS_ALL(oran_rx_total_c, "%lu");
+                        PRINT_STATS_ALL(oran_rx_on_time_c, "%lu");
+                        PRINT_STATS_ALL(oran_rx_early_c, "%lu");
+                        PRINT_STATS_ALL(oran_rx_late_c, "%lu");
+                        PRINT_STATS_ALL(oran_rx_corrupt, "%lu");
+                        PRINT_STATS_ALL(oran_rx_error_drop, "%lu");
+                        PRINT_STATS_ALL(oran_tx_total, "%lu");
+                        PRINT_STATS_ALL(oran_tx_total_c, "%lu");
+                        PRINT_STATS_ALL(offset_earliest_u_pkt, "%d");
+                        PRINT_STATS_ALL(offset_earliest_c_pkt, "%d");
+                        return SUCCESS;
+                    }
+                }
+                else if (match(s, "fhi_stats_delta") && num_tokens == 3)
+                {
+                    // get fhi_stats_delta <port>
+                    unsigned int port;
+                    if (parse_integer(2, &port))
+                    {
+                        int result = XORIF_SUCCESS;
+                        if (stats_consumer < 0)
+                        {
+                            uint16_t handle;
+                            result = xorif_open_stats_consumer(&handle);
+                            stats_consumer = (result == XORIF_SUCCESS) ? handle : -1;
+                        }
+                        struct xorif_fhi_eth_stats_delta stats;
+                        if (result == XORIF_SUCCESS)
+                        {
+                            result = xorif_read_stats_consumer(stats_consumer, port, &stats);
+                        }
+                        response += sprintf(response, "status = %d\n", result);
+                        if (result == XORIF_SUCCESS)
+                        {
+                            response += sprintf(response, "epoch = %u\n", stats.epoch);
+                            response += sprintf(response, "resets = %u\n", stats.resets);
+                            response += sprintf(response, "interval = %lu\n", stats.interval);
+                            response += sprintf(response, "total_rx_good_pkt_cnt = %lu\n", stats.delta.total_rx_good_pkt_cnt);
+                            response += sprintf(response, "total_rx_bad_pkt_cnt = %lu\n", stats.delta.total_rx_bad_pkt_cnt);
+                            response += sprintf(response, "total_rx_bad_fcs_cnt = %lu\n", stats.delta.total_rx_bad_fcs_cnt);
+                            response += sprintf(response, "total_rx_bit_rate = %lu\n", stats.delta.total_rx_bit_rate);
+                            response += sprintf(response, "oran_rx_bit_rate = %lu\n", stats.delta.oran_rx_bit_rate);
+                            response += sprintf(response, "oran_rx_total = %lu\n", stats.delta.oran_rx_total);
+                            response += sprintf(response, "oran_rx_on_time = %lu\n", stats.delta.oran_rx_on_time);
+                            response += sprintf(response, "oran_rx_early = %lu\n", stats.delta.oran_rx_early);
+                            response += sprintf(response, "oran_rx_late = %lu\n", stats.delta.oran_rx_late);
+                            response += sprintf(response, "oran_rx_total_c = %lu\n", stats.delta.oran_rx_total_c);
+                            response += sprintf(response, "oran_rx_on_time_c = %lu\n", stats.delta.oran_rx_on_time_c);
+                            response += sprintf(response, "oran_rx_early_c = %lu\n", stats.delta.oran_rx_early_c);
+                            response += sprintf(response, "oran_rx_late_c = %lu\n", stats.delta.oran_rx_late_c);
+                            response += sprintf(response, "oran_rx_corrupt = %lu\n", stats.delta.oran_rx_corrupt);
+                            response += sprintf(response, "oran_rx_error_drop = %lu\n", stats.delta.oran_rx_error_drop);
+                            response += sprintf(response, "oran_tx_total = %lu\n", stats.delta.oran_tx_total);
+                            response += sprintf(response, "oran_tx_total_c = %lu\n", stats.delta.oran_tx_total_c);
+                            response += sprintf(response, "offset_earliest_u_pkt = %d\n", stats.delta.offset_earliest_u_pkt);
+                            response += sprintf(response, "offset_earliest_c_pkt = %d\n", stats.delta.offset_earliest_c_pkt);
+                            return SUCCESS;
+                        }
+                    }
+                }
                 else if (match(s, "fhi_cc_config") && num_tokens == 3)
                 {
                     // get fhi_cc_config <cc>
@@ -1452,11 +1730,103 @@ static int get(const char *request, char *response)
                 else if (match(s, "fhi_enabled") && num_tokens == 2)
                 {
                     // get fhi_enabled
-                    uint8_t result = xorif_get_enabled_cc_mask();
+                    uint16_t result = xorif_get_enabled_cc_mask();
                     response += sprintf(response, "status = 0\n");
-                    response += sprintf(response, "result = 0x%02X\n", result);
+                    response += sprintf(response, "result = 0x%04X\n", result);
                     return SUCCESS;
                 }
+                else if (match(s, "fhi_eaxc_layout") && num_tokens == 8)
+                {
+                    // get fhi_eaxc_layout <num_du> <num_bs> <num_cc> <num_user> <num_prach> <num_ssb>
+                    unsigned int du, bs, cc, user, prach, ssb;
+                    if (parse_integer(2, &du) && parse_integer(3, &bs) && parse_integer(4, &cc) &&
+                        parse_integer(5, &user) && parse_integer(6, &prach) && parse_integer(7, &ssb))
+                    {
+                        struct xorif_eaxc_spec spec = {du, bs, cc, user, prach, ssb};
+                        struct xorif_eaxc_layout layout;
+                        int result = xorif_compile_eaxc_layout(&spec, &layout, NULL, 0);
+                        if (result == XORIF_SUCCESS)
+                        {
+                            response += sprintf(response, "status = 0\n");
+                            response += sprintf(response, "du_bits = %d\n", layout.du_bits);
+                            response += sprintf(response, "bs_bits = %d\n", layout.bs_bits);
+                            response += sprintf(response, "cc_bits = %d\n", layout.cc_bits);
+                            response += sprintf(response, "ru_bits = %d\n", layout.ru_bits);
+                            response += sprintf(response, "ss_bits = %d\n", layout.ss_bits);
+                            response += sprintf(response, "mask = 0x%X\n", layout.mask);
+                            response += sprintf(response, "user_val = 0x%X\n", layout.user_val);
+                            response += sprintf(response, "prach_val = 0x%X\n", layout.prach_val);
+                            response += sprintf(response, "ssb_val = 0x%X\n", layout.ssb_val);
+                            response += sprintf(response, "table_size = %d\n", layout.table_size);
+                            return SUCCESS;
+                        }
+                        else
+                        {
+                            return result;
+                        }
+                    }
+                }
+                else if (match(s, "fhi_port_config") && num_tokens == 3)
+                {
+                    // get fhi_port_config <port>
+                    unsigned int port;
+                    if (parse_integer(2, &port))
+                    {
+                        struct xorif_fhi_port_config config;
+                        int result = xorif_get_fhi_port_config(port, &config);
+                        if (result == XORIF_SUCCESS)
+                        {
+                            response += sprintf(response, "status = 0\n");
+                            response += sprintf(response, "transport = %s\n", config.transport == PROTOCOL_ECPRI ? "ECPRI" : "1914.3");
+                            response += sprintf(response, "vlan = %d\n", config.vlan);
+                            response += sprintf(response, "ip_mode = %s\n", config.ip_mode == IP_MODE_IPV4 ? "IPv4" : config.ip_mode == IP_MODE_IPV6 ? "IPv6" : "RAW");
+                            response += sprintf(response, "vlan_id = %d\n", config.vlan_id);
+                            response += sprintf(response, "vlan_dei = %d\n", config.vlan_dei);
+                            response += sprintf(response, "vlan_pcp = %d\n", config.vlan_pcp);
+                            response += sprintf(response, "planned_cc_mask = 0x%04X\n", config.planned_cc_mask);
+                            for (int i = 0; i < 4; ++i)
+                            {
+                                response += sprintf(response, "filter_%d = 0x%08X 0x%08X 0x%08X 0x%08X\n", i,
+                                                    config.filter[i * 4], config.filter[i * 4 + 1],
+                                                    config.filter[i * 4 + 2], config.filter[i * 4 + 3]);
+                                response += sprintf(response, "mask_%d = 0x%04X\n", i, config.mask[i]);
+                            }
+                            return SUCCESS;
+                        }
+                        else
+                        {
+                            return result;
+                        }
+                    }
+                }
+                else if (match(s, "fhi_modu_table") && (num_tokens == 3 || num_tokens == 5))
+                {
+                    // get fhi_modu_table <port> [<du> <number>]
+                    unsigned int port;
+                    unsigned int du = 0;
+                    unsigned int number = 16;
+                    if (parse_integer(2, &port) && (num_tokens == 3 || (parse_integer(3, &du) && parse_integer(4, &number))))
+                    {
+                        struct xorif_modu_entry table[16];
+                        int result = (number <= 16) ? xorif_get_modu_table(port, du, number, table) : XORIF_INVALID_CONFIG;
+                        if (result == XORIF_SUCCESS)
+                        {
+                            response += sprintf(response, "status = 0\n");
+                            for (int i = 0; i < number; ++i)
+                            {
+                                const uint8_t *a = table[i].address;
+                                response += sprintf(response, "du_%d = %02X:%02X:%02X:%02X:%02X:%02X %d %d %d\n", du + i,
+                                                    a[0], a[1], a[2], a[3], a[4], a[5],
+                                                    table[i].id, table[i].dei, table[i].pcp);
+                            }
+                            return SUCCESS;
+                        }
+                        else
+                        {
+                            return result;
+                        }
+                    }
+                }
 #ifdef BF_INCLUDED
                 else if (match(s, "bf_sw_version") && num_tokens == 2)
                 {
@@ -2226,6 +2596,28 @@ static int set(const char *request, char *response)
                         return xorif_set_mtu_size(size);
                     }
                 }
+                else if (match(s, "fhi_alarm_policy") && (num_tokens == 4 || num_tokens == 5))
+                {
+                    // set fhi_alarm_policy <alarms> <action> [<cc_mask>]
+                    unsigned int alarms;
+                    unsigned int action;
+                    unsigned int cc_mask = 0;
+                    if (parse_integer(2, &alarms) && parse_integer(3, &action) && (num_tokens == 4 || parse_integer(4, &cc_mask)))
+                    {
+                        return xorif_set_fhi_alarm_policy(alarms, action, cc_mask);
+                    }
+                }
+                else if (match(s, "fhi_alarm_storm") && num_tokens == 5)
+                {
+                    // set fhi_alarm_storm <threshold> <window_ms> <backoff_ms>
+                    unsigned int threshold;
+                    unsigned int window_ms;
+                    unsigned int backoff_ms;
+                    if (parse_integer(2, &threshold) && parse_integer(3, &window_ms) && parse_integer(4, &backoff_ms))
+                    {
+                        return xorif_set_fhi_alarm_storm(threshold, window_ms, backoff_ms);
+                    }
+                }
                 else if (match(s, "protocol") && num_tokens == 5)
                 {
                     // set protocol <ECPRI | 1914.3> <VLAN = 0|1> <RAW | IPv4 | IPv6>
@@ -2317,6 +2709,16 @@ static int set(const char *request, char *response)
                         return xorif_set_fhi_vlan_tag(port, id, dei, pcp);
                     }
                 }
+                else if (match(s, "cc_planned_eth_port") && num_tokens == 4)
+                {
+                    // set cc_planned_eth_port <cc> <port>
+                    unsigned int cc;
+                    unsigned int port;
+                    if (parse_integer(2, &cc) && parse_integer(3, &port))
+                    {
+                        return xorif_set_cc_planned_eth_port(cc, port);
+                    }
+                }
                 else if (match(s, "eAxC_id") && num_tokens == 6)
                 {
                     // set eaxc_id <DU bits> <BS bits> <CC bits> <RU bits>
@@ -2551,7 +2953,7 @@ static int clear(const char *request, char *response)
     {
         if (num_tokens == 2)
         {
-            // clear (fhi_alarms | fhi_stats | bf_alarms | bf_stats | ru_ports_table)
+            // clear (fhi_alarms | fhi_alarm_counts | fhi_stats | irq_stats | bf_alarms | bf_stats | ru_ports_table)
             const char *s;
             if (parse_string(1, &s))
             {
@@ -2561,12 +2963,24 @@ static int clear(const char *request, char *response)
                     response += sprintf(response, "status = 0\n");
                     return SUCCESS;
                 }
+                else if (match(s, "fhi_alarm_counts"))
+                {
+                    xorif_clear_fhi_alarm_counts();
+                    response += sprintf(response, "status = 0\n");
+                    return SUCCESS;
+                }
                 else if (match(s, "fhi_stats"))
                 {
                     xorif_clear_fhi_stats();
                     response += sprintf(response, "status = 0\n");
                     return SUCCESS;
                 }
+                else if (match(s, "irq_stats"))
+                {
+                    xorif_clear_irq_stats();
+                    response += sprintf(response, "status = 0\n");
+                    return SUCCESS;
+                }
                 else if (match(s, "ru_ports_table"))
                 {
                     xorif_clear_ru_ports_table();
@@ -2651,6 +3065,10 @@ static int configure(const char *request, char *response)
                 {
                     return xorif_configure_cc(cc);
                 }
+                else if (match(s, "fhi_hot_add"))
+                {
+                    return xorif_configure_cc_hot_add(cc);
+                }
 #ifdef BF_INCLUDED
                 else if (match(s, "bf"))
                 {
@@ -3189,7 +3607,107 @@ static int monitor(const char *request, char *response)
 #else
     else
     {
-        if (num_tokens == 3)
+        const char *s1;
+        const char *s2;
+        if ((num_tokens >= 4) && parse_string(1, &s1) && parse_string(2, &s2) && match(s1, "fhi") && match(s2, "read_bulk"))
+        {
+            // monitor fhi read_bulk <counter> {<counter>}
+            uint8_t counters[MAX_TOKENS];
+            uint64_t values[MAX_TOKENS];
+            uint64_t timestamp;
+            int num = num_tokens - 3;
+            for (int i = 0; i < num; ++i)
+            {
+                unsigned int val;
+                if (!parse_integer(3 + i, &val))
+                {
+                    return MALFORMED_COMMAND;
+                }
+                counters[i] = val;
+            }
+            int result = xorif_monitor_read_bulk(num, counters, values, &timestamp);
+            if (result == XORIF_SUCCESS)
+            {
+                response += sprintf(response, "status = 0\n");
+                response += sprintf(response, "timestamp = %lu\n", timestamp);
+                for (int i = 0; i < num; ++i)
+                {
+                    response += sprintf(response, "counter[%d] = %lu\n", counters[i], values[i]);
+                }
+                return SUCCESS;
+            }
+            return result;
+        }
+        else if ((num_tokens >= 4) && parse_string(1, &s1) && parse_string(2, &s2) && match(s1, "fhi") && match(s2, "stream"))
+        {
+            // monitor fhi stream start <period_us> <counter> {<counter>}
+            // monitor fhi stream read
+            // monitor fhi stream stop
+            const char *s3;
+            unsigned int period;
+            if (!parse_string(3, &s3))
+            {
+                return MALFORMED_COMMAND;
+            }
+            else if (match(s3, "start") && (num_tokens >= 6) && parse_integer(4, &period))
+            {
+                uint8_t counters[MAX_TOKENS];
+                int num = num_tokens - 5;
+                for (int i = 0; i < num; ++i)
+                {
+                    unsigned int val;
+                    if (!parse_integer(5 + i, &val))
+                    {
+                        return MALFORMED_COMMAND;
+                    }
+                    counters[i] = val;
+                }
+                return xorif_start_monitor_stream(period, num, counters, MONITOR_STREAM_DEPTH);
+            }
+            else if (match(s3, "stop") && (num_tokens == 4))
+            {
+                return xorif_stop_monitor_stream();
+            }
+            else if (match(s3, "read") && (num_tokens == 4))
+            {
+                // Read one sample at a time, for as long as the samples fit in the response
+                const char *start = response;
+                struct xorif_monitor_sample sample;
+                uint32_t dropped = 0;
+                int count = 0;
+                int result;
+                response += sprintf(response, "status = 0\n");
+                while (1)
+                {
+                    uint16_t num;
+                    uint32_t temp;
+                    result = xorif_read_monitor_stream(1, &sample, &num, &temp);
+                    if (result != XORIF_SUCCESS)
+                    {
+                        return result;
+                    }
+                    dropped += temp;
+                    if (num == 0)
+                    {
+                        break;
+                    }
+                    response += sprintf(response, "sample[%d] = %lu", count++, sample.timestamp);
+                    for (int i = 0; i < sample.num_counters; ++i)
+                    {
+                        response += sprintf(response, " %lu", sample.values[i]);
+                    }
+                    response += sprintf(response, "\n");
+                    if ((response - start) + 21 * (sample.num_counters + 2) + 64 >= MAX_BUFF_SIZE)
+                    {
+                        break;
+                    }
+                }
+                response += sprintf(response, "samples = %d\n", count);
+                response += sprintf(response, "dropped = %u\n", dropped);
+                return SUCCESS;
+            }
+        }
+        else if (num_tokens == 3)
         {
             // monitor fhi clear
             // monitor fhi snapshot
@@ -3263,7 +3781,64 @@ static int stall(const char *request, char *response)
 #else
     else
     {
-        if (num_tokens == 2)
+        const char *s1;
+        const char *s2;
+        if ((num_tokens >= 3) && parse_string(1, &s1) && parse_string(2, &s2) && match(s1, "sampler"))
+        {
+            // stall sampler start <period_ms> <window_ms> [<threshold> <action>]
+            // stall sampler read
+            // stall sampler clear
+            // stall sampler stop
+            unsigned int period, window, threshold = 0, action = 0;
+            if (match(s2, "start") && ((num_tokens == 5) || (num_tokens == 7)) &&
+                parse_integer(3, &period) && parse_integer(4, &window) &&
+                ((num_tokens == 5) || (parse_integer(5, &threshold) && parse_integer(6, &action))))
+            {
+                return xorif_start_stall_sampler(period, window, threshold, action);
+            }
+            else if (match(s2, "stop") && (num_tokens == 3))
+            {
+                return xorif_stop_stall_sampler();
+            }
+            else if (match(s2, "clear") && (num_tokens == 3))
+            {
+                return xorif_clear_stall_stats();
+            }
+            else if (match(s2, "read") && (num_tokens == 3))
+            {
+                struct xorif_stall_sampler_status status;
+                int result = xorif_get_stall_sampler_status(&status);
+                if (result != XORIF_SUCCESS)
+                {
+                    return result;
+                }
+                response += sprintf(response, "status = 0\n");
+                response += sprintf(response, "running = %u\n", status.running);
+                response += sprintf(response, "samples = %lu\n", status.samples);
+                response += sprintf(response, "events = %u\n", status.events);
+                response += sprintf(response, "window_events = %u\n", status.window_events);
+                response += sprintf(response, "recoveries = %u\n", status.recoveries);
+
+                // Only the spatial streams that have stalled
+                static const char *names[] = {"dl", "ul", "prach", "ssb", "unsol"};
+                static const int nums[] = {20, 16, 4, 4, 4};
+                for (int t = 0; t < 5; ++t)
+                {
+                    for (int ss = 0; ss < nums[t]; ++ss)
+                    {
+                        struct xorif_stall_stats stats;
+                        if ((xorif_get_stall_stats(t, ss, &stats) == XORIF_SUCCESS) && (stats.events || stats.stalled))
+                        {
+                            response += sprintf(response, "%s_ss[%d] = %u %u %lu %lu %u %u %.3f\n", names[t], ss,
+                                                stats.events, stats.stalled, stats.duration, stats.max_duration,
+                                                stats.window_events, stats.cc_events, stats.rate);
+                        }
+                    }
+                }
+                return SUCCESS;
+            }
+        }
+        else if (num_tokens == 2)
         {
             // stall snapshot
             // stall read
@@ -3297,6 +3872,608 @@ static int stall(const char *request, char *response)
 #endif // NO_HW
 }
 
+/**
+ * @brief "arrival" command.
+ * @param[in] request Pointer to request string
+ * @param[in,out] response Pointer to response string
+ * @returns
+ *      - 0 if successful
+ *      - Error code if not successful
+ */
+static int arrival(const char *request, char *response)
+{
+    if (remote_target)
+    {
+        return send_to_target(request, response);
+    }
+#ifdef NO_HW
+    return NO_HARDWARE;
+#else
+    else
+    {
+        const char *s;
+        if ((num_tokens >= 2) && parse_string(1, &s))
+        {
+            unsigned int cc, port, width, bins;
+            double value;
+            if (match(s, "config") && ((num_tokens == 4) || (num_tokens == 5)) &&
+                parse_integer(2, &width) && parse_integer(3, &bins))
+            {
+                // arrival config <bin_width_ns> <num_bins> [<origin_ns>]
+                double origin = 0;
+                if ((num_tokens == 5) && !parse_double(4, &origin))
+                {
+                    return MALFORMED_COMMAND;
+                }
+                return xorif_configure_arrival_histogram(width, bins, (int32_t)origin);
+            }
+            else if (match(s, "add") && (num_tokens >= 5) && parse_integer(2, &cc) && parse_integer(3, &port))
+            {
+                // arrival add <cc> <port> <offset_ns> {<offset_ns>}
+                int32_t offsets[MAX_TOKENS];
+                int num = num_tokens - 4;
+                for (int i = 0; i < num; ++i)
+                {
+                    if (!parse_double(4 + i, &value))
+                    {
+                        return MALFORMED_COMMAND;
+                    }
+                    offsets[i] = (int32_t)value;
+                }
+                return xorif_add_arrival_samples(cc, port, num, offsets);
+            }
+            else if (match(s, "read") && (num_tokens == 4) && parse_integer(2, &cc) && parse_integer(3, &port))
+            {
+                // arrival read <cc> <port>
+                struct xorif_arrival_histogram hist;
+                int result = xorif_get_arrival_histogram(cc, port, &hist);
+                if (result == XORIF_SUCCESS)
+                {
+                    response += sprintf(response, "status = 0\n");
+                    response += sprintf(response, "samples = %lu\n", hist.samples);
+                    response += sprintf(response, "underflow = %lu\n", hist.underflow);
+                    response += sprintf(response, "overflow = %lu\n", hist.overflow);
+                    response += sprintf(response, "min_ns = %d\n", hist.min_ns);
+                    response += sprintf(response, "mean_ns = %d\n", hist.mean_ns);
+                    response += sprintf(response, "max_ns = %d\n", hist.max_ns);
+                    response += sprintf(response, "p50_ns = %d\n", hist.p50_ns);
+                    response += sprintf(response, "p90_ns = %d\n", hist.p90_ns);
+                    response += sprintf(response, "p99_ns = %d\n", hist.p99_ns);
+                    response += sprintf(response, "p999_ns = %d\n", hist.p999_ns);
+                    response += sprintf(response, "hw_early = %lu\n", hist.hw_early);
+                    response += sprintf(response, "hw_on_time = %lu\n", hist.hw_on_time);
+                    response += sprintf(response, "hw_late = %lu\n", hist.hw_late);
+
+                    // Only the bins with samples
+                    for (int i = 0; i < hist.num_bins; ++i)
+                    {
+                        if (hist.bins[i])
+                        {
+                            response += sprintf(response, "bin[%d] = %lu\n", hist.origin_ns + i * (int)hist.bin_width_ns, hist.bins[i]);
+                        }
+                    }
+                    return SUCCESS;
+                }
+                return result;
+            }
+            else if (match(s, "percentile") && (num_tokens == 5) && parse_integer(2, &cc) && parse_integer(3, &port) &&
+                     parse_double(4, &value))
+            {
+                // arrival percentile <cc> <port> <percentile>
+                int32_t offset;
+                int result = xorif_get_arrival_percentile(cc, port, value, &offset);
+                if (result == XORIF_SUCCESS)
+                {
+                    response += sprintf(response, "status = 0\n");
+                    response += sprintf(response, "offset_ns = %d\n", offset);
+                    return SUCCESS;
+                }
+                return result;
+            }
+            else if (match(s, "clear") && (num_tokens == 2))
+            {
+                // arrival clear
+                return xorif_clear_arrival_histograms();
+            }
+        }
+    }
+    return UNKNOWN_COMMAND;
+#endif // NO_HW
+}
+
+/**
+ * @brief "recorder" command.
+ * @param[in] request Pointer to request string
+ * @param[in,out] response Pointer to response string
+ * @returns
+ *      - 0 if successful
+ *      - Error code if not successful
+ */
+static int recorder(const char *request, char *response)
+{
+    if (remote_target)
+    {
+        return send_to_target(request, response);
+    }
+#ifdef NO_HW
+    return NO_HARDWARE;
+#else
+    else
+    {
+        const char *s;
+        const char *file;
+        if ((num_tokens >= 2) && parse_string(1, &s))
+        {
+            unsigned int triggers, mask, post, period;
+            if (match(s, "trigger") && ((num_tokens == 5) || (num_tokens == 6)) &&
+                parse_integer(2, &triggers) && parse_integer(3, &mask) && parse_integer(4, &post))
+            {
+                // recorder trigger <triggers> <alarm_mask> <post_records> [<dump_file>]
+                file = NULL;
+                if ((num_tokens == 6) && !parse_string(5, &file))
+                {
+                    return MALFORMED_COMMAND;
+                }
+                return xorif_set_recorder_trigger(triggers, mask, post, file);
+            }
+            else if (match(s, "sampling") && (num_tokens == 3) && parse_integer(2, &period))
+            {
+                // recorder sampling <period_ms>
+                return xorif_set_recorder_sampling(period);
+            }
+            else if (match(s, "fire") && (num_tokens == 2))
+            {
+                // recorder fire
+                return xorif_trigger_recorder();
+            }
+            else if (match(s, "rearm") && (num_tokens == 2))
+            {
+                // recorder rearm
+                return xorif_rearm_recorder();
+            }
+            else if (match(s, "dump") && (num_tokens == 3) && parse_string(2, &file))
+            {
+                // recorder dump <dump_file>
+                return xorif_dump_recorder(file);
+            }
+            else if (match(s, "status") && (num_tokens == 2))
+            {
+                // recorder status
+                struct xorif_recorder_status status;
+                int result = xorif_get_recorder_status(&status);
+                if (result == XORIF_SUCCESS)
+                {
+                    response += sprintf(response, "status = 0\n");
+                    response += sprintf(response, "frozen = %u\n", status.frozen);
+                    response += sprintf(response, "triggers = 0x%X\n", status.triggers);
+                    response += sprintf(response, "alarm_mask = 0x%X\n", status.alarm_mask);
+                    response += sprintf(response, "post_records = %u\n", status.post_records);
+                    response += sprintf(response, "sample_ms = %u\n", status.sample_ms);
+                    response += sprintf(response, "trigger = 0x%X\n", status.trigger);
+                    response += sprintf(response, "trigger_seq = %u\n", status.trigger_seq);
+                    response += sprintf(response, "trigger_time = %lu\n", status.trigger_time);
+                    response += sprintf(response, "records = %lu\n", status.records);
+                    response += sprintf(response, "dumps = %u\n", status.dumps);
+                    response += sprintf(response, "dump_result = %d\n", status.dump_result);
+                    return SUCCESS;
+                }
+                return result;
+            }
+        }
+    }
+    return UNKNOWN_COMMAND;
+#endif // NO_HW
+}
+
+/**
+ * @brief "timeline" command.
+ * @param[in] request Pointer to request string
+ * @param[in,out] response Pointer to response string
+ * @returns
+ *      - 0 if successful
+ *      - Error code if not successful
+ */
+static int timeline(const char *request, char *response)
+{
+    if (remote_target)
+    {
+        return send_to_target(request, response);
+    }
+#ifdef NO_HW
+    return NO_HARDWARE;
+#else
+    else
+    {
+        const char *s;
+        const char *file;
+        if ((num_tokens >= 2) && parse_string(1, &s))
+        {
+            unsigned int max_events = 0;
+            if (match(s, "start") && ((num_tokens == 2) || ((num_tokens == 3) && parse_integer(2, &max_events))))
+            {
+                // timeline start [<max_events>]
+                return xorif_start_timeline(max_events);
+            }
+            else if (match(s, "stop") && (num_tokens == 2))
+            {
+                // timeline stop
+                return xorif_stop_timeline();
+            }
+            else if (match(s, "write") && (num_tokens == 3) && parse_string(2, &file))
+            {
+                // timeline write <file>
+                return xorif_write_timeline(file);
+            }
+            else if (match(s, "status") && (num_tokens == 2))
+            {
+                // timeline status
+                struct xorif_timeline_status status;
+                int result = xorif_get_timeline_status(&status);
+                if (result == XORIF_SUCCESS)
+                {
+                    response += sprintf(response, "status = 0\n");
+                    response += sprintf(response, "enabled = %u\n", status.enabled);
+                    response += sprintf(response, "capacity = %u\n", status.capacity);
+                    response += sprintf(response, "spans = %u\n", status.spans);
+                    response += sprintf(response, "open = %u\n", status.open);
+                    response += sprintf(response, "lost = %u\n", status.lost);
+                    return SUCCESS;
+                }
+                return result;
+            }
+        }
+    }
+    return UNKNOWN_COMMAND;
+#endif // NO_HW
+}
+
+/**
+ * @brief "scrubber" command.
+ * @param[in] request Pointer to request string
+ * @param[in,out] response Pointer to response string
+ * @returns
+ *      - 0 if successful
+ *      - Error code if not successful
+ */
+static int scrubber(const char *request, char *response)
+{
+    if (remote_target)
+    {
+        return send_to_target(request, response);
+    }
+#ifdef NO_HW
+    return NO_HARDWARE;
+#else
+    else
+    {
+        const char *s;
+        if ((num_tokens >= 2) && parse_string(1, &s))
+        {
+            unsigned int budget = 0;
+            unsigned int mode = SCRUB_REPORT;
+            if (match(s, "start") && (num_tokens <= 4) &&
+                ((num_tokens < 3) || parse_integer(2, &budget)) &&
+                ((num_tokens < 4) || parse_integer(3, &mode)))
+            {
+                // scrubber start [<budget> [<mode>]]
+                return xorif_start_scrubber(budget, mode);
+            }
+            else if (match(s, "stop") && (num_tokens == 2))
+            {
+                // scrubber stop
+                return xorif_stop_scrubber();
+            }
+            else if (match(s, "run") && ((num_tokens == 2) || ((num_tokens == 3) && parse_integer(2, &mode))))
+            {
+                // scrubber run [<mode>]
+                uint32_t mismatches;
+                int result = xorif_scrub_registers(mode, &mismatches);
+                if (result == XORIF_SUCCESS)
+                {
+                    response += sprintf(response, "status = 0\n");
+                    response += sprintf(response, "mismatches = %u\n", mismatches);
+                    return SUCCESS;
+                }
+                return result;
+            }
+            else if (match(s, "status") && (num_tokens == 2))
+            {
+                // scrubber status
+                struct xorif_scrubber_status status;
+                int result = xorif_get_scrubber_status(&status);
+                if (result == XORIF_SUCCESS)
+                {
+                    response += sprintf(response, "status = 0\n");
+                    response += sprintf(response, "running = %u\n", status.running);
+                    response += sprintf(response, "budget = %u\n", status.budget);
+                    response += sprintf(response, "mode = %u\n", status.mode);
+                    response += sprintf(response, "registers = %u\n", status.registers);
+                    response += sprintf(response, "passes = %lu\n", status.passes);
+                    response += sprintf(response, "reads = %lu\n", status.reads);
+                    response += sprintf(response, "mismatches = %u\n", status.mismatches);
+                    response += sprintf(response, "restored = %u\n", status.restored);
+                    response += sprintf(response, "retries = %u\n", status.retries);
+                    return SUCCESS;
+                }
+                return result;
+            }
+            else if (match(s, "log") && (num_tokens == 2))
+            {
+                // scrubber log
+                struct xorif_scrub_mismatch log[SCRUB_LOG_SIZE];
+                uint16_t num;
+                int result = xorif_get_scrubber_log(SCRUB_LOG_SIZE, log, &num);
+                if (result == XORIF_SUCCESS)
+                {
+                    response += sprintf(response, "status = 0\n");
+                    response += sprintf(response, "num = %u\n", num);
+                    for (int i = 0; i < num; ++i)
+                    {
+                        response += sprintf(response, "mismatch[%d] = %s 0x%04X 0x%X 0x%X %u\n", i, log[i].name,
+                                            log[i].addr, log[i].expected, log[i].actual, log[i].restored);
+                    }
+                    return SUCCESS;
+                }
+                return result;
+            }
+            else if (match(s, "clear") && (num_tokens == 2))
+            {
+                // scrubber clear
+                return xorif_clear_scrubber_stats();
+            }
+        }
+    }
+    return UNKNOWN_COMMAND;
+#endif // NO_HW
+}
+
+/**
+ * @brief "latency" command.
+ * @param[in] request Pointer to request string
+ * @param[in,out] response Pointer to response string
+ * @returns
+ *      - 0 if successful
+ *      - Error code if not successful
+ */
+static int latency(const char *request, char *response)
+{
+    if (remote_target)
+    {
+        return send_to_target(request, response);
+    }
+#ifdef NO_HW
+    return NO_HARDWARE;
+#else
+    else
+    {
+        unsigned int cc;
+        struct xorif_transport_delay transport = {0};
+        if (((num_tokens == 4) || (num_tokens == 6) || (num_tokens == 8)) && parse_integer(1, &cc) &&
+            parse_double(2, &transport.t12_min) && parse_double(3, &transport.t12_max) &&
+            ((num_tokens < 6) || (parse_double(4, &transport.t34_min) && parse_double(5, &transport.t34_max))) &&
+            ((num_tokens < 8) || (parse_double(6, &transport.t1a_max_up) && parse_double(7, &transport.ta4_max))))
+        {
+            // latency <cc> <t12_min> <t12_max> [<t34_min> <t34_max> [<t1a_max_up> <ta4_max>]]
+            if (num_tokens == 4)
+            {
+                // Same transport delay in both directions
+                transport.t34_min = transport.t12_min;
+                transport.t34_max = transport.t12_max;
+            }
+
+            struct xorif_latency_budget budget;
+            int result = xorif_get_latency_budget(cc, &transport, &budget);
+            if (result == XORIF_SUCCESS)
+            {
+                response += sprintf(response, "status = 0\n");
+                response += sprintf(response, "sym_period = %g\n", budget.sym_period);
+                response += sprintf(response, "dl_transport = %g\n", budget.dl_transport);
+                response += sprintf(response, "dl_deskew = %g\n", budget.dl_deskew);
+                response += sprintf(response, "dl_decap = %g\n", budget.dl_decap);
+                response += sprintf(response, "dl_total = %g\n", budget.dl_total);
+                response += sprintf(response, "dl_ctrl_advance = %g\n", budget.dl_ctrl_advance);
+                response += sprintf(response, "dl_ctrl_deskew = %g\n", budget.dl_ctrl_deskew);
+                response += sprintf(response, "dl_ctrl_total = %g\n", budget.dl_ctrl_total);
+                response += sprintf(response, "ul_radio = %g\n", budget.ul_radio);
+                response += sprintf(response, "ul_framing = %g\n", budget.ul_framing);
+                response += sprintf(response, "ul_transport = %g\n", budget.ul_transport);
+                response += sprintf(response, "ul_total = %g\n", budget.ul_total);
+                response += sprintf(response, "ul_ctrl_advance = %g\n", budget.ul_ctrl_advance);
+                response += sprintf(response, "ul_ctrl_deskew = %g\n", budget.ul_ctrl_deskew);
+                response += sprintf(response, "ul_bid_forward = %g\n", budget.ul_bid_forward);
+                response += sprintf(response, "t2a_up = %g %g\n", budget.t2a_min_up, budget.t2a_max_up);
+                response += sprintf(response, "t2a_cp_dl = %g %g\n", budget.t2a_min_cp_dl, budget.t2a_max_cp_dl);
+                response += sprintf(response, "t2a_cp_ul = %g %g\n", budget.t2a_min_cp_ul, budget.t2a_max_cp_ul);
+                response += sprintf(response, "ta3 = %g %g\n", budget.ta3_min, budget.ta3_max);
+                response += sprintf(response, "t1a_up = %g %g\n", budget.t1a_min_up, budget.t1a_max_up);
+                response += sprintf(response, "t1a_cp_dl = %g %g\n", budget.t1a_min_cp_dl, budget.t1a_max_cp_dl);
+                response += sprintf(response, "t1a_cp_ul = %g %g\n", budget.t1a_min_cp_ul, budget.t1a_max_cp_ul);
+                response += sprintf(response, "ta4 = %g %g\n", budget.ta4_min, budget.ta4_max);
+                response += sprintf(response, "dl_data_symbols = %u %u\n", budget.dl_data_symbols, budget.max_data_symbols);
+                response += sprintf(response, "dl_ctrl_symbols = %u %u\n", budget.dl_ctrl_symbols, budget.max_ctrl_symbols);
+                response += sprintf(response, "ul_ctrl_symbols = %u %u\n", budget.ul_ctrl_symbols, budget.max_ctrl_symbols);
+                response += sprintf(response, "violations = 0x%X\n", budget.violations);
+                return SUCCESS;
+            }
+            return result;
+        }
+    }
+    return UNKNOWN_COMMAND;
+#endif // NO_HW
+}
+
+/**
+ * @brief "bandwidth" command.
+ * @param[in] request Pointer to request string
+ * @param[in,out] response Pointer to response string
+ * @returns
+ *      - 0 if successful
+ *      - Error code if not successful
+ */
+static int bandwidth(const char *request, char *response)
+{
+    if (remote_target)
+    {
+        return send_to_target(request, response);
+    }
+#ifdef NO_HW
+    return NO_HARDWARE;
+#else
+    else
+    {
+        const char *s;
+        unsigned int id, mtu, dl, ul, prach = 0, prach_rbs = 0, prach_sym = 0, ssb = 0, ssb_sym = 0;
+        double link_rate;
+        if (((num_tokens == 7) || (num_tokens == 10) || (num_tokens == 12)) && parse_string(1, &s) &&
+            parse_integer(2, &id) && parse_double(3, &link_rate) && parse_integer(4, &mtu) &&
+            parse_integer(5, &dl) && parse_integer(6, &ul) &&
+            ((num_tokens < 10) || (parse_integer(7, &prach) && parse_integer(8, &prach_rbs) && parse_integer(9, &prach_sym))) &&
+            ((num_tokens < 12) || (parse_integer(10, &ssb) && parse_integer(11, &ssb_sym))))
+        {
+            struct xorif_bandwidth_params params = {
+                .link_rate = link_rate,
+                .mtu = mtu,
+                .dl_streams = dl,
+                .ul_streams = ul,
+                .prach_streams = prach,
+                .ssb_streams = ssb,
+                .prach_rbs = prach_rbs,
+                .prach_symbols = prach_sym,
+                .ssb_symbols = ssb_sym,
+            };
+
+            if (match(s, "cc"))
+            {
+                // bandwidth cc <cc> <link_gbps> <mtu> <dl> <ul> [<prach> <prach_rbs> <prach_sym> [<ssb> <ssb_sym>]]
+                struct xorif_cc_bandwidth bw;
+                int result = xorif_get_cc_bandwidth(id, &params, &bw);
+                if (result == XORIF_SUCCESS)
+                {
+                    response += sprintf(response, "status = 0\n");
+                    response += sprintf(response, "eth_port = %u\n", bw.eth_port);
+                    response += sprintf(response, "mtu = %u\n", bw.mtu);
+                    response += sprintf(response, "dl = %.0f %.0f %.0f %u\n", bw.dl.iq_rate, bw.dl.bit_rate, bw.dl.packet_rate, bw.dl.frame_size);
+                    response += sprintf(response, "ul = %.0f %.0f %.0f %u\n", bw.ul.iq_rate, bw.ul.bit_rate, bw.ul.packet_rate, bw.ul.frame_size);
+                    response += sprintf(response, "prach = %.0f %.0f %.0f %u\n", bw.prach.iq_rate, bw.prach.bit_rate, bw.prach.packet_rate, bw.prach.frame_size);
+                    response += sprintf(response, "ssb = %.0f %.0f %.0f %u\n", bw.ssb.iq_rate, bw.ssb.bit_rate, bw.ssb.packet_rate, bw.ssb.frame_size);
+                    return SUCCESS;
+                }
+                return result;
+            }
+            else if (match(s, "port"))
+            {
+                // bandwidth port <port> <link_gbps> <mtu> <dl> <ul> [<prach> <prach_rbs> <prach_sym> [<ssb> <ssb_sym>]]
+                struct xorif_port_bandwidth bw;
+                int result = xorif_get_port_bandwidth(id, &params, &bw);
+                if (result == XORIF_SUCCESS)
+                {
+                    response += sprintf(response, "status = 0\n");
+                    response += sprintf(response, "cc_mask = 0x%X\n", bw.cc_mask);
+                    response += sprintf(response, "link_rate = %g\n", bw.link_rate);
+                    response += sprintf(response, "dl = %.0f %.0f %.0f %u\n", bw.dl.iq_rate, bw.dl.bit_rate, bw.dl.packet_rate, bw.dl.frame_size);
+                    response += sprintf(response, "ul = %.0f %.0f %.0f %u\n", bw.ul.iq_rate, bw.ul.bit_rate, bw.ul.packet_rate, bw.ul.frame_size);
+                    response += sprintf(response, "dl_utilization = %.4f\n", bw.dl_utilization);
+                    response += sprintf(response, "ul_utilization = %.4f\n", bw.ul_utilization);
+                    response += sprintf(response, "overload = 0x%X\n", bw.overload);
+                    return SUCCESS;
+                }
+                return result;
+            }
+        }
+    }
+    return UNKNOWN_COMMAND;
+#endif // NO_HW
+}
+
+/**
+ * @brief "comp_advice" command.
+ * @param[in] request Pointer to request string
+ * @param[in,out] response Pointer to response string
+ * @returns
+ *      - 0 if successful
+ *      - Error code if not successful
+ */
+static int comp_advice(const char *request, char *response)
+{
+    if (remote_target)
+    {
+        return send_to_target(request, response);
+    }
+#ifdef NO_HW
+    return NO_HARDWARE;
+#else
+    else
+    {
+        const char *s;
+        unsigned int cc, modulation = 0, num_rbs = 0, seed = 0;
+        struct xorif_comp_advice_params params = {0};
+        if (((num_tokens == 4) || (num_tokens == 7) || (num_tokens == 9)) && parse_integer(1, &cc) &&
+            parse_string(2, &s) && parse_double(3, &params.target_evm) &&
+            ((num_tokens < 7) || (parse_integer(4, &modulation) && parse_double(5, &params.backoff) && parse_double(6, &params.power_range))) &&
+            ((num_tokens < 9) || (parse_integer(7, &num_rbs) && parse_integer(8, &seed))))
+        {
+            // comp_advice <cc> (ul | dl | ssb | prach) <target_evm> [<modulation> <backoff> <power_range> [<num_rbs> <seed>]]
+            enum xorif_chan_type chan;
+            if (match(s, "ul"))
+            {
+                chan = CHAN_UL;
+            }
+            else if (match(s, "dl"))
+            {
+                chan = CHAN_DL;
+            }
+            else if (match(s, "ssb"))
+            {
+                chan = CHAN_SSB;
+            }
+            else if (match(s, "prach"))
+            {
+                chan = CHAN_PRACH;
+            }
+            else
+            {
+                return UNKNOWN_COMMAND;
+            }
+
+            if (num_tokens < 7)
+            {
+                // Default test vector, 256QAM at 12 dB below full scale
+                params.backoff = 12;
+            }
+            params.modulation = modulation;
+            params.num_rbs = num_rbs;
+            params.seed = seed;
+
+            struct xorif_comp_advice advice;
+            int result = xorif_advise_iq_compression(cc, chan, &params, &advice);
+            if (result == XORIF_SUCCESS)
+            {
+                response += sprintf(response, "status = 0\n");
+                response += sprintf(response, "num = %u\n", advice.num_candidates);
+                for (int i = 0; i < advice.num_candidates; ++i)
+                {
+                    const struct xorif_comp_candidate *ptr = &advice.candidates[i];
+                    response += sprintf(response, "candidate[%d] = %u %u %.4f %.2f %.0f %u\n", i, ptr->comp_meth,
+                                        ptr->comp_width, ptr->evm, ptr->sqnr, ptr->bit_rate, ptr->meets_target);
+                }
+                if (advice.recommended != COMP_ADVICE_NONE)
+                {
+                    const struct xorif_comp_candidate *ptr = &advice.candidates[advice.recommended];
+                    response += sprintf(response, "recommended = %u %u\n", ptr->comp_meth, ptr->comp_width);
+                }
+                else
+                {
+                    response += sprintf(response, "recommended = none\n");
+                }
+                return SUCCESS;
+            }
+            return result;
+        }
+    }
+    return UNKNOWN_COMMAND;
+#endif // NO_HW
+}
+
 #ifdef BF_INCLUDED
 /**
  * @brief "schedule_bf" command.
@@ -0,0 +1,476 @@
+/*
+ * Copyright 2020 - 2023 Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file xorif_metrics.c
+ * @author Steven Dickinson
+ * @brief Source file for the xorif-app "metrics exporter" functions.
+ * @addtogroup xorif-app
+ * @{
+ *
+ * The metrics exporter serves the Front-Haul Interface statistics, alarms,
+ * memory pool utilization (and OCP state) in OpenMetrics text format over
+ * HTTP, on a TCP port or a Unix domain socket. It runs in its own thread, so
+ * that a slow scraper doesn't hold up the command socket. Each scrape holds
+ * off the "init" and "finish" commands (see library_lock), so the libraries
+ * can't be finished (and the device unmapped) part way through, but it runs
+ * alongside the other commands. The Ethernet statistics of all ports come
+ * from a single snapshot (or from the libxorif statistics collector, if it's
+ * running), and are accumulated so that the counters never go backwards.
+ */
+
+#include <stddef.h>
+#include <stdarg.h>
+#include <pthread.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include "xorif_app.h"
+#ifndef NO_HW
+#include "xorif_api.h"
+#ifdef OCP_INCLUDED
+#include "xocp_api.h"
+#endif
+#endif
+
+#ifndef NO_HW
+
+#define METRICS_BUFF_SIZE 65536       // Size of the response buffer
+#define METRICS_MAX_PORTS 8           // Maximum number of Ethernet ports reported
+#define METRICS_READ_TIMEOUT_MS 1000  // Time-out for reading the HTTP request
+
+// Ethernet statistics fields (counters are reported with the "_total" suffix)
+struct metrics_field
+{
+    const char *name;  // Metric name (without the "xorif_fhi_" prefix)
+    uint16_t offset;   // Offset in the statistics structure
+    uint8_t size;      // Field size in bytes
+    uint8_t counter;   // 1 = counter, 0 = gauge
+    const char *help;  // Help text
+};
+
+#define FIELD(f, c, h) {#f, offsetof(struct xorif_fhi_eth_stats, f), sizeof(((struct xorif_fhi_eth_stats *)0)->f), c, h}
+
+static const struct metrics_field stats_fields[] = {
+    FIELD(total_rx_good_pkt_cnt, 1, "Total received good packets"),
+    FIELD(total_rx_bad_pkt_cnt, 1, "Total received bad packets"),
+    FIELD(total_rx_bad_fcs_cnt, 1, "Total received packets with bad FCS"),
+    FIELD(total_rx_bit_rate, 0, "Total received packets bit rate"),
+    FIELD(oran_rx_bit_rate, 0, "O-RAN received packets bit rate"),
+    FIELD(oran_rx_total, 1, "O-RAN total received packets"),
+    FIELD(oran_rx_on_time, 1, "O-RAN U-Plane on-time received packets"),
+    FIELD(oran_rx_early, 1, "O-RAN U-Plane early received packets"),
+    FIELD(oran_rx_late, 1, "O-RAN U-Plane late received packets"),
+    FIELD(oran_rx_total_c, 1, "O-RAN C-Plane total received packets"),
+    FIELD(oran_rx_on_time_c, 1, "O-RAN C-Plane on-time received packets"),
+    FIELD(oran_rx_early_c, 1, "O-RAN C-Plane early received packets"),
+    FIELD(oran_rx_late_c, 1, "O-RAN C-Plane late received packets"),
+    FIELD(oran_rx_corrupt, 1, "O-RAN received packets with corrupted transport header fields"),
+    FIELD(oran_rx_error_drop, 1, "O-RAN discarded received packets"),
+    FIELD(oran_tx_total, 1, "O-RAN total transmitted packets"),
+    FIELD(oran_tx_total_c, 1, "O-RAN C-Plane total transmitted packets"),
+    FIELD(offset_earliest_u_pkt, 0, "Largest offset of a U-Plane packet from the internal timer"),
+    FIELD(offset_earliest_c_pkt, 0, "Largest offset of a C-Plane packet from the internal timer"),
+};
+#define NUM_STATS_FIELDS (sizeof(stats_fields) / sizeof(stats_fields[0]))
+
+// Alarm names (see enum xorif_fhi_alarms)
+static const struct
+{
+    uint32_t mask;
+    const char *name;
+} alarm_names[] = {
+    {FRAMER_RESET_STATUS, "framer_reset_status"},
+    {DEFRAMER_RESET_STATUS, "deframer_reset_status"},
+    {DEFRAMER_IN_FIFO_OF, "deframer_in_fifo_of"},
+    {DEFRAMER_IN_FIFO_UF, "deframer_in_fifo_uf"},
+    {DEFRAMER_ETH_CIRC_BUFF_OF, "deframer_eth_circ_buff_of"},
+    {DEFRAMER_ETH_CIRC_BUFF_PTR_OF, "deframer_eth_circ_buff_ptr_of"},
+    {FRAMER_OUT_FIFO_OF, "framer_out_fifo_of"},
+    {FRAMER_OUT_FIFO_UF, "framer_out_fifo_uf"},
+    {FRAMER_PRACH_SECTION_OF, "framer_prach_section_of"},
+    {FRAMER_PRACH_SECTION_NF, "framer_prach_section_nf"},
+    {FRAMER_SECTION_OF, "framer_section_of"},
+    {AXI_TIMEOUT, "axi_timeout"},
+};
+#define NUM_ALARMS (sizeof(alarm_names) / sizeof(alarm_names[0]))
+
+static int metrics_fd = -1;
+static pthread_t metrics_thread;
+static char metrics_buff[METRICS_BUFF_SIZE];
+static size_t metrics_len;
+
+/**
+ * @brief Append formatted text to the metrics response buffer.
+ * @param[in] format Format
+ * @note The text is silently truncated if the buffer is full.
+ */
+static void append(const char *format, ...)
+{
+    size_t space = METRICS_BUFF_SIZE - metrics_len;
+    if (space > 1)
+    {
+        va_list args;
+        va_start(args, format);
+        int n = vsnprintf(&metrics_buff[metrics_len], space, format, args);
+        va_end(args);
+        if (n > 0)
+        {
+            // When truncated, only the text that was written counts (not the terminator)
+            metrics_len += ((size_t)n < space) ? (size_t)n : space - 1;
+        }
+    }
+}
+
+/**
+ * @brief Append the metric family meta-data.
+ * @param[in] name Metric family name
+ * @param[in] type Metric type
+ * @param[in] help Help text
+ */
+static void append_family(const char *name, const char *type, const char *help)
+{
+    append("# TYPE %s %s\n", name, type);
+    append("# HELP %s %s\n", name, help);
+}
+
+/**
+ * @brief Append the Ethernet statistics for all ports.
+ */
+static void append_stats(void)
+{
+    struct xorif_fhi_eth_stats stats[METRICS_MAX_PORTS];
+    int num_ports = xorif_get_capabilities()->num_eth_ports;
+    num_ports = (num_ports > METRICS_MAX_PORTS) ? METRICS_MAX_PORTS : num_ports;
+
+    // One snapshot for all ports (served from the statistics collector, if it's running)
+    if (xorif_get_fhi_eth_stats_all(num_ports, stats) != XORIF_SUCCESS)
+    {
+        return;
+    }
+
+    for (int f = 0; f < NUM_STATS_FIELDS; ++f)
+    {
+        const struct metrics_field *field = &stats_fields[f];
+        char name[64];
+        snprintf(name, sizeof(name), "xorif_fhi_%s", field->name);
+        append_family(name, field->counter ? "counter" : "gauge", field->help);
+
+        for (int port = 0; port < num_ports; ++port)
+        {
+            const uint8_t *ptr = (const uint8_t *)&stats[port] + field->offset;
+            uint64_t value = (field->size == 8) ? *(const uint64_t *)ptr : *(const uint16_t *)ptr;
+            append("%s%s{port=\"%d\"} %" PRIu64 "\n", name, field->counter ? "_total" : "", port, value);
+        }
+    }
+}
+
+/**
+ * @brief Append the alarm status and per-alarm counters.
+ */
+static void append_alarms(void)
+{
+    uint32_t alarms = xorif_get_fhi_alarms();
+
+    append_family("xorif_fhi_alarm", "gauge", "Front-Haul Interface alarm status (1 = raised)");
+    for (int i = 0; i < NUM_ALARMS; ++i)
+    {
+        append("xorif_fhi_alarm{alarm=\"%s\"} %d\n", alarm_names[i].name, (alarms & alarm_names[i].mask) ? 1 : 0);
+    }
+
+    struct xorif_fhi_alarm_counts counts;
+    if (xorif_get_fhi_alarm_counts(&counts) == XORIF_SUCCESS)
+    {
+        append_family("xorif_fhi_alarm_events", "counter", "Front-Haul Interface alarm occurrences");
+        for (int i = 0; i < NUM_ALARMS; ++i)
+        {
+            int bit = __builtin_ctz(alarm_names[i].mask);
+            append("xorif_fhi_alarm_events_total{alarm=\"%s\"} %u\n", alarm_names[i].name, counts.count[bit]);
+        }
+    }
+}
+
+/**
+ * @brief Append the memory pool utilization (summed over all component carriers).
+ */
+static void append_pools(void)
+{
+    const struct xorif_caps *caps = xorif_get_capabilities();
+    uint32_t used[8] = {0};
+    const char *names[8] = {"ul_ctrl", "ul_ctrl_base", "dl_ctrl", "dl_data_ptrs",
+                            "dl_data_buff", "ssb_ctrl", "ssb_data_ptrs", "ssb_data_buff"};
+    uint32_t sizes[8] = {1024 * caps->max_ul_ctrl_1kwords, caps->max_subcarriers / 12,
+                         1024 * caps->max_dl_ctrl_1kwords, caps->max_data_symbols,
+                         1024 * caps->max_dl_data_1kwords, 512 * caps->max_ssb_ctrl_512words,
+                         caps->max_data_symbols, 512 * caps->max_ssb_data_512words};
+
+    for (int cc = 0; cc < caps->max_cc; ++cc)
+    {
+        struct xorif_cc_alloc alloc;
+        memset(&alloc, 0, sizeof(alloc));
+        if (xorif_get_fhi_cc_alloc(cc, &alloc) == XORIF_SUCCESS)
+        {
+            used[0] += alloc.ul_ctrl_size;
+            used[1] += alloc.ul_ctrl_base_size;
+            used[2] += alloc.dl_ctrl_size;
+            used[3] += alloc.dl_data_ptrs_size;
+            used[4] += alloc.dl_data_buff_size;
+            used[5] += alloc.ssb_ctrl_size;
+            used[6] += alloc.ssb_data_ptrs_size;
+            used[7] += alloc.ssb_data_buff_size;
+        }
+    }
+
+    append_family("xorif_fhi_pool_used", "gauge", "Memory pool allocation (all component carriers)");
+    for (int i = 0; i < 8; ++i)
+    {
+        append("xorif_fhi_pool_used{pool=\"%s\"} %u\n", names[i], used[i]);
+    }
+    append_family("xorif_fhi_pool_size", "gauge", "Memory pool size");
+    for (int i = 0; i < 8; ++i)
+    {
+        append("xorif_fhi_pool_size{pool=\"%s\"} %u\n", names[i], sizes[i]);
+    }
+}
+
+#ifdef OCP_INCLUDED
+/**
+ * @brief Append the OCP state.
+ */
+static void append_ocp(void)
+{
+    const char *states[] = {"idle", "reset", "ready", "operational"};
+
+    append_family("xocp_state", "stateset", "O-RAN Channel Processor state");
+    for (int instance = 0; instance < XOCP_NUM_INSTANCES; ++instance)
+    {
+        int state = xocp_get_state(instance);
+        for (int i = 0; i < 4; ++i)
+        {
+            append("xocp_state{instance=\"%d\",xocp_state=\"%s\"} %d\n", instance, states[i], (state == i) ? 1 : 0);
+        }
+    }
+}
+#endif
+
+/**
+ * @brief Build the metrics response (OpenMetrics text format).
+ */
+static void build_metrics(void)
+{
+    // Hold off the "init" and "finish" commands until the scrape is complete
+    pthread_rwlock_rdlock(&library_lock);
+    int up = (xorif_get_state() == 1);
+
+    metrics_len = 0;
+    append_family("xorif_fhi_up", "gauge", "Front-Haul Interface initialized");
+    append("xorif_fhi_up %d\n", up);
+    if (up)
+    {
+        append_stats();
+        append_alarms();
+        append_pools();
+    }
+#ifdef OCP_INCLUDED
+    append_ocp();
+#endif
+    append("# EOF\n");
+    pthread_rwlock_unlock(&library_lock);
+}
+
+/**
+ * @brief Write a complete buffer to a socket.
+ * @param[in] fd Socket file descriptor
+ * @param[in] buff Buffer
+ * @param[in] len Length of buffer
+ */
+static void write_all(int fd, const char *buff, size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t n = write(fd, buff, len);
+        if (n <= 0)
+        {
+            PERROR("Metrics socket write failed\n");
+            return;
+        }
+        buff += n;
+        len -= n;
+    }
+}
+
+/**
+ * @brief Handle a single (HTTP) metrics request.
+ * @param[in] fd Connection file descriptor
+ */
+static void handle_request(int fd)
+{
+    char request[LINE_BUFF_SIZE];
+    size_t len = 0;
+
+    // Read the request (headers are ignored, only the request line matters)
+    while (len < sizeof(request) - 1)
+    {
+        struct pollfd pfd = {.fd = fd, .events = POLLIN};
+        if (poll(&pfd, 1, METRICS_READ_TIMEOUT_MS) <= 0)
+        {
+            break;
+        }
+        ssize_t n = read(fd, &request[len], sizeof(request) - 1 - len);
+        if (n <= 0)
+        {
+            break;
+        }
+        len += n;
+        request[len] = '\0';
+        if (strstr(request, "\r\n\r\n") || strstr(request, "\n\n"))
+        {
+            break;
+        }
+    }
+    request[len] = '\0';
+
+    char header[256];
+    if (strncmp(request, "GET ", 4) != 0)
+    {
+        snprintf(header, sizeof(header), "HTTP/1.0 405 Method Not Allowed\r\nContent-Length: 0\r\n\r\n");
+        write_all(fd, header, strlen(header));
+        return;
+    }
+
+    build_metrics();
+    snprintf(header, sizeof(header),
+             "HTTP/1.0 200 OK\r\n"
+             "Content-Type: application/openmetrics-text; version=1.0.0; charset=utf-8\r\n"
+             "Content-Length: %zu\r\n"
+             "\r\n",
+             metrics_len);
+    write_all(fd, header, strlen(header));
+    write_all(fd, metrics_buff, metrics_len);
+}
+
+/**
+ * @brief Metrics exporter thread.
+ * @param[in] arg Not used
+ * @returns NULL
+ */
+static void *metrics_thread_func(void *arg)
+{
+    (void)arg;
+
+    while (1)
+    {
+        int fd = accept(metrics_fd, NULL, NULL);
+        if (fd < 0)
+        {
+            PERROR("Metrics socket accept failed\n");
+            continue;
+        }
+        handle_request(fd);
+        close(fd);
+    }
+
+    return NULL;
+}
+
+int start_metrics(const char *endpoint)
+{
+    int tcp_port;
+    char dummy;
+
+    if (sscanf(endpoint, "%d%c", &tcp_port, &dummy) == 1)
+    {
+        // TCP/IP port
+        struct sockaddr_in addr;
+        int opt = 1;
+
+        if ((metrics_fd = socket(AF_INET, SOCK_STREAM, 0)) < 0)
+        {
+            PERROR("Metrics socket creation failed\n");
+            return COMMS_ERROR;
+        }
+        setsockopt(metrics_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = INADDR_ANY;
+        addr.sin_port = htons(tcp_port);
+        if (bind(metrics_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+        {
+            PERROR("Metrics socket bind failed (check that the port is not already in use)\n");
+            close(metrics_fd);
+            return COMMS_ERROR;
+        }
+    }
+    else
+    {
+        // Unix domain socket
+        struct sockaddr_un addr;
+
+        if (strlen(endpoint) >= sizeof(addr.sun_path))
+        {
+            PERROR("Metrics socket path too long\n");
+            return COMMS_ERROR;
+        }
+        if ((metrics_fd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0)
+        {
+            PERROR("Metrics socket creation failed\n");
+            return COMMS_ERROR;
+        }
+
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        strcpy(addr.sun_path, endpoint);
+        unlink(endpoint);
+        if (bind(metrics_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+        {
+            PERROR("Metrics socket bind failed\n");
+            close(metrics_fd);
+            return COMMS_ERROR;
+        }
+    }
+
+    if (listen(metrics_fd, 3) < 0)
+    {
+        PERROR("Metrics socket listen failed\n");
+        close(metrics_fd);
+        return COMMS_ERROR;
+    }
+
+    if (pthread_create(&metrics_thread, NULL, metrics_thread_func, NULL) != 0)
+    {
+        PERROR("Failed to start metrics exporter thread\n");
+        close(metrics_fd);
+        return COMMS_ERROR;
+    }
+    pthread_detach(metrics_thread);
+
+    TRACE("Metrics exporter on '%s'\n", endpoint);
+    return SUCCESS;
+}
+
+#else
+
+int start_metrics(const char *endpoint)
+{
+    (void)endpoint;
+    return NO_HARDWARE;
+}
+
+#endif // NO_HW
+
+/** @} */
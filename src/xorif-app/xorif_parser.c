@@ -33,6 +33,10 @@
 char *token[MAX_TOKENS];
 int num_tokens = 0;
 
+// Held for writing by the commands that initialize / finish the libraries, and
+// for reading by the other threads that use them (e.g. metrics exporter)
+pthread_rwlock_t library_lock = PTHREAD_RWLOCK_INITIALIZER;
+
 int match(const char *s1, const char *s2)
 {
     // Case-insensitive comparison